@@ -0,0 +1,508 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// minio-bench runs a configurable S3 workload through Client and reports
+// ops/s, throughput and latency percentiles per operation. Objects are
+// uploaded with PutObject() from a stream and downloaded with GetObject(), so
+// the library's own transfer paths are measured.
+//
+// Usage: minio-bench [OPTIONS]
+//   --endpoint=HOST[:PORT]  Server; SERVER_ENDPOINT if unset, and an
+//                           in-process mock server if neither is set.
+//   --https                 Use HTTPS; also set by ENABLE_HTTPS.
+//   --access-key=KEY        Also taken from ACCESS_KEY.
+//   --secret-key=KEY        Also taken from SECRET_KEY.
+//   --bucket=NAME           Bucket to use; a new bucket by default.
+//   --workload=mixed        put, get, stat, list, delete or mixed.
+//   --mix=put:20,get:60,stat:10,list:5,delete:5
+//                           Operation weights of mixed workload.
+//   --concurrency=16        Number of parallel workers.
+//   --duration=30           Seconds to run.
+//   --size=64KiB            Object size, or MIN-MAX for sizes evenly spread
+//                           in log scale.
+//   --objects=1000          Objects uploaded before non-put workloads.
+//   --prefixes=16           Objects are spread over this many prefixes.
+//   --part-size=5MiB        Larger objects use multipart upload.
+//   --single-put            Upload objects up to 5GiB with single PUT.
+//   --json                  Print results as JSON.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "client.h"
+#include "mockserver.h"
+
+namespace {
+enum Operation { kPut, kGet, kStat, kList, kDelete, kOperationCount };
+
+const char* kOperationNames[kOperationCount] = {"put", "get", "stat", "list",
+                                                "delete"};
+
+struct Config {
+  std::string endpoint;
+  bool https = false;
+  std::string access_key = "minioadmin";
+  std::string secret_key = "minioadmin";
+  std::string bucket;
+  std::string workload = "mixed";
+  unsigned int weights[kOperationCount] = {20, 60, 10, 5, 5};
+  unsigned int concurrency = 16;
+  std::chrono::seconds duration{30};
+  size_t min_size = 64 * 1024;
+  size_t max_size = 64 * 1024;
+  unsigned int objects = 1000;
+  unsigned int prefixes = 16;
+  size_t part_size = minio::utils::kMinPartSize;
+  bool json = false;
+};  // struct Config
+
+struct OperationStats {
+  std::atomic<unsigned long> ops = 0;
+  std::atomic<unsigned long> errors = 0;
+  std::atomic<unsigned long> bytes = 0;
+  minio::s3::Histogram latency;  // Microseconds.
+};  // struct OperationStats
+
+// Keys are names of existing objects shared by all workers.
+class Keys {
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> keys_;
+
+ public:
+  void Add(std::string key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    keys_.push_back(std::move(key));
+  }
+
+  // Pick returns a random key, which is removed if take is set.
+  bool Pick(std::mt19937_64& rg, std::string& key, bool take = false) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (keys_.empty()) return false;
+    size_t i = std::uniform_int_distribution<size_t>(0, keys_.size() - 1)(rg);
+    if (!take) {
+      key = keys_[i];
+      return true;
+    }
+    key = std::move(keys_[i]);
+    keys_[i] = std::move(keys_.back());
+    keys_.pop_back();
+    return true;
+  }
+
+  bool Empty() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return keys_.empty();
+  }
+
+  std::vector<std::string> All() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return keys_;
+  }
+};  // class Keys
+
+// ParseSize parses sizes like 4096, 64KiB, 16MiB or 1GiB.
+size_t ParseSize(std::string value) {
+  size_t pos = 0;
+  double size = std::stod(value, &pos);
+  std::string unit = minio::utils::ToLower(value.substr(pos));
+  if (unit == "k" || unit == "kb" || unit == "kib") size *= 1024;
+  if (unit == "m" || unit == "mb" || unit == "mib") size *= 1024 * 1024;
+  if (unit == "g" || unit == "gb" || unit == "gib") size *= 1024 * 1024 * 1024;
+  return size_t(size);
+}
+
+class Bench {
+ private:
+  Config& config_;
+  minio::s3::Client& client_;
+  std::string data_;  // Source of uploaded bytes.
+  Keys keys_;
+  std::atomic<unsigned long> next_key_ = 0;
+  OperationStats stats_[kOperationCount];
+
+ public:
+  Bench(Config& config, minio::s3::Client& client)
+      : config_(config), client_(client) {
+    data_.resize(config.max_size);
+    std::mt19937_64 rg(1);
+    for (size_t i = 0; i < data_.size(); i++) data_[i] = char(rg());
+  }
+
+  size_t RandomSize(std::mt19937_64& rg) {
+    if (config_.min_size == config_.max_size) return config_.min_size;
+    std::uniform_real_distribution<double> dist(
+        std::log(double(config_.min_size)), std::log(double(config_.max_size)));
+    return std::min(config_.max_size, size_t(std::exp(dist(rg))));
+  }
+
+  std::string NewKey() {
+    unsigned long n = next_key_++;
+    return "prefix-" + std::to_string(n % config_.prefixes) + "/object-" +
+           std::to_string(n);
+  }
+
+  bool Put(std::mt19937_64& rg, size_t& bytes) {
+    bytes = RandomSize(rg);
+    minio::utils::CharBuffer buf(data_.data(), bytes);
+    std::istream stream(&buf);
+    minio::s3::PutObjectArgs args(stream, bytes, config_.part_size);
+    args.bucket = config_.bucket;
+    args.object = NewKey();
+    minio::s3::PutObjectResponse resp = client_.PutObject(args);
+    if (!resp) return false;
+    keys_.Add(args.object);
+    return true;
+  }
+
+  bool Get(std::mt19937_64& rg, size_t& bytes) {
+    minio::s3::GetObjectArgs args;
+    args.bucket = config_.bucket;
+    if (!keys_.Pick(rg, args.object)) return true;
+    args.datafunc = [&bytes](minio::http::DataFunctionArgs args) -> bool {
+      bytes += args.datachunk.size();
+      return true;
+    };
+    return bool(client_.GetObject(args));
+  }
+
+  bool Stat(std::mt19937_64& rg) {
+    minio::s3::StatObjectArgs args;
+    args.bucket = config_.bucket;
+    if (!keys_.Pick(rg, args.object)) return true;
+    return bool(client_.StatObject(args));
+  }
+
+  bool List(std::mt19937_64& rg) {
+    minio::s3::ListObjectsArgs args;
+    args.bucket = config_.bucket;
+    args.prefix =
+        "prefix-" +
+        std::to_string(std::uniform_int_distribution<unsigned int>(
+            0, config_.prefixes - 1)(rg)) +
+        "/";
+    minio::s3::ListObjectsResult result = client_.ListObjects(args);
+    // One page is listed per operation.
+    for (unsigned int count = 0; result; count++) {
+      if (!(*result)) return false;
+      if (count + 1 == args.max_keys) break;
+      result++;
+    }
+    return true;
+  }
+
+  bool Delete(std::mt19937_64& rg) {
+    minio::s3::RemoveObjectArgs args;
+    args.bucket = config_.bucket;
+    if (!keys_.Pick(rg, args.object, true)) return true;
+    return bool(client_.RemoveObject(args));
+  }
+
+  // Prepare uploads objects used by non-put workloads.
+  void Prepare() {
+    std::atomic<unsigned int> count = 0;
+    std::atomic<unsigned int> failures = 0;
+    std::list<std::thread> workers;
+    for (unsigned int i = 0; i < config_.concurrency; i++) {
+      workers.emplace_back([&, i]() {
+        std::mt19937_64 rg(i);
+        size_t bytes = 0;
+        while (count++ < config_.objects) {
+          if (!Put(rg, bytes)) failures++;
+        }
+      });
+    }
+    for (auto& worker : workers) worker.join();
+    if (failures > 0) {
+      std::cerr << "unable to upload " << failures << " of " << config_.objects
+                << " objects" << std::endl;
+    }
+  }
+
+  std::chrono::duration<double> Run() {
+    unsigned int total = 0;
+    for (unsigned int weight : config_.weights) total += weight;
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + config_.duration;
+    std::list<std::thread> workers;
+    for (unsigned int i = 0; i < config_.concurrency; i++) {
+      workers.emplace_back([&, i]() {
+        std::mt19937_64 rg(std::random_device{}() + i);
+        std::uniform_int_distribution<unsigned int> pick(0, total - 1);
+        while (std::chrono::steady_clock::now() < deadline) {
+          unsigned int n = pick(rg);
+          int op = 0;
+          while (n >= config_.weights[op]) n -= config_.weights[op++];
+          // Without objects left, reads and deletes turn into uploads.
+          if (op != kPut && op != kList && keys_.Empty()) op = kPut;
+
+          size_t bytes = 0;
+          auto begin = std::chrono::steady_clock::now();
+          bool ok = false;
+          switch (op) {
+            case kPut:
+              ok = Put(rg, bytes);
+              break;
+            case kGet:
+              ok = Get(rg, bytes);
+              break;
+            case kStat:
+              ok = Stat(rg);
+              break;
+            case kList:
+              ok = List(rg);
+              break;
+            case kDelete:
+              ok = Delete(rg);
+              break;
+          }
+          auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - begin);
+
+          OperationStats& stats = stats_[op];
+          stats.ops++;
+          if (!ok) stats.errors++;
+          stats.bytes += bytes;
+          stats.latency.Record(elapsed.count());
+        }
+      });
+    }
+    for (auto& worker : workers) worker.join();
+    return std::chrono::steady_clock::now() - start;
+  }
+
+  // Cleanup removes all objects left.
+  void Cleanup() {
+    std::vector<std::string> keys = keys_.All();
+    size_t i = 0;
+    minio::s3::RemoveObjectsArgs args;
+    args.bucket = config_.bucket;
+    args.func = [&keys, &i](minio::s3::DeleteObject& obj) -> bool {
+      if (i == keys.size()) return false;
+      obj.name = keys[i++];
+      return true;
+    };
+    minio::s3::RemoveObjectsResult result = client_.RemoveObjects(args);
+    for (; result; result++) {
+      minio::s3::DeleteError err = *result;
+      if (!err) {
+        std::cerr << "unable to remove objects; " << err.Error().String()
+                  << std::endl;
+        break;
+      }
+    }
+  }
+
+  void Report(std::chrono::duration<double> elapsed) {
+    nlohmann::json results = nlohmann::json::array();
+    if (!config_.json) {
+      std::cout << std::left << std::setw(8) << "op" << std::right
+                << std::setw(10) << "ops" << std::setw(10) << "errors"
+                << std::setw(12) << "ops/s" << std::setw(12) << "MiB/s"
+                << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms"
+                << std::setw(10) << "p99 ms" << std::setw(10) << "max ms"
+                << std::endl;
+    }
+
+    double seconds = elapsed.count();
+    for (int op = 0; op < kOperationCount; op++) {
+      OperationStats& stats = stats_[op];
+      if (stats.ops == 0) continue;
+      minio::s3::HistogramSnapshot latency = stats.latency.Snapshot();
+      double ms[4] = {latency.Percentile(0.5) / 1000.0,
+                      latency.Percentile(0.9) / 1000.0,
+                      latency.Percentile(0.99) / 1000.0,
+                      latency.Percentile(1) / 1000.0};
+      double ops_per_second = stats.ops / seconds;
+      double bytes_per_second = stats.bytes / seconds;
+
+      if (config_.json) {
+        nlohmann::json result;
+        result["operation"] = kOperationNames[op];
+        result["ops"] = stats.ops.load();
+        result["errors"] = stats.errors.load();
+        result["ops_per_second"] = ops_per_second;
+        result["bytes_per_second"] = bytes_per_second;
+        result["latency_ms"] = {
+            {"p50", ms[0]}, {"p90", ms[1]}, {"p99", ms[2]}, {"max", ms[3]}};
+        results.push_back(result);
+        continue;
+      }
+
+      std::cout << std::left << std::setw(8) << kOperationNames[op]
+                << std::right << std::setw(10) << stats.ops << std::setw(10)
+                << stats.errors << std::fixed << std::setprecision(1)
+                << std::setw(12) << ops_per_second << std::setw(12)
+                << bytes_per_second / (1024 * 1024) << std::setprecision(2);
+      for (double value : ms) std::cout << std::setw(10) << value;
+      std::cout << std::endl;
+    }
+
+    if (config_.json) {
+      nlohmann::json output;
+      output["seconds"] = seconds;
+      output["concurrency"] = config_.concurrency;
+      output["operations"] = results;
+      std::cout << output.dump(2) << std::endl;
+    }
+  }
+};  // class Bench
+
+bool ParseArgs(int argc, char* argv[], Config& config) {
+  minio::utils::GetEnv(config.endpoint, "SERVER_ENDPOINT");
+  minio::utils::GetEnv(config.access_key, "ACCESS_KEY");
+  minio::utils::GetEnv(config.secret_key, "SECRET_KEY");
+  std::string value;
+  if (minio::utils::GetEnv(value, "ENABLE_HTTPS")) config.https = true;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    size_t pos = arg.find('=');
+    std::string name = arg.substr(0, pos);
+    value = pos == std::string::npos ? "" : arg.substr(pos + 1);
+    if (name == "--endpoint") {
+      config.endpoint = value;
+    } else if (name == "--https") {
+      config.https = true;
+    } else if (name == "--access-key") {
+      config.access_key = value;
+    } else if (name == "--secret-key") {
+      config.secret_key = value;
+    } else if (name == "--bucket") {
+      config.bucket = value;
+    } else if (name == "--workload") {
+      config.workload = value;
+    } else if (name == "--mix") {
+      std::fill(std::begin(config.weights), std::end(config.weights), 0);
+      std::stringstream ss(value);
+      std::string item;
+      while (std::getline(ss, item, ',')) {
+        size_t colon = item.find(':');
+        std::string op = item.substr(0, colon);
+        int j = 0;
+        while (j < kOperationCount && op != kOperationNames[j]) j++;
+        if (j == kOperationCount || colon == std::string::npos) {
+          std::cerr << "invalid mix " << item << std::endl;
+          return false;
+        }
+        config.weights[j] = std::stoul(item.substr(colon + 1));
+      }
+    } else if (name == "--concurrency") {
+      config.concurrency = std::stoul(value);
+    } else if (name == "--duration") {
+      config.duration = std::chrono::seconds(std::stoul(value));
+    } else if (name == "--size") {
+      size_t dash = value.find('-');
+      config.min_size = ParseSize(value.substr(0, dash));
+      config.max_size = dash == std::string::npos
+                            ? config.min_size
+                            : ParseSize(value.substr(dash + 1));
+    } else if (name == "--objects") {
+      config.objects = std::stoul(value);
+    } else if (name == "--prefixes") {
+      config.prefixes = std::stoul(value);
+    } else if (name == "--part-size") {
+      config.part_size = ParseSize(value);
+    } else if (name == "--single-put") {
+      config.part_size = minio::utils::kMaxPartSize;
+    } else if (name == "--json") {
+      config.json = true;
+    } else {
+      std::cerr << "unknown argument " << arg << std::endl;
+      return false;
+    }
+  }
+
+  if (config.workload != "mixed") {
+    int j = 0;
+    while (j < kOperationCount && config.workload != kOperationNames[j]) j++;
+    if (j == kOperationCount) {
+      std::cerr << "unknown workload " << config.workload << std::endl;
+      return false;
+    }
+    std::fill(std::begin(config.weights), std::end(config.weights), 0);
+    config.weights[j] = 1;
+  }
+
+  unsigned int total = 0;
+  for (unsigned int weight : config.weights) total += weight;
+  if (total == 0 || config.concurrency == 0 || config.prefixes == 0 ||
+      config.min_size == 0 || config.min_size > config.max_size) {
+    std::cerr << "invalid workload, concurrency, prefixes or size"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Config config;
+  if (!ParseArgs(argc, argv, config)) return EXIT_FAILURE;
+
+  minio::mock::Server mock;
+  if (config.endpoint.empty()) {
+    if (minio::error::Error err = mock.Start()) {
+      std::cerr << "unable to start mock server; " << err.String()
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    config.endpoint = mock.Endpoint();
+    config.https = false;
+  }
+
+  minio::s3::BaseUrl base_url(config.endpoint, config.https);
+  minio::creds::StaticProvider provider(config.access_key, config.secret_key);
+  minio::s3::Client client(base_url, &provider);
+
+  bool make_bucket = config.bucket.empty();
+  if (make_bucket) {
+    config.bucket = "minio-bench-" + std::to_string(std::random_device{}());
+    minio::s3::MakeBucketArgs args;
+    args.bucket = config.bucket;
+    minio::s3::MakeBucketResponse resp = client.MakeBucket(args);
+    if (!resp) {
+      std::cerr << "MakeBucket(): " << resp.Error().String() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  Bench bench(config, client);
+  if (config.workload != "put") bench.Prepare();
+  std::chrono::duration<double> elapsed = bench.Run();
+  bench.Report(elapsed);
+  bench.Cleanup();
+
+  if (make_bucket) {
+    minio::s3::RemoveBucketArgs args;
+    args.bucket = config.bucket;
+    minio::s3::RemoveBucketResponse resp = client.RemoveBucket(args);
+    if (!resp) {
+      std::cerr << "RemoveBucket(): " << resp.Error().String() << std::endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
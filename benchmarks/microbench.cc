@@ -0,0 +1,649 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// minio-microbench measures hot paths of the library without a server:
+// request signing, Multimap, URL handling, hashing and response decoding.
+// Each benchmark runs until it took at least --min-time seconds and reports
+// nanoseconds, bytes per second and heap allocations per operation as JSON.
+//
+// Usage: minio-microbench [--filter=SUBSTRING] [--min-time=SECONDS]
+//
+// Configuring with -DBENCHMARK_JEMALLOC=ON also builds
+// minio-microbench-jemalloc and minio-bench-jemalloc, so that results under
+// glibc malloc and jemalloc can be compared.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <map>
+#include <iostream>
+#include <new>
+#include <nlohmann/json.hpp>
+
+#include "credentials.h"
+#include "request.h"
+#include "response.h"
+#include "select.h"
+#include "signer.h"
+#include "xml.h"
+
+namespace {
+std::atomic<unsigned long> allocations{0};
+std::atomic<unsigned long> allocated_bytes{0};
+}  // namespace
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+// Results of benchmarked functions are added here so that the compiler
+// cannot drop the work.
+volatile size_t sink = 0;
+
+using Function = std::function<size_t()>;
+
+struct Benchmark {
+  std::string name;
+  size_t bytes = 0;  // Bytes processed by one operation.
+  Function func;
+};  // struct Benchmark
+
+nlohmann::json Run(Benchmark& bm, std::chrono::duration<double> min_time) {
+  size_t iterations = 1;
+  std::chrono::duration<double> elapsed;
+  unsigned long allocs = 0;
+  unsigned long alloc_bytes = 0;
+  while (true) {
+    unsigned long allocs_start = allocations.load();
+    unsigned long bytes_start = allocated_bytes.load();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) sink = sink + bm.func();
+    elapsed = std::chrono::steady_clock::now() - start;
+    allocs = allocations.load() - allocs_start;
+    alloc_bytes = allocated_bytes.load() - bytes_start;
+
+    if (elapsed >= min_time) break;
+
+    // Grow towards min_time, at most 10 times per round.
+    double scale = 10;
+    if (elapsed.count() > 0) {
+      scale = std::min(scale, 1.2 * min_time.count() / elapsed.count());
+    }
+    iterations = std::max(iterations + 1, size_t(iterations * scale));
+  }
+
+  double seconds = elapsed.count();
+  nlohmann::json result;
+  result["name"] = bm.name;
+  result["iterations"] = iterations;
+  result["ns_per_op"] = seconds * 1e9 / iterations;
+  result["ops_per_second"] = iterations / seconds;
+  if (bm.bytes) result["bytes_per_second"] = bm.bytes * iterations / seconds;
+  result["allocs_per_op"] = double(allocs) / iterations;
+  result["alloc_bytes_per_op"] = double(alloc_bytes) / iterations;
+  return result;
+}
+
+// ListObjectsV2Xml returns a ListObjectsV2 page of given number of keys.
+std::string ListObjectsV2Xml(unsigned int keys) {
+  std::string xml =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+      "<Name>my-bucket</Name><Prefix>logs/</Prefix>"
+      "<KeyCount>" +
+      std::to_string(keys) +
+      "</KeyCount><MaxKeys>1000</MaxKeys><IsTruncated>true</IsTruncated>"
+      "<NextContinuationToken>1ueGcxLPRx1Tr/XYExHnhbYLgveDs2J/wm36Hy4vbOwM="
+      "</NextContinuationToken>";
+  for (unsigned int i = 0; i < keys; i++) {
+    xml += "<Contents><Key>logs/2022/10/16/server-" + std::to_string(i) +
+           ".log</Key><LastModified>2022-10-16T12:34:56.789Z</LastModified>"
+           "<ETag>&quot;9b2cf535f27731c974343645a3985328&quot;</ETag>"
+           "<Size>" +
+           std::to_string(1024 + i) +
+           "</Size><Owner><ID>02d6176db174dc93cb1b899f7c6078f08654445fe8cf1b6c"
+           "e98d8855f66bdbf4</ID><DisplayName>minio</DisplayName></Owner>"
+           "<StorageClass>STANDARD</StorageClass></Contents>";
+  }
+  xml += "</ListBucketResult>";
+  return xml;
+}
+
+// ListObjectVersionsXml returns a ListObjectVersions page of given number of
+// versions, every tenth of them a delete marker.
+std::string ListObjectVersionsXml(unsigned int versions) {
+  std::string xml =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<ListVersionsResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+      "<Name>my-bucket</Name><Prefix>logs/</Prefix><KeyMarker></KeyMarker>"
+      "<VersionIdMarker></VersionIdMarker><MaxKeys>1000</MaxKeys>"
+      "<IsTruncated>false</IsTruncated>";
+  for (unsigned int i = 0; i < versions; i++) {
+    std::string key =
+        "logs/2022/10/16/server-" + std::to_string(i / 2) + ".log";
+    if (i % 10 == 9) {
+      xml += "<DeleteMarker><Key>" + key +
+             "</Key><VersionId>a2b3c4d5-e6f7-4a8b-9c0d-" + std::to_string(i) +
+             "</VersionId><IsLatest>true</IsLatest>"
+             "<LastModified>2022-10-16T12:34:56.789Z</LastModified>"
+             "<Owner><ID>minio</ID><DisplayName>minio</DisplayName></Owner>"
+             "</DeleteMarker>";
+      continue;
+    }
+    xml += "<Version><Key>" + key +
+           "</Key><VersionId>a2b3c4d5-e6f7-4a8b-9c0d-" + std::to_string(i) +
+           "</VersionId><IsLatest>false</IsLatest>"
+           "<LastModified>2022-10-16T12:34:56.789Z</LastModified>"
+           "<ETag>&quot;9b2cf535f27731c974343645a3985328&quot;</ETag>"
+           "<Size>" +
+           std::to_string(1024 + i) +
+           "</Size><Owner><ID>minio</ID><DisplayName>minio</DisplayName>"
+           "</Owner><StorageClass>STANDARD</StorageClass></Version>";
+  }
+  xml += "</ListVersionsResult>";
+  return xml;
+}
+
+// ListBucketsXml returns a ListBuckets response of given number of buckets.
+std::string ListBucketsXml(unsigned int buckets) {
+  std::string xml =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<ListAllMyBucketsResult "
+      "xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\"><Owner><ID>minio"
+      "</ID><DisplayName>minio</DisplayName></Owner><Buckets>";
+  for (unsigned int i = 0; i < buckets; i++) {
+    xml += "<Bucket><Name>my-bucket-" + std::to_string(i) +
+           "</Name><CreationDate>2022-10-16T12:34:56.789Z</CreationDate>"
+           "</Bucket>";
+  }
+  xml += "</Buckets></ListAllMyBucketsResult>";
+  return xml;
+}
+
+// DeleteResultXml returns a DeleteObjects response of given number of keys,
+// every hundredth of them failed.
+std::string DeleteResultXml(unsigned int keys) {
+  std::string xml =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<DeleteResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">";
+  for (unsigned int i = 0; i < keys; i++) {
+    std::string key = "logs/2022/10/16/server-" + std::to_string(i) + ".log";
+    if (i % 100 == 99) {
+      xml += "<Error><Key>" + key +
+             "</Key><Code>AccessDenied</Code><Message>Access Denied.</Message>"
+             "</Error>";
+    } else {
+      xml += "<Deleted><Key>" + key + "</Key></Deleted>";
+    }
+  }
+  xml += "</DeleteResult>";
+  return xml;
+}
+
+const char* kErrorXml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<Error><Code>NoSuchKey</Code><Message>The specified key does not exist."
+    "</Message><Key>logs/2022/10/16/server-1.log</Key>"
+    "<BucketName>my-bucket</BucketName><Resource>/my-bucket/logs/2022/10/16/"
+    "server-1.log</Resource><RequestId>171E4D4F21A9E5C5</RequestId>"
+    "<HostId>dd9025bab4ad464b049177c95eb6ebf374d3b3fd1af9251148b658df7ac2e3e8"
+    "</HostId></Error>";
+
+const char* kCompleteMultipartUploadXml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<CompleteMultipartUploadResult "
+    "xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+    "<Location>http://play.min.io/my-bucket/logs/2022/10/16/server-1.log"
+    "</Location><Bucket>my-bucket</Bucket>"
+    "<Key>logs/2022/10/16/server-1.log</Key>"
+    "<ETag>&quot;3858f62230ac3c915f300c664312c11f-9&quot;</ETag>"
+    "</CompleteMultipartUploadResult>";
+
+const char* kNotificationXml =
+    "<NotificationConfiguration>"
+    "<QueueConfiguration><Id>1</Id><Queue>arn:minio:sqs::miniojavatest:webhook"
+    "</Queue><Event>s3:ObjectCreated:*</Event><Event>s3:ObjectRemoved:*"
+    "</Event><Filter><S3Key><FilterRule><Name>prefix</Name><Value>images/"
+    "</Value></FilterRule><FilterRule><Name>suffix</Name><Value>.jpg</Value>"
+    "</FilterRule></S3Key></Filter></QueueConfiguration>"
+    "<TopicConfiguration><Id>2</Id><Topic>arn:minio:sns::miniojavatest:kafka"
+    "</Topic><Event>s3:ObjectAccessed:Get</Event></TopicConfiguration>"
+    "</NotificationConfiguration>";
+
+const char* kEncryptionXml =
+    "<ServerSideEncryptionConfiguration><Rule>"
+    "<ApplyServerSideEncryptionByDefault><SSEAlgorithm>aws:kms</SSEAlgorithm>"
+    "<KMSMasterKeyID>my-minio-key</KMSMasterKeyID>"
+    "</ApplyServerSideEncryptionByDefault></Rule>"
+    "</ServerSideEncryptionConfiguration>";
+
+const char* kVersioningXml =
+    "<VersioningConfiguration><Status>Enabled</Status>"
+    "<MFADelete>Disabled</MFADelete></VersioningConfiguration>";
+
+const char* kReplicationXml =
+    "<ReplicationConfiguration><Role>REPLACE-WITH-ACTUAL-ROLE</Role><Rule>"
+    "<ID>rule1</ID><Status>Enabled</Status><Priority>1</Priority>"
+    "<DeleteMarkerReplication><Status>Disabled</Status>"
+    "</DeleteMarkerReplication><Filter><And><Prefix>TaxDocs</Prefix><Tag>"
+    "<Key>key1</Key><Value>value1</Value></Tag><Tag><Key>key2</Key>"
+    "<Value>value2</Value></Tag></And></Filter><Destination>"
+    "<Bucket>arn:aws:s3:::REPLACE-WITH-ACTUAL-DESTINATION-BUCKET-ARN</Bucket>"
+    "<ReplicationTime><Time><Minutes>15</Minutes></Time>"
+    "<Status>Enabled</Status></ReplicationTime></Destination></Rule>"
+    "</ReplicationConfiguration>";
+
+const char* kLifecycleXml =
+    "<LifecycleConfiguration><Rule><ID>rule1</ID><Status>Enabled</Status>"
+    "<Filter><Prefix>logs/</Prefix></Filter><Expiration><Days>365</Days>"
+    "</Expiration><Transition><Days>30</Days><StorageClass>GLACIER"
+    "</StorageClass></Transition></Rule><Rule><ID>rule2</ID>"
+    "<Status>Enabled</Status><Filter><And><Prefix>tmp/</Prefix><Tag><Key>k"
+    "</Key><Value>v</Value></Tag></And></Filter>"
+    "<NoncurrentVersionExpiration><NoncurrentDays>7</NoncurrentDays>"
+    "</NoncurrentVersionExpiration></Rule></LifecycleConfiguration>";
+
+const char* kTaggingXml =
+    "<Tagging><TagSet><Tag><Key>project</Key><Value>minio-cpp</Value></Tag>"
+    "<Tag><Key>team</Key><Value>sdk</Value></Tag><Tag><Key>env</Key>"
+    "<Value>prod</Value></Tag></TagSet></Tagging>";
+
+const char* kObjectLockXml =
+    "<ObjectLockConfiguration><ObjectLockEnabled>Enabled</ObjectLockEnabled>"
+    "<Rule><DefaultRetention><Mode>GOVERNANCE</Mode><Days>30</Days>"
+    "</DefaultRetention></Rule></ObjectLockConfiguration>";
+
+const char* kRetentionXml =
+    "<Retention><Mode>COMPLIANCE</Mode>"
+    "<RetainUntilDate>2030-10-16T12:34:56.789Z</RetainUntilDate></Retention>";
+
+const char* kAssumeRoleXml =
+    "<AssumeRoleResponse xmlns=\"https://sts.amazonaws.com/doc/2011-06-15/\">"
+    "<AssumeRoleResult><AssumedRoleUser><Arn></Arn><AssumeRoleId>"
+    "</AssumeRoleId></AssumedRoleUser><Credentials><AccessKeyId>"
+    "Y4RJU1RNFGK48LGO9I2S</AccessKeyId><SecretAccessKey>"
+    "sYLRKS1Z7hSjluf6gEbb9066hnx315wHTiACPAjg</SecretAccessKey><Expiration>"
+    "2030-10-16T12:34:56Z</Expiration><SessionToken>eyJhbGciOiJIUzUxMiIsInR5"
+    "cCI6IkpXVCJ9.eyJhY2Nlc3NLZXkiOiJZNFJKVTFSTkZHSzQ4TEdPOUkyUyJ9</Session"
+    "Token></Credentials></AssumeRoleResult><ResponseMetadata><RequestId>"
+    "171E4D4F21A9E5C5</RequestId></ResponseMetadata></AssumeRoleResponse>";
+
+// BigEndian appends value of given bytes to data in network order.
+void BigEndian(std::string& data, unsigned long value, int bytes) {
+  for (int i = bytes - 1; i >= 0; i--) data += char((value >> (8 * i)) & 0xff);
+}
+
+// SelectMessage returns an event stream message as sent by SelectObjectContent.
+std::string SelectMessage(std::map<std::string, std::string> headers,
+                          std::string_view payload) {
+  std::string header_data;
+  for (auto& [name, value] : headers) {
+    header_data += char(name.size());
+    header_data += name;
+    header_data += char(7);
+    BigEndian(header_data, value.size(), 2);
+    header_data += value;
+  }
+
+  std::string message;
+  BigEndian(message, 16 + header_data.size() + payload.size(), 4);
+  BigEndian(message, header_data.size(), 4);
+  BigEndian(message, minio::utils::CRC32(message), 4);
+  message += header_data;
+  message += payload;
+  BigEndian(message, minio::utils::CRC32(message), 4);
+  return message;
+}
+
+// SelectStream returns records events of given total size and an end event.
+std::string SelectStream(size_t size, size_t record_size) {
+  std::map<std::string, std::string> records = {
+      {":message-type", "event"},
+      {":event-type", "Records"},
+      {":content-type", "application/octet-stream"}};
+  std::string stream;
+  std::string payload(record_size, 'r');
+  for (size_t i = 0; i < size; i += record_size) {
+    stream += SelectMessage(records, payload);
+  }
+  stream += SelectMessage({{":message-type", "event"}, {":event-type", "End"}},
+                          "");
+  return stream;
+}
+
+const char* kNotificationRecord = R"({
+  "eventVersion": "2.0",
+  "eventSource": "minio:s3",
+  "awsRegion": "",
+  "eventTime": "2022-10-16T12:34:56.789Z",
+  "eventName": "s3:ObjectCreated:Put",
+  "userIdentity": {"principalId": "minio"},
+  "requestParameters": {
+    "principalId": "minio",
+    "region": "",
+    "sourceIPAddress": "127.0.0.1"
+  },
+  "responseElements": {
+    "content-length": "0",
+    "x-amz-request-id": "171E4D4F21A9E5C5",
+    "x-minio-deployment-id": "d0a0f1c6-0b3e-4d0b-9e5f-1d2c3b4a5f6e",
+    "x-minio-origin-endpoint": "http://127.0.0.1:9000"
+  },
+  "s3": {
+    "s3SchemaVersion": "1.0",
+    "configurationId": "Config",
+    "bucket": {
+      "name": "my-bucket",
+      "ownerIdentity": {"principalId": "minio"},
+      "arn": "arn:aws:s3:::my-bucket"
+    },
+    "object": {
+      "key": "logs/2022/10/16/server-1.log",
+      "size": 1024,
+      "eTag": "9b2cf535f27731c974343645a3985328",
+      "contentType": "text/plain",
+      "userMetadata": {"content-type": "text/plain"},
+      "sequencer": "171E4D4F21B5E7A2"
+    }
+  },
+  "source": {
+    "host": "127.0.0.1",
+    "port": "",
+    "userAgent": "MinIO (linux; amd64) minio-cpp/0.1.0"
+  }
+})";
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string filter;
+  std::chrono::duration<double> min_time(0.5);
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg = argv[i];
+    if (minio::utils::StartsWith(arg, "--filter=")) {
+      filter = arg.substr(9);
+    } else if (minio::utils::StartsWith(arg, "--min-time=")) {
+      min_time = std::chrono::duration<double>(std::stod(argv[i] + 11));
+    } else {
+      std::cerr << "usage: " << argv[0]
+                << " [--filter=SUBSTRING] [--min-time=SECONDS]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::string access_key = "Q3AM3UQ867SPQQA43P2F";
+  std::string secret_key = "zuf+tfteSlswRu7BJ86wekitnifILbZam1KYY3TG";
+  std::string region = "us-east-1";
+  std::string host = "play.min.io";
+  std::string uri = "/my-bucket/logs/2022/10/16/server-1.log";
+  minio::utils::Time date = minio::utils::Time::Now();
+  std::string content_sha256 = minio::utils::Sha256Hash("");
+
+  minio::utils::Multimap headers;
+  headers.Add("Host", host);
+  headers.Add("Content-Type", "application/octet-stream");
+  headers.Add("Content-Length", "1024");
+  headers.Add("x-amz-content-sha256", content_sha256);
+  headers.Add("x-amz-date", date.ToAmzDate());
+  headers.Add("x-amz-meta-project", "minio-cpp");
+  headers.Add("User-Agent", "MinIO (linux; amd64) minio-cpp/0.1.0");
+
+  minio::utils::Multimap query_params;
+  query_params.Add("partNumber", "3");
+  query_params.Add("uploadId", "9b2cf535-f277-31c9-7434-3645a3985328");
+  query_params.Add("versionId", "null");
+
+  std::string url_string =
+      "https://play.min.io:9000/my-bucket/logs/2022/10/16/server-1.log"
+      "?partNumber=3&uploadId=9b2cf535";
+  minio::http::Url url = minio::http::Url::Parse(url_string);
+  minio::s3::BaseUrl base_url("s3.amazonaws.com");
+
+  std::string path = "/my bucket//logs/2022/10/16/server 1+2=3.log";
+  std::string kib(1024, 'x');
+  std::string mib(1024 * 1024, 'x');
+  std::string list_xml = ListObjectsV2Xml(1000);
+  std::string versions_xml = ListObjectVersionsXml(1000);
+  std::string buckets_xml = ListBucketsXml(100);
+  std::string delete_xml = DeleteResultXml(1000);
+  std::string select_stream = SelectStream(1024 * 1024, 1024);
+  nlohmann::json notification = nlohmann::json::parse(kNotificationRecord);
+  minio::utils::Arena arena;
+  std::list<std::string> keys;
+  for (int i = 0; i < 1000; i++) {
+    keys.push_back("logs/2022/10/16/server-" + std::to_string(i) + ".log");
+  }
+
+  std::list<Benchmark> benchmarks = {
+      {"SignV4S3", 0,
+       [&]() -> size_t {
+         minio::utils::Multimap h(headers);
+         minio::signer::SignV4S3(minio::http::Method::kPut, uri, region, h,
+                                 query_params, access_key, secret_key,
+                                 content_sha256, date);
+         return h.GetFront("Authorization").size();
+       }},
+      {"SignV4S3/Arena", 0,
+       [&]() -> size_t {
+         minio::utils::Multimap h(headers);
+         minio::signer::SignV4S3(minio::http::Method::kPut, uri, region, h,
+                                 query_params, access_key, secret_key,
+                                 content_sha256, date, arena.Resource());
+         arena.Release();
+         return h.GetFront("Authorization").size();
+       }},
+      {"PresignV4", 0,
+       [&]() -> size_t {
+         minio::utils::Multimap q(query_params);
+         minio::signer::PresignV4(minio::http::Method::kGet, host, uri, region,
+                                  q, access_key, secret_key, date, 3600);
+         return q.GetFront("X-Amz-Signature").size();
+       }},
+      {"Multimap/Add", 0,
+       [&]() -> size_t {
+         minio::utils::Multimap h;
+         h.Add("Host", host);
+         h.Add("Content-Type", "application/octet-stream");
+         h.Add("Content-Length", "1024");
+         h.Add("x-amz-content-sha256", content_sha256);
+         h.Add("x-amz-date", "20221016T123456Z");
+         h.Add("x-amz-meta-project", "minio-cpp");
+         h.Add("User-Agent", "MinIO (linux; amd64) minio-cpp/0.1.0");
+         return bool(h);
+       }},
+      {"Multimap/Get", 0,
+       [&]() -> size_t {
+         return headers.GetFront("x-amz-content-sha256").size() +
+                headers.Contains("Range") + headers.Get("host").size();
+       }},
+      {"Multimap/GetCanonicalHeaders", 0,
+       [&]() -> size_t {
+         std::string signed_headers;
+         std::string canonical_headers;
+         headers.GetCanonicalHeaders(signed_headers, canonical_headers);
+         return signed_headers.size() + canonical_headers.size();
+       }},
+      {"Multimap/GetCanonicalQueryString", 0,
+       [&]() -> size_t {
+         return query_params.GetCanonicalQueryString().size();
+       }},
+      {"Url/Parse", url_string.size(),
+       [&]() -> size_t {
+         return minio::http::Url::Parse(url_string).path.size();
+       }},
+      {"Url/String", 0, [&]() -> size_t { return url.String().size(); }},
+      {"BaseUrl/BuildUrl", 0,
+       [&]() -> size_t {
+         minio::http::Url u;
+         base_url.BuildUrl(u, minio::http::Method::kGet, region, query_params,
+                           "my-bucket", "logs/2022/10/16/server-1.log");
+         return u.path.size();
+       }},
+      {"EncodePath", path.size(),
+       [&]() -> size_t { return minio::utils::EncodePath(path).size(); }},
+      {"Sha256Hash/1KiB", kib.size(),
+       [&]() -> size_t { return minio::utils::Sha256Hash(kib).size(); }},
+      {"Sha256Hash/1MiB", mib.size(),
+       [&]() -> size_t { return minio::utils::Sha256Hash(mib).size(); }},
+      {"Md5sumHash/1KiB", kib.size(),
+       [&]() -> size_t { return minio::utils::Md5sumHash(kib).size(); }},
+      {"Md5sumHash/1MiB", mib.size(),
+       [&]() -> size_t { return minio::utils::Md5sumHash(mib).size(); }},
+      {"ListObjectsResponse/ParseXML/1000", list_xml.size(),
+       [&]() -> size_t {
+         return minio::s3::ListObjectsResponse::ParseXML(list_xml, false)
+             .contents.size();
+       }},
+      {"ListObjectsResponse/ParseXML/Versions/1000", versions_xml.size(),
+       [&]() -> size_t {
+         return minio::s3::ListObjectsResponse::ParseXML(versions_xml, true)
+             .contents.size();
+       }},
+      {"ListBucketsResponse/ParseXML/100", buckets_xml.size(),
+       [&]() -> size_t {
+         return minio::s3::ListBucketsResponse::ParseXML(buckets_xml)
+             .buckets.size();
+       }},
+      {"RemoveObjectsResponse/ParseXML/1000", delete_xml.size(),
+       [&]() -> size_t {
+         auto resp = minio::s3::RemoveObjectsResponse::ParseXML(delete_xml);
+         return resp.objects.size() + resp.errors.size();
+       }},
+      {"Response/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::Response::ParseXML(kErrorXml, 404,
+                                              minio::utils::Multimap())
+             .code.size();
+       }},
+      {"CompleteMultipartUploadResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::CompleteMultipartUploadResponse::ParseXML(
+                    kCompleteMultipartUploadXml, "")
+             .etag.size();
+       }},
+      {"GetBucketNotificationResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::GetBucketNotificationResponse::ParseXML(
+                    kNotificationXml)
+             .config.queue_config_list.size();
+       }},
+      {"GetBucketEncryptionResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::GetBucketEncryptionResponse::ParseXML(
+                    kEncryptionXml)
+             .config.sse_algorithm.size();
+       }},
+      {"GetBucketVersioningResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::GetBucketVersioningResponse::ParseXML(
+                    kVersioningXml)
+             .Status()
+             .size();
+       }},
+      {"GetBucketReplicationResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::GetBucketReplicationResponse::ParseXML(
+                    kReplicationXml)
+             .config.rules.size();
+       }},
+      {"GetBucketLifecycleResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::GetBucketLifecycleResponse::ParseXML(kLifecycleXml)
+             .config.rules.size();
+       }},
+      {"GetBucketTagsResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::GetBucketTagsResponse::ParseXML(kTaggingXml)
+             .tags.size();
+       }},
+      {"GetObjectTagsResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::GetObjectTagsResponse::ParseXML(kTaggingXml)
+             .tags.size();
+       }},
+      {"GetObjectLockConfigResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::GetObjectLockConfigResponse::ParseXML(
+                    kObjectLockXml)
+             .config.retention_duration_days.Get();
+       }},
+      {"GetObjectRetentionResponse/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::s3::GetObjectRetentionResponse::ParseXML(kRetentionXml)
+             .retain_until_date.ToISO8601UTC()
+             .size();
+       }},
+      {"Credentials/ParseXML", 0,
+       [&]() -> size_t {
+         return minio::creds::Credentials::ParseXML(kAssumeRoleXml,
+                                                    "AssumeRoleResult")
+             .access_key.size();
+       }},
+      {"xml::Writer/Delete/1000", 0,
+       [&]() -> size_t {
+         minio::xml::Writer writer(64 + keys.size() * 64);
+         writer.Start("Delete").Element("Quiet", "true");
+         for (auto& key : keys) {
+           writer.Start("Object").Element("Key", key).End("Object");
+         }
+         writer.End("Delete");
+         return writer.Finish().data.size();
+       }},
+      {"SelectHandler/Records/1MiB", select_stream.size(),
+       [&]() -> size_t {
+         size_t records = 0;
+         minio::s3::SelectHandler handler(
+             [&records](minio::s3::SelectResult result) -> bool {
+               records += result.records.size();
+               return true;
+             });
+         // Feed the stream in 16KiB chunks as libcurl does.
+         std::string_view stream = select_stream;
+         for (size_t i = 0; i < stream.size(); i += 16 * 1024) {
+           minio::http::DataFunctionArgs args;
+           args.datachunk = stream.substr(i, 16 * 1024);
+           if (!handler.DataFunction(args)) break;
+         }
+         return records;
+       }},
+      {"NotificationRecord/ParseJSON", 0,
+       [&]() -> size_t {
+         return minio::s3::NotificationRecord::ParseJSON(notification)
+             .s3.object.key.size();
+       }},
+  };
+
+  nlohmann::json results = nlohmann::json::array();
+  for (auto& bm : benchmarks) {
+    if (!filter.empty() && bm.name.find(filter) == std::string::npos) continue;
+    results.push_back(Run(bm, min_time));
+    std::cerr << bm.name << " done" << std::endl;
+  }
+
+  nlohmann::json output;
+  output["benchmarks"] = results;
+  std::cout << output.dump(2) << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// minio-mock-s3 runs the mock S3 server of benchmarks until interrupted, so
+// examples, tests and benchmarks can be pointed to it with SERVER_ENDPOINT.
+//
+// Usage: minio-mock-s3 [--address=ADDRESS] [--port=PORT] [--data-dir=DIR]
+//                      [--latency-ms=MS] [--bandwidth=BYTES_PER_SECOND]
+//                      [--error-rate=RATE] [--drop-rate=RATE]
+
+#include <signal.h>
+
+#include <iostream>
+
+#include "mockserver.h"
+
+int main(int argc, char* argv[]) {
+  minio::mock::ServerConfig config;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    size_t pos = arg.find('=');
+    std::string name = arg.substr(0, pos);
+    std::string value = pos == std::string::npos ? "" : arg.substr(pos + 1);
+    if (name == "--address") {
+      config.address = value;
+    } else if (name == "--port") {
+      config.port = std::stoul(value);
+    } else if (name == "--data-dir") {
+      config.data_dir = value;
+    } else if (name == "--latency-ms") {
+      config.latency = std::chrono::milliseconds(std::stoul(value));
+    } else if (name == "--bandwidth") {
+      config.bandwidth = std::stoul(value);
+    } else if (name == "--error-rate") {
+      config.error_rate = std::stod(value);
+    } else if (name == "--drop-rate") {
+      config.drop_rate = std::stod(value);
+    } else {
+      std::cerr << "unknown argument " << arg << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Block termination signals before threads start so that only sigwait()
+  // below receives them.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+  minio::mock::Server server(config);
+  if (minio::error::Error err = server.Start()) {
+    std::cerr << "unable to start server; " << err.String() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "SERVER_ENDPOINT=" << server.Endpoint() << std::endl;
+
+  int signal = 0;
+  sigwait(&signals, &signal);
+  server.Stop();
+
+  minio::mock::ServerStats stats = server.Stats();
+  std::cout << "connections: " << stats.connections
+            << ", requests: " << stats.requests
+            << ", injected errors: " << stats.injected_errors
+            << ", dropped: " << stats.dropped
+            << ", received: " << stats.bytes_received
+            << ", sent: " << stats.bytes_sent << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// pagecache writes and reads back a large file through the same file I/O
+// path used by UploadObject and DownloadObject, once per cache mode, and
+// reports page cache growth observed during each transfer.
+//
+// Usage: pagecache [SIZE_GIB] [FILENAME] [sync|threaded|io_uring]
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "fileio.h"
+
+// cachedBytes returns "Cached" value of /proc/meminfo in bytes.
+long cachedBytes() {
+  std::ifstream meminfo("/proc/meminfo");
+  std::string key;
+  long value;
+  std::string unit;
+  while (meminfo >> key >> value) {
+    std::getline(meminfo, unit);
+    if (key == "Cached:") return value * 1024;
+  }
+  return 0;
+}
+
+/**
+ * Sampler tracks peak page cache growth in a background thread.
+ */
+class Sampler {
+ private:
+  long start_;
+  std::atomic<long> peak_;
+  std::atomic<bool> stop_ = false;
+  std::thread thread_;
+
+ public:
+  Sampler() : start_(cachedBytes()), peak_(start_) {
+    thread_ = std::thread([this] {
+      while (!stop_) {
+        long cached = cachedBytes();
+        if (cached > peak_) peak_ = cached;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+    });
+  }
+
+  // Stop returns peak growth in bytes.
+  long Stop() {
+    stop_ = true;
+    thread_.join();
+    long cached = cachedBytes();
+    if (cached > peak_) peak_ = cached;
+    return peak_ - start_;
+  }
+};  // class Sampler
+
+void report(const char* phase, minio::fileio::CacheMode cache_mode,
+            size_t size, std::chrono::duration<double> elapsed, long growth) {
+  std::cout << std::left << std::setw(8) << phase << std::setw(10)
+            << minio::fileio::CacheModeToString(cache_mode) << std::right
+            << std::fixed << std::setprecision(1) << std::setw(10)
+            << size / elapsed.count() / (1024 * 1024) << " MiB/s"
+            << std::setw(12) << growth / (1024.0 * 1024) << " MiB cached"
+            << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  size_t size = 100;
+  if (argc > 1) size = std::stoul(argv[1]);
+  size *= 1024 * 1024 * 1024UL;
+
+  std::string filename = "pagecache.bench";
+  if (argc > 2) filename = argv[2];
+
+  minio::fileio::Engine engine = minio::fileio::Engine::kSync;
+  if (argc > 3) {
+    std::string name = argv[3];
+    if (name == "threaded") engine = minio::fileio::Engine::kThreaded;
+    if (name == "io_uring") engine = minio::fileio::Engine::kIoUring;
+  }
+
+  std::string chunk(minio::fileio::kBufferSize, 0);
+  for (size_t i = 0; i < chunk.size(); i++) chunk[i] = (char)(i * 31 + 7);
+
+  std::cout << "engine: " << minio::fileio::EngineToString(engine)
+            << ", size: " << size / (1024 * 1024) << " MiB" << std::endl;
+
+  for (auto cache_mode :
+       {minio::fileio::CacheMode::kDefault, minio::fileio::CacheMode::kDontNeed,
+        minio::fileio::CacheMode::kDirect}) {
+    {
+      minio::fileio::Writer writer(engine, cache_mode);
+      if (minio::error::Error err = writer.Open(filename)) {
+        std::cerr << err.String() << std::endl;
+        return 1;
+      }
+
+      Sampler sampler;
+      auto start = std::chrono::steady_clock::now();
+      minio::error::Error err;
+      for (size_t written = 0; written < size && !err;
+           written += chunk.size()) {
+        err = writer.Write(std::string_view(chunk).substr(
+            0, std::min(chunk.size(), size - written)));
+      }
+      if (!err) err = writer.Close();
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      long growth = sampler.Stop();
+      if (err) {
+        std::cerr << err.String() << std::endl;
+        return 1;
+      }
+      report("write", writer.GetCacheMode(), size, elapsed, growth);
+    }
+
+    // Drop what the write phase left behind so reads start cold.
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+
+    {
+      minio::fileio::Reader reader(engine, cache_mode);
+      if (minio::error::Error err = reader.Open(filename)) {
+        std::cerr << err.String() << std::endl;
+        return 1;
+      }
+
+      Sampler sampler;
+      auto start = std::chrono::steady_clock::now();
+      std::istream stream(&reader);
+      size_t read = 0;
+      while (stream.read(&chunk[0], chunk.size()) || stream.gcount() > 0) {
+        read += stream.gcount();
+      }
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      long growth = sampler.Stop();
+      if (minio::error::Error err = reader.Error()) {
+        std::cerr << err.String() << std::endl;
+        return 1;
+      }
+      report("read", reader.GetCacheMode(), read, elapsed, growth);
+    }
+
+    std::filesystem::remove(filename);
+  }
+
+  return 0;
+}
@@ -0,0 +1,400 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// minio-replay sends requests of a trace written by TraceRecorder again, at
+// the recorded times or faster, and compares latencies per API with the
+// trace. Objects are named by their key hash under "replay/" and uploaded
+// with the recorded sizes; objects read before being written in the trace
+// are uploaded first. Only first attempts are replayed, as the client makes
+// its own retries.
+//
+// Usage: minio-replay TRACE [--endpoint=HOST[:PORT]] [--https]
+//                     [--access-key=KEY] [--secret-key=KEY] [--bucket=NAME]
+//                     [--speed=FACTOR] [--workers=COUNT]
+//
+// Server is taken from SERVER_ENDPOINT, ACCESS_KEY, SECRET_KEY and
+// ENABLE_HTTPS environment variables unless given. Without a server, an
+// in-process mock server is used. --bucket sends requests of all buckets to
+// one bucket.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "client.h"
+#include "mockserver.h"
+
+namespace {
+struct ApiStats {
+  std::atomic<unsigned long> ops = 0;
+  std::atomic<unsigned long> errors = 0;
+  std::atomic<unsigned long> skipped = 0;
+  minio::s3::Histogram latency;        // Microseconds.
+  minio::s3::Histogram trace_latency;  // Microseconds.
+};  // struct ApiStats
+
+// PatternBuffer is a stream of size bytes repeating block.
+class PatternBuffer : public std::streambuf {
+ private:
+  std::string& block_;
+  size_t remaining_;
+
+ public:
+  PatternBuffer(std::string& block, size_t size)
+      : block_(block), remaining_(size) {}
+
+  int_type underflow() override {
+    if (remaining_ == 0) return traits_type::eof();
+    size_t size = std::min(remaining_, block_.size());
+    setg(block_.data(), block_.data(), block_.data() + size);
+    remaining_ -= size;
+    return traits_type::to_int_type(*gptr());
+  }
+};  // class PatternBuffer
+
+class Replay {
+ private:
+  minio::s3::Client& client_;
+  std::string bucket_;
+  std::string block_;
+
+ public:
+  Replay(minio::s3::Client& client, std::string bucket)
+      : client_(client), bucket_(bucket), block_(1024 * 1024, '\0') {
+    std::mt19937_64 rg(1);
+    for (auto& ch : block_) ch = char(rg());
+  }
+
+  std::string Bucket(const minio::s3::TraceRecord& record) {
+    return bucket_.empty() ? record.bucket : bucket_;
+  }
+
+  static std::string Key(uint64_t hash) {
+    std::stringstream ss;
+    ss << "replay/" << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return ss.str();
+  }
+
+  bool Put(std::string bucket, std::string object, size_t size) {
+    PatternBuffer buf(block_, size);
+    std::istream stream(&buf);
+    // Each recorded PutObject or UploadPart is one PUT request.
+    minio::s3::PutObjectArgs args(stream, size, minio::utils::kMaxPartSize);
+    args.bucket = bucket;
+    args.object = object;
+    return bool(client_.PutObject(args));
+  }
+
+  // Send sends request of record. It returns false if the API is not
+  // replayed.
+  bool Send(const minio::s3::TraceRecord& record, bool& ok) {
+    std::string bucket = Bucket(record);
+    std::string object = Key(record.key_hash);
+    if (record.api == "PutObject" || record.api == "UploadPart") {
+      ok = Put(bucket, object, record.request_bytes);
+    } else if (record.api == "GetObject") {
+      minio::s3::GetObjectArgs args;
+      args.bucket = bucket;
+      args.object = object;
+      args.datafunc = [](minio::http::DataFunctionArgs) -> bool {
+        return true;
+      };
+      ok = bool(client_.GetObject(args));
+    } else if (record.api == "StatObject") {
+      minio::s3::StatObjectArgs args;
+      args.bucket = bucket;
+      args.object = object;
+      ok = bool(client_.StatObject(args));
+    } else if (record.api == "RemoveObject") {
+      minio::s3::RemoveObjectArgs args;
+      args.bucket = bucket;
+      args.object = object;
+      ok = bool(client_.RemoveObject(args));
+    } else if (record.api == "ListObjectsV1" ||
+               record.api == "ListObjectsV2") {
+      minio::s3::ListObjectsV2Args args;
+      args.bucket = bucket;
+      args.prefix = "replay/";
+      ok = bool(client_.ListObjectsV2(args));
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // Cleanup removes objects of all keys of the trace.
+  void Cleanup(std::map<std::string, std::set<uint64_t>>& keys) {
+    for (auto& [bucket, hashes] : keys) {
+      auto it = hashes.begin();
+      minio::s3::RemoveObjectsArgs args;
+      args.bucket = bucket;
+      args.func = [&](minio::s3::DeleteObject& obj) -> bool {
+        if (it == hashes.end()) return false;
+        obj.name = Key(*it++);
+        return true;
+      };
+      minio::s3::RemoveObjectsResult result = client_.RemoveObjects(args);
+      for (; result; result++) {
+        minio::s3::DeleteError err = *result;
+        if (!err) {
+          std::cerr << "unable to remove objects; " << err.Error().String()
+                    << std::endl;
+          break;
+        }
+      }
+    }
+  }
+};  // class Replay
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " TRACE [--endpoint=HOST[:PORT]] [--https] "
+                 "[--access-key=KEY] [--secret-key=KEY] [--bucket=NAME] "
+                 "[--speed=FACTOR] [--workers=COUNT]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::string endpoint;
+  std::string access_key = "minioadmin";
+  std::string secret_key = "minioadmin";
+  std::string value;
+  bool https = false;
+  std::string bucket;
+  double speed = 1;
+  unsigned int workers = 256;
+  minio::utils::GetEnv(endpoint, "SERVER_ENDPOINT");
+  minio::utils::GetEnv(access_key, "ACCESS_KEY");
+  minio::utils::GetEnv(secret_key, "SECRET_KEY");
+  if (minio::utils::GetEnv(value, "ENABLE_HTTPS")) https = true;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    size_t pos = arg.find('=');
+    std::string name = arg.substr(0, pos);
+    value = pos == std::string::npos ? "" : arg.substr(pos + 1);
+    if (name == "--endpoint") {
+      endpoint = value;
+    } else if (name == "--https") {
+      https = true;
+    } else if (name == "--access-key") {
+      access_key = value;
+    } else if (name == "--secret-key") {
+      secret_key = value;
+    } else if (name == "--bucket") {
+      bucket = value;
+    } else if (name == "--speed") {
+      speed = std::stod(value);
+    } else if (name == "--workers") {
+      workers = std::stoul(value);
+    } else {
+      std::cerr << "unknown argument " << arg << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (speed <= 0 || workers == 0) {
+    std::cerr << "speed and workers must be positive" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<minio::s3::TraceRecord> records;
+  {
+    minio::s3::TraceReader reader;
+    if (minio::error::Error err = reader.Open(argv[1])) {
+      std::cerr << err.String() << std::endl;
+      return EXIT_FAILURE;
+    }
+    minio::s3::TraceRecord record;
+    while (reader.Next(record)) {
+      if (record.attempt == 1) records.push_back(record);
+    }
+  }
+  if (records.empty()) {
+    std::cerr << "no records in trace" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const auto& a, const auto& b) -> bool {
+                     return a.start < b.start;
+                   });
+
+  minio::mock::Server mock;
+  if (endpoint.empty()) {
+    if (minio::error::Error err = mock.Start()) {
+      std::cerr << "unable to start mock server; " << err.String()
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    endpoint = mock.Endpoint();
+    https = false;
+  }
+
+  minio::s3::BaseUrl base_url(endpoint, https);
+  minio::creds::StaticProvider provider(access_key, secret_key);
+  minio::s3::Client client(base_url, &provider);
+  Replay replay(client, bucket);
+
+  // Find buckets, keys and objects to upload before replay.
+  std::map<std::string, ApiStats> stats;
+  std::map<std::string, std::set<uint64_t>> keys;
+  std::map<std::pair<std::string, uint64_t>, size_t> preloads;
+  std::set<std::pair<std::string, uint64_t>> written;
+  for (auto& record : records) {
+    stats[record.api];
+    std::string name = replay.Bucket(record);
+    if (name.empty()) continue;
+    keys[name];
+    if (record.key_hash == 0) continue;
+
+    keys[name].insert(record.key_hash);
+    auto key = std::make_pair(name, record.key_hash);
+    if (record.api == "PutObject" || record.api == "UploadPart") {
+      written.insert(key);
+    } else if ((record.api == "GetObject" || record.api == "StatObject") &&
+               !written.count(key)) {
+      size_t& size = preloads[key];
+      size = std::max(size, record.response_bytes);
+    }
+  }
+
+  std::list<std::string> created;
+  for (auto& [name, hashes] : keys) {
+    minio::s3::MakeBucketArgs args;
+    args.bucket = name;
+    minio::s3::MakeBucketResponse resp = client.MakeBucket(args);
+    if (resp) {
+      created.push_back(name);
+    } else if (resp.code != "BucketAlreadyOwnedByYou") {
+      std::cerr << "MakeBucket(): " << resp.Error().String() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  for (auto& [key, size] : preloads) {
+    if (!replay.Put(key.first, Replay::Key(key.second), size)) {
+      std::cerr << "unable to upload " << Replay::Key(key.second)
+                << std::endl;
+    }
+  }
+
+  // Requests are queued at their recorded times scaled by speed. Lag is how
+  // late workers pick them up; it grows when workers are too few.
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<std::pair<const minio::s3::TraceRecord*,
+                       std::chrono::steady_clock::time_point>>
+      queue;
+  bool done = false;
+  minio::s3::Histogram lag;
+
+  std::list<std::thread> threads;
+  for (unsigned int i = 0; i < workers; i++) {
+    threads.emplace_back([&]() {
+      while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&]() { return done || !queue.empty(); });
+        if (queue.empty()) return;
+        auto [record, scheduled] = queue.front();
+        queue.pop_front();
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        lag.Record(std::chrono::duration_cast<std::chrono::microseconds>(
+                       start - scheduled)
+                       .count());
+        ApiStats& api = stats.at(record->api);
+        bool ok = false;
+        if (!replay.Send(*record, ok)) {
+          api.skipped++;
+          continue;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+        api.ops++;
+        if (!ok) api.errors++;
+        api.latency.Record(elapsed.count());
+        api.trace_latency.Record(record->duration.count());
+      }
+    });
+  }
+
+  auto replay_start = std::chrono::steady_clock::now();
+  for (auto& record : records) {
+    auto offset = std::chrono::duration_cast<std::chrono::microseconds>(
+        (record.start - records.front().start) / speed);
+    auto scheduled = replay_start + offset;
+    std::this_thread::sleep_until(scheduled);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back({&record, scheduled});
+    }
+    cond.notify_one();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  cond.notify_all();
+  for (auto& thread : threads) thread.join();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - replay_start;
+
+  std::cout << "replayed " << records.size() << " requests in "
+            << elapsed.count() << "s; lag p50: "
+            << lag.Snapshot().Percentile(0.5) / 1000.0
+            << "ms, p99: " << lag.Snapshot().Percentile(0.99) / 1000.0
+            << "ms" << std::endl;
+  std::cout << std::left << std::setw(24) << "api" << std::right
+            << std::setw(10) << "ops" << std::setw(10) << "errors"
+            << std::setw(10) << "skipped" << std::setw(12) << "p50 ms"
+            << std::setw(12) << "trace p50" << std::setw(12) << "p99 ms"
+            << std::setw(12) << "trace p99" << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+  for (auto& [name, api] : stats) {
+    minio::s3::HistogramSnapshot latency = api.latency.Snapshot();
+    minio::s3::HistogramSnapshot trace_latency = api.trace_latency.Snapshot();
+    std::cout << std::left << std::setw(24) << name << std::right
+              << std::setw(10) << api.ops << std::setw(10) << api.errors
+              << std::setw(10) << api.skipped << std::setw(12)
+              << latency.Percentile(0.5) / 1000.0 << std::setw(12)
+              << trace_latency.Percentile(0.5) / 1000.0 << std::setw(12)
+              << latency.Percentile(0.99) / 1000.0 << std::setw(12)
+              << trace_latency.Percentile(0.99) / 1000.0 << std::endl;
+  }
+
+  replay.Cleanup(keys);
+  for (auto& name : created) {
+    minio::s3::RemoveBucketArgs args;
+    args.bucket = name;
+    minio::s3::RemoveBucketResponse resp = client.RemoveBucket(args);
+    if (!resp) {
+      std::cerr << "RemoveBucket(): " << resp.Error().String() << std::endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// stress shares one Client between many threads. Each thread repeatedly puts,
+// stats, gets and removes its own object, so every operation also goes
+// through the shared region cache and credential provider.
+//
+// Usage: stress [THREADS] [ITERATIONS]
+//
+// Server is taken from SERVER_ENDPOINT, ACCESS_KEY, SECRET_KEY and
+// ENABLE_HTTPS environment variables as in tests. Without SERVER_ENDPOINT, an
+// in-process mock server is used.
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <random>
+#include <thread>
+
+#include "client.h"
+#include "mockserver.h"
+
+std::string RandBucketName() {
+  static const std::string charset = "0123456789abcdefghijklmnopqrstuvwxyz";
+  std::mt19937 rg{std::random_device{}()};
+  std::uniform_int_distribution<std::string::size_type> pick(
+      0, charset.length() - 1);
+  std::string s;
+  for (int i = 0; i < 8; i++) s += charset[pick(rg)];
+  return "stress-" + s;
+}
+
+int main(int argc, char* argv[]) {
+  unsigned int threads = 64;
+  if (argc > 1) threads = std::stoul(argv[1]);
+  unsigned int iterations = 100;
+  if (argc > 2) iterations = std::stoul(argv[2]);
+
+  minio::mock::Server mock;
+  std::string host;
+  std::string access_key = "minioadmin";
+  std::string secret_key = "minioadmin";
+  std::string value;
+  bool secure = false;
+  if (!minio::utils::GetEnv(host, "SERVER_ENDPOINT")) {
+    if (minio::error::Error err = mock.Start()) {
+      std::cerr << "unable to start mock server; " << err.String()
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    host = mock.Endpoint();
+  } else {
+    if (!minio::utils::GetEnv(access_key, "ACCESS_KEY")) {
+      std::cerr << "ACCESS_KEY environment variable must be set" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if (!minio::utils::GetEnv(secret_key, "SECRET_KEY")) {
+      std::cerr << "SECRET_KEY environment variable must be set" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if (minio::utils::GetEnv(value, "ENABLE_HTTPS")) secure = true;
+  }
+
+  minio::s3::BaseUrl base_url(host, secure);
+  minio::creds::StaticProvider provider(access_key, secret_key);
+  minio::s3::Client client(base_url, &provider);
+
+  std::string bucket_name = RandBucketName();
+  {
+    minio::s3::MakeBucketArgs args;
+    args.bucket = bucket_name;
+    minio::s3::MakeBucketResponse resp = client.MakeBucket(args);
+    if (!resp) {
+      std::cerr << "MakeBucket(): " << resp.Error().String() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::atomic<unsigned long> ops = 0;
+  std::atomic<unsigned long> failures = 0;
+  std::string data(4096, 'x');
+
+  auto worker = [&](unsigned int id) {
+    std::string object_name = "object-" + std::to_string(id);
+    auto check = [&](bool ok, const char* api, minio::error::Error err) {
+      ops++;
+      if (ok) return;
+      if (failures++ < 10) {
+        std::cerr << api << ": " << err.String() << std::endl;
+      }
+    };
+
+    for (unsigned int i = 0; i < iterations; i++) {
+      {
+        std::stringstream ss(data);
+        minio::s3::PutObjectArgs args(ss, data.size(), 0);
+        args.bucket = bucket_name;
+        args.object = object_name;
+        minio::s3::PutObjectResponse resp = client.PutObject(args);
+        check(resp, "PutObject()", resp.Error());
+      }
+      {
+        minio::s3::StatObjectArgs args;
+        args.bucket = bucket_name;
+        args.object = object_name;
+        minio::s3::StatObjectResponse resp = client.StatObject(args);
+        check(resp && resp.size == data.size(), "StatObject()", resp.Error());
+      }
+      {
+        size_t size = 0;
+        minio::s3::GetObjectArgs args;
+        args.bucket = bucket_name;
+        args.object = object_name;
+        args.datafunc = [&size](minio::http::DataFunctionArgs args) -> bool {
+          size += args.datachunk.size();
+          return true;
+        };
+        minio::s3::GetObjectResponse resp = client.GetObject(args);
+        check(resp && size == data.size(), "GetObject()", resp.Error());
+      }
+      {
+        minio::s3::RemoveObjectArgs args;
+        args.bucket = bucket_name;
+        args.object = object_name;
+        minio::s3::RemoveObjectResponse resp = client.RemoveObject(args);
+        check(resp, "RemoveObject()", resp.Error());
+      }
+    }
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  std::list<std::thread> workers;
+  for (unsigned int i = 0; i < threads; i++) workers.emplace_back(worker, i);
+  for (auto& t : workers) t.join();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  {
+    minio::s3::RemoveBucketArgs args;
+    args.bucket = bucket_name;
+    minio::s3::RemoveBucketResponse resp = client.RemoveBucket(args);
+    if (!resp) {
+      std::cerr << "RemoveBucket(): " << resp.Error().String() << std::endl;
+    }
+  }
+
+  std::cout << "threads: " << threads << ", operations: " << ops
+            << ", failures: " << failures << ", elapsed: " << elapsed.count()
+            << "s, throughput: " << ops / elapsed.count() << " ops/s"
+            << std::endl;
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
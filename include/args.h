@@ -19,7 +19,9 @@
 #include <filesystem>
 #include <nlohmann/json.hpp>
 
+#include "fileio.h"
 #include "http.h"
+#include "limiter.h"
 #include "signer.h"
 #include "sse.h"
 #include "types.h"
@@ -29,6 +31,12 @@ namespace s3 {
 struct BaseArgs {
   utils::Multimap extra_headers;
   utils::Multimap extra_query_params;
+  std::string limit_tag;  // Rate limit tag; see BaseClient::SetTagRateLimit().
+  Priority priority = Priority::kNormal;  // See ConcurrencyLimiter.
+
+  // InheritLimits copies limit_tag and priority of args, which requests made
+  // on behalf of an operation carry.
+  void InheritLimits(const BaseArgs& args);
 };  // struct BaseArgs
 
 struct BucketArgs : public BaseArgs {
@@ -139,6 +147,8 @@ using RemoveObjectArgs = ObjectVersionArgs;
 struct DownloadObjectArgs : public ObjectReadArgs {
   std::string filename;
   bool overwrite;
+  fileio::Engine io_engine = fileio::Engine::kSync;
+  fileio::CacheMode cache_mode = fileio::CacheMode::kDefault;
 
   error::Error Validate();
 };  // struct DownloadObjectArgs
@@ -234,6 +244,8 @@ struct ComposeObjectArgs : public ObjectWriteArgs {
 
 struct UploadObjectArgs : public PutObjectBaseArgs {
   std::string filename;
+  fileio::Engine io_engine = fileio::Engine::kSync;
+  fileio::CacheMode cache_mode = fileio::CacheMode::kDefault;
 
   error::Error Validate();
 };  // struct PutObjectArgs
@@ -249,10 +261,33 @@ using DeleteObjectFunction = std::function<bool(DeleteObject &)>;
 struct RemoveObjectsArgs : public BucketArgs {
   bool bypass_governance_mode = false;
   DeleteObjectFunction func = NULL;
+  // Number of DeleteObjects requests of up to 1000 objects kept in flight.
+  // With more than one, batches are sent by worker threads calling func one
+  // at a time, and errors of batches come in the order they finish.
+  unsigned int concurrency = 1;
+  // Called after each batch, from the thread which sent it, one at a time.
+  // Progress older than already reported is not reported.
+  RemoveObjectsProgressFunction progressfunc = NULL;
 
   error::Error Validate();
 };  // struct RemoveObjectsArgs
 
+struct RemovePrefixArgs : public BucketArgs {
+  std::string prefix;
+  // Must be set to remove all objects of the bucket by an empty prefix.
+  bool all_objects = false;
+  // Removes every version and delete marker instead of adding delete markers
+  // to current objects of a versioned bucket.
+  bool include_versions = false;
+  bool bypass_governance_mode = false;
+  // As RemoveObjectsArgs::concurrency, but defaults to four, so that listing
+  // overlaps removal.
+  unsigned int concurrency = 4;
+  RemoveObjectsProgressFunction progressfunc = NULL;
+
+  error::Error Validate();
+};  // struct RemovePrefixArgs
+
 struct SelectObjectContentArgs : public ObjectReadArgs {
   SelectRequest &request;
   SelectResultFunction resultfunc = NULL;
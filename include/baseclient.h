@@ -16,11 +16,23 @@
 #ifndef _MINIO_S3_BASE_CLIENT_H
 #define _MINIO_S3_BASE_CLIENT_H
 
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "args.h"
 #include "config.h"
+#include "endpoints.h"
+#include "hedge.h"
+#include "limiter.h"
+#include "metrics.h"
+#include "regioncache.h"
+#include "retry.h"
 #include "request.h"
 #include "response.h"
 #include "select.h"
+#include "trace.h"
 
 namespace minio {
 namespace s3 {
@@ -31,12 +43,35 @@ utils::Multimap GetCommonListObjectsQueryParams(std::string& delimiter,
 
 /**
  * Base client to perform S3 APIs.
+ *
+ * A client may be shared by any number of threads once it is configured.
+ * Setters like Debug(), IgnoreCertCheck(), SetSslCertFile(), SetAppInfo(),
+ * SetConcurrencyLimit(), SetSpanSink(), SetTraceRecorder() and
+ * SetMemoryResource() must be called before the client is shared. Bucket
+ * regions are kept in a RegionCache which serves lookups without locking.
+ *
+ * A client built over an EndpointPool sends each request attempt to an
+ * endpoint picked by the pool, so a retry after a node failure goes to
+ * another node.
  */
 class BaseClient {
  protected:
   BaseUrl& base_url_;
+  EndpointPool* endpoints_ = NULL;
   creds::Provider* provider_ = NULL;
-  std::map<std::string, std::string> region_map_;
+  RegionCache region_cache_;
+  RetryPolicy retry_policy_;
+  RetryMetrics retry_metrics_;
+  RequestMetrics metrics_;
+  SpanSink* span_sink_ = NULL;
+  TraceRecorder* trace_recorder_ = NULL;
+  std::pmr::memory_resource* memory_resource_ = NULL;
+  Hedger hedger_;
+  http::Resolver resolver_;
+  std::vector<std::unique_ptr<ConcurrencyLimiter>> limiters_;
+  std::shared_ptr<http::RateLimiter> rate_limiter_;
+  http::RateLimiterMap bucket_rate_limiters_;
+  http::RateLimiterMap tag_rate_limiters_;
   bool debug_ = false;
   bool ignore_cert_check_ = false;
   std::string ssl_cert_file_;
@@ -44,26 +79,104 @@ class BaseClient {
 
  public:
   BaseClient(BaseUrl& base_url, creds::Provider* provider = NULL);
+  BaseClient(EndpointPool& endpoints, creds::Provider* provider = NULL);
 
   void Debug(bool flag) { debug_ = flag; }
 
-  void IgnoreCertCheck(bool flag) { ignore_cert_check_ = flag; }
+  void IgnoreCertCheck(bool flag) {
+    ignore_cert_check_ = flag;
+    if (endpoints_ != NULL) endpoints_->IgnoreCertCheck(flag);
+  }
 
   void SetSslCertFile(std::string ssl_cert_file) {
     ssl_cert_file_ = ssl_cert_file;
+    if (endpoints_ != NULL) endpoints_->SetSslCertFile(ssl_cert_file);
   }
 
   error::Error SetAppInfo(std::string_view app_name,
                           std::string_view app_version);
 
+  // SetRegionCacheTtl sets how long bucket regions and NoSuchBucket results
+  // are cached. Zero TTL caches regions forever; zero negative TTL disables
+  // caching of NoSuchBucket.
+  void SetRegionCacheTtl(std::chrono::seconds ttl,
+                         std::chrono::seconds negative_ttl =
+                             RegionCache::kDefaultNegativeTtl) {
+    region_cache_.SetTtl(ttl, negative_ttl);
+  }
+
+  void SetRetryPolicy(RetryPolicy policy) { retry_policy_ = policy; }
+
+  RetryMetrics& GetRetryMetrics() { return retry_metrics_; }
+
+  // GetRequestMetrics returns per API and bucket request metrics, read by
+  // RequestMetrics::Snapshot() or exported by RequestMetrics::Prometheus().
+  RequestMetrics& GetRequestMetrics() { return metrics_; }
+
+  // SetSpanSink sets sink receiving a Span of every request attempt. NULL
+  // disables tracing. The sink must outlive requests of the client.
+  void SetSpanSink(SpanSink* sink) { span_sink_ = sink; }
+
+  // SetTraceRecorder sets recorder writing every request attempt to a trace
+  // file, which minio-replay can send again. NULL disables recording.
+  void SetTraceRecorder(TraceRecorder* recorder) {
+    trace_recorder_ = recorder;
+  }
+
+  // SetMemoryResource sets upstream resource of the arena each request
+  // attempt builds its signing temporaries in. NULL uses the default
+  // resource. The resource must outlive requests of the client.
+  void SetMemoryResource(std::pmr::memory_resource* resource) {
+    memory_resource_ = resource;
+  }
+
+  void SetHedgePolicy(HedgePolicy policy) { hedger_.SetPolicy(policy); }
+
+  HedgeMetrics& GetHedgeMetrics() { return hedger_.Metrics(); }
+
+  // SetResolveInterval sets how often all addresses of endpoint hosts are
+  // resolved again. New connections are spread over those addresses; zero
+  // interval, the default, leaves name resolution to libcurl.
+  void SetResolveInterval(std::chrono::seconds interval) {
+    resolver_.SetInterval(interval);
+  }
+
+  // SetConcurrencyLimit limits requests in flight to each endpoint with an
+  // adaptive ConcurrencyLimiter. Requests waiting for a slot are served by
+  // the priority of their args. A fixed limit is set by equal min_limit and
+  // max_limit.
+  void SetConcurrencyLimit(LimiterPolicy policy);
+
+  // GetConcurrencyLimits returns current limiter state of each endpoint.
+  // Callers running parallel requests may size their workers by it.
+  std::list<LimiterStats> GetConcurrencyLimits();
+
+  // SetRateLimit limits request rate and bandwidth of the whole client,
+  // SetBucketRateLimit() of requests to a bucket and SetTagRateLimit() of
+  // requests whose args have given limit_tag. A request is held to every
+  // limit that applies to it. An empty RateLimit removes a limit. These may
+  // be called while the client is in use.
+  void SetRateLimit(http::RateLimit limit);
+  void SetBucketRateLimit(std::string bucket_name, http::RateLimit limit) {
+    bucket_rate_limiters_.Set(bucket_name, limit);
+  }
+  void SetTagRateLimit(std::string tag, http::RateLimit limit) {
+    tag_rate_limiters_.Set(tag, limit);
+  }
+
+  // PrewarmRegions looks up regions of given buckets concurrently so that
+  // first requests to them skip the location round trip.
+  error::Error PrewarmRegions(std::list<std::string> buckets);
+
   void HandleRedirectResponse(std::string& code, std::string& message,
                               int status_code, http::Method method,
-                              utils::Multimap headers, std::string& bucket_name,
-                              bool retry = false);
-  Response GetErrorResponse(http::Response resp, std::string_view resource,
+                              const utils::Multimap& headers,
+                              std::string& bucket_name, bool retry = false);
+  Response GetErrorResponse(const http::Response& resp,
+                            std::string_view resource,
                             http::Method method, std::string& bucket_name,
                             std::string& object_name);
-  Response execute(Request& req);
+  Response execute(Request& req, bool* retryable = NULL);
   Response Execute(Request& req);
   GetRegionResponse GetRegion(std::string& bucket_name, std::string& region);
 
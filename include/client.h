@@ -17,6 +17,7 @@
 #define _MINIO_S3_CLIENT_H
 
 #include <fstream>
+#include <memory>
 
 #include "args.h"
 #include "baseclient.h"
@@ -28,10 +29,15 @@ namespace minio {
 namespace s3 {
 class Client;
 
+/**
+ * ListObjectsResult iterates objects listed by Client::ListObjects(), fetching
+ * the next page when the current one is consumed. It keeps its own copy of
+ * the arguments, shared by its copies, to carry markers between pages.
+ */
 class ListObjectsResult {
  private:
   Client* client_ = NULL;
-  ListObjectsArgs* args_ = NULL;
+  std::shared_ptr<ListObjectsArgs> args_;
   bool failed_ = false;
   ListObjectsResponse resp_;
   std::list<Item>::iterator itr_;
@@ -57,10 +63,19 @@ class ListObjectsResult {
   }
 };  // class ListObjectsResult
 
+/**
+ * RemoveObjectsResult iterates errors of objects removed by
+ * Client::RemoveObjects() or Client::RemovePrefix(). Objects are removed in
+ * batches of up to 1000 with up to args.concurrency DeleteObjects requests
+ * in flight, each holding a slot of the concurrency limiter of the client.
+ * Memory use is bounded by the batches in flight and a listing page,
+ * however many objects are removed. Copies share the batches.
+ */
 class RemoveObjectsResult {
  private:
-  Client* client_ = NULL;
-  RemoveObjectsArgs* args_ = NULL;
+  class Batches;
+
+  std::shared_ptr<Batches> batches_;
   bool done_ = false;
   RemoveObjectsResponse resp_;
   std::list<DeleteError>::iterator itr_;
@@ -70,6 +85,7 @@ class RemoveObjectsResult {
  public:
   RemoveObjectsResult(error::Error err);
   RemoveObjectsResult(Client* client, RemoveObjectsArgs* args);
+  RemoveObjectsResult(Client* client, RemovePrefixArgs* args);
   DeleteError& operator*() const { return *itr_; }
   operator bool() const { return itr_ != resp_.errors.end(); }
   RemoveObjectsResult& operator++() {
@@ -93,7 +109,7 @@ class RemoveObjectsResult {
 class Client : public BaseClient {
  protected:
   StatObjectResponse CalculatePartCount(size_t& part_count,
-                                        std::list<ComposeSource> sources);
+                                        std::list<ComposeSource>& sources);
   ComposeObjectResponse ComposeObject(ComposeObjectArgs args,
                                       std::string& upload_id);
   PutObjectResponse PutObject(PutObjectArgs& args, std::string& upload_id,
@@ -101,6 +117,7 @@ class Client : public BaseClient {
 
  public:
   Client(BaseUrl& base_url, creds::Provider* provider = NULL);
+  Client(EndpointPool& endpoints, creds::Provider* provider = NULL);
   ComposeObjectResponse ComposeObject(ComposeObjectArgs args);
   CopyObjectResponse CopyObject(CopyObjectArgs args);
   DownloadObjectResponse DownloadObject(DownloadObjectArgs args);
@@ -108,6 +125,9 @@ class Client : public BaseClient {
   PutObjectResponse PutObject(PutObjectArgs args);
   UploadObjectResponse UploadObject(UploadObjectArgs args);
   RemoveObjectsResult RemoveObjects(RemoveObjectsArgs args);
+  // RemovePrefix removes objects under args.prefix recursively while they
+  // are listed.
+  RemoveObjectsResult RemovePrefix(RemovePrefixArgs args);
 };  // class Client
 }  // namespace s3
 }  // namespace minio
@@ -16,16 +16,18 @@
 #ifndef _MINIO_CREDS_CREDENTIALS_H
 #define _MINIO_CREDS_CREDENTIALS_H
 
-#include <pugixml.hpp>
-
 #include "utils.h"
+#include "xml.h"
 
 namespace minio {
 namespace creds {
+// Credentials are treated as expired this many seconds before expiration.
+inline constexpr time_t kExpirySkewSeconds = 10;
+
 static bool expired(utils::Time expiration) {
   if (!expiration) return false;
   utils::Time now = utils::Time::Now();
-  now.Add(10);
+  now.Add(kExpirySkewSeconds);
   return expiration < now;
 }
 
@@ -43,30 +45,44 @@ struct Credentials {
   bool IsExpired() { return expired(expiration); }
 
   operator bool() const {
-    return !err && !access_key.empty() && expired(expiration);
+    return !err && !access_key.empty() && !expired(expiration);
   }
 
+  // ParseXML reads Credentials element of root element of a STS response,
+  // like AssumeRoleResponse/AssumeRoleResult/Credentials.
   static Credentials ParseXML(std::string_view data, std::string root) {
-    pugi::xml_document xdoc;
-    pugi::xml_parse_result result = xdoc.load_string(data.data());
-    if (!result) return Credentials{error::Error("unable to parse XML")};
-
-    auto credentials = xdoc.select_node((root + "/Credentials").c_str());
-
-    auto text = credentials.node().select_node("AccessKeyId/text()");
-    std::string access_key = text.node().value();
-
-    text = credentials.node().select_node("SecretAccessKey/text()");
-    std::string secret_key = text.node().value();
-
-    text = credentials.node().select_node("SessionToken/text()");
-    std::string session_token = text.node().value();
-
-    text = credentials.node().select_node("Expiration/text()");
-    auto expiration = utils::Time::FromISO8601UTC(text.node().value());
-
-    return Credentials{error::SUCCESS, access_key, secret_key, session_token,
-                       expiration};
+    Credentials creds;
+    std::string prefix = "/" + root + "/Credentials/";
+    xml::Reader reader(data);
+    while (true) {
+      switch (reader.Next()) {
+        case xml::Reader::Token::kStart:
+          break;
+        case xml::Reader::Token::kEnd: {
+          std::string_view path = reader.Path();
+          size_t pos = path.find('/');
+          if (pos == std::string_view::npos ||
+              path.compare(pos, prefix.size(), prefix) != 0) {
+            break;
+          }
+          std::string_view name = path.substr(pos + prefix.size());
+          if (name == "AccessKeyId") {
+            creds.access_key = reader.Text();
+          } else if (name == "SecretAccessKey") {
+            creds.secret_key = reader.Text();
+          } else if (name == "SessionToken") {
+            creds.session_token = reader.Text();
+          } else if (name == "Expiration") {
+            creds.expiration = xml::Time(reader.Text());
+          }
+          break;
+        }
+        case xml::Reader::Token::kEof:
+          return creds;
+        default:
+          return Credentials{error::Error("unable to parse XML")};
+      }
+    }
   }
 };  // class Credentials
 }  // namespace creds
@@ -0,0 +1,130 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_S3_ENDPOINTS_H
+#define _MINIO_S3_ENDPOINTS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "http.h"
+#include "request.h"
+
+namespace minio {
+namespace s3 {
+/**
+ * EndpointStats is a point in time view of an endpoint of EndpointPool.
+ */
+struct EndpointStats {
+  std::string host;
+  bool healthy = true;
+  unsigned int outstanding = 0;          // Requests in flight.
+  unsigned long requests = 0;            // Requests sent.
+  unsigned long failures = 0;            // Requests failed by the endpoint.
+  std::chrono::microseconds latency{0};  // Moving average latency.
+};  // struct EndpointStats
+
+/**
+ * EndpointPool is a set of equivalent endpoints of one deployment, like the
+ * nodes of a distributed MinIO server. Each request goes to the better of two
+ * randomly chosen healthy endpoints, scored by moving average latency and
+ * requests in flight.
+ *
+ * An endpoint is ejected when it cannot be reached, i.e. on a resolve,
+ * connect, send, receive or timeout error, or after kMaxFailures server
+ * errors in a row, for a period doubling with each ejection up to
+ * kMaxEjection. Optional active health checks probe the MinIO liveness API of
+ * every endpoint in the background. If every endpoint is ejected, the one
+ * due back first is used.
+ *
+ * A pool may be shared by any number of clients and threads.
+ */
+class EndpointPool {
+ public:
+  static constexpr unsigned int kMaxFailures = 3;
+  static constexpr std::chrono::seconds kMinEjection{5};
+  static constexpr std::chrono::seconds kMaxEjection{60};
+  static constexpr std::chrono::seconds kDefaultHealthCheckInterval{5};
+  static constexpr std::chrono::seconds kHealthCheckTimeout{2};
+
+  EndpointPool(std::list<std::string> hosts, bool https = true);
+  ~EndpointPool();
+
+  operator bool() const { return !err_; }
+  error::Error Error() { return err_; }
+
+  // GetBaseUrl returns base URL of the first endpoint, which is used for
+  // everything except the host a request is sent to.
+  BaseUrl& GetBaseUrl() { return base_url_; }
+
+  size_t Size() { return endpoints_.size(); }
+  BaseUrl& Get(size_t index) { return endpoints_[index]->base_url; }
+  EndpointStats Stats(size_t index);
+
+  // Pick chooses the endpoint for a request; Done() must be called with the
+  // result.
+  size_t Pick();
+  void Done(size_t index, http::Response& response,
+            std::chrono::microseconds elapsed);
+
+  // IgnoreCertCheck and SetSslCertFile set TLS settings of health checks.
+  // Clients using the pool pass their own settings here too.
+  void IgnoreCertCheck(bool flag);
+  void SetSslCertFile(std::string ssl_cert_file);
+
+  void StartHealthChecks(
+      std::chrono::seconds interval = kDefaultHealthCheckInterval);
+  void StopHealthChecks();
+
+ private:
+  struct Endpoint {
+    BaseUrl base_url;
+    std::atomic<unsigned int> outstanding = 0;
+    std::atomic<unsigned long> requests = 0;
+    std::atomic<unsigned long> failures = 0;
+    std::atomic<unsigned int> consecutive_failures = 0;
+    std::atomic<unsigned int> ejections = 0;
+    std::atomic<long long> latency_us = 0;
+    std::atomic<long long> ejected_until = 0;  // Steady clock ticks.
+
+    Endpoint(BaseUrl base_url) : base_url(base_url) {}
+  };  // struct Endpoint
+
+  BaseUrl base_url_;
+  std::vector<std::unique_ptr<Endpoint>> endpoints_;
+  error::Error err_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread checker_;
+  bool stop_ = false;
+  bool ignore_cert_check_ = false;  // Guarded by mutex_.
+  std::string ssl_cert_file_;       // Guarded by mutex_.
+
+  bool healthy(Endpoint& endpoint, long long now);
+  void eject(Endpoint& endpoint);
+  void restore(Endpoint& endpoint);
+  void check(std::chrono::seconds interval);
+};  // class EndpointPool
+}  // namespace s3
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_S3_ENDPOINTS_H
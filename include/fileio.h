@@ -0,0 +1,173 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_FILEIO_H
+#define _MINIO_FILEIO_H
+
+#include <sys/types.h>
+
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "error.h"
+
+namespace minio {
+namespace fileio {
+inline constexpr size_t kBufferSize = 1024 * 1024;  // 1MiB
+inline constexpr unsigned int kQueueDepth = 8;
+inline constexpr size_t kAlignment = 4096;
+
+/**
+ * Engine selects how file data is read from or written to disk.
+ */
+enum class Engine {
+  kSync,      // pread/pwrite on the calling thread.
+  kThreaded,  // pread/pwrite on a background I/O thread.
+  kIoUring,   // io_uring submission; falls back to kThreaded if unavailable.
+};
+
+// EngineToString converts engine enum to string.
+constexpr const char* EngineToString(Engine engine) throw() {
+  switch (engine) {
+    case Engine::kSync:
+      return "sync";
+    case Engine::kThreaded:
+      return "threaded";
+    case Engine::kIoUring:
+      return "io_uring";
+  }
+  return "";
+}
+
+/**
+ * CacheMode controls how file data interacts with the kernel page cache.
+ */
+enum class CacheMode {
+  kDefault,   // Regular buffered I/O.
+  kDontNeed,  // Buffered I/O; each transferred part is dropped from the cache.
+  kDirect,    // O_DIRECT I/O from aligned buffers; falls back to kDontNeed if
+              // the file system does not support it.
+};
+
+// CacheModeToString converts cache mode enum to string.
+constexpr const char* CacheModeToString(CacheMode cache_mode) throw() {
+  switch (cache_mode) {
+    case CacheMode::kDefault:
+      return "default";
+    case CacheMode::kDontNeed:
+      return "dontneed";
+    case CacheMode::kDirect:
+      return "direct";
+  }
+  return "";
+}
+
+/**
+ * Queue executes positional reads and writes into fixed slots. Submit() starts
+ * an operation on a slot and Wait() blocks until that slot's operation is
+ * done. A queue is used by one thread at a time.
+ */
+class Queue {
+ public:
+  virtual ~Queue() {}
+
+  virtual error::Error Submit(unsigned int slot, bool write, int fd, char* buf,
+                              size_t length, off_t offset) = 0;
+  virtual error::Error Wait(unsigned int slot, ssize_t& result) = 0;
+  virtual Engine GetEngine() = 0;
+
+  // Create returns a queue of given depth for the engine. kIoUring falls back
+  // to kThreaded when io_uring is not supported by the running kernel.
+  static std::unique_ptr<Queue> Create(Engine engine, unsigned int depth);
+};  // class Queue
+
+/**
+ * Reader is a read-ahead stream buffer over a file. Up to kQueueDepth buffers
+ * are kept in flight so disk reads overlap with consumption of earlier data.
+ */
+class Reader : public std::streambuf {
+ private:
+  Engine engine_;
+  CacheMode cache_mode_;
+  int fd_ = -1;
+  std::unique_ptr<Queue> queue_;
+  std::vector<char*> buffers_;
+  std::vector<off_t> offsets_;
+  std::vector<bool> pending_;
+  unsigned int head_ = 0;
+  int current_ = -1;
+  off_t next_offset_ = 0;
+  off_t size_ = 0;  // File size at Open(); no reads are submitted beyond.
+  bool eof_ = false;
+  error::Error err_;
+
+  void submit(unsigned int slot);
+
+ public:
+  Reader(Engine engine = Engine::kSync,
+         CacheMode cache_mode = CacheMode::kDefault);
+  ~Reader();
+
+  error::Error Open(std::string filename);
+  void Close();
+  error::Error Error() { return err_; }
+  CacheMode GetCacheMode() { return cache_mode_; }
+
+ protected:
+  int_type underflow() override;
+  std::streamsize xsgetn(char* s, std::streamsize count) override;
+};  // class Reader
+
+/**
+ * Writer is a write-behind file writer. Data is copied into kBufferSize
+ * buffers and each full buffer is written asynchronously while the caller
+ * keeps producing data.
+ */
+class Writer {
+ private:
+  Engine engine_;
+  CacheMode cache_mode_;
+  int fd_ = -1;
+  std::unique_ptr<Queue> queue_;
+  std::vector<char*> buffers_;
+  std::vector<size_t> lengths_;
+  std::vector<off_t> offsets_;
+  std::vector<bool> pending_;
+  unsigned int slot_ = 0;
+  size_t used_ = 0;
+  off_t offset_ = 0;
+  error::Error err_;
+
+  error::Error submit();
+  error::Error wait(unsigned int slot);
+  error::Error clearDirect();
+
+ public:
+  Writer(Engine engine = Engine::kSync,
+         CacheMode cache_mode = CacheMode::kDefault);
+  ~Writer();
+
+  error::Error Open(std::string filename);
+  error::Error Write(std::string_view data);
+  error::Error Close();
+  CacheMode GetCacheMode() { return cache_mode_; }
+};  // class Writer
+}  // namespace fileio
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_FILEIO_H
@@ -0,0 +1,100 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_S3_HEDGE_H
+#define _MINIO_S3_HEDGE_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "http.h"
+
+namespace minio {
+namespace s3 {
+inline constexpr size_t kHedgeSamples = 1024;   // Latencies kept per method.
+inline constexpr size_t kHedgeMinSamples = 32;  // Needed before hedging.
+inline constexpr size_t kHedgeRecompute = 32;   // Samples between updates.
+inline constexpr double kHedgeBurst = 10;       // Max saved hedge budget.
+
+/**
+ * HedgePolicy controls hedging of idempotent requests. GetObject, StatObject,
+ * DownloadObject and UploadPart requests that have not received a response
+ * byte within the given percentile of recently observed time to first byte
+ * are sent again, and whichever first responds with a successful status is
+ * used while the other is cancelled. Hedges are capped to max_extra_load of
+ * eligible requests.
+ */
+struct HedgePolicy {
+  bool enabled = false;
+  double percentile = 0.95;                // Of time to first byte.
+  std::chrono::milliseconds min_delay{5};  // Lower bound of hedge delay.
+  double max_extra_load = 0.05;            // Hedges per eligible request.
+};  // struct HedgePolicy
+
+/**
+ * HedgeMetrics counts hedged requests of a client. wins / hedges is the hedge
+ * win rate.
+ */
+struct HedgeMetrics {
+  std::atomic<unsigned long> requests = 0;   // Hedge eligible requests.
+  std::atomic<unsigned long> hedges = 0;     // Duplicate requests sent.
+  std::atomic<unsigned long> wins = 0;       // Duplicates succeeding first.
+  std::atomic<unsigned long> throttled = 0;  // Hedges denied by load cap.
+};  // struct HedgeMetrics
+
+/**
+ * Hedger tracks time to first byte per HTTP method and decides after how
+ * long a request is hedged. It is safe to use from multiple threads.
+ */
+class Hedger {
+ private:
+  struct Latencies {
+    std::vector<long long> samples;  // Ring of microseconds.
+    size_t next = 0;
+    size_t added = 0;
+    std::chrono::microseconds delay{0};  // Zero until enough samples.
+  };  // struct Latencies
+
+  std::mutex mutex_;
+  HedgePolicy policy_;
+  Latencies latencies_[3];  // GET, HEAD and PUT.
+  double tokens_ = 1;
+  HedgeMetrics metrics_;
+
+  static int index(http::Method method);
+  void add(Latencies& latencies, std::chrono::microseconds latency);
+
+ public:
+  Hedger() {}
+
+  void SetPolicy(HedgePolicy policy);
+  HedgePolicy GetPolicy();
+  HedgeMetrics& Metrics() { return metrics_; }
+
+  // Delay returns hedge delay for a request of given method, or zero if the
+  // request must not be hedged. A non-zero delay reserves hedge budget which
+  // Done() returns if no duplicate was sent.
+  std::chrono::milliseconds Delay(http::Method method);
+
+  // Done records the outcome of a request started with given delay.
+  void Done(http::Method method, std::chrono::milliseconds delay,
+            http::Response& response);
+};  // class Hedger
+}  // namespace s3
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_S3_HEDGE_H
@@ -18,10 +18,13 @@
 
 #include <WinSock2.h>
 
+#include <chrono>
 #include <curlpp/Easy.hpp>
 #include <curlpp/Multi.hpp>
 #include <curlpp/Options.hpp>
 
+#include "ratelimit.h"
+#include "resolver.h"
 #include "utils.h"
 
 namespace minio {
@@ -177,6 +180,16 @@ struct Request {
   std::string ssl_cert_file;
   std::string key_file;
   std::string cert_file;
+  // If no response byte arrived within hedge_delay, a duplicate request is
+  // sent and the one first reading a successful status is used. Zero
+  // disables hedging.
+  std::chrono::milliseconds hedge_delay{0};
+  std::chrono::milliseconds timeout{0};  // Zero means no timeout.
+  // Resolver handing libcurl all addresses of url.host, in turn starting at
+  // a different one.
+  Resolver* resolver = NULL;
+  // Rate limiters every one of which must admit the request and its data.
+  std::list<std::shared_ptr<RateLimiter>> rate_limiters;
 
   Request(Method method, Url url);
   Response Execute();
@@ -186,11 +199,26 @@ struct Request {
   }
 
  private:
+  void setup(curlpp::Easy& request, std::istream& body_stream);
   Response execute();
 };  // struct Request
 
 struct Response {
   std::string error;
+  CURLcode curl_code = CURLE_OK;
+  bool hedged = false;     // Duplicate request was sent.
+  bool hedge_won = false;  // Duplicate request succeeded first.
+  std::chrono::microseconds first_byte_time{0};  // Time to first byte.
+  size_t bytes_sent = 0;           // Request body bytes.
+  size_t bytes_received = 0;       // Response header and body bytes.
+  bool reused_connection = false;  // Sent on an existing connection.
+  // libcurl timings of the transfer, each counted from its start.
+  std::chrono::microseconds name_lookup_time{0};
+  std::chrono::microseconds connect_time{0};
+  std::chrono::microseconds app_connect_time{0};
+  std::chrono::microseconds pre_transfer_time{0};
+  std::chrono::microseconds start_transfer_time{0};
+  std::chrono::microseconds total_time{0};
   DataFunction datafunc = NULL;
   void* userdata = NULL;
   int status_code = 0;
@@ -0,0 +1,174 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_S3_LIMITER_H
+#define _MINIO_S3_LIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "http.h"
+
+namespace minio {
+namespace s3 {
+/**
+ * Priority is the scheduling class of a request waiting for a slot of a
+ * ConcurrencyLimiter.
+ */
+enum class Priority {
+  kCritical,     // Served ahead of every other class.
+  kInteractive,  // Weighted fair share; high weight.
+  kNormal,       // Weighted fair share; default.
+  kBackground,   // Weighted fair share; low weight.
+};
+inline constexpr unsigned int kPriorityCount = 4;
+
+// PriorityToString converts priority enum to string.
+constexpr const char* PriorityToString(Priority priority) throw() {
+  switch (priority) {
+    case Priority::kCritical:
+      return "critical";
+    case Priority::kInteractive:
+      return "interactive";
+    case Priority::kNormal:
+      return "normal";
+    case Priority::kBackground:
+      return "background";
+  }
+  return "";
+}
+
+/**
+ * LimiterPolicy configures ConcurrencyLimiter.
+ */
+struct LimiterPolicy {
+  unsigned int initial_limit = 16;
+  unsigned int min_limit = 1;
+  unsigned int max_limit = 256;
+  double backoff = 0.7;    // Limit is multiplied by this on throttling.
+  double tolerance = 1.5;  // Latency over baseline times this is congestion.
+  // Shares of slots among waiting kInteractive, kNormal and kBackground
+  // requests.
+  unsigned int interactive_weight = 16;
+  unsigned int normal_weight = 4;
+  unsigned int background_weight = 1;
+};  // struct LimiterPolicy
+
+/**
+ * LimiterStats is a point in time view of a ConcurrencyLimiter.
+ */
+struct LimiterStats {
+  double limit = 0;
+  unsigned int inflight = 0;
+  unsigned long requests = 0;
+  unsigned long throttled = 0;  // 503, 429 or timed out responses.
+  unsigned long waits = 0;      // Acquires blocked on the limit.
+  unsigned int queued = 0;      // Acquires blocked now.
+  std::chrono::microseconds latency{0};   // Recent latency.
+  std::chrono::microseconds baseline{0};  // Latency without load.
+};  // struct LimiterStats
+
+/**
+ * ConcurrencyLimiter limits requests in flight to an endpoint with an
+ * adaptive limit. While latency stays within tolerance of the no-load
+ * baseline and the limit is in use, the limit grows by one per limit
+ * requests (additive increase), so throughput grows as long as the server
+ * keeps up. Rising latency shrinks the limit in proportion to the rise, and
+ * 503 SlowDown, 429 or timed out responses multiply it by backoff at most
+ * once per round trip (multiplicative decrease). Latency is time to first
+ * byte of requests without a body; an upload's includes sending its body.
+ *
+ * Blocked requests are granted freed slots by priority. kCritical requests
+ * go first; the other classes share slots by weight with weighted fair
+ * queuing, so background work keeps a small share without delaying
+ * interactive requests by more than its share.
+ *
+ * It is safe to use from multiple threads.
+ */
+class ConcurrencyLimiter {
+ private:
+  struct Waiter {
+    std::condition_variable cond;
+    double finish = 0;  // Virtual finish time.
+    bool granted = false;
+  };  // struct Waiter
+
+  std::mutex mutex_;
+  LimiterPolicy policy_;
+  double limit_;
+  unsigned int inflight_ = 0;
+  double latency_ = 0;   // Microseconds; fast moving average.
+  double baseline_ = 0;  // Microseconds; slow moving average of minimums.
+  std::chrono::steady_clock::time_point last_decrease_;
+  unsigned long requests_ = 0;
+  unsigned long throttled_ = 0;
+  unsigned long waits_ = 0;
+  std::deque<Waiter*> queues_[kPriorityCount];
+  double finishes_[kPriorityCount] = {};
+  double virtual_time_ = 0;
+
+  void setLimit(double limit);
+  void dispatch();
+
+ public:
+  ConcurrencyLimiter(LimiterPolicy policy = LimiterPolicy());
+
+  // Acquire blocks until a request of given priority may be sent.
+  void Acquire(Priority priority = Priority::kNormal);
+
+  // Release ends a request started with Acquire() and adapts the limit to
+  // its response and latency.
+  void Release(http::Response& response, std::chrono::microseconds elapsed);
+
+  unsigned int Limit();
+  LimiterStats Stats();
+};  // class ConcurrencyLimiter
+
+/**
+ * LimiterSlot holds a slot of a ConcurrencyLimiter from construction until
+ * Release() or destruction, so that a request failing before its response
+ * does not leak the slot. A NULL limiter holds nothing.
+ */
+class LimiterSlot {
+ private:
+  ConcurrencyLimiter* limiter_;
+
+ public:
+  LimiterSlot(ConcurrencyLimiter* limiter, Priority priority)
+      : limiter_(limiter) {
+    if (limiter_ != NULL) limiter_->Acquire(priority);
+  }
+
+  LimiterSlot(const LimiterSlot&) = delete;
+  LimiterSlot& operator=(const LimiterSlot&) = delete;
+
+  // A slot released without a response does not adapt the limit.
+  ~LimiterSlot() {
+    http::Response response;
+    Release(response, std::chrono::microseconds(0));
+  }
+
+  void Release(http::Response& response, std::chrono::microseconds elapsed) {
+    if (limiter_ == NULL) return;
+    limiter_->Release(response, elapsed);
+    limiter_ = NULL;
+  }
+};  // class LimiterSlot
+}  // namespace s3
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_S3_LIMITER_H
@@ -0,0 +1,139 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_S3_METRICS_H
+#define _MINIO_S3_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "http.h"
+
+namespace minio {
+namespace s3 {
+/**
+ * HistogramSnapshot is a point in time copy of a Histogram.
+ */
+struct HistogramSnapshot {
+  std::vector<unsigned long long> counts;
+  unsigned long long count = 0;
+  unsigned long long sum = 0;
+
+  // Percentile returns upper bound of the bucket holding quantile q (0..1).
+  unsigned long long Percentile(double q) const;
+  // CountBelow returns number of values less than or equal to bound,
+  // rounded to bucket boundaries.
+  unsigned long long CountBelow(unsigned long long bound) const;
+};  // struct HistogramSnapshot
+
+/**
+ * Histogram is a lock-free log-linear histogram of non-negative values like
+ * HdrHistogram: each power of two is split into kSubBuckets equal buckets,
+ * so any value is kept within 1/kSubBuckets relative error. Values up to
+ * 2^kMaxBits are recorded; larger values count in the last bucket.
+ */
+class Histogram {
+ public:
+  static constexpr unsigned int kSubBits = 3;
+  static constexpr unsigned int kSubBuckets = 1 << kSubBits;
+  static constexpr unsigned int kMaxBits = 40;
+  static constexpr unsigned int kBuckets =
+      kSubBuckets + (kMaxBits - kSubBits) * kSubBuckets;
+
+  Histogram() {}
+
+  void Record(unsigned long long value);
+  HistogramSnapshot Snapshot() const;
+
+  static unsigned int Index(unsigned long long value);
+  // UpperBound returns the smallest value above bucket of index.
+  static unsigned long long UpperBound(unsigned int index);
+
+ private:
+  std::atomic<unsigned long long> counts_[kBuckets] = {};
+  std::atomic<unsigned long long> sum_ = 0;
+};  // class Histogram
+
+/**
+ * OperationStats is a snapshot of metrics of one S3 API and bucket.
+ */
+struct OperationStats {
+  std::string api;
+  std::string bucket;
+  unsigned long long requests = 0;  // Attempts sent.
+  unsigned long long retries = 0;
+  unsigned long long network_errors = 0;
+  unsigned long long status_classes[6] = {};  // 1xx..5xx at [1]..[5].
+  unsigned long long bytes_sent = 0;
+  unsigned long long bytes_received = 0;
+  unsigned long long connections_reused = 0;
+  unsigned long long connections_opened = 0;
+  HistogramSnapshot latency;  // Microseconds.
+};  // struct OperationStats
+
+/**
+ * RequestMetrics records request metrics per S3 API and bucket. Recording
+ * does not take the metrics mutex once a series exists: series are found in
+ * an immutable map snapshot and updated with relaxed atomic increments. At
+ * most kMaxSeries API/bucket series are kept; further buckets are recorded
+ * with an empty bucket name.
+ */
+class RequestMetrics {
+ public:
+  static constexpr size_t kMaxSeries = 1024;
+
+  RequestMetrics() {}
+
+  void Record(std::string_view api, const std::string& bucket,
+              http::Response& response, std::chrono::microseconds elapsed);
+  void RecordRetry(std::string_view api, const std::string& bucket);
+
+  std::list<OperationStats> Snapshot();
+
+  // Prometheus returns all metrics in Prometheus text exposition format.
+  std::string Prometheus();
+
+ private:
+  struct Series {
+    std::string api;
+    std::string bucket;
+    std::atomic<unsigned long long> requests = 0;
+    std::atomic<unsigned long long> retries = 0;
+    std::atomic<unsigned long long> network_errors = 0;
+    std::atomic<unsigned long long> status_classes[6] = {};
+    std::atomic<unsigned long long> bytes_sent = 0;
+    std::atomic<unsigned long long> bytes_received = 0;
+    std::atomic<unsigned long long> connections_reused = 0;
+    std::atomic<unsigned long long> connections_opened = 0;
+    Histogram latency;
+  };  // struct Series
+
+  using Map = std::map<std::string, std::shared_ptr<Series>>;
+
+  std::mutex mutex_;
+  std::shared_ptr<const Map> map_ = std::make_shared<const Map>();
+
+  Series& series(std::string_view api, const std::string& bucket);
+};  // class RequestMetrics
+}  // namespace s3
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_S3_METRICS_H
@@ -22,9 +22,14 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <thread>
 
 #include "credentials.h"
 #include "signer.h"
@@ -69,12 +74,38 @@ static error::Error checkLoopbackHost(std::string host) {
 }
 
 /**
- * Credential provider interface.
+ * Credential provider interface. Fetch() is safe to call from multiple
+ * threads. Providers refreshing credentials serve the last published snapshot
+ * without locking and serialize refreshes on mutex_.
  */
 class Provider {
+ private:
+  std::shared_ptr<const Credentials> snapshot_;
+
  protected:
   error::Error err_;
   Credentials creds_;
+  std::mutex mutex_;
+
+  // Snapshot returns last published credentials without locking.
+  Credentials Snapshot() const {
+    std::shared_ptr<const Credentials> snapshot = std::atomic_load(&snapshot_);
+    if (snapshot == NULL) return Credentials{};
+    return *snapshot;
+  }
+
+  // Publish makes credentials visible to Snapshot() and returns them.
+  Credentials Publish(Credentials creds) {
+    std::atomic_store(&snapshot_, std::make_shared<const Credentials>(creds));
+    return creds;
+  }
+
+  // Drop cached credentials so that next Fetch() retrieves new ones.
+  void Drop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    creds_ = Credentials{};
+    Publish(creds_);
+  }
 
  public:
   Provider() {}
@@ -84,6 +115,10 @@ class Provider {
   operator bool() const { return !err_; }
 
   virtual Credentials Fetch() = 0;
+
+  // Reset makes next Fetch() retrieve new credentials even if cached ones are
+  // not expired yet. It does nothing for providers of fixed credentials.
+  virtual void Reset() {}
 };  // class Provider
 
 class ChainedProvider : public Provider {
@@ -99,21 +134,30 @@ class ChainedProvider : public Provider {
   Credentials Fetch() {
     if (err_) return Credentials{err_};
 
+    if (Credentials creds = Snapshot()) return creds;
+
+    std::lock_guard<std::mutex> lock(mutex_);
     if (creds_) return creds_;
 
     if (provider_ != NULL) {
       creds_ = provider_->Fetch();
-      if (creds_) return creds_;
+      if (creds_) return Publish(creds_);
     }
 
     for (auto provider : providers_) {
       provider_ = provider;
       creds_ = provider_->Fetch();
-      if (creds_) return creds_;
+      if (creds_) return Publish(creds_);
     }
 
     return Credentials{error::Error("All providers fail to fetch credentials")};
   }
+
+  void Reset() {
+    Drop();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (provider_ != NULL) provider_->Reset();
+  }
 };  // class ChainedProvider
 
 /**
@@ -274,6 +318,9 @@ class AssumeRoleProvider : public Provider {
   Credentials Fetch() {
     if (err_) return Credentials{err_};
 
+    if (Credentials creds = Snapshot()) return creds;
+
+    std::lock_guard<std::mutex> lock(mutex_);
     if (creds_) return creds_;
 
     utils::Time date = utils::Time::Now();
@@ -297,8 +344,10 @@ class AssumeRoleProvider : public Provider {
       creds_ = Credentials::ParseXML(resp.body, "AssumeRoleResult");
     }
 
-    return creds_;
+    return Publish(creds_);
   }
+
+  void Reset() { Drop(); }
 };  // class AssumeRoleProvider
 
 class WebIdentityClientGrantsProvider : public Provider {
@@ -335,6 +384,9 @@ class WebIdentityClientGrantsProvider : public Provider {
   }
 
   Credentials Fetch() {
+    if (Credentials creds = Snapshot()) return creds;
+
+    std::lock_guard<std::mutex> lock(mutex_);
     if (creds_) return creds_;
 
     Jwt jwt = jwtfunc_();
@@ -374,8 +426,10 @@ class WebIdentityClientGrantsProvider : public Provider {
           resp.body, IsWebIdentity() ? "AssumeRoleWithWebIdentityResult"
                                      : "AssumeRoleWithClientGrantsResult");
     }
-    return creds_;
+    return Publish(creds_);
   }
+
+  void Reset() { Drop(); }
 };  // class WebIdentityClientGrantsProvider
 
 class ClientGrantsProvider : public WebIdentityClientGrantsProvider {
@@ -470,6 +524,9 @@ class IamAwsProvider : public Provider {
   }
 
   Credentials Fetch() {
+    if (Credentials creds = Snapshot()) return creds;
+
+    std::lock_guard<std::mutex> lock(mutex_);
     if (creds_) return creds_;
 
     http::Url url = custom_endpoint_;
@@ -491,7 +548,7 @@ class IamAwsProvider : public Provider {
           },
           url, 0, "", role_arn_, role_session_name_);
       creds_ = provider.Fetch();
-      return creds_;
+      return Publish(creds_);
     }
 
     if (!relative_uri_.empty()) {
@@ -504,7 +561,7 @@ class IamAwsProvider : public Provider {
       if (!url) url = http::Url::Parse(full_uri_);
       if (error::Error err = checkLoopbackHost(url.host)) {
         creds_ = Credentials{err};
-        return creds_;
+        return Publish(creds_);
       }
     } else {
       if (!url) {
@@ -516,15 +573,17 @@ class IamAwsProvider : public Provider {
       std::string role_name;
       if (error::Error err = getRoleName(role_name, url)) {
         creds_ = Credentials{err};
-        return creds_;
+        return Publish(creds_);
       }
 
       url.path += "/" + role_name;
     }
 
     creds_ = fetch(url);
-    return creds_;
+    return Publish(creds_);
   }
+
+  void Reset() { Drop(); }
 };  // class IamAwsProvider
 
 class LdapIdentityProvider : public Provider {
@@ -544,6 +603,9 @@ class LdapIdentityProvider : public Provider {
   }
 
   Credentials Fetch() {
+    if (Credentials creds = Snapshot()) return creds;
+
+    std::lock_guard<std::mutex> lock(mutex_);
     if (creds_) return creds_;
 
     http::Request req(http::Method::kPost, sts_endpoint_);
@@ -552,8 +614,10 @@ class LdapIdentityProvider : public Provider {
 
     creds_ =
         Credentials::ParseXML(resp.body, "AssumeRoleWithLDAPIdentityResult");
-    return creds_;
+    return Publish(creds_);
   }
+
+  void Reset() { Drop(); }
 };  // class LdapIdentityProvider
 
 struct CertificateIdentityProvider : public Provider {
@@ -598,6 +662,9 @@ struct CertificateIdentityProvider : public Provider {
   Credentials Fetch() {
     if (err_) return Credentials{err_};
 
+    if (Credentials creds = Snapshot()) return creds;
+
+    std::lock_guard<std::mutex> lock(mutex_);
     if (creds_) return creds_;
 
     http::Request req(http::Method::kPost, sts_endpoint_);
@@ -610,9 +677,146 @@ struct CertificateIdentityProvider : public Provider {
 
     creds_ =
         Credentials::ParseXML(resp.body, "AssumeRoleWithCertificateResult");
-    return creds_;
+    return Publish(creds_);
   }
+
+  void Reset() { Drop(); }
 };  // struct CertificateIdentityProvider
+
+/**
+ * RefreshingProvider wraps a provider of expiring credentials, e.g.
+ * AssumeRoleProvider or IamAwsProvider, and refreshes them on a background
+ * thread once refresh_fraction of their lifetime has passed. Fetch() returns
+ * the current snapshot without locking and blocks only when credentials have
+ * actually expired, for example after background refreshes kept failing.
+ * Failed refreshes are retried every retry_interval_seconds. The wrapped
+ * provider is called without holding a lock and by one caller at a time.
+ */
+class RefreshingProvider : public Provider {
+ private:
+  Provider* provider_ = NULL;
+  double refresh_fraction_;
+  std::chrono::seconds retry_interval_;
+  utils::Time issued_;
+  bool stop_ = false;
+  bool refreshing_ = false;  // A refresh is in progress.
+  Credentials last_;         // Result of last refresh.
+  std::condition_variable cond_;
+  std::thread thread_;
+
+  // refresh fetches new credentials with lock released, or waits for the
+  // refresh in progress and returns its result. lock must hold mutex_.
+  Credentials refresh(std::unique_lock<std::mutex>& lock) {
+    if (refreshing_) {
+      cond_.wait(lock, [this] { return !refreshing_; });
+      return last_;
+    }
+
+    refreshing_ = true;
+    lock.unlock();
+    Credentials creds;
+    try {
+      provider_->Reset();
+      creds = provider_->Fetch();
+    } catch (...) {
+      lock.lock();
+      refreshing_ = false;
+      cond_.notify_all();
+      throw;
+    }
+    lock.lock();
+    refreshing_ = false;
+
+    if (creds) {
+      issued_ = utils::Time::Now();
+      Publish(creds);
+    }
+    last_ = creds;
+    cond_.notify_all();
+    return creds;
+  }
+
+  // nextRefresh returns seconds to wait before next refresh of credentials.
+  long nextRefresh(Credentials& creds) {
+    if (!creds) return 0;
+    if (!creds.expiration) return -1;  // Credentials never expire.
+
+    std::time_t issued = issued_.ToEpochSeconds();
+    std::time_t lifetime =
+        creds.expiration.ToEpochSeconds() - kExpirySkewSeconds - issued;
+    std::time_t due = issued + (std::time_t)(lifetime * refresh_fraction_);
+    long wait = due - utils::Time::Now().ToEpochSeconds();
+    return wait > 0 ? wait : 0;
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      Credentials creds = Snapshot();
+      long wait = nextRefresh(creds);
+      if (wait < 0) {
+        cond_.wait(lock, [this] { return stop_; });
+        continue;
+      }
+
+      if (wait > 0) {
+        cond_.wait_for(lock, std::chrono::seconds(wait),
+                       [this] { return stop_; });
+        continue;
+      }
+
+      if (!refresh(lock)) {
+        cond_.wait_for(lock, retry_interval_, [this] { return stop_; });
+      }
+    }
+  }
+
+ public:
+  RefreshingProvider(Provider* provider, double refresh_fraction = 0.75,
+                     unsigned int retry_interval_seconds = 10) {
+    if (provider == NULL) {
+      this->err_ = error::Error("provider must not be NULL");
+      return;
+    }
+
+    if (refresh_fraction <= 0 || refresh_fraction >= 1) {
+      this->err_ = error::Error("refresh fraction must be between 0 and 1");
+      return;
+    }
+
+    this->provider_ = provider;
+    this->refresh_fraction_ = refresh_fraction;
+    this->retry_interval_ = std::chrono::seconds(retry_interval_seconds);
+    this->thread_ = std::thread(&RefreshingProvider::run, this);
+  }
+
+  // ~RefreshingProvider waits only for a refresh already in progress.
+  ~RefreshingProvider() {
+    if (!thread_.joinable()) return;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cond_.notify_all();
+    thread_.join();
+  }
+
+  Credentials Fetch() {
+    if (err_) return Credentials{err_};
+
+    if (Credentials creds = Snapshot()) return creds;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (Credentials creds = Snapshot()) return creds;
+
+    return refresh(lock);
+  }
+
+  void Reset() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    refresh(lock);
+  }
+};  // class RefreshingProvider
 }  // namespace creds
 }  // namespace minio
 
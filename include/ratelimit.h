@@ -0,0 +1,118 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_HTTP_RATELIMIT_H
+#define _MINIO_HTTP_RATELIMIT_H
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace minio {
+namespace http {
+// Token buckets hold this much of their rate, so short bursts pass unpaced.
+inline constexpr std::chrono::milliseconds kRateLimitBurst{100};
+
+/**
+ * TokenBucket hands out tokens at a fixed rate. Take() never refuses; a
+ * caller taking more than available puts the bucket in debt and sleeps until
+ * the debt is paid, so concurrent callers are served in arrival order.
+ */
+class TokenBucket {
+ private:
+  std::mutex mutex_;
+  double rate_;  // Tokens per second.
+  double burst_;
+  double tokens_;
+  std::chrono::steady_clock::time_point last_;
+
+ public:
+  TokenBucket(double rate);
+
+  // Take takes tokens, sleeping until any debt is paid.
+  void Take(double tokens);
+
+  // Debit takes tokens and returns how long until any debt is paid, for
+  // callers that must not sleep.
+  std::chrono::microseconds Debit(double tokens);
+};  // class TokenBucket
+
+/**
+ * RateLimit is a limit of request rate and bandwidth. Zero is unlimited.
+ */
+struct RateLimit {
+  double requests_per_second = 0;
+  double send_bytes_per_second = 0;
+  double receive_bytes_per_second = 0;
+
+  operator bool() const {
+    return requests_per_second > 0 || send_bytes_per_second > 0 ||
+           receive_bytes_per_second > 0;
+  }
+};  // struct RateLimit
+
+/**
+ * RateLimiter applies a RateLimit to every request it is attached to.
+ */
+class RateLimiter {
+ private:
+  RateLimit limit_;
+  std::unique_ptr<TokenBucket> requests_;
+  std::unique_ptr<TokenBucket> send_;
+  std::unique_ptr<TokenBucket> receive_;
+
+ public:
+  RateLimiter(RateLimit limit);
+
+  RateLimit Limit() { return limit_; }
+  void Request() {
+    if (requests_) requests_->Take(1);
+  }
+  void Send(size_t bytes) {
+    if (send_) send_->Take(bytes);
+  }
+  // Receive returns how long the transfer must pause after receiving bytes.
+  // It does not sleep; other transfers of the caller keep running.
+  std::chrono::microseconds Receive(size_t bytes) {
+    if (!receive_) return std::chrono::microseconds(0);
+    return receive_->Debit(bytes);
+  }
+};  // class RateLimiter
+
+/**
+ * RateLimiterMap keeps rate limiters by key, like a bucket name or a caller
+ * supplied tag. Lookups read an immutable snapshot without locking.
+ */
+class RateLimiterMap {
+ private:
+  using Map = std::map<std::string, std::shared_ptr<RateLimiter>>;
+
+  std::mutex mutex_;
+  std::shared_ptr<const Map> map_ = std::make_shared<const Map>();
+
+ public:
+  RateLimiterMap() {}
+
+  // Set sets limit of key; an empty limit removes it.
+  void Set(std::string key, RateLimit limit);
+  std::shared_ptr<RateLimiter> Get(const std::string& key);
+};  // class RateLimiterMap
+}  // namespace http
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_HTTP_RATELIMIT_H
@@ -0,0 +1,95 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_S3_REGION_CACHE_H
+#define _MINIO_S3_REGION_CACHE_H
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "response.h"
+
+namespace minio {
+namespace s3 {
+using RegionLookupFunction = std::function<GetRegionResponse()>;
+
+/**
+ * RegionCache maps bucket names to their regions. Buckets are spread over
+ * kShards shards and each shard publishes an immutable map, so readers never
+ * take a lock. Concurrent misses for the same bucket share a single lookup.
+ * Entries expire after the TTL; NoSuchBucket results are kept for the
+ * negative TTL. Zero TTL means entries never expire and zero negative TTL,
+ * the default, disables negative entries.
+ */
+class RegionCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t kShards = 16;
+  static constexpr std::chrono::seconds kDefaultTtl{0};
+  static constexpr std::chrono::seconds kDefaultNegativeTtl{0};
+  static constexpr size_t kPrewarmConcurrency = 8;
+
+ private:
+  struct Entry {
+    GetRegionResponse response;
+    Clock::time_point expiry;
+  };  // struct Entry
+
+  using Map = std::map<std::string, Entry>;
+
+  struct Shard {
+    std::shared_ptr<const Map> map = std::make_shared<const Map>();
+    std::map<std::string, std::shared_future<GetRegionResponse>> inflight;
+    std::mutex mutex;
+  };  // struct Shard
+
+  std::array<Shard, kShards> shards_;
+  std::chrono::seconds ttl_ = kDefaultTtl;
+  std::chrono::seconds negative_ttl_ = kDefaultNegativeTtl;
+
+  Shard& shard(const std::string& bucket_name);
+  Clock::time_point expiry(std::chrono::seconds ttl);
+  void store(Shard& shard, const std::string& bucket_name, Entry entry);
+
+ public:
+  RegionCache() {}
+
+  // SetTtl must be called before the cache is shared between threads.
+  void SetTtl(std::chrono::seconds ttl, std::chrono::seconds negative_ttl) {
+    ttl_ = ttl;
+    negative_ttl_ = negative_ttl;
+  }
+
+  // Lookup returns cached region of the bucket without locking.
+  bool Lookup(const std::string& bucket_name, std::string& region);
+
+  // Get returns cached region of the bucket or calls lookup on a miss.
+  // Concurrent callers missing the same bucket wait for one lookup.
+  GetRegionResponse Get(const std::string& bucket_name,
+                        RegionLookupFunction lookup);
+
+  void Set(const std::string& bucket_name, const std::string& region);
+  void Remove(const std::string& bucket_name);
+};  // class RegionCache
+}  // namespace s3
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_S3_REGION_CACHE_H
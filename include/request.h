@@ -16,9 +16,11 @@
 #ifndef _MINIO_REQUEST_H
 #define _MINIO_REQUEST_H
 
+#include "args.h"
 #include "credentials.h"
 #include "providers.h"
 #include "signer.h"
+#include "trace.h"
 
 namespace minio {
 namespace s3 {
@@ -52,10 +54,11 @@ struct BaseUrl {
 
   BaseUrl() {}
   BaseUrl(std::string host, bool https = true);
-  error::Error BuildUrl(http::Url& url, http::Method method, std::string region,
-                        utils::Multimap query_params,
-                        std::string bucket_name = "",
-                        std::string object_name = "");
+  error::Error BuildUrl(http::Url& url, http::Method method,
+                        const std::string& region,
+                        const utils::Multimap& query_params,
+                        const std::string& bucket_name = "",
+                        const std::string& object_name = "");
   operator bool() const { return !err_ && !host.empty(); }
   error::Error Error() {
     if (host.empty() && !err_) return error::Error("empty host");
@@ -70,19 +73,27 @@ struct Request {
   http::Method method;
   std::string region;
   BaseUrl& base_url;
+  BaseUrl* endpoint = NULL;  // Pool endpoint to send to instead of base_url.
 
   std::string user_agent;
 
+  std::string_view api = "";  // S3 API name, used to label metrics.
+
   utils::Multimap headers;
   utils::Multimap query_params;
 
   std::string bucket_name;
   std::string object_name;
+  std::string limit_tag;
+  Priority priority = Priority::kNormal;
 
   std::string_view body = "";
+  std::string body_data;  // Storage of body built by the client.
 
   http::DataFunction datafunc = NULL;
   void* userdata = NULL;
+  bool resumable = false;  // GET whose body may be resumed by a range request.
+  bool hedgeable = false;  // Idempotent request which may be sent twice.
 
   std::string sha256;
   utils::Time date;
@@ -91,12 +102,27 @@ struct Request {
   bool ignore_cert_check = false;
   std::string ssl_cert_file;
 
+  unsigned int attempts = 0;
+  // Trace of the successful attempt, exported with its parse time when the
+  // request is destroyed.
+  std::unique_ptr<Span> span;
+  SpanSink* span_sink = NULL;
+  std::chrono::steady_clock::time_point span_end;
+
   Request(http::Method method, std::string region, BaseUrl& baseurl,
           utils::Multimap extra_headers, utils::Multimap extra_query_params);
-  http::Request ToHttpRequest(creds::Provider* provider = NULL);
+  Request(http::Method method, std::string region, BaseUrl& baseurl,
+          BaseArgs& args);
+  ~Request();
+  // ToHttpRequest builds signed HTTP request. Temporaries of signing are
+  // allocated from memory if given.
+  http::Request ToHttpRequest(creds::Provider* provider = NULL,
+                              std::pmr::memory_resource* memory = NULL);
 
  private:
-  void BuildHeaders(http::Url& url, creds::Provider* provider);
+  void BuildHeaders(utils::Multimap& http_headers, http::Url& url,
+                    creds::Provider* provider,
+                    std::pmr::memory_resource* memory);
 };  // struct Request
 }  // namespace s3
 }  // namespace minio
@@ -0,0 +1,84 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_HTTP_RESOLVER_H
+#define _MINIO_HTTP_RESOLVER_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace minio {
+namespace http {
+/**
+ * Resolver keeps every IPv4 and IPv6 address of host names and hands all of
+ * them to each request, starting at a different one in turn, so that new
+ * connections to a host with many DNS records are spread over all of them
+ * while libcurl still falls back to the other addresses. Addresses are
+ * resolved again when older than the resolve interval. The resolver is off
+ * by default. It is safe to use from multiple threads.
+ */
+class Resolver {
+ public:
+  static constexpr std::chrono::seconds kDefaultInterval{0};
+
+  // ResolveFunction returns addresses of host, IPv6 ones in brackets.
+  using ResolveFunction =
+      std::function<std::vector<std::string>(std::string, unsigned int)>;
+
+  Resolver(std::chrono::seconds interval = kDefaultInterval)
+      : interval_(interval) {}
+
+  // SetInterval sets how long resolved addresses are used. Zero disables the
+  // resolver, leaving name resolution to libcurl.
+  void SetInterval(std::chrono::seconds interval);
+
+  // SetResolveFunction replaces getaddrinfo() lookups, e.g. by service
+  // discovery. NULL restores getaddrinfo().
+  void SetResolveFunction(ResolveFunction func);
+
+  // Next returns all addresses of host, rotated to start one further than
+  // the previous call, or an empty list if host is an IP address, could not
+  // be resolved or the resolver is disabled.
+  std::vector<std::string> Next(std::string host, unsigned int port);
+
+  // Addresses returns all currently known addresses of host.
+  std::vector<std::string> Addresses(std::string host, unsigned int port);
+
+ private:
+  struct Entry {
+    std::vector<std::string> addresses;
+    std::chrono::steady_clock::time_point resolved;
+    std::atomic<size_t> next = 0;
+    bool refreshing = false;
+  };  // struct Entry
+
+  std::mutex mutex_;
+  std::chrono::seconds interval_;
+  ResolveFunction resolve_func_ = NULL;
+  std::map<std::string, std::shared_ptr<Entry>> entries_;
+
+  static std::vector<std::string> resolve(std::string host, unsigned int port);
+  std::shared_ptr<Entry> get(std::string& host, unsigned int port);
+};  // class Resolver
+}  // namespace http
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_HTTP_RESOLVER_H
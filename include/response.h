@@ -16,8 +16,6 @@
 #ifndef _MINIO_S3_RESPONSE_H
 #define _MINIO_S3_RESPONSE_H
 
-#include <pugixml.hpp>
-
 #include "types.h"
 
 namespace minio {
@@ -39,20 +37,13 @@ struct Response {
 
   Response(error::Error err) { this->err_ = err; }
 
-  Response(const Response& resp) {
-    this->err_ = resp.err_;
-
-    this->status_code = resp.status_code;
-    this->headers = resp.headers;
-    this->data = resp.data;
-    this->code = resp.code;
-    this->message = resp.message;
-    this->resource = resp.resource;
-    this->request_id = resp.request_id;
-    this->host_id = resp.host_id;
-    this->bucket_name = resp.bucket_name;
-    this->object_name = resp.object_name;
-  }
+  Response(const Response& resp) = default;
+
+  Response(Response&& resp) = default;
+
+  Response& operator=(const Response& resp) = default;
+
+  Response& operator=(Response&& resp) = default;
 
   operator bool() const {
     return !err_ && code.empty() && message.empty() &&
@@ -84,6 +75,8 @@ struct GetRegionResponse : public Response {
   GetRegionResponse(error::Error err) : Response(err) {}
 
   GetRegionResponse(const Response& resp) : Response(resp) {}
+
+  GetRegionResponse(Response&& resp) : Response(std::move(resp)) {}
 };  // struct GetRegionResponse
 
 using MakeBucketResponse = Response;
@@ -97,6 +90,8 @@ struct ListBucketsResponse : public Response {
 
   ListBucketsResponse(const Response& resp) : Response(resp) {}
 
+  ListBucketsResponse(Response&& resp) : Response(std::move(resp)) {}
+
   static ListBucketsResponse ParseXML(std::string_view data);
 };  // struct ListBucketsResponse
 
@@ -108,6 +103,8 @@ struct BucketExistsResponse : public Response {
   BucketExistsResponse(error::Error err) : Response(err) {}
 
   BucketExistsResponse(const Response& resp) : Response(resp) {}
+
+  BucketExistsResponse(Response&& resp) : Response(std::move(resp)) {}
 };  // struct BucketExistsResponse
 
 using RemoveBucketResponse = Response;
@@ -125,6 +122,9 @@ struct CompleteMultipartUploadResponse : public Response {
 
   CompleteMultipartUploadResponse(const Response& resp) : Response(resp) {}
 
+  CompleteMultipartUploadResponse(Response&& resp)
+      : Response(std::move(resp)) {}
+
   static CompleteMultipartUploadResponse ParseXML(std::string_view data,
                                                   std::string version_id);
 };  // struct CompleteMultipartUploadResponse
@@ -139,6 +139,8 @@ struct CreateMultipartUploadResponse : public Response {
   CreateMultipartUploadResponse(error::Error err) : Response(err) {}
 
   CreateMultipartUploadResponse(const Response& resp) : Response(resp) {}
+
+  CreateMultipartUploadResponse(Response&& resp) : Response(std::move(resp)) {}
 };  // struct CreateMultipartUploadResponse
 
 struct PutObjectResponse : public Response {
@@ -149,6 +151,8 @@ struct PutObjectResponse : public Response {
 
   PutObjectResponse(const Response& resp) : Response(resp) {}
 
+  PutObjectResponse(Response&& resp) : Response(std::move(resp)) {}
+
   PutObjectResponse(error::Error err) : Response(err) {}
 };  // struct PutObjectResponse
 
@@ -172,6 +176,8 @@ struct StatObjectResponse : public Response {
   StatObjectResponse(error::Error err) : Response(err) {}
 
   StatObjectResponse(const Response& resp) : Response(resp) {}
+
+  StatObjectResponse(Response&& resp) : Response(std::move(resp)) {}
 };  // struct StatObjectResponse
 
 using RemoveObjectResponse = Response;
@@ -200,6 +206,8 @@ struct Item : public Response {
   Item(error::Error err) : Response(err) {}
 
   Item(const Response& resp) : Response(resp) {}
+
+  Item(Response&& resp) : Response(std::move(resp)) {}
 };  // struct Item
 
 struct ListObjectsResponse : public Response {
@@ -208,8 +216,8 @@ struct ListObjectsResponse : public Response {
   std::string encoding_type;
   std::string prefix;
   std::string delimiter;
-  bool is_truncated;
-  unsigned int max_keys;
+  bool is_truncated = false;
+  unsigned int max_keys = 0;
   std::list<Item> contents;
 
   // ListObjectsV1
@@ -217,7 +225,7 @@ struct ListObjectsResponse : public Response {
   std::string next_marker;
 
   // ListObjectsV2
-  unsigned int key_count;
+  unsigned int key_count = 0;
   std::string start_after;
   std::string continuation_token;
   std::string next_continuation_token;
@@ -234,6 +242,8 @@ struct ListObjectsResponse : public Response {
 
   ListObjectsResponse(const Response& resp) : Response(resp) {}
 
+  ListObjectsResponse(Response&& resp) : Response(std::move(resp)) {}
+
   static ListObjectsResponse ParseXML(std::string_view data, bool version);
 };  // struct ListObjectsResponse
 
@@ -246,7 +256,7 @@ using UploadObjectResponse = PutObjectResponse;
 struct DeletedObject : public Response {
   std::string name;
   std::string version_id;
-  bool delete_marker;
+  bool delete_marker = false;
   std::string delete_marker_version_id;
 };  // struct DeletedObject
 
@@ -258,6 +268,8 @@ struct DeleteError : public Response {
   DeleteError(error::Error err) : Response(err) {}
 
   DeleteError(const Response& resp) : Response(resp) {}
+
+  DeleteError(Response&& resp) : Response(std::move(resp)) {}
 };  // struct DeleteError
 
 struct RemoveObjectsResponse : public Response {
@@ -270,6 +282,8 @@ struct RemoveObjectsResponse : public Response {
 
   RemoveObjectsResponse(const Response& resp) : Response(resp) {}
 
+  RemoveObjectsResponse(Response&& resp) : Response(std::move(resp)) {}
+
   static RemoveObjectsResponse ParseXML(std::string_view data);
 };  // struct RemoveObjectsResponse
 
@@ -287,6 +301,8 @@ struct GetBucketPolicyResponse : public Response {
   GetBucketPolicyResponse(error::Error err) : Response(err) {}
 
   GetBucketPolicyResponse(const Response& resp) : Response(resp) {}
+
+  GetBucketPolicyResponse(Response&& resp) : Response(std::move(resp)) {}
 };  // struct GetBucketPolicyResponse
 
 using SetBucketPolicyResponse = Response;
@@ -304,6 +320,8 @@ struct GetBucketNotificationResponse : public Response {
 
   GetBucketNotificationResponse(const Response& resp) : Response(resp) {}
 
+  GetBucketNotificationResponse(Response&& resp) : Response(std::move(resp)) {}
+
   static GetBucketNotificationResponse ParseXML(std::string_view data);
 };  // struct GetBucketNotificationResponse
 
@@ -320,6 +338,8 @@ struct GetBucketEncryptionResponse : public Response {
 
   GetBucketEncryptionResponse(const Response& resp) : Response(resp) {}
 
+  GetBucketEncryptionResponse(Response&& resp) : Response(std::move(resp)) {}
+
   static GetBucketEncryptionResponse ParseXML(std::string_view data);
 };  // struct GetBucketEncryptionResponse
 
@@ -335,6 +355,8 @@ struct GetBucketVersioningResponse : public Response {
 
   GetBucketVersioningResponse(const Response& resp) : Response(resp) {}
 
+  GetBucketVersioningResponse(Response&& resp) : Response(std::move(resp)) {}
+
   std::string Status() {
     if (!status) return "Off";
     return status.Get() ? "Enabled" : "Suspended";
@@ -343,6 +365,8 @@ struct GetBucketVersioningResponse : public Response {
     if (!mfa_delete) return "";
     return mfa_delete.Get() ? "Enabled" : "Disabled";
   }
+
+  static GetBucketVersioningResponse ParseXML(std::string_view data);
 };  // struct GetBucketVersioningResponse
 
 using SetBucketVersioningResponse = Response;
@@ -360,6 +384,8 @@ struct GetBucketReplicationResponse : public Response {
 
   GetBucketReplicationResponse(const Response& resp) : Response(resp) {}
 
+  GetBucketReplicationResponse(Response&& resp) : Response(std::move(resp)) {}
+
   static GetBucketReplicationResponse ParseXML(std::string_view data);
 };  // struct GetBucketReplicationResponse
 
@@ -376,6 +402,8 @@ struct GetBucketLifecycleResponse : public Response {
 
   GetBucketLifecycleResponse(const Response& resp) : Response(resp) {}
 
+  GetBucketLifecycleResponse(Response&& resp) : Response(std::move(resp)) {}
+
   static GetBucketLifecycleResponse ParseXML(std::string_view data);
 };  // struct GetBucketLifecycleResponse
 
@@ -394,6 +422,8 @@ struct GetBucketTagsResponse : public Response {
 
   GetBucketTagsResponse(const Response& resp) : Response(resp) {}
 
+  GetBucketTagsResponse(Response&& resp) : Response(std::move(resp)) {}
+
   static GetBucketTagsResponse ParseXML(std::string_view data);
 };  // struct GetBucketTagsResponse
 
@@ -411,6 +441,10 @@ struct GetObjectLockConfigResponse : public Response {
   GetObjectLockConfigResponse(error::Error err) : Response(err) {}
 
   GetObjectLockConfigResponse(const Response& resp) : Response(resp) {}
+
+  GetObjectLockConfigResponse(Response&& resp) : Response(std::move(resp)) {}
+
+  static GetObjectLockConfigResponse ParseXML(std::string_view data);
 };  // struct GetObjectLockConfigResponse
 
 using SetObjectLockConfigResponse = Response;
@@ -428,6 +462,8 @@ struct GetObjectTagsResponse : public Response {
 
   GetObjectTagsResponse(const Response& resp) : Response(resp) {}
 
+  GetObjectTagsResponse(Response&& resp) : Response(std::move(resp)) {}
+
   static GetObjectTagsResponse ParseXML(std::string_view data);
 };  // struct GetObjectTagsResponse
 
@@ -445,6 +481,9 @@ struct IsObjectLegalHoldEnabledResponse : public Response {
   IsObjectLegalHoldEnabledResponse(error::Error err) : Response(err) {}
 
   IsObjectLegalHoldEnabledResponse(const Response& resp) : Response(resp) {}
+
+  IsObjectLegalHoldEnabledResponse(Response&& resp)
+      : Response(std::move(resp)) {}
 };  // struct IsObjectLegalHoldEnabledResponse
 
 struct GetObjectRetentionResponse : public Response {
@@ -456,6 +495,10 @@ struct GetObjectRetentionResponse : public Response {
   GetObjectRetentionResponse(error::Error err) : Response(err) {}
 
   GetObjectRetentionResponse(const Response& resp) : Response(resp) {}
+
+  GetObjectRetentionResponse(Response&& resp) : Response(std::move(resp)) {}
+
+  static GetObjectRetentionResponse ParseXML(std::string_view data);
 };  // struct GetObjectRetentionResponse
 
 using SetObjectRetentionResponse = Response;
@@ -468,6 +511,8 @@ struct GetPresignedObjectUrlResponse : public Response {
   GetPresignedObjectUrlResponse(error::Error err) : Response(err) {}
 
   GetPresignedObjectUrlResponse(const Response& resp) : Response(resp) {}
+
+  GetPresignedObjectUrlResponse(Response&& resp) : Response(std::move(resp)) {}
 };  // struct GetPresignedObjectUrlResponse
 
 struct GetPresignedPostFormDataResponse : public Response {
@@ -481,6 +526,9 @@ struct GetPresignedPostFormDataResponse : public Response {
   GetPresignedPostFormDataResponse(error::Error err) : Response(err) {}
 
   GetPresignedPostFormDataResponse(const Response& resp) : Response(resp) {}
+
+  GetPresignedPostFormDataResponse(Response&& resp)
+      : Response(std::move(resp)) {}
 };  // struct GetPresignedPostFormDataResponse
 }  // namespace s3
 }  // namespace minio
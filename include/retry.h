@@ -0,0 +1,55 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_S3_RETRY_H
+#define _MINIO_S3_RETRY_H
+
+#include <atomic>
+#include <chrono>
+
+#include "http.h"
+#include "response.h"
+
+namespace minio {
+namespace s3 {
+/**
+ * RetryPolicy controls retries of failed requests. A request is retried when
+ * it fails with a network error, a throttling or server side HTTP status, or
+ * a transient S3 error code, at most max_retries times per operation. Delay
+ * before n-th retry is drawn uniformly from zero to base_delay * 2^(n-1),
+ * capped at max_delay ("full jitter").
+ */
+struct RetryPolicy {
+  unsigned int max_retries = 5;  // Zero disables retries.
+  std::chrono::milliseconds base_delay{100};
+  std::chrono::milliseconds max_delay{10000};
+
+  bool IsRetryable(http::Response& http_response, Response& response);
+  std::chrono::milliseconds Backoff(unsigned int retry);
+};  // struct RetryPolicy
+
+/**
+ * RetryMetrics counts request attempts and retries of a client.
+ */
+struct RetryMetrics {
+  std::atomic<unsigned long> attempts = 0;   // Requests sent including retries.
+  std::atomic<unsigned long> retries = 0;    // Requests sent again on failure.
+  std::atomic<unsigned long> resumes = 0;    // Retries resuming a GET body.
+  std::atomic<unsigned long> exhausted = 0;  // Operations out of retries.
+};  // struct RetryMetrics
+}  // namespace s3
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_S3_RETRY_H
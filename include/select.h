@@ -16,8 +16,6 @@
 #ifndef _MINIO_S3_SELECT_H
 #define _MINIO_S3_SELECT_H
 
-#include <pugixml.hpp>
-
 #include "http.h"
 #include "types.h"
 
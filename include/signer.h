@@ -42,19 +42,23 @@ std::string GetAuthorization(std::string& access_key, std::string& scope,
                              std::string& signature);
 utils::Multimap& SignV4(std::string& service_name, http::Method& method,
                         std::string& uri, std::string& region,
-                        utils::Multimap& headers, utils::Multimap& query_params,
+                        utils::Multimap& headers,
+                        const utils::Multimap& query_params,
                         std::string& access_key, std::string& secret_key,
-                        std::string& content_sha256, utils::Time& date);
+                        std::string& content_sha256, utils::Time& date,
+                        std::pmr::memory_resource* memory = NULL);
 utils::Multimap& SignV4S3(http::Method method, std::string& uri,
                           std::string& region, utils::Multimap& headers,
-                          utils::Multimap query_params, std::string& access_key,
-                          std::string& secret_key, std::string& content_sha256,
-                          utils::Time& date);
+                          const utils::Multimap& query_params,
+                          std::string& access_key, std::string& secret_key,
+                          std::string& content_sha256, utils::Time& date,
+                          std::pmr::memory_resource* memory = NULL);
 utils::Multimap& SignV4STS(http::Method method, std::string& uri,
                            std::string& region, utils::Multimap& headers,
-                           utils::Multimap query_params,
+                           const utils::Multimap& query_params,
                            std::string& access_key, std::string& secret_key,
-                           std::string& content_sha256, utils::Time& date);
+                           std::string& content_sha256, utils::Time& date,
+                           std::pmr::memory_resource* memory = NULL);
 utils::Multimap& PresignV4(http::Method method, std::string& host,
                            std::string& uri, std::string& region,
                            utils::Multimap& query_params,
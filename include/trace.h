@@ -0,0 +1,163 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_S3_TRACE_H
+#define _MINIO_S3_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "http.h"
+
+namespace minio {
+namespace s3 {
+/**
+ * Span is the trace of one request attempt, split into phases. Network
+ * phases come from libcurl timings of the attempt.
+ */
+struct Span {
+  std::string api;
+  std::string bucket;
+  std::string object;
+  std::string method;
+  unsigned int attempt = 1;  // 1 for the first attempt.
+  int status_code = 0;
+  std::string error;  // S3 error code or transfer error.
+  std::string request_id;
+  bool hedged = false;
+  bool reused_connection = false;
+  size_t bytes_sent = 0;
+  size_t bytes_received = 0;
+  std::chrono::system_clock::time_point start;
+
+  std::chrono::microseconds sign{0};      // Payload hash and signature.
+  std::chrono::microseconds dns{0};       // Name resolution.
+  std::chrono::microseconds connect{0};   // TCP connect.
+  std::chrono::microseconds tls{0};       // TLS handshake.
+  std::chrono::microseconds ttfb{0};      // Request sent to first byte.
+  std::chrono::microseconds transfer{0};  // First byte to last byte.
+  std::chrono::microseconds parse{0};     // Response handling after transfer.
+  std::chrono::microseconds total{0};
+};  // struct Span
+
+/**
+ * SpanSink receives spans of finished request attempts. Export() is called
+ * concurrently from every thread using the client.
+ */
+class SpanSink {
+ public:
+  virtual ~SpanSink() {}
+
+  virtual void Export(const Span& span) = 0;
+};  // class SpanSink
+
+/**
+ * RingBufferSink keeps the last capacity sampled spans in memory. Spans
+ * taking at least slow_threshold are always kept; others are kept with
+ * probability sample_rate.
+ */
+class RingBufferSink : public SpanSink {
+ private:
+  std::mutex mutex_;
+  std::vector<Span> spans_;
+  size_t next_ = 0;
+  size_t capacity_;
+  double sample_rate_;
+  std::chrono::microseconds slow_threshold_;
+
+ public:
+  RingBufferSink(size_t capacity = 1024, double sample_rate = 0.01,
+                 std::chrono::microseconds slow_threshold =
+                     std::chrono::seconds(1));
+
+  void Export(const Span& span) override;
+
+  // Spans returns kept spans, oldest first.
+  std::vector<Span> Spans();
+  void Clear();
+};  // class RingBufferSink
+
+/**
+ * TraceRecord is a request attempt kept in a trace file. Object names are
+ * kept only as hashes and payloads are not kept.
+ */
+struct TraceRecord {
+  std::string api;
+  std::string bucket;
+  uint64_t key_hash = 0;  // KeyHash() of object name; zero without object.
+  http::Method method = http::Method::kGet;
+  unsigned int attempt = 1;
+  int status_code = 0;        // Zero on network error.
+  size_t request_bytes = 0;   // Request body bytes.
+  size_t response_bytes = 0;  // Content-Length of response.
+  std::chrono::system_clock::time_point start;
+  std::chrono::microseconds duration{0};
+};  // struct TraceRecord
+
+/**
+ * TraceRecorder writes request attempts to a compact binary trace file read
+ * by TraceReader. Numbers are varint encoded and each API and bucket name is
+ * written once, so a record takes about 25 bytes. It is safe to use from
+ * multiple threads.
+ */
+class TraceRecorder {
+ private:
+  std::mutex mutex_;
+  std::ofstream file_;
+  std::chrono::system_clock::time_point start_;
+  std::map<std::string, unsigned int, std::less<>> names_;
+
+  unsigned int name(std::string_view value);
+
+ public:
+  TraceRecorder() {}
+  ~TraceRecorder();
+
+  // Open creates or truncates trace file.
+  error::Error Open(std::string filename);
+  void Record(const TraceRecord& record);
+  void Close();
+
+  // KeyHash returns 64-bit FNV-1a hash of object name.
+  static uint64_t KeyHash(std::string_view key);
+};  // class TraceRecorder
+
+/**
+ * TraceReader reads a trace file written by TraceRecorder.
+ */
+class TraceReader {
+ private:
+  std::ifstream file_;
+  std::chrono::system_clock::time_point start_;
+  std::vector<std::string> names_;
+
+ public:
+  TraceReader() {}
+
+  error::Error Open(std::string filename);
+
+  // Next reads next record. It returns false at end of the trace or on a
+  // malformed entry.
+  bool Next(TraceRecord& record);
+};  // class TraceReader
+}  // namespace s3
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_S3_TRACE_H
@@ -16,10 +16,12 @@
 #ifndef _MINIO_S3_TYPES_H
 #define _MINIO_S3_TYPES_H
 
+#include <chrono>
 #include <iostream>
 #include <nlohmann/json.hpp>
 
 #include "utils.h"
+#include "xml.h"
 
 namespace minio {
 namespace s3 {
@@ -266,6 +268,7 @@ struct SelectRequest {
   }
 
   std::string ToXML();
+  void ToXML(xml::Writer& writer);
 };  // struct SelectRequest
 
 struct SelectResult {
@@ -317,6 +320,26 @@ struct DeleteObject {
   std::string version_id;
 };  // struct DeleteObject
 
+/**
+ * RemoveObjectsProgress is progress of Client::RemoveObjects() or
+ * Client::RemovePrefix(), reported after each batch is sent.
+ */
+struct RemoveObjectsProgress {
+  size_t pulled = 0;   // Objects taken from func or listing.
+  size_t removed = 0;  // Objects removed.
+  size_t failed = 0;   // Objects failed to remove.
+  std::chrono::steady_clock::duration elapsed{};
+
+  // Throughput returns objects removed per second.
+  double Throughput() const {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? removed / seconds : 0;
+  }
+};  // struct RemoveObjectsProgress
+
+using RemoveObjectsProgressFunction =
+    std::function<void(RemoveObjectsProgress)>;
+
 struct NotificationRecord {
   std::string event_version;
   std::string event_source;
@@ -422,6 +445,7 @@ struct NotificationConfig {
   std::list<TopicConfig> topic_config_list;
 
   std::string ToXML();
+  void ToXML(xml::Writer& writer);
 };  // struct NotificationConfig
 
 struct SseConfig {
@@ -508,6 +532,8 @@ struct Filter {
   Tag tag;
 
   operator bool() const { return and_operator ^ prefix ^ tag; }
+
+  void ToXML(xml::Writer& writer);
 };  // struct Filter
 
 struct AccessControlTranslation {
@@ -590,6 +616,7 @@ struct ReplicationConfig {
   std::list<ReplicationRule> rules;
 
   std::string ToXML();
+  void ToXML(xml::Writer& writer);
 };  // status ReplicationConfig
 
 struct LifecycleRule {
@@ -614,6 +641,7 @@ struct LifecycleConfig {
   std::list<LifecycleRule> rules;
 
   std::string ToXML();
+  void ToXML(xml::Writer& writer);
 };  // struct LifecycleConfig
 
 struct ObjectLockConfig {
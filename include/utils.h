@@ -32,6 +32,7 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory_resource>
 #include <regex>
 #include <set>
 #include <sstream>
@@ -94,7 +95,7 @@ std::string Join(std::list<std::string> values, std::string delimiter);
 std::string Join(std::vector<std::string> values, std::string delimiter);
 
 // EncodePath does URL encoding of path. It also normalizes multiple slashes.
-std::string EncodePath(std::string& path);
+std::string EncodePath(const std::string& path);
 
 // Sha256hash computes SHA-256 of data and return hash as hex encoded value.
 std::string Sha256Hash(std::string_view str);
@@ -150,9 +151,44 @@ class Time {
     return t;
   }
 
-  operator bool() const { return tv_.tv_sec != 0 && tv_.tv_usec != 0; }
+  std::time_t ToEpochSeconds() const { return tv_.tv_sec; }
+
+  bool operator<(const Time& rhs) const {
+    return tv_.tv_sec < rhs.tv_.tv_sec ||
+           (tv_.tv_sec == rhs.tv_.tv_sec && tv_.tv_usec < rhs.tv_.tv_usec);
+  }
+
+  operator bool() const { return tv_.tv_sec != 0 || tv_.tv_usec != 0; }
 };  // class Time
 
+/**
+ * Arena is a monotonic memory resource for short lived strings and
+ * containers built while sending a request. Allocations are served from an
+ * inline buffer first and then from blocks of upstream resource; all of them
+ * are freed at once by Release() or destruction.
+ */
+class Arena {
+ public:
+  static constexpr size_t kInlineSize = 4096;
+
+  explicit Arena(std::pmr::memory_resource* upstream = NULL)
+      : resource_(buffer_, sizeof(buffer_),
+                  upstream != NULL ? upstream
+                                   : std::pmr::get_default_resource()) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  std::pmr::memory_resource* Resource() { return &resource_; }
+
+  // Release frees every allocation so that the arena may be used again.
+  void Release() { resource_.release(); }
+
+ private:
+  alignas(std::max_align_t) char buffer_[kInlineSize];
+  std::pmr::monotonic_buffer_resource resource_;
+};  // class Arena
+
 /**
  * Multimap represents dictionary of keys and their multiple values.
  */
@@ -164,30 +200,46 @@ class Multimap {
  public:
   Multimap() {}
 
-  Multimap(const Multimap& headers) { this->AddAll(headers); }
+  Multimap(const Multimap&) = default;
+  Multimap(Multimap&&) = default;
+  Multimap& operator=(const Multimap&) = default;
+  Multimap& operator=(Multimap&&) = default;
 
   void Add(std::string key, std::string value);
 
   void AddAll(const Multimap& headers);
 
-  std::list<std::string> ToHttpHeaders();
+  // AddAll takes over entries of headers when this map is empty instead of
+  // copying them.
+  void AddAll(Multimap&& headers);
 
-  std::string ToQueryString();
+  std::list<std::string> ToHttpHeaders() const;
+
+  std::string ToQueryString() const;
 
   operator bool() const { return !map_.empty(); }
 
-  bool Contains(std::string_view key);
+  bool Contains(std::string_view key) const;
+
+  std::list<std::string> Get(std::string_view key) const;
 
-  std::list<std::string> Get(std::string_view key);
+  std::string GetFront(std::string_view key) const;
 
-  std::string GetFront(std::string_view key);
+  void Remove(std::string_view key);
 
-  std::list<std::string> Keys();
+  std::list<std::string> Keys() const;
 
   void GetCanonicalHeaders(std::string& signed_headers,
-                           std::string& canonical_headers);
+                           std::string& canonical_headers) const;
+
+  // GetCanonicalHeaders allocates from memory resource of signed_headers.
+  void GetCanonicalHeaders(std::pmr::string& signed_headers,
+                           std::pmr::string& canonical_headers) const;
+
+  std::string GetCanonicalQueryString() const;
 
-  std::string GetCanonicalQueryString();
+  std::pmr::string GetCanonicalQueryString(
+      std::pmr::memory_resource* memory) const;
 };  // class Multimap
 
 /**
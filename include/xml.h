@@ -0,0 +1,310 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_XML_H
+#define _MINIO_XML_H
+
+#include <charconv>
+#include <list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "utils.h"
+
+namespace minio {
+namespace xml {
+/**
+ * Reader is a pull parser reading elements of an XML document in place.
+ * Names and text are views into the document, except text having entity
+ * references or CDATA sections, which is decoded into a buffer of the
+ * reader. Attributes, comments, processing instructions and whitespace-only
+ * text are skipped.
+ */
+class Reader {
+ public:
+  enum class Token { kStart, kEnd, kEof, kError };
+
+  explicit Reader(std::string_view data) : data_(data) {}
+
+  // Next reads up to next start or end tag. An empty element <a/> is read as
+  // a start and an end tag.
+  Token Next();
+
+  // Name returns name of the current element.
+  std::string_view Name() const { return name_; }
+
+  // Path returns names of the current element and its ancestors joined by
+  // '/', e.g. "ListBucketResult/Contents/Key".
+  std::string_view Path() const { return path_; }
+
+  // Text returns decoded text of the element ended by the current end tag.
+  std::string_view Text() const { return text_; }
+
+ private:
+  std::string_view data_;
+  size_t pos_ = 0;
+  std::string_view name_;
+  std::string path_;
+  std::string_view text_;
+  std::string buffer_;  // Text which is not a plain view of the document.
+  bool buffered_ = false;
+  bool empty_element_ = false;  // Current start tag is of <a/>.
+  bool pop_ = false;            // Current end tag is still on path_.
+
+  void addText(std::string_view raw, bool cdata);
+};  // class Reader
+
+// Unescape appends text with entity references replaced to out.
+void Unescape(std::string_view text, std::string& out);
+
+void Assign(std::string& value, std::string_view text);
+void Assign(bool& value, std::string_view text);
+void Assign(utils::Time& value, std::string_view text);
+
+// Assign parses decimal number; invalid or empty text leaves value as is.
+template <typename T>
+std::enable_if_t<std::is_integral_v<T>> Assign(T& value,
+                                               std::string_view text);
+
+// Int and Bool convert text for members whose type is constructed from
+// them, like s3::Integer and s3::Boolean.
+int Int(std::string_view text);
+bool Bool(std::string_view text);
+std::string String(std::string_view text);
+utils::Time Time(std::string_view text);
+
+/**
+ * Field maps an element to a member of T. Path of the element is relative to
+ * the element being decoded, like "Owner/ID". A text field gets the text of
+ * the element when it ends, and also sees empty elements, so it may record
+ * their presence. An element field is called at the start tag and reads the
+ * element up to its end tag itself.
+ *
+ * Fields of a response are kept in a constexpr table, so that decoding looks
+ * up elements without building a DOM or evaluating XPath.
+ */
+template <typename T>
+struct Field {
+  std::string_view path;
+  void (*text)(T& obj, std::string_view text) = NULL;
+  bool (*element)(T& obj, Reader& reader) = NULL;
+};  // struct Field
+
+template <typename T, typename... Tables>
+bool Decode(Reader& reader, T& obj, const Tables&... tables);
+
+// Set assigns text to a member, converted by Convert if given.
+template <typename T, auto Member, auto Convert = nullptr>
+void Set(T& obj, std::string_view text) {
+  if constexpr (std::is_same_v<decltype(Convert), std::nullptr_t>) {
+    Assign(obj.*Member, text);
+  } else {
+    obj.*Member = Convert(text);
+  }
+}
+
+// Append decodes the element by Tables and appends it to a list member.
+template <typename T, typename C, std::list<C> T::*Member,
+          const auto&... Tables>
+bool Append(T& obj, Reader& reader) {
+  C child;
+  if (!Decode(reader, child, Tables...)) return false;
+  (obj.*Member).push_back(std::move(child));
+  return true;
+}
+
+// Into decodes the element by Tables into a member.
+template <typename T, typename C, C T::*Member, const auto&... Tables>
+bool Into(T& obj, Reader& reader) {
+  return Decode(reader, obj.*Member, Tables...);
+}
+
+// Children calls func with name and text of each child element having no
+// children itself.
+template <typename Func>
+bool Children(Reader& reader, Func func) {
+  size_t base = reader.Path().size() + 1;
+  size_t depth = 0;
+  while (true) {
+    switch (reader.Next()) {
+      case Reader::Token::kStart:
+        depth++;
+        break;
+      case Reader::Token::kEnd:
+        if (reader.Path().size() < base) return true;
+        if (depth-- == 1) func(reader.Name(), reader.Text());
+        break;
+      default:
+        return false;
+    }
+  }
+}
+
+namespace internal {
+template <typename T, typename U, size_t N>
+bool callText(const Field<U> (&table)[N], T& obj, std::string_view path,
+              std::string_view text) {
+  for (const Field<U>& field : table) {
+    if (field.text != NULL && field.path == path) {
+      field.text(obj, text);
+      return true;
+    }
+  }
+  return false;
+}
+
+// callElement returns 1 if an element field read the element, 0 if there is
+// none for path, and -1 on error.
+template <typename T, typename U, size_t N>
+int callElement(const Field<U> (&table)[N], T& obj, std::string_view path,
+                Reader& reader) {
+  for (const Field<U>& field : table) {
+    if (field.element != NULL && field.path == path) {
+      return field.element(obj, reader) ? 1 : -1;
+    }
+  }
+  return 0;
+}
+}  // namespace internal
+
+// Decode reads the current element up to its end tag into obj by fields of
+// tables. Tables may have fields of base classes of T.
+template <typename T, typename... Tables>
+bool Decode(Reader& reader, T& obj, const Tables&... tables) {
+  size_t base = reader.Path().size() + 1;
+  while (true) {
+    switch (reader.Next()) {
+      case Reader::Token::kStart: {
+        std::string_view path = reader.Path().substr(base);
+        int found = 0;
+        ((found = found != 0 ? found
+                             : internal::callElement(tables, obj, path,
+                                                     reader)),
+         ...);
+        if (found < 0) return false;
+        break;
+      }
+      case Reader::Token::kEnd: {
+        if (reader.Path().size() < base) return true;
+        std::string_view path = reader.Path().substr(base);
+        (internal::callText(tables, obj, path, reader.Text()) || ...);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+}
+
+// Decode reads document whose root element is root into obj. A document
+// having another root element leaves obj as is.
+template <typename T, typename... Tables>
+error::Error Decode(std::string_view data, std::string_view root, T& obj,
+                    const Tables&... tables) {
+  Reader reader(data);
+  if (reader.Next() != Reader::Token::kStart) {
+    return error::Error("unable to parse XML");
+  }
+  if (reader.Name() != root) return error::SUCCESS;
+  if (!Decode(reader, obj, tables...)) {
+    return error::Error("unable to parse XML");
+  }
+  return error::SUCCESS;
+}
+
+// Value assigns text of the element at path, like "LegalHold/Status", to
+// value. A document without the element leaves value as is.
+error::Error Value(std::string_view data, std::string_view path,
+                   std::string& value);
+
+/**
+ * Body is an XML request body with its MD5 (Base64 encoded, for Content-MD5)
+ * and SHA-256 (hex encoded, for x-amz-content-sha256).
+ */
+struct Body {
+  std::string data;
+  std::string md5sum;
+  std::string sha256;
+};  // struct Body
+
+/**
+ * Writer writes an XML document into a buffer reserved up front. Text is
+ * escaped as it is written. MD5 and SHA-256 of the document are updated
+ * with every few kilobytes written, while those bytes are still in cache,
+ * so that the body need not be read again to be hashed.
+ */
+class Writer {
+ public:
+  // Bytes written between digest updates.
+  static constexpr size_t kHashChunk = 8 * 1024;
+
+  explicit Writer(size_t capacity = 0, bool hash = true);
+  ~Writer();
+
+  Writer(const Writer&) = delete;
+  Writer& operator=(const Writer&) = delete;
+
+  // Start writes start tag of element.
+  Writer& Start(std::string_view name);
+
+  // End writes end tag of element.
+  Writer& End(std::string_view name);
+
+  // Text writes escaped text.
+  Writer& Text(std::string_view text);
+
+  // Element writes element having escaped text.
+  Writer& Element(std::string_view name, std::string_view text);
+  Writer& Element(std::string_view name, char text) {
+    return Element(name, std::string_view(&text, 1));
+  }
+
+  // Element writes element having decimal number.
+  template <typename T>
+  std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                       !std::is_same_v<T, char>,
+                   Writer&>
+  Element(std::string_view name, T value) {
+    char buf[24];
+    auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    return Element(name, std::string_view(buf, ptr - buf));
+  }
+
+  // Finish returns the document and its hashes, which are empty if the
+  // writer was made without hashing. The writer is not usable afterwards.
+  Body Finish();
+
+ private:
+  std::string data_;
+  size_t hashed_ = 0;  // Bytes of data_ given to digests.
+  EVP_MD_CTX* md5_ = NULL;
+  EVP_MD_CTX* sha256_ = NULL;
+
+  void update(bool force = false);
+};  // class Writer
+
+template <typename T>
+std::enable_if_t<std::is_integral_v<T>> Assign(T& value,
+                                               std::string_view text) {
+  T result;
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(),
+                                   result);
+  if (ec == std::errc() && ptr == text.data() + text.size()) value = result;
+}
+}  // namespace xml
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_XML_H
@@ -0,0 +1,1078 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mockserver.h"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <pugixml.hpp>
+#include <random>
+
+namespace {
+constexpr size_t kMaxHeaderSize = 64 * 1024;
+constexpr size_t kChunkSize = 64 * 1024;
+const char* kXmlHeader = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+const char* kXmlns = " xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\"";
+
+double Random() {
+  thread_local static std::minstd_rand rg{std::random_device{}()};
+  return std::uniform_real_distribution<double>(0, 1)(rg);
+}
+
+std::string Hex(const unsigned char* data, size_t size) {
+  static const char* digits = "0123456789abcdef";
+  std::string hex;
+  for (size_t i = 0; i < size; i++) {
+    hex += digits[data[i] >> 4];
+    hex += digits[data[i] & 0xf];
+  }
+  return hex;
+}
+
+std::string Md5Hex(std::string_view data) {
+  unsigned char hash[EVP_MAX_MD_SIZE];
+  unsigned int length = 0;
+  EVP_Digest(data.data(), data.size(), hash, &length, EVP_md5(), NULL);
+  return Hex(hash, length);
+}
+
+std::string Decode(std::string_view str) {
+  std::string decoded;
+  for (size_t i = 0; i < str.size(); i++) {
+    if (str[i] == '%' && i + 2 < str.size() && isxdigit(str[i + 1]) &&
+        isxdigit(str[i + 2])) {
+      decoded += char(std::stoi(std::string(str.substr(i + 1, 2)), NULL, 16));
+      i += 2;
+    } else {
+      decoded += str[i];
+    }
+  }
+  return decoded;
+}
+
+// Encode does URL encoding as done for encoding-type=url listings.
+std::string Encode(std::string_view str) {
+  static const char* digits = "0123456789ABCDEF";
+  std::string encoded;
+  for (unsigned char ch : str) {
+    if (isalnum(ch) || ch == '-' || ch == '_' || ch == '.' || ch == '~' ||
+        ch == '/') {
+      encoded += ch;
+    } else {
+      encoded += '%';
+      encoded += digits[ch >> 4];
+      encoded += digits[ch & 0xf];
+    }
+  }
+  return encoded;
+}
+
+std::string Escape(std::string_view str) {
+  std::string escaped;
+  for (char ch : str) {
+    switch (ch) {
+      case '&':
+        escaped += "&amp;";
+        break;
+      case '<':
+        escaped += "&lt;";
+        break;
+      case '>':
+        escaped += "&gt;";
+        break;
+      case '"':
+        escaped += "&quot;";
+        break;
+      case '\'':
+        escaped += "&apos;";
+        break;
+      default:
+        escaped += ch;
+    }
+  }
+  return escaped;
+}
+
+std::string Element(std::string_view name, std::string_view value) {
+  std::string element = "<" + std::string(name) + ">";
+  element += Escape(value);
+  element += "</" + std::string(name) + ">";
+  return element;
+}
+
+const char* Reason(int status) {
+  switch (status) {
+    case 100:
+      return "Continue";
+    case 200:
+      return "OK";
+    case 204:
+      return "No Content";
+    case 206:
+      return "Partial Content";
+    case 400:
+      return "Bad Request";
+    case 404:
+      return "Not Found";
+    case 409:
+      return "Conflict";
+    case 416:
+      return "Requested Range Not Satisfiable";
+    case 429:
+      return "Too Many Requests";
+    case 500:
+      return "Internal Server Error";
+    case 501:
+      return "Not Implemented";
+    case 503:
+      return "Service Unavailable";
+  }
+  return "Unknown";
+}
+
+// Pace sleeps until bytes transferred since start fit in bandwidth.
+void Pace(size_t bandwidth, std::chrono::steady_clock::time_point start,
+          size_t bytes) {
+  if (bandwidth == 0) return;
+  std::this_thread::sleep_until(
+      start + std::chrono::microseconds(bytes * 1000000 / bandwidth));
+}
+
+void BigEndian(std::string& data, unsigned long value, int bytes) {
+  for (int i = bytes - 1; i >= 0; i--) data += char((value >> (8 * i)) & 0xff);
+}
+
+// EventMessage returns a message of SelectObjectContent event stream.
+std::string EventMessage(std::string_view event_type,
+                         std::string_view content_type,
+                         std::string_view payload) {
+  std::list<std::pair<std::string_view, std::string_view>> headers = {
+      {":message-type", "event"}, {":event-type", event_type}};
+  if (!content_type.empty()) headers.push_back({":content-type", content_type});
+
+  std::string header_data;
+  for (auto& [name, value] : headers) {
+    header_data += char(name.size());
+    header_data += name;
+    header_data += char(7);
+    BigEndian(header_data, value.size(), 2);
+    header_data += value;
+  }
+
+  std::string message;
+  BigEndian(message, 16 + header_data.size() + payload.size(), 4);
+  BigEndian(message, header_data.size(), 4);
+  BigEndian(message, minio::utils::CRC32(message), 4);
+  message += header_data;
+  message += payload;
+  BigEndian(message, minio::utils::CRC32(message), 4);
+  return message;
+}
+}  // namespace
+
+struct minio::mock::Server::Connection {
+  int sock;
+  std::string buffer;  // Received bytes not consumed yet.
+};  // struct Connection
+
+minio::mock::Server::Server(ServerConfig config) : config_(config) {}
+
+minio::mock::Server::~Server() {
+  Stop();
+  for (auto& [name, bucket] : buckets_) {
+    for (auto& [key, object] : bucket.objects) remove(object);
+  }
+  for (auto& [id, upload] : uploads_) {
+    for (auto& [number, part] : upload.parts) remove(part);
+  }
+}
+
+minio::error::Error minio::mock::Server::Start() {
+  if (!config_.data_dir.empty() && mkdir(config_.data_dir.c_str(), 0700) &&
+      errno != EEXIST) {
+    return error::Error("unable to create " + config_.data_dir + "; " +
+                        strerror(errno));
+  }
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(config_.port);
+  if (inet_pton(AF_INET, config_.address.c_str(), &addr.sin_addr) != 1) {
+    return error::Error("invalid address " + config_.address);
+  }
+
+  listener_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (listener_ < 0) {
+    return error::Error(std::string("socket: ") + strerror(errno));
+  }
+  int one = 1;
+  setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  if (bind(listener_, (sockaddr*)&addr, sizeof(addr)) ||
+      listen(listener_, SOMAXCONN)) {
+    std::string msg = std::string("bind: ") + strerror(errno);
+    close(listener_);
+    listener_ = -1;
+    return error::Error(msg);
+  }
+
+  socklen_t length = sizeof(addr);
+  getsockname(listener_, (sockaddr*)&addr, &length);
+  port_ = ntohs(addr.sin_port);
+
+  acceptor_ = std::thread(&Server::accept, this);
+  return error::SUCCESS;
+}
+
+void minio::mock::Server::Stop() {
+  if (stopped_.exchange(true)) return;
+
+  if (listener_ >= 0) shutdown(listener_, SHUT_RDWR);
+  if (acceptor_.joinable()) acceptor_.join();
+  if (listener_ >= 0) close(listener_);
+
+  std::list<std::thread> workers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int sock : sockets_) shutdown(sock, SHUT_RDWR);
+    workers.swap(workers_);
+  }
+  for (auto& worker : workers) worker.join();
+}
+
+void minio::mock::Server::FailNext(unsigned int count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  fail_next_ = count;
+}
+
+void minio::mock::Server::DropNext(unsigned int count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  drop_next_ = count;
+}
+
+minio::mock::ServerStats minio::mock::Server::Stats() {
+  ServerStats stats;
+  stats.connections = connections_;
+  stats.requests = requests_;
+  stats.injected_errors = injected_errors_;
+  stats.dropped = dropped_;
+  stats.bytes_received = bytes_received_;
+  stats.bytes_sent = bytes_sent_;
+  return stats;
+}
+
+void minio::mock::Server::accept() {
+  while (!stopped_) {
+    int sock = ::accept(listener_, NULL, NULL);
+    if (sock < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      break;
+    }
+
+    int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+      close(sock);
+      break;
+    }
+    sockets_.push_back(sock);
+    workers_.emplace_back(&Server::serve, this, sock);
+  }
+}
+
+void minio::mock::Server::serve(int sock) {
+  connections_++;
+  Connection conn{sock};
+  while (!stopped_) {
+    HttpRequest req;
+    if (!read(conn, req)) break;
+
+    unsigned long id = ++requests_;
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016lX", id);
+    req.id = buf;
+
+    HttpResponse resp;
+    if (!inject(req, resp)) resp = handle(req);
+    if (config_.latency.count() > 0) {
+      std::this_thread::sleep_for(config_.latency);
+    }
+    resp.headers.push_back({"x-amz-request-id", req.id});
+    resp.headers.push_back({"Server", "MinIO"});
+    resp.headers.push_back({"Date", utils::Time::Now().ToHttpHeaderValue()});
+
+    if (!write(conn, resp) || req.headers["connection"] == "close") break;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sockets_.remove(sock);
+  }
+  close(sock);
+}
+
+bool minio::mock::Server::read(Connection& conn, HttpRequest& req) {
+  auto start = std::chrono::steady_clock::now();
+  size_t received = 0;
+  auto receive = [&]() -> bool {
+    char buf[kChunkSize];
+    ssize_t n = recv(conn.sock, buf, sizeof(buf), 0);
+    if (n <= 0) return false;
+    conn.buffer.append(buf, n);
+    bytes_received_ += n;
+    received += n;
+    Pace(config_.bandwidth, start, received);
+    return true;
+  };
+
+  size_t end;
+  while ((end = conn.buffer.find("\r\n\r\n")) == std::string::npos) {
+    if (conn.buffer.size() > kMaxHeaderSize || !receive()) return false;
+  }
+  std::string head = conn.buffer.substr(0, end);
+  conn.buffer.erase(0, end + 4);
+
+  std::istringstream lines(head);
+  std::string line;
+  std::getline(lines, line);
+  std::istringstream request_line(line);
+  std::string version;
+  request_line >> req.method >> req.target >> version;
+  while (std::getline(lines, line)) {
+    size_t pos = line.find(':');
+    if (pos == std::string::npos) continue;
+    req.headers[utils::ToLower(line.substr(0, pos))] =
+        utils::Trim(utils::Trim(line.substr(pos + 1), '\r'));
+  }
+
+  std::string_view target = req.target;
+  size_t pos = target.find('?');
+  std::string path = Decode(target.substr(0, pos));
+  if (pos != std::string_view::npos) {
+    std::string_view query = target.substr(pos + 1);
+    while (!query.empty()) {
+      std::string_view param = query.substr(0, query.find('&'));
+      query.remove_prefix(std::min(query.size(), param.size() + 1));
+      size_t eq = param.find('=');
+      std::string value;
+      if (eq != std::string_view::npos) value = Decode(param.substr(eq + 1));
+      req.query[Decode(param.substr(0, eq))] = value;
+    }
+  }
+  size_t slash = path.find('/', 1);
+  req.bucket = path.substr(1, slash == std::string::npos ? slash : slash - 1);
+  if (slash != std::string::npos) req.object = path.substr(slash + 1);
+
+  if (utils::ToLower(req.headers["expect"]) == "100-continue") {
+    std::string cont = "HTTP/1.1 100 Continue\r\n\r\n";
+    if (send(conn.sock, cont.data(), cont.size(), MSG_NOSIGNAL) < 0) {
+      return false;
+    }
+  }
+
+  if (utils::ToLower(req.headers["transfer-encoding"]) == "chunked") {
+    while (true) {
+      while ((end = conn.buffer.find("\r\n")) == std::string::npos) {
+        if (!receive()) return false;
+      }
+      size_t size = std::stoul(conn.buffer.substr(0, end), NULL, 16);
+      conn.buffer.erase(0, end + 2);
+      while (conn.buffer.size() < size + 2) {
+        if (!receive()) return false;
+      }
+      req.body.append(conn.buffer, 0, size);
+      conn.buffer.erase(0, size + 2);
+      if (size == 0) return true;
+    }
+  }
+
+  size_t length = 0;
+  if (req.headers.count("content-length")) {
+    length = std::stoul(req.headers["content-length"]);
+  }
+  while (conn.buffer.size() < length) {
+    if (!receive()) return false;
+  }
+  req.body = conn.buffer.substr(0, length);
+  conn.buffer.erase(0, length);
+  return true;
+}
+
+bool minio::mock::Server::write(Connection& conn, HttpResponse& resp) {
+  std::string head = "HTTP/1.1 " + std::to_string(resp.status) + " " +
+                     Reason(resp.status) + "\r\n";
+  for (auto& [name, value] : resp.headers) {
+    head += name + ": " + value + "\r\n";
+  }
+  head += "Content-Length: " + std::to_string(resp.length) + "\r\n\r\n";
+
+  auto start = std::chrono::steady_clock::now();
+  size_t sent = 0;
+  auto transmit = [&](const char* data, size_t size) -> bool {
+    while (size > 0) {
+      ssize_t n = send(conn.sock, data, std::min(size, kChunkSize),
+                       MSG_NOSIGNAL);
+      if (n <= 0) return false;
+      bytes_sent_ += n;
+      sent += n;
+      data += n;
+      size -= n;
+      Pace(config_.bandwidth, start, sent);
+    }
+    return true;
+  };
+
+  if (!transmit(head.data(), head.size())) return false;
+  if (resp.head || resp.data == NULL) return true;
+
+  size_t length = resp.drop ? resp.length / 2 : resp.length;
+  if (!transmit(resp.data->data() + resp.offset, length)) return false;
+  return !resp.drop;
+}
+
+bool minio::mock::Server::inject(HttpRequest& req, HttpResponse& resp) {
+  bool fail = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fail_next_ > 0) {
+      fail_next_--;
+      fail = true;
+    }
+  }
+  if (!fail && config_.error_rate > 0) fail = Random() < config_.error_rate;
+  if (!fail) return false;
+
+  injected_errors_++;
+  resp = error(req, config_.error_status, config_.error_code,
+               "Injected error.");
+  return true;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::error(
+    HttpRequest& req, int status, std::string code, std::string message) {
+  std::string resource = "/" + req.bucket;
+  if (!req.object.empty()) resource += "/" + req.object;
+
+  HttpResponse resp = xml("<Error>" + Element("Code", code) +
+                          Element("Message", message) +
+                          Element("Resource", resource) +
+                          Element("RequestId", req.id) +
+                          Element("BucketName", req.bucket) +
+                          Element("Key", req.object) + "</Error>");
+  resp.status = status;
+  resp.head = req.method == "HEAD";
+  return resp;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::xml(std::string body) {
+  HttpResponse resp;
+  resp.headers.push_back({"Content-Type", "application/xml"});
+  resp.data = std::make_shared<const std::string>(kXmlHeader + body);
+  resp.length = resp.data->size();
+  return resp;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::handle(
+    HttpRequest& req) {
+  auto& query = req.query;
+  const std::string& method = req.method;
+
+  if (req.bucket.empty()) {
+    if (method == "GET") return listBuckets();
+  } else if (req.object.empty()) {
+    if (method == "PUT" && query.empty()) return makeBucket(req);
+    if (method == "DELETE" && query.empty()) return removeBucket(req);
+    if (method == "HEAD") {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!buckets_.count(req.bucket)) {
+        return error(req, 404, "NoSuchBucket", "Bucket does not exist.");
+      }
+      HttpResponse resp;
+      resp.head = true;
+      return resp;
+    }
+    if (method == "GET" && query.count("location")) {
+      return xml("<LocationConstraint" + std::string(kXmlns) + ">" +
+                 Escape(config_.region) + "</LocationConstraint>");
+    }
+    if (method == "GET" && query.count("list-type") &&
+        query.at("list-type") == "2") {
+      return listObjectsV2(req);
+    }
+    if (method == "POST" && query.count("delete")) return removeObjects(req);
+  } else {
+    if (method == "PUT" && query.count("uploadId")) return uploadPart(req);
+    if (method == "PUT" && query.empty() &&
+        !req.headers.count("x-amz-copy-source")) {
+      return putObject(req);
+    }
+    if (method == "GET" && query.empty()) {
+      HttpResponse resp = getObject(req, false);
+      if (resp.status / 100 != 2 || resp.length == 0) return resp;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (drop_next_ > 0) {
+          drop_next_--;
+          resp.drop = true;
+        }
+      }
+      if (!resp.drop && config_.drop_rate > 0) {
+        resp.drop = Random() < config_.drop_rate;
+      }
+      if (resp.drop) dropped_++;
+      return resp;
+    }
+    if (method == "HEAD") return getObject(req, true);
+    if (method == "DELETE" && query.count("uploadId")) {
+      return abortMultipartUpload(req);
+    }
+    if (method == "DELETE" && query.empty()) return removeObject(req);
+    if (method == "POST" && query.count("uploads")) {
+      return createMultipartUpload(req);
+    }
+    if (method == "POST" && query.count("uploadId")) {
+      return completeMultipartUpload(req);
+    }
+    if (method == "POST" && query.count("select")) {
+      return selectObjectContent(req);
+    }
+  }
+
+  return error(req, 501, "NotImplemented",
+               "A header you provided implies functionality that is not "
+               "implemented.");
+}
+
+minio::mock::Server::Object minio::mock::Server::store(std::string data) {
+  Object object;
+  object.size = data.size();
+  object.etag = Md5Hex(data);
+  object.last_modified = utils::Time::Now();
+  if (config_.data_dir.empty()) {
+    object.data = std::make_shared<const std::string>(std::move(data));
+    return object;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    object.file = config_.data_dir + "/" + std::to_string(next_id_++);
+  }
+  std::ofstream file(object.file, std::ios::binary | std::ios::trunc);
+  file.write(data.data(), data.size());
+  return object;
+}
+
+std::shared_ptr<const std::string> minio::mock::Server::load(
+    const Object& object) {
+  if (object.data != NULL) return object.data;
+
+  std::string data(object.size, '\0');
+  std::ifstream file(object.file, std::ios::binary);
+  file.read(data.data(), data.size());
+  return std::make_shared<const std::string>(std::move(data));
+}
+
+void minio::mock::Server::remove(const Object& object) {
+  if (!object.file.empty()) std::remove(object.file.c_str());
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::listBuckets() {
+  std::string body = "<ListAllMyBucketsResult" + std::string(kXmlns) +
+                     "><Owner><ID>minio</ID><DisplayName>minio</DisplayName>"
+                     "</Owner><Buckets>";
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [name, bucket] : buckets_) {
+      body += "<Bucket>" + Element("Name", name) +
+              Element("CreationDate", bucket.creation_date.ToISO8601UTC()) +
+              "</Bucket>";
+    }
+  }
+  body += "</Buckets></ListAllMyBucketsResult>";
+  return xml(body);
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::makeBucket(
+    HttpRequest& req) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (buckets_.count(req.bucket)) {
+    return error(req, 409, "BucketAlreadyOwnedByYou",
+                 "Your previous request to create the named bucket "
+                 "succeeded and you already own it.");
+  }
+  buckets_[req.bucket].creation_date = utils::Time::Now();
+
+  HttpResponse resp;
+  resp.headers.push_back({"Location", "/" + req.bucket});
+  return resp;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::removeBucket(
+    HttpRequest& req) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = buckets_.find(req.bucket);
+  if (it == buckets_.end()) {
+    return error(req, 404, "NoSuchBucket", "Bucket does not exist.");
+  }
+  if (!it->second.objects.empty()) {
+    return error(req, 409, "BucketNotEmpty",
+                 "The bucket you tried to delete is not empty.");
+  }
+  buckets_.erase(it);
+
+  HttpResponse resp;
+  resp.status = 204;
+  return resp;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::listObjectsV2(
+    HttpRequest& req) {
+  std::string& prefix = req.query["prefix"];
+  std::string& delimiter = req.query["delimiter"];
+  std::string& token = req.query["continuation-token"];
+  std::string& start_after = req.query["start-after"];
+  bool url = req.query["encoding-type"] == "url";
+  unsigned int max_keys = 1000;
+  if (!req.query["max-keys"].empty()) {
+    max_keys = std::min(1000ul, std::stoul(req.query["max-keys"]));
+  }
+  auto encode = [url](std::string_view value) -> std::string {
+    return url ? Encode(value) : std::string(value);
+  };
+
+  // Listing continues after the token, or after start-after on first page.
+  // A token ending with delimiter is a common prefix; its keys are skipped.
+  std::string marker = token.empty() ? start_after : token;
+
+  std::string contents;
+  std::string common_prefixes;
+  std::string last;
+  unsigned int count = 0;
+  bool truncated = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto bucket = buckets_.find(req.bucket);
+    if (bucket == buckets_.end()) {
+      return error(req, 404, "NoSuchBucket", "Bucket does not exist.");
+    }
+
+    auto& objects = bucket->second.objects;
+    auto it = marker.empty() ? objects.lower_bound(prefix)
+                             : objects.upper_bound(marker);
+    std::string common_prefix;
+    for (; it != objects.end(); ++it) {
+      const std::string& key = it->first;
+      if (!utils::StartsWith(key, prefix)) {
+        if (key > prefix) break;
+        continue;
+      }
+      if (!delimiter.empty() && !marker.empty() &&
+          utils::EndsWith(marker, delimiter) &&
+          utils::StartsWith(key, marker)) {
+        continue;
+      }
+      if (!common_prefix.empty() && utils::StartsWith(key, common_prefix)) {
+        continue;
+      }
+
+      if (count == max_keys) {
+        truncated = true;
+        break;
+      }
+
+      size_t pos = delimiter.empty()
+                       ? std::string::npos
+                       : key.find(delimiter, prefix.size());
+      if (pos != std::string::npos) {
+        common_prefix = key.substr(0, pos + delimiter.size());
+        common_prefixes += "<CommonPrefixes>" +
+                           Element("Prefix", encode(common_prefix)) +
+                           "</CommonPrefixes>";
+        last = common_prefix;
+      } else {
+        Object& object = it->second;
+        contents += "<Contents>" + Element("Key", encode(key)) +
+                    Element("LastModified",
+                            object.last_modified.ToISO8601UTC()) +
+                    Element("ETag", "\"" + object.etag + "\"") +
+                    Element("Size", std::to_string(object.size)) +
+                    "<StorageClass>STANDARD</StorageClass></Contents>";
+        last = key;
+      }
+      count++;
+    }
+  }
+
+  std::string body = "<ListBucketResult" + std::string(kXmlns) + ">" +
+                     Element("Name", req.bucket) +
+                     Element("Prefix", encode(prefix));
+  if (!delimiter.empty()) body += Element("Delimiter", encode(delimiter));
+  if (url) body += Element("EncodingType", "url");
+  if (!token.empty()) body += Element("ContinuationToken", token);
+  if (!start_after.empty()) {
+    body += Element("StartAfter", encode(start_after));
+  }
+  body += Element("KeyCount", std::to_string(count)) +
+          Element("MaxKeys", std::to_string(max_keys)) +
+          Element("IsTruncated", truncated ? "true" : "false");
+  if (truncated) body += Element("NextContinuationToken", last);
+  body += contents + common_prefixes + "</ListBucketResult>";
+  return xml(body);
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::removeObjects(
+    HttpRequest& req) {
+  pugi::xml_document xdoc;
+  if (!xdoc.load_string(req.body.c_str())) {
+    return error(req, 400, "MalformedXML",
+                 "The XML you provided was not well-formed.");
+  }
+  std::string quiet =
+      xdoc.select_node("/Delete/Quiet/text()").node().value();
+
+  std::list<std::pair<std::string, std::string>> keys;
+  for (auto& node : xdoc.select_nodes("/Delete/Object")) {
+    auto object = node.node();
+    keys.push_back({object.select_node("Key/text()").node().value(),
+                    object.select_node("VersionId/text()").node().value()});
+  }
+
+  std::list<Object> removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto bucket = buckets_.find(req.bucket);
+    if (bucket == buckets_.end()) {
+      return error(req, 404, "NoSuchBucket", "Bucket does not exist.");
+    }
+    for (auto& [key, version_id] : keys) {
+      auto it = bucket->second.objects.find(key);
+      if (it == bucket->second.objects.end()) continue;
+      removed.push_back(it->second);
+      bucket->second.objects.erase(it);
+    }
+  }
+  for (auto& object : removed) remove(object);
+
+  std::string body = "<DeleteResult" + std::string(kXmlns) + ">";
+  if (quiet != "true") {
+    for (auto& [key, version_id] : keys) {
+      body += "<Deleted>" + Element("Key", key);
+      if (!version_id.empty()) body += Element("VersionId", version_id);
+      body += "</Deleted>";
+    }
+  }
+  body += "</DeleteResult>";
+  return xml(body);
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::putObject(
+    HttpRequest& req) {
+  Object object = store(std::move(req.body));
+  object.content_type = req.headers["content-type"];
+  if (object.content_type.empty()) {
+    object.content_type = "application/octet-stream";
+  }
+  for (auto& [name, value] : req.headers) {
+    if (utils::StartsWith(name, "x-amz-meta-")) {
+      object.metadata.push_back({name, value});
+    }
+  }
+
+  Object old;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto bucket = buckets_.find(req.bucket);
+    if (bucket == buckets_.end()) {
+      remove(object);
+      return error(req, 404, "NoSuchBucket", "Bucket does not exist.");
+    }
+    Object& current = bucket->second.objects[req.object];
+    old = current;
+    current = object;
+  }
+  remove(old);
+
+  HttpResponse resp;
+  resp.headers.push_back({"ETag", "\"" + object.etag + "\""});
+  return resp;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::getObject(
+    HttpRequest& req, bool head) {
+  Object object;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto bucket = buckets_.find(req.bucket);
+    if (bucket == buckets_.end()) {
+      return error(req, 404, "NoSuchBucket", "Bucket does not exist.");
+    }
+    auto it = bucket->second.objects.find(req.object);
+    if (it == bucket->second.objects.end()) {
+      return error(req, 404, "NoSuchKey", "Object does not exist.");
+    }
+    object = it->second;
+  }
+
+  auto if_match = req.headers.find("if-match");
+  if (if_match != req.headers.end() &&
+      if_match->second != "\"" + object.etag + "\"" &&
+      if_match->second != object.etag) {
+    return error(req, 412, "PreconditionFailed",
+                 "At least one of the pre-conditions you specified did not "
+                 "hold");
+  }
+
+  HttpResponse resp;
+  resp.head = head;
+  resp.length = object.size;
+  resp.headers.push_back({"ETag", "\"" + object.etag + "\""});
+  resp.headers.push_back(
+      {"Last-Modified", object.last_modified.ToHttpHeaderValue()});
+  resp.headers.push_back({"Content-Type", object.content_type});
+  resp.headers.push_back({"Accept-Ranges", "bytes"});
+  for (auto& header : object.metadata) resp.headers.push_back(header);
+
+  std::string range = req.headers["range"];
+  if (utils::StartsWith(range, "bytes=")) {
+    std::string_view spec = std::string_view(range).substr(6);
+    size_t dash = spec.find('-');
+    std::string first(spec.substr(0, dash));
+    std::string last;
+    if (dash != std::string_view::npos) last = spec.substr(dash + 1);
+    size_t start = 0;
+    size_t end = object.size;  // Exclusive.
+    if (first.empty()) {
+      size_t suffix = last.empty() ? 0 : std::stoul(last);
+      start = object.size - std::min(object.size, suffix);
+    } else {
+      start = std::stoul(first);
+      if (!last.empty()) end = std::min(end, std::stoul(last) + 1);
+    }
+    if (dash == std::string_view::npos || start >= end) {
+      return error(req, 416, "InvalidRange",
+                   "The requested range is not satisfiable");
+    }
+    resp.status = 206;
+    resp.offset = start;
+    resp.length = end - start;
+    resp.headers.push_back({"Content-Range",
+                            "bytes " + std::to_string(start) + "-" +
+                                std::to_string(end - 1) + "/" +
+                                std::to_string(object.size)});
+  }
+
+  if (head) return resp;
+
+  resp.data = load(object);
+  return resp;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::removeObject(
+    HttpRequest& req) {
+  Object object;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto bucket = buckets_.find(req.bucket);
+    if (bucket == buckets_.end()) {
+      return error(req, 404, "NoSuchBucket", "Bucket does not exist.");
+    }
+    auto it = bucket->second.objects.find(req.object);
+    if (it != bucket->second.objects.end()) {
+      object = it->second;
+      bucket->second.objects.erase(it);
+    }
+  }
+  remove(object);
+
+  HttpResponse resp;
+  resp.status = 204;
+  return resp;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::createMultipartUpload(
+    HttpRequest& req) {
+  std::string upload_id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!buckets_.count(req.bucket)) {
+      return error(req, 404, "NoSuchBucket", "Bucket does not exist.");
+    }
+    upload_id = Md5Hex(req.bucket + "/" + req.object + "/" +
+                       std::to_string(next_id_++));
+    Upload& upload = uploads_[upload_id];
+    upload.bucket = req.bucket;
+    upload.object = req.object;
+    upload.content_type = req.headers["content-type"];
+  }
+
+  return xml("<InitiateMultipartUploadResult" + std::string(kXmlns) + ">" +
+             Element("Bucket", req.bucket) + Element("Key", req.object) +
+             Element("UploadId", upload_id) +
+             "</InitiateMultipartUploadResult>");
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::uploadPart(
+    HttpRequest& req) {
+  unsigned long number = 0;
+  if (!req.query["partNumber"].empty()) {
+    number = std::stoul(req.query["partNumber"]);
+  }
+  if (number < 1 || number > utils::kMaxMultipartCount) {
+    return error(req, 400, "InvalidArgument",
+                 "Part number must be an integer between 1 and 10000.");
+  }
+
+  Object part = store(std::move(req.body));
+  Object old;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto upload = uploads_.find(req.query["uploadId"]);
+    if (upload == uploads_.end()) {
+      remove(part);
+      return error(req, 404, "NoSuchUpload",
+                   "The specified multipart upload does not exist.");
+    }
+    Object& current = upload->second.parts[number];
+    old = current;
+    current = part;
+  }
+  remove(old);
+
+  HttpResponse resp;
+  resp.headers.push_back({"ETag", "\"" + part.etag + "\""});
+  return resp;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::completeMultipartUpload(
+    HttpRequest& req) {
+  pugi::xml_document xdoc;
+  if (!xdoc.load_string(req.body.c_str())) {
+    return error(req, 400, "MalformedXML",
+                 "The XML you provided was not well-formed.");
+  }
+
+  Upload upload;
+  std::list<Object> parts;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = uploads_.find(req.query["uploadId"]);
+    if (it == uploads_.end()) {
+      return error(req, 404, "NoSuchUpload",
+                   "The specified multipart upload does not exist.");
+    }
+    for (auto& node : xdoc.select_nodes("/CompleteMultipartUpload/Part")) {
+      std::string number =
+          node.node().select_node("PartNumber/text()").node().value();
+      std::string etag = utils::Trim(
+          node.node().select_node("ETag/text()").node().value(), '"');
+      auto part = number.empty() ? it->second.parts.end()
+                                 : it->second.parts.find(std::stoul(number));
+      if (part == it->second.parts.end() || part->second.etag != etag) {
+        return error(req, 400, "InvalidPart",
+                     "One or more of the specified parts could not be "
+                     "found.");
+      }
+      parts.push_back(part->second);
+    }
+    upload = std::move(it->second);
+    uploads_.erase(it);
+  }
+
+  std::string data;
+  std::string etags;
+  for (auto& part : parts) {
+    data += *load(part);
+    etags += part.etag;
+  }
+  for (auto& [number, part] : upload.parts) remove(part);
+
+  Object object = store(std::move(data));
+  object.etag = Md5Hex(etags) + "-" + std::to_string(parts.size());
+  object.content_type = upload.content_type.empty() ? "application/octet-stream"
+                                                    : upload.content_type;
+
+  Object old;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto bucket = buckets_.find(req.bucket);
+    if (bucket == buckets_.end()) {
+      remove(object);
+      return error(req, 404, "NoSuchBucket", "Bucket does not exist.");
+    }
+    Object& current = bucket->second.objects[req.object];
+    old = current;
+    current = object;
+  }
+  remove(old);
+
+  return xml("<CompleteMultipartUploadResult" + std::string(kXmlns) + ">" +
+             Element("Location", "/" + req.bucket + "/" + req.object) +
+             Element("Bucket", req.bucket) + Element("Key", req.object) +
+             Element("ETag", "\"" + object.etag + "\"") +
+             "</CompleteMultipartUploadResult>");
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::abortMultipartUpload(
+    HttpRequest& req) {
+  Upload upload;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = uploads_.find(req.query["uploadId"]);
+    if (it == uploads_.end()) {
+      return error(req, 404, "NoSuchUpload",
+                   "The specified multipart upload does not exist.");
+    }
+    upload = std::move(it->second);
+    uploads_.erase(it);
+  }
+  for (auto& [number, part] : upload.parts) remove(part);
+
+  HttpResponse resp;
+  resp.status = 204;
+  return resp;
+}
+
+minio::mock::Server::HttpResponse minio::mock::Server::selectObjectContent(
+    HttpRequest& req) {
+  HttpResponse resp = getObject(req, false);
+  if (resp.status != 200) return resp;
+
+  // Records are the object data as is; the expression is not evaluated.
+  std::string_view data = *resp.data;
+  std::string stream;
+  for (size_t i = 0; i < data.size(); i += kChunkSize) {
+    stream += EventMessage("Records", "application/octet-stream",
+                           data.substr(i, kChunkSize));
+  }
+  std::string size = std::to_string(data.size());
+  stream += EventMessage("Stats", "text/xml",
+                         "<Stats>" + Element("BytesScanned", size) +
+                             Element("BytesProcessed", size) +
+                             Element("BytesReturned", size) + "</Stats>");
+  stream += EventMessage("End", "", "");
+
+  HttpResponse select;
+  select.headers.push_back({"Content-Type", "application/octet-stream"});
+  select.data = std::make_shared<const std::string>(std::move(stream));
+  select.length = select.data->size();
+  return select;
+}
@@ -0,0 +1,201 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MINIO_MOCK_SERVER_H
+#define _MINIO_MOCK_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "utils.h"
+
+namespace minio {
+namespace mock {
+/**
+ * ServerConfig configures Server.
+ */
+struct ServerConfig {
+  std::string address = "127.0.0.1";
+  unsigned int port = 0;  // Zero picks a free port.
+  // Object data is kept in files under data_dir, e.g. on tmpfs, if set and
+  // in memory otherwise.
+  std::string data_dir;
+  std::string region = "us-east-1";
+
+  std::chrono::milliseconds latency{0};  // Added before every response.
+  size_t bandwidth = 0;  // Bytes per second each way per connection; zero is
+                         // unlimited.
+  double error_rate = 0;  // Share of requests failed with error_status.
+  int error_status = 503;
+  std::string error_code = "SlowDown";
+  double drop_rate = 0;  // Share of downloads cut off after half the body.
+};  // struct ServerConfig
+
+/**
+ * ServerStats counts requests served by Server.
+ */
+struct ServerStats {
+  unsigned long connections = 0;
+  unsigned long requests = 0;
+  unsigned long injected_errors = 0;
+  unsigned long dropped = 0;
+  unsigned long bytes_received = 0;
+  unsigned long bytes_sent = 0;
+};  // struct ServerStats
+
+/**
+ * Server is a local S3 stand-in serving buckets and objects from memory or a
+ * directory over HTTP/1.1 on a loopback port. It handles path style
+ * MakeBucket, BucketExists, RemoveBucket, GetBucketLocation, ListBuckets,
+ * PutObject, GetObject with ranges and If-Match, StatObject, RemoveObject,
+ * multipart uploads, ListObjectsV2, RemoveObjects and SelectObjectContent,
+ * which returns the object as records. Signatures are not checked.
+ *
+ * Latency, bandwidth, error responses and dropped connections are injected
+ * as configured, so the whole client including retries and parallel
+ * transfers can be run without network or credentials.
+ */
+class Server {
+ private:
+  struct Object {
+    std::shared_ptr<const std::string> data;  // NULL if kept in a file.
+    std::string file;
+    size_t size = 0;
+    std::string etag;
+    std::string content_type;
+    utils::Time last_modified;
+    std::list<std::pair<std::string, std::string>> metadata;
+  };  // struct Object
+
+  struct Bucket {
+    utils::Time creation_date;
+    std::map<std::string, Object> objects;
+  };  // struct Bucket
+
+  struct Upload {
+    std::string bucket;
+    std::string object;
+    std::string content_type;
+    std::map<unsigned int, Object> parts;
+  };  // struct Upload
+
+  struct HttpRequest {
+    std::string id;
+    std::string method;
+    std::string target;
+    std::string bucket;
+    std::string object;
+    std::map<std::string, std::string> query;
+    std::map<std::string, std::string> headers;  // Lower case names.
+    std::string body;
+  };  // struct HttpRequest
+
+  struct HttpResponse {
+    int status = 200;
+    std::list<std::pair<std::string, std::string>> headers;
+    // Body is data[offset, offset + length).
+    std::shared_ptr<const std::string> data;
+    size_t offset = 0;
+    size_t length = 0;
+    bool head = false;  // Content-Length is sent without body.
+    bool drop = false;  // Connection is closed after half the body.
+  };  // struct HttpResponse
+
+  struct Connection;
+
+  ServerConfig config_;
+  int listener_ = -1;
+  unsigned int port_ = 0;
+  std::thread acceptor_;
+  std::list<std::thread> workers_;
+  std::list<int> sockets_;
+  std::atomic<bool> stopped_ = false;
+
+  std::mutex mutex_;
+  std::map<std::string, Bucket> buckets_;
+  std::map<std::string, Upload> uploads_;
+  unsigned long next_id_ = 0;
+  unsigned int fail_next_ = 0;
+  unsigned int drop_next_ = 0;
+
+  std::atomic<unsigned long> connections_ = 0;
+  std::atomic<unsigned long> requests_ = 0;
+  std::atomic<unsigned long> injected_errors_ = 0;
+  std::atomic<unsigned long> dropped_ = 0;
+  std::atomic<unsigned long> bytes_received_ = 0;
+  std::atomic<unsigned long> bytes_sent_ = 0;
+
+  void accept();
+  void serve(int sock);
+  bool read(Connection& conn, HttpRequest& req);
+  bool write(Connection& conn, HttpResponse& resp);
+  HttpResponse handle(HttpRequest& req);
+  static HttpResponse error(HttpRequest& req, int status, std::string code,
+                            std::string message);
+  static HttpResponse xml(std::string body);
+  bool inject(HttpRequest& req, HttpResponse& resp);
+
+  Object store(std::string data);
+  std::shared_ptr<const std::string> load(const Object& object);
+  void remove(const Object& object);
+
+  HttpResponse listBuckets();
+  HttpResponse makeBucket(HttpRequest& req);
+  HttpResponse removeBucket(HttpRequest& req);
+  HttpResponse listObjectsV2(HttpRequest& req);
+  HttpResponse removeObjects(HttpRequest& req);
+  HttpResponse putObject(HttpRequest& req);
+  HttpResponse getObject(HttpRequest& req, bool head);
+  HttpResponse removeObject(HttpRequest& req);
+  HttpResponse createMultipartUpload(HttpRequest& req);
+  HttpResponse uploadPart(HttpRequest& req);
+  HttpResponse completeMultipartUpload(HttpRequest& req);
+  HttpResponse abortMultipartUpload(HttpRequest& req);
+  HttpResponse selectObjectContent(HttpRequest& req);
+
+ public:
+  Server(ServerConfig config = ServerConfig());
+  ~Server();
+
+  // Start listens on the configured address and serves requests in
+  // background threads until Stop().
+  error::Error Start();
+  void Stop();
+
+  unsigned int Port() const { return port_; }
+
+  // Endpoint returns host:port to build a BaseUrl with https disabled.
+  std::string Endpoint() const {
+    return config_.address + ":" + std::to_string(port_);
+  }
+
+  // FailNext fails next count requests with the configured error.
+  void FailNext(unsigned int count);
+
+  // DropNext cuts off next count object downloads after half the body.
+  void DropNext(unsigned int count);
+
+  ServerStats Stats();
+};  // class Server
+}  // namespace mock
+}  // namespace minio
+
+#endif  // #ifndef _MINIO_MOCK_SERVER_H
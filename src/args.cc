@@ -15,6 +15,11 @@
 
 #include "args.h"
 
+void minio::s3::BaseArgs::InheritLimits(const BaseArgs& args) {
+  limit_tag = args.limit_tag;
+  priority = args.priority;
+}
+
 minio::error::Error minio::s3::BucketArgs::Validate() {
   return utils::CheckBucketName(bucket);
 }
@@ -188,8 +193,7 @@ minio::error::Error minio::s3::GetObjectArgs::Validate() {
 minio::s3::ListObjectsV1Args::ListObjectsV1Args() {}
 
 minio::s3::ListObjectsV1Args::ListObjectsV1Args(ListObjectsArgs args) {
-  this->extra_headers = args.extra_headers;
-  this->extra_query_params = args.extra_query_params;
+  static_cast<BaseArgs&>(*this) = args;
   this->bucket = args.bucket;
   this->region = args.region;
   this->delimiter = args.delimiter;
@@ -202,8 +206,7 @@ minio::s3::ListObjectsV1Args::ListObjectsV1Args(ListObjectsArgs args) {
 minio::s3::ListObjectsV2Args::ListObjectsV2Args() {}
 
 minio::s3::ListObjectsV2Args::ListObjectsV2Args(ListObjectsArgs args) {
-  this->extra_headers = args.extra_headers;
-  this->extra_query_params = args.extra_query_params;
+  static_cast<BaseArgs&>(*this) = args;
   this->bucket = args.bucket;
   this->region = args.region;
   this->delimiter = args.delimiter;
@@ -220,8 +223,7 @@ minio::s3::ListObjectVersionsArgs::ListObjectVersionsArgs() {}
 
 minio::s3::ListObjectVersionsArgs::ListObjectVersionsArgs(
     ListObjectsArgs args) {
-  this->extra_headers = args.extra_headers;
-  this->extra_query_params = args.extra_query_params;
+  static_cast<BaseArgs&>(*this) = args;
   this->bucket = args.bucket;
   this->region = args.region;
   this->delimiter = args.delimiter;
@@ -361,6 +363,22 @@ minio::error::Error minio::s3::RemoveObjectsArgs::Validate() {
   if (func == NULL) {
     return error::Error("delete object function must be set");
   }
+  if (concurrency == 0) {
+    return error::Error("concurrency must be greater than zero");
+  }
+
+  return error::SUCCESS;
+}
+
+minio::error::Error minio::s3::RemovePrefixArgs::Validate() {
+  if (error::Error err = BucketArgs::Validate()) return err;
+  if (prefix.empty() && !all_objects) {
+    return error::Error(
+        "prefix cannot be empty unless all objects are to be removed");
+  }
+  if (concurrency == 0) {
+    return error::Error("concurrency must be greater than zero");
+  }
 
   return error::SUCCESS;
 }
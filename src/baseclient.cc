@@ -15,6 +15,37 @@
 
 #include "baseclient.h"
 
+#include "xml.h"
+
+namespace {
+// setBody moves XML body into request with hashes computed while it was
+// written.
+void setBody(minio::s3::Request& req, minio::xml::Body body) {
+  req.body_data = std::move(body.data);
+  req.body = req.body_data;
+  req.sha256 = std::move(body.sha256);
+  req.headers.Add("Content-MD5", std::move(body.md5sum));
+}
+
+minio::xml::Body taggingBody(const std::map<std::string, std::string>& tags) {
+  size_t size = 64;
+  for (auto& [key, value] : tags) size += 40 + key.size() + value.size();
+
+  minio::xml::Writer writer(size);
+  writer.Start("Tagging");
+  if (!tags.empty()) {
+    writer.Start("TagSet");
+    for (auto& [key, value] : tags) {
+      writer.Start("Tag").Element("Key", key).Element("Value", value).End(
+          "Tag");
+    }
+    writer.End("TagSet");
+  }
+  writer.End("Tagging");
+  return writer.Finish();
+}
+}  // namespace
+
 minio::utils::Multimap minio::s3::GetCommonListObjectsQueryParams(
     std::string& delimiter, std::string& encoding_type, unsigned int max_keys,
     std::string& prefix) {
@@ -37,6 +68,40 @@ minio::s3::BaseClient::BaseClient(BaseUrl& base_url, creds::Provider* provider)
   this->provider_ = provider;
 }
 
+minio::s3::BaseClient::BaseClient(EndpointPool& endpoints,
+                                  creds::Provider* provider)
+    : base_url_(endpoints.GetBaseUrl()) {
+  if (!endpoints) {
+    std::cerr << "valid endpoints must be provided; "
+              << endpoints.Error().String() << std::endl;
+    std::terminate();
+  }
+
+  this->endpoints_ = &endpoints;
+  this->provider_ = provider;
+}
+
+void minio::s3::BaseClient::SetConcurrencyLimit(LimiterPolicy policy) {
+  size_t count = (endpoints_ != NULL) ? endpoints_->Size() : 1;
+  limiters_.clear();
+  for (size_t i = 0; i < count; i++) {
+    limiters_.push_back(std::make_unique<ConcurrencyLimiter>(policy));
+  }
+}
+
+void minio::s3::BaseClient::SetRateLimit(http::RateLimit limit) {
+  std::shared_ptr<http::RateLimiter> limiter;
+  if (limit) limiter = std::make_shared<http::RateLimiter>(limit);
+  std::atomic_store(&rate_limiter_, limiter);
+}
+
+std::list<minio::s3::LimiterStats>
+minio::s3::BaseClient::GetConcurrencyLimits() {
+  std::list<LimiterStats> stats;
+  for (auto& limiter : limiters_) stats.push_back(limiter->Stats());
+  return stats;
+}
+
 minio::error::Error minio::s3::BaseClient::SetAppInfo(
     std::string_view app_name, std::string_view app_version) {
   if (app_name.empty() || app_version.empty()) {
@@ -50,8 +115,8 @@ minio::error::Error minio::s3::BaseClient::SetAppInfo(
 
 void minio::s3::BaseClient::HandleRedirectResponse(
     std::string& code, std::string& message, int status_code,
-    http::Method method, utils::Multimap headers, std::string& bucket_name,
-    bool retry) {
+    http::Method method, const utils::Multimap& headers,
+    std::string& bucket_name, bool retry) {
   switch (status_code) {
     case 301:
       code = "PermanentRedirect";
@@ -72,21 +137,23 @@ void minio::s3::BaseClient::HandleRedirectResponse(
   }
 
   std::string region = headers.GetFront("x-amz-bucket-region");
+  std::string cached_region;
 
   if (!message.empty() && !region.empty()) {
     message += "; use region " + region;
   }
 
   if (retry && !region.empty() && method == http::Method::kHead &&
-      !bucket_name.empty() && !region_map_[bucket_name].empty()) {
+      !bucket_name.empty() &&
+      region_cache_.Lookup(bucket_name, cached_region)) {
     code = "RetryHead";
     message = "";
   }
 }
 
 minio::s3::Response minio::s3::BaseClient::GetErrorResponse(
-    http::Response resp, std::string_view resource, http::Method method,
-    std::string& bucket_name, std::string& object_name) {
+    const http::Response& resp, std::string_view resource,
+    http::Method method, std::string& bucket_name, std::string& object_name) {
   if (!resp.error.empty()) return error::Error(resp.error);
 
   if (!resp.body.empty()) {
@@ -169,36 +236,197 @@ minio::s3::Response minio::s3::BaseClient::GetErrorResponse(
   return response;
 }
 
-minio::s3::Response minio::s3::BaseClient::execute(Request& req) {
+minio::s3::Response minio::s3::BaseClient::execute(Request& req,
+                                                  bool* retryable) {
   req.user_agent = user_agent_;
   req.ignore_cert_check = ignore_cert_check_;
   if (!ssl_cert_file_.empty()) req.ssl_cert_file = ssl_cert_file_;
-  http::Request request = req.ToHttpRequest(provider_);
+  size_t endpoint = 0;
+  if (endpoints_ != NULL) {
+    endpoint = endpoints_->Pick();
+    req.endpoint = &endpoints_->Get(endpoint);
+  }
+  LimiterSlot slot(limiters_.empty() ? NULL : limiters_[endpoint].get(),
+                   req.priority);
+  req.attempts++;
+  auto attempt_start = std::chrono::system_clock::now();
+  auto sign_start = std::chrono::steady_clock::now();
+  // Released when this attempt is done.
+  utils::Arena arena(memory_resource_);
+  http::Request request = req.ToHttpRequest(provider_, arena.Resource());
+  auto sign = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - sign_start);
   request.debug = debug_;
+  request.resolver = &resolver_;
+  if (auto limiter = std::atomic_load(&rate_limiter_)) {
+    request.rate_limiters.push_back(limiter);
+  }
+  if (auto limiter = bucket_rate_limiters_.Get(req.bucket_name)) {
+    request.rate_limiters.push_back(limiter);
+  }
+  if (!req.limit_tag.empty()) {
+    if (auto limiter = tag_rate_limiters_.Get(req.limit_tag)) {
+      request.rate_limiters.push_back(limiter);
+    }
+  }
+  if (req.hedgeable) request.hedge_delay = hedger_.Delay(req.method);
+  auto start = std::chrono::steady_clock::now();
   http::Response response = request.Execute();
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  slot.Release(response, elapsed);
+  metrics_.Record(req.api, req.bucket_name, response, elapsed);
+  if (endpoints_ != NULL) endpoints_->Done(endpoint, response, elapsed);
+  if (req.hedgeable) hedger_.Done(req.method, request.hedge_delay, response);
+
+  if (trace_recorder_ != NULL) {
+    TraceRecord record;
+    record.api = req.api;
+    record.bucket = req.bucket_name;
+    if (!req.object_name.empty()) {
+      record.key_hash = TraceRecorder::KeyHash(req.object_name);
+    }
+    record.method = req.method;
+    record.attempt = req.attempts;
+    record.status_code = response.status_code;
+    record.request_bytes = response.bytes_sent;
+    record.response_bytes = std::strtoull(
+        response.headers.GetFront("content-length").c_str(), NULL, 10);
+    record.start = attempt_start;
+    record.duration = sign + elapsed;
+    trace_recorder_->Record(record);
+  }
+
+  std::unique_ptr<Span> span;
+  if (span_sink_ != NULL) {
+    span = std::make_unique<Span>();
+    span->api = req.api;
+    span->bucket = req.bucket_name;
+    span->object = req.object_name;
+    span->method = http::MethodToString(req.method);
+    span->attempt = req.attempts;
+    span->status_code = response.status_code;
+    span->request_id = response.headers.GetFront("x-amz-request-id");
+    span->hedged = response.hedged;
+    span->reused_connection = response.reused_connection;
+    span->bytes_sent = response.bytes_sent;
+    span->bytes_received = response.bytes_received;
+    span->start = attempt_start;
+    span->sign = sign;
+    span->dns = response.name_lookup_time;
+    span->connect = response.connect_time - response.name_lookup_time;
+    if (response.app_connect_time.count() > 0) {
+      span->tls = response.app_connect_time - response.connect_time;
+    }
+    if (response.start_transfer_time.count() > 0) {
+      span->ttfb = response.start_transfer_time - response.pre_transfer_time;
+      span->transfer = response.total_time - response.start_transfer_time;
+    }
+    span->total = sign + elapsed;
+  }
+
   if (response) {
     Response resp;
     resp.status_code = response.status_code;
-    resp.headers = response.headers;
-    resp.data = response.body;
+    resp.headers = std::move(response.headers);
+    resp.data = std::move(response.body);
+    if (span != NULL) {
+      // Exported when the request is done, after its response is parsed.
+      req.span = std::move(span);
+      req.span_sink = span_sink_;
+      req.span_end = std::chrono::steady_clock::now();
+    }
     return resp;
   }
 
+  auto parse_start = std::chrono::steady_clock::now();
   Response resp = GetErrorResponse(response, request.url.path, req.method,
                                    req.bucket_name, req.object_name);
+  if (span != NULL) {
+    span->parse = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - parse_start);
+    span->total += span->parse;
+    span->error = resp.code.empty() ? response.error : resp.code;
+    span_sink_->Export(*span);
+  }
   if (resp.code == "NoSuchBucket" || resp.code == "RetryHead") {
-    region_map_.erase(req.bucket_name);
+    region_cache_.Remove(req.bucket_name);
+  }
+  if (retryable != NULL) {
+    *retryable = retry_policy_.IsRetryable(response, resp);
   }
 
   return resp;
 }
 
 minio::s3::Response minio::s3::BaseClient::Execute(Request& req) {
-  Response resp = execute(req);
-  if (resp || resp.code != "RetryHead") return resp;
+  // Attempts sign their own copy of req.headers; only a resumed body changes
+  // them, so keep the original range to resume from.
+  std::string range;
+  if (req.resumable) range = req.headers.GetFront("Range");
+
+  // Track body bytes handed to data function; those cannot be sent again.
+  http::DataFunction datafunc = req.datafunc;
+  size_t delivered = 0;
+  std::string etag;
+  if (datafunc != NULL) {
+    req.datafunc = [&](http::DataFunctionArgs args) -> bool {
+      if (delivered == 0) etag = args.response->headers.GetFront("ETag");
+      delivered += args.datachunk.size();
+      return datafunc(args);
+    };
+  }
+
+  Response resp;
+  bool retry_head = true;
+  unsigned int retries = 0;
+  while (true) {
+    retry_metrics_.attempts++;
+    bool retryable = false;
+    resp = execute(req, &retryable);
+    if (resp) break;
+
+    // Retry only once on RetryHead error.
+    if (resp.code == "RetryHead" && retry_head) {
+      retry_head = false;
+      continue;
+    }
+
+    if (!retryable) break;
+    if (retries == retry_policy_.max_retries) {
+      retry_metrics_.exhausted++;
+      break;
+    }
 
-  // Retry only once on RetryHead error.
-  resp = execute(req);
+    if (delivered > 0) {
+      // Continue the body after delivered bytes of the same object version.
+      if (!req.resumable || etag.empty()) break;
+
+      size_t start = 0;
+      std::string end;
+      if (!range.empty()) {
+        size_t pos = range.find('-');
+        if (!utils::StartsWith(range, "bytes=") || pos == 6 ||
+            pos == std::string::npos) {
+          break;
+        }
+        start = std::stoul(range.substr(6, pos - 6));
+        end = range.substr(pos + 1);
+      }
+      req.headers.Remove("Range");
+      req.headers.Add("Range", "bytes=" + std::to_string(start + delivered) +
+                                   "-" + end);
+      if (!req.headers.Contains("If-Match")) req.headers.Add("If-Match", etag);
+      retry_metrics_.resumes++;
+    }
+
+    retries++;
+    retry_metrics_.retries++;
+    metrics_.RecordRetry(req.api, req.bucket_name);
+    std::this_thread::sleep_for(retry_policy_.Backoff(retries));
+  }
+
+  req.datafunc = datafunc;
   if (resp || resp.code != "RetryHead") return resp;
 
   std::string code;
@@ -227,32 +455,59 @@ minio::s3::GetRegionResponse minio::s3::BaseClient::GetRegion(
 
   if (bucket_name.empty() || provider_ == NULL) return std::string("us-east-1");
 
-  std::string stored_region = region_map_[bucket_name];
-  if (!stored_region.empty()) return stored_region;
+  return region_cache_.Get(bucket_name, [&]() -> GetRegionResponse {
+    Request req(http::Method::kGet, "us-east-1", base_url_, utils::Multimap(),
+                utils::Multimap());
+    req.api = "GetBucketLocation";
+    req.query_params.Add("location", "");
+    req.bucket_name = bucket_name;
 
-  Request req(http::Method::kGet, "us-east-1", base_url_, utils::Multimap(),
-              utils::Multimap());
-  req.query_params.Add("location", "");
-  req.bucket_name = bucket_name;
+    Response resp = Execute(req);
+    if (!resp) return resp;
 
-  Response resp = Execute(req);
-  if (!resp) return resp;
+    std::string value;
+    if (error::Error err = xml::Value(resp.data, "LocationConstraint", value)) {
+      return err;
+    }
 
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(resp.data.data());
-  if (!result) return error::Error("unable to parse XML");
-  auto text = xdoc.select_node("/LocationConstraint/text()");
-  std::string value = text.node().value();
+    if (value.empty()) {
+      value = "us-east-1";
+    } else if (value == "EU") {
+      if (base_url_.aws_host) value = "eu-west-1";
+    }
 
-  if (value.empty()) {
-    value = "us-east-1";
-  } else if (value == "EU") {
-    if (base_url_.aws_host) value = "eu-west-1";
-  }
+    return value;
+  });
+}
 
-  region_map_[bucket_name] = value;
+minio::error::Error minio::s3::BaseClient::PrewarmRegions(
+    std::list<std::string> buckets) {
+  std::vector<std::string> names(buckets.begin(), buckets.end());
+  std::vector<error::Error> errors(names.size());
+  std::atomic<size_t> next = 0;
+
+  auto worker = [&]() {
+    std::string region;
+    for (size_t i = next++; i < names.size(); i = next++) {
+      GetRegionResponse resp = GetRegion(names[i], region);
+      if (!resp) errors[i] = resp.Error();
+    }
+  };
+
+  size_t count = std::min(names.size(), RegionCache::kPrewarmConcurrency);
+  std::list<std::thread> workers;
+  for (size_t i = 1; i < count; i++) workers.emplace_back(worker);
+  worker();
+  for (auto& t : workers) t.join();
+
+  for (size_t i = 0; i < names.size(); i++) {
+    if (errors[i]) {
+      return error::Error("unable to get region of bucket " + names[i] +
+                          "; " + errors[i].String());
+    }
+  }
 
-  return value;
+  return error::SUCCESS;
 }
 
 minio::s3::AbortMultipartUploadResponse
@@ -266,8 +521,8 @@ minio::s3::BaseClient::AbortMultipartUpload(AbortMultipartUploadArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "AbortMultipartUpload";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   req.query_params.Add("uploadId", args.upload_id);
@@ -286,8 +541,8 @@ minio::s3::BucketExistsResponse minio::s3::BaseClient::BucketExists(
     return (resp.code == "NoSuchBucket") ? false : resp;
   }
 
-  Request req(http::Method::kHead, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kHead, region, base_url_, args);
+  req.api = "BucketExists";
   req.bucket_name = args.bucket;
   if (Response resp = Execute(req)) {
     return true;
@@ -308,30 +563,29 @@ minio::s3::BaseClient::CompleteMultipartUpload(
     return resp;
   }
 
-  Request req(http::Method::kPost, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPost, region, base_url_, args);
+  req.api = "CompleteMultipartUpload";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   req.query_params.Add("uploadId", args.upload_id);
 
-  std::stringstream ss;
-  ss << "<CompleteMultipartUpload>";
+  size_t size = 64;
+  for (auto& part : args.parts) size += 64 + part.etag.size();
+
+  xml::Writer writer(size);
+  writer.Start("CompleteMultipartUpload");
   for (auto& part : args.parts) {
-    ss << "<Part>"
-       << "<PartNumber>" << part.number << "</PartNumber>"
-       << "<ETag>"
-       << "\"" << part.etag << "\""
-       << "</ETag>"
-       << "</Part>";
-  }
-  ss << "</CompleteMultipartUpload>";
-  std::string body = ss.str();
-  req.body = body;
-
-  utils::Multimap headers;
-  headers.Add("Content-Type", "application/xml");
-  headers.Add("Content-MD5", utils::Md5sumHash(body));
-  req.headers = headers;
+    writer.Start("Part");
+    writer.Element("PartNumber", part.number);
+    writer.Start("ETag").Text("\"").Text(part.etag).Text("\"").End("ETag");
+    writer.End("Part");
+  }
+  writer.End("CompleteMultipartUpload");
+  xml::Body body = writer.Finish();
+
+  req.headers = utils::Multimap();
+  req.headers.Add("Content-Type", "application/xml");
+  setBody(req, std::move(body));
 
   Response response = Execute(req);
   if (!response) return response;
@@ -354,20 +608,20 @@ minio::s3::BaseClient::CreateMultipartUpload(CreateMultipartUploadArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kPost, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPost, region, base_url_, args);
+  req.api = "CreateMultipartUpload";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   req.query_params.Add("uploads", "");
-  req.headers.AddAll(args.headers);
+  req.headers.AddAll(std::move(args.headers));
 
   if (Response resp = Execute(req)) {
-    pugi::xml_document xdoc;
-    pugi::xml_parse_result result = xdoc.load_string(resp.data.data());
-    if (!result) return error::Error("unable to parse XML");
-    auto text =
-        xdoc.select_node("/InitiateMultipartUploadResult/UploadId/text()");
-    return std::string(text.node().value());
+    std::string upload_id;
+    if (error::Error err = xml::Value(
+            resp.data, "InitiateMultipartUploadResult/UploadId", upload_id)) {
+      return err;
+    }
+    return upload_id;
   } else {
     return resp;
   }
@@ -384,8 +638,8 @@ minio::s3::BaseClient::DeleteBucketEncryption(DeleteBucketEncryptionArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "DeleteBucketEncryption";
   req.bucket_name = args.bucket;
   req.query_params.Add("encryption", "");
 
@@ -407,18 +661,19 @@ minio::s3::BaseClient::DisableObjectLegalHold(DisableObjectLegalHoldArgs args) {
     return resp;
   }
 
-  std::string body = "<LegalHold><Status>OFF</Status></LegalHold>";
+  xml::Writer writer(64);
+  writer.Start("LegalHold").Element("Status", "OFF").End("LegalHold");
+  xml::Body body = writer.Finish();
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "DisableObjectLegalHold";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
     req.query_params.Add("versionId", args.version_id);
   }
   req.query_params.Add("legal-hold", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -434,8 +689,8 @@ minio::s3::BaseClient::DeleteBucketLifecycle(DeleteBucketLifecycleArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "DeleteBucketLifecycle";
   req.bucket_name = args.bucket;
   req.query_params.Add("lifecycle", "");
 
@@ -449,8 +704,7 @@ minio::s3::BaseClient::DeleteBucketNotification(
 
   NotificationConfig config;
   SetBucketNotificationArgs sbnargs(config);
-  sbnargs.extra_headers = args.extra_headers;
-  sbnargs.extra_query_params = args.extra_query_params;
+  static_cast<BaseArgs&>(sbnargs) = args;
   sbnargs.bucket = args.bucket;
   sbnargs.region = args.region;
 
@@ -468,8 +722,8 @@ minio::s3::DeleteBucketPolicyResponse minio::s3::BaseClient::DeleteBucketPolicy(
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "DeleteBucketPolicy";
   req.bucket_name = args.bucket;
   req.query_params.Add("policy", "");
 
@@ -488,8 +742,8 @@ minio::s3::BaseClient::DeleteBucketReplication(
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "DeleteBucketReplication";
   req.bucket_name = args.bucket;
   req.query_params.Add("replication", "");
 
@@ -510,8 +764,8 @@ minio::s3::DeleteBucketTagsResponse minio::s3::BaseClient::DeleteBucketTags(
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "DeleteBucketTags";
   req.bucket_name = args.bucket;
   req.query_params.Add("tagging", "");
 
@@ -529,8 +783,8 @@ minio::s3::BaseClient::DeleteObjectLockConfig(DeleteObjectLockConfigArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "DeleteObjectLockConfig";
   req.bucket_name = args.bucket;
   req.query_params.Add("object-lock", "");
 
@@ -548,8 +802,8 @@ minio::s3::DeleteObjectTagsResponse minio::s3::BaseClient::DeleteObjectTags(
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "DeleteObjectTags";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
@@ -571,18 +825,19 @@ minio::s3::BaseClient::EnableObjectLegalHold(EnableObjectLegalHoldArgs args) {
     return resp;
   }
 
-  std::string body = "<LegalHold><Status>ON</Status></LegalHold>";
+  xml::Writer writer(64);
+  writer.Start("LegalHold").Element("Status", "ON").End("LegalHold");
+  xml::Body body = writer.Finish();
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "EnableObjectLegalHold";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
     req.query_params.Add("versionId", args.version_id);
   }
   req.query_params.Add("legal-hold", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -598,8 +853,8 @@ minio::s3::BaseClient::GetBucketEncryption(GetBucketEncryptionArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetBucketEncryption";
   req.bucket_name = args.bucket;
   req.query_params.Add("encryption", "");
 
@@ -619,8 +874,8 @@ minio::s3::GetBucketLifecycleResponse minio::s3::BaseClient::GetBucketLifecycle(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetBucketLifecycle";
   req.bucket_name = args.bucket;
   req.query_params.Add("lifecycle", "");
 
@@ -645,8 +900,8 @@ minio::s3::BaseClient::GetBucketNotification(GetBucketNotificationArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetBucketNotification";
   req.bucket_name = args.bucket;
   req.query_params.Add("notification", "");
 
@@ -666,8 +921,8 @@ minio::s3::GetBucketPolicyResponse minio::s3::BaseClient::GetBucketPolicy(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetBucketPolicy";
   req.bucket_name = args.bucket;
   req.query_params.Add("policy", "");
 
@@ -687,8 +942,8 @@ minio::s3::BaseClient::GetBucketReplication(GetBucketReplicationArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetBucketReplication";
   req.bucket_name = args.bucket;
   req.query_params.Add("replication", "");
 
@@ -708,8 +963,8 @@ minio::s3::GetBucketTagsResponse minio::s3::BaseClient::GetBucketTags(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetBucketTags";
   req.bucket_name = args.bucket;
   req.query_params.Add("tagging", "");
 
@@ -729,34 +984,15 @@ minio::s3::BaseClient::GetBucketVersioning(GetBucketVersioningArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetBucketVersioning";
   req.bucket_name = args.bucket;
   req.query_params.Add("versioning", "");
 
   Response resp = Execute(req);
   if (!resp) return resp;
 
-  GetBucketVersioningResponse response;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(resp.data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto root = xdoc.select_node("/VersioningConfiguration");
-
-  pugi::xpath_node text;
-
-  if (!root.node().select_node("Status")) {
-    text = root.node().select_node("Status/text()");
-    response.status = (strcmp(text.node().value(), "Enabled") == 0);
-  }
-  if (!root.node().select_node("MFADelete")) {
-    text = root.node().select_node("MFADelete/text()");
-    response.mfa_delete = (strcmp(text.node().value(), "Enabled") == 0);
-  }
-
-  return response;
+  return GetBucketVersioningResponse::ParseXML(resp.data);
 }
 
 minio::s3::GetObjectResponse minio::s3::BaseClient::GetObject(
@@ -775,8 +1011,8 @@ minio::s3::GetObjectResponse minio::s3::BaseClient::GetObject(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetObject";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
@@ -784,7 +1020,9 @@ minio::s3::GetObjectResponse minio::s3::BaseClient::GetObject(
   }
   req.datafunc = args.datafunc;
   req.userdata = args.userdata;
-  if (args.ssec != NULL) req.headers.AddAll(args.ssec->Headers());
+  req.resumable = true;
+  req.hedgeable = true;
+  req.headers.AddAll(args.Headers());
 
   return Execute(req);
 }
@@ -800,40 +1038,15 @@ minio::s3::BaseClient::GetObjectLockConfig(GetObjectLockConfigArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetObjectLockConfig";
   req.bucket_name = args.bucket;
   req.query_params.Add("object-lock", "");
 
   Response resp = Execute(req);
   if (!resp) return resp;
 
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(resp.data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  ObjectLockConfig config;
-
-  auto rule = xdoc.select_node("/ObjectLockConfiguration/Rule");
-  if (!rule) return config;
-
-  auto text = rule.node().select_node("DefaultRetention/Mode/text()");
-  RetentionMode* mode = new RetentionMode;
-  config.retention_mode = StringToRetentionMode(text.node().value());
-
-  if (rule.node().select_node("DefaultRetention/Days")) {
-    text = rule.node().select_node("DefaultRetention/Days/text()");
-    std::string value = text.node().value();
-    config.retention_duration_days = Integer(std::stoi(value));
-  }
-
-  if (rule.node().select_node("DefaultRetention/Years")) {
-    text = rule.node().select_node("DefaultRetention/Years/text()");
-    std::string value = text.node().value();
-    config.retention_duration_years = Integer(std::stoi(value));
-  }
-
-  return config;
+  return GetObjectLockConfigResponse::ParseXML(resp.data);
 }
 
 minio::s3::GetObjectRetentionResponse minio::s3::BaseClient::GetObjectRetention(
@@ -847,8 +1060,8 @@ minio::s3::GetObjectRetentionResponse minio::s3::BaseClient::GetObjectRetention(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetObjectRetention";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
@@ -864,17 +1077,7 @@ minio::s3::GetObjectRetentionResponse minio::s3::BaseClient::GetObjectRetention(
     return resp;
   }
 
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(resp.data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto text = xdoc.select_node("/Retention/Mode/text()");
-  response.retention_mode = StringToRetentionMode(text.node().value());
-
-  text = xdoc.select_node("/Retention/RetainUntilDate/text()");
-  response.retain_until_date = utils::Time::FromISO8601UTC(text.node().value());
-
-  return response;
+  return GetObjectRetentionResponse::ParseXML(resp.data);
 }
 
 minio::s3::GetObjectTagsResponse minio::s3::BaseClient::GetObjectTags(
@@ -888,8 +1091,8 @@ minio::s3::GetObjectTagsResponse minio::s3::BaseClient::GetObjectTags(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "GetObjectTags";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
@@ -983,8 +1186,8 @@ minio::s3::BaseClient::IsObjectLegalHoldEnabled(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "IsObjectLegalHoldEnabled";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
@@ -998,18 +1201,17 @@ minio::s3::BaseClient::IsObjectLegalHoldEnabled(
     return resp;
   }
 
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(resp.data.data());
-  if (!result) return error::Error("unable to parse XML");
-  auto text = xdoc.select_node("/LegalHold/Status/text()");
-  std::string value = text.node().value();
+  std::string value;
+  if (error::Error err = xml::Value(resp.data, "LegalHold/Status", value)) {
+    return err;
+  }
   return (value == "ON");
 }
 
 minio::s3::ListBucketsResponse minio::s3::BaseClient::ListBuckets(
     ListBucketsArgs args) {
-  Request req(http::Method::kGet, base_url_.region, base_url_,
-              args.extra_headers, args.extra_query_params);
+  Request req(http::Method::kGet, base_url_.region, base_url_, args);
+  req.api = "ListBuckets";
   Response resp = Execute(req);
   if (!resp) return resp;
   return ListBucketsResponse::ParseXML(resp.data);
@@ -1091,8 +1293,8 @@ minio::s3::ListObjectsResponse minio::s3::BaseClient::ListObjectsV1(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "ListObjectsV1";
   req.bucket_name = args.bucket;
   req.query_params.AddAll(GetCommonListObjectsQueryParams(
       args.delimiter, args.encoding_type, args.max_keys, args.prefix));
@@ -1115,8 +1317,8 @@ minio::s3::ListObjectsResponse minio::s3::BaseClient::ListObjectsV2(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "ListObjectsV2";
   req.bucket_name = args.bucket;
   req.query_params.Add("list-type", "2");
   req.query_params.AddAll(GetCommonListObjectsQueryParams(
@@ -1147,8 +1349,8 @@ minio::s3::ListObjectsResponse minio::s3::BaseClient::ListObjectVersions(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "ListObjectVersions";
   req.bucket_name = args.bucket;
   req.query_params.Add("versions", "");
   req.query_params.AddAll(GetCommonListObjectsQueryParams(
@@ -1180,25 +1382,23 @@ minio::s3::MakeBucketResponse minio::s3::BaseClient::MakeBucket(
   if (region.empty()) region = base_region;
   if (region.empty()) region = "us-east-1";
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "MakeBucket";
   req.bucket_name = args.bucket;
   if (args.object_lock) {
     req.headers.Add("x-amz-bucket-object-lock-enabled", "true");
   }
 
-  std::string body;
   if (region != "us-east-1") {
-    std::stringstream ss;
-    ss << "<CreateBucketConfiguration>"
-       << "<LocationConstraint>" << region << "</LocationConstraint>"
-       << "</CreateBucketConfiguration>";
-    body = ss.str();
-    req.body = body;
+    xml::Writer writer(128);
+    writer.Start("CreateBucketConfiguration")
+        .Element("LocationConstraint", region)
+        .End("CreateBucketConfiguration");
+    setBody(req, writer.Finish());
   }
 
   Response resp = Execute(req);
-  if (resp) region_map_[args.bucket] = region;
+  if (resp) region_cache_.Set(args.bucket, region);
 
   return resp;
 }
@@ -1214,13 +1414,17 @@ minio::s3::PutObjectResponse minio::s3::BaseClient::PutObject(
     return resp;
   }
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  bool upload_part = args.query_params.Contains("partNumber");
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = upload_part ? "UploadPart" : "PutObject";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   req.query_params.AddAll(args.query_params);
-  req.headers.AddAll(args.headers);
+  req.headers.AddAll(std::move(args.headers));
   req.body = args.data;
+  // A duplicate part upload is harmless, but a duplicate PUT of an object
+  // may add an extra version on versioned buckets.
+  req.hedgeable = upload_part;
 
   Response response = Execute(req);
   if (!response) return response;
@@ -1243,8 +1447,8 @@ minio::s3::RemoveBucketResponse minio::s3::BaseClient::RemoveBucket(
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "RemoveBucket";
   req.bucket_name = args.bucket;
 
   return Execute(req);
@@ -1261,8 +1465,8 @@ minio::s3::RemoveObjectResponse minio::s3::BaseClient::RemoveObject(
     return resp;
   }
 
-  Request req(http::Method::kDelete, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kDelete, region, base_url_, args);
+  req.api = "RemoveObject";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
@@ -1283,30 +1487,35 @@ minio::s3::RemoveObjectsResponse minio::s3::BaseClient::RemoveObjects(
     return resp;
   }
 
-  Request req(http::Method::kPost, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPost, region, base_url_, args);
+  req.api = "RemoveObjects";
   req.bucket_name = args.bucket;
   req.query_params.Add("delete", "");
   if (args.bypass_governance_mode) {
     req.headers.Add("x-amz-bypass-governance-retention", "true");
   }
 
-  std::stringstream ss;
-  ss << "<Delete>";
-  if (args.quiet) ss << "<Quiet>true</Quiet>";
+  size_t size = 64;
   for (auto& object : args.objects) {
-    ss << "<Object>";
-    ss << "<Key>" << object.name << "</Key>";
+    size += 32 + object.name.size();
+    if (!object.version_id.empty()) size += 24 + object.version_id.size();
+  }
+
+  xml::Writer writer(size);
+  writer.Start("Delete");
+  if (args.quiet) writer.Element("Quiet", "true");
+  for (auto& object : args.objects) {
+    writer.Start("Object");
+    writer.Element("Key", object.name);
     if (!object.version_id.empty()) {
-      ss << "<VersionId>" << object.version_id << "</VersionId>";
+      writer.Element("VersionId", object.version_id);
     }
-    ss << "</Object>";
+    writer.End("Object");
   }
-  ss << "</Delete>";
-  std::string body = ss.str();
-  req.body = body;
+  writer.End("Delete");
+  xml::Body body = writer.Finish();
   req.headers.Add("Content-Type", "application/xml");
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   Response response = Execute(req);
   if (!response) return response;
@@ -1329,15 +1538,16 @@ minio::s3::BaseClient::SelectObjectContent(SelectObjectContentArgs args) {
     return resp;
   }
 
-  Request req(http::Method::kPost, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPost, region, base_url_, args);
+  req.api = "SelectObjectContent";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   req.query_params.Add("select", "");
   req.query_params.Add("select-type", "2");
-  std::string body = args.request.ToXML();
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
-  req.body = body;
+  xml::Writer writer(512 + args.request.expr.size());
+  args.request.ToXML(writer);
+  xml::Body body = writer.Finish();
+  setBody(req, std::move(body));
 
   SelectHandler handler(args.resultfunc);
   using namespace std::placeholders;
@@ -1357,24 +1567,22 @@ minio::s3::BaseClient::SetBucketEncryption(SetBucketEncryptionArgs args) {
     return resp;
   }
 
-  std::stringstream ss;
-  ss << "<ServerSideEncryptionConfiguration>";
-  ss << "<Rule><ApplyServerSideEncryptionByDefault>";
-  ss << "<SSEAlgorithm>" << args.config.sse_algorithm << "</SSEAlgorithm>";
+  xml::Writer writer(256);
+  writer.Start("ServerSideEncryptionConfiguration");
+  writer.Start("Rule").Start("ApplyServerSideEncryptionByDefault");
+  writer.Element("SSEAlgorithm", args.config.sse_algorithm);
   if (!args.config.kms_master_key_id.empty()) {
-    ss << "<KMSMasterKeyID>" << args.config.kms_master_key_id
-       << "</KMSMasterKeyID>";
+    writer.Element("KMSMasterKeyID", args.config.kms_master_key_id);
   }
-  ss << "</ApplyServerSideEncryptionByDefault></Rule>";
-  ss << "</ServerSideEncryptionConfiguration>";
-  std::string body = ss.str();
+  writer.End("ApplyServerSideEncryptionByDefault").End("Rule");
+  writer.End("ServerSideEncryptionConfiguration");
+  xml::Body body = writer.Finish();
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetBucketEncryption";
   req.bucket_name = args.bucket;
   req.query_params.Add("encryption", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -1390,14 +1598,15 @@ minio::s3::SetBucketLifecycleResponse minio::s3::BaseClient::SetBucketLifecycle(
     return resp;
   }
 
-  std::string body = args.config.ToXML();
+  xml::Writer writer(1024);
+  args.config.ToXML(writer);
+  xml::Body body = writer.Finish();
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetBucketLifecycle";
   req.bucket_name = args.bucket;
   req.query_params.Add("lifecycle", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -1413,14 +1622,15 @@ minio::s3::BaseClient::SetBucketNotification(SetBucketNotificationArgs args) {
     return resp;
   }
 
-  std::string body = args.config.ToXML();
+  xml::Writer writer(1024);
+  args.config.ToXML(writer);
+  xml::Body body = writer.Finish();
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetBucketNotification";
   req.bucket_name = args.bucket;
   req.query_params.Add("notification", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -1436,8 +1646,8 @@ minio::s3::SetBucketPolicyResponse minio::s3::BaseClient::SetBucketPolicy(
     return resp;
   }
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetBucketPolicy";
   req.bucket_name = args.bucket;
   req.query_params.Add("policy", "");
   req.body = args.policy;
@@ -1457,14 +1667,15 @@ minio::s3::BaseClient::SetBucketReplication(SetBucketReplicationArgs args) {
     return resp;
   }
 
-  std::string body = args.config.ToXML();
+  xml::Writer writer(1024);
+  args.config.ToXML(writer);
+  xml::Body body = writer.Finish();
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetBucketReplication";
   req.bucket_name = args.bucket;
   req.query_params.Add("replication", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -1480,28 +1691,13 @@ minio::s3::SetBucketTagsResponse minio::s3::BaseClient::SetBucketTags(
     return resp;
   }
 
-  std::stringstream ss;
-  ss << "<Tagging>";
-  if (!args.tags.empty()) {
-    ss << "<TagSet>";
-    for (auto& [key, value] : args.tags) {
-      ss << "<Tag>"
-         << "<Key>" << key << "</Key>"
-         << "<Value>" << value << "</Value>"
-         << "</Tag>";
-    }
-    ss << "</TagSet>";
-  }
-  ss << "</Tagging>";
-
-  std::string body = ss.str();
+  xml::Body body = taggingBody(args.tags);
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetBucketTags";
   req.bucket_name = args.bucket;
   req.query_params.Add("tagging", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -1517,25 +1713,22 @@ minio::s3::BaseClient::SetBucketVersioning(SetBucketVersioningArgs args) {
     return resp;
   }
 
-  std::stringstream ss;
-  ss << "<VersioningConfiguration>";
+  xml::Writer writer(128);
+  writer.Start("VersioningConfiguration");
   if (args.status) {
-    ss << "<Status>" << (args.status.Get() ? "Enabled" : "Suspended")
-       << "</Status>";
+    writer.Element("Status", args.status.Get() ? "Enabled" : "Suspended");
   }
   if (args.mfa_delete) {
-    ss << "<MFADelete>" << (args.mfa_delete.Get() ? "Enabled" : "Disabled")
-       << "</MFADelete>";
+    writer.Element("MFADelete", args.mfa_delete.Get() ? "Enabled" : "Disabled");
   }
-  ss << "</VersioningConfiguration>";
-  std::string body = ss.str();
+  writer.End("VersioningConfiguration");
+  xml::Body body = writer.Finish();
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetBucketVersioning";
   req.bucket_name = args.bucket;
   req.query_params.Add("versioning", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -1551,35 +1744,28 @@ minio::s3::BaseClient::SetObjectLockConfig(SetObjectLockConfigArgs args) {
     return resp;
   }
 
-  std::stringstream ss;
-  ss << "<ObjectLockConfiguration>";
-  ss << "<ObjectLockEnabled>Enabled</ObjectLockEnabled>";
+  xml::Writer writer(256);
+  writer.Start("ObjectLockConfiguration");
+  writer.Element("ObjectLockEnabled", "Enabled");
   if (IsRetentionModeValid(args.config.retention_mode)) {
-    ss << "<Rule><DefaultRetention>";
-    ss << "<Mode>" << RetentionModeToString(args.config.retention_mode)
-       << "</Mode>";
+    writer.Start("Rule").Start("DefaultRetention");
+    writer.Element("Mode", RetentionModeToString(args.config.retention_mode));
     if (args.config.retention_duration_days) {
-      ss << "<Days>"
-         << std::to_string(args.config.retention_duration_days.Get())
-         << "</Days>";
+      writer.Element("Days", args.config.retention_duration_days.Get());
     }
     if (args.config.retention_duration_years) {
-      ss << "<Years>"
-         << std::to_string(args.config.retention_duration_years.Get())
-         << "</Years>";
+      writer.Element("Years", args.config.retention_duration_years.Get());
     }
-    ss << "</DefaultRetention></Rule>";
+    writer.End("DefaultRetention").End("Rule");
   }
-  ss << "</ObjectLockConfiguration>";
-
-  std::string body = ss.str();
+  writer.End("ObjectLockConfiguration");
+  xml::Body body = writer.Finish();
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetObjectLockConfig";
   req.bucket_name = args.bucket;
   req.query_params.Add("object-lock", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -1595,25 +1781,22 @@ minio::s3::SetObjectRetentionResponse minio::s3::BaseClient::SetObjectRetention(
     return resp;
   }
 
-  std::stringstream ss;
-  ss << "<Retention>"
-     << "<Mode>" << RetentionModeToString(args.retention_mode) << "</Mode>"
-     << "<RetainUntilDate>" << args.retain_until_date.ToISO8601UTC()
-     << "</RetainUntilDate>"
-     << "</Retention>";
-
-  std::string body = ss.str();
+  xml::Writer writer(128);
+  writer.Start("Retention");
+  writer.Element("Mode", RetentionModeToString(args.retention_mode));
+  writer.Element("RetainUntilDate", args.retain_until_date.ToISO8601UTC());
+  writer.End("Retention");
+  xml::Body body = writer.Finish();
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetObjectRetention";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
     req.query_params.Add("versionId", args.version_id);
   }
   req.query_params.Add("retention", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -1629,32 +1812,17 @@ minio::s3::SetObjectTagsResponse minio::s3::BaseClient::SetObjectTags(
     return resp;
   }
 
-  std::stringstream ss;
-  ss << "<Tagging>";
-  if (!args.tags.empty()) {
-    ss << "<TagSet>";
-    for (auto& [key, value] : args.tags) {
-      ss << "<Tag>"
-         << "<Key>" << key << "</Key>"
-         << "<Value>" << value << "</Value>"
-         << "</Tag>";
-    }
-    ss << "</TagSet>";
-  }
-  ss << "</Tagging>";
-
-  std::string body = ss.str();
+  xml::Body body = taggingBody(args.tags);
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "SetObjectTags";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
     req.query_params.Add("versionId", args.version_id);
   }
   req.query_params.Add("tagging", "");
-  req.body = body;
-  req.headers.Add("Content-MD5", utils::Md5sumHash(body));
+  setBody(req, std::move(body));
 
   return Execute(req);
 }
@@ -1675,58 +1843,60 @@ minio::s3::StatObjectResponse minio::s3::BaseClient::StatObject(
     return resp;
   }
 
-  Request req(http::Method::kHead, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kHead, region, base_url_, args);
+  req.api = "StatObject";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
     req.query_params.Add("versionId", args.version_id);
   }
+  req.hedgeable = true;
   req.headers.AddAll(args.Headers());
 
   Response response = Execute(req);
   if (!response) return response;
 
-  StatObjectResponse resp = response;
+  // Take over headers and body instead of copying them.
+  StatObjectResponse resp(std::move(response));
   resp.bucket_name = args.bucket;
   resp.object_name = args.object;
-  resp.version_id = response.headers.GetFront("x-amz-version-id");
+  resp.version_id = resp.headers.GetFront("x-amz-version-id");
 
-  resp.etag = utils::Trim(response.headers.GetFront("etag"), '"');
+  resp.etag = utils::Trim(resp.headers.GetFront("etag"), '"');
 
-  std::string value = response.headers.GetFront("content-length");
+  std::string value = resp.headers.GetFront("content-length");
   if (!value.empty()) resp.size = std::stoi(value);
 
-  value = response.headers.GetFront("last-modified");
+  value = resp.headers.GetFront("last-modified");
   if (!value.empty()) {
     resp.last_modified = utils::Time::FromHttpHeaderValue(value.c_str());
   }
 
-  value = response.headers.GetFront("x-amz-object-lock-mode");
+  value = resp.headers.GetFront("x-amz-object-lock-mode");
   if (!value.empty()) resp.retention_mode = StringToRetentionMode(value);
 
-  value = response.headers.GetFront("x-amz-object-lock-retain-until-date");
+  value = resp.headers.GetFront("x-amz-object-lock-retain-until-date");
   if (!value.empty()) {
     resp.retention_retain_until_date =
         utils::Time::FromISO8601UTC(value.c_str());
   }
 
-  value = response.headers.GetFront("x-amz-object-lock-legal-hold");
+  value = resp.headers.GetFront("x-amz-object-lock-legal-hold");
   if (!value.empty()) resp.legal_hold = StringToLegalHold(value);
 
-  value = response.headers.GetFront("x-amz-delete-marker");
+  value = resp.headers.GetFront("x-amz-delete-marker");
   if (!value.empty()) resp.delete_marker = utils::StringToBool(value);
 
   utils::Multimap user_metadata;
-  std::list<std::string> keys = response.headers.Keys();
+  std::list<std::string> keys = resp.headers.Keys();
   for (auto key : keys) {
     if (utils::StartsWith(key, "x-amz-meta-")) {
-      std::list<std::string> values = response.headers.Get(key);
+      std::list<std::string> values = resp.headers.Get(key);
       key.erase(0, 11);
       for (auto value : values) user_metadata.Add(key, value);
     }
   }
-  resp.user_metadata = user_metadata;
+  resp.user_metadata = std::move(user_metadata);
 
   return resp;
 }
@@ -1740,8 +1910,7 @@ minio::s3::UploadPartResponse minio::s3::BaseClient::UploadPart(
   query_params.Add("uploadId", args.upload_id);
 
   PutObjectApiArgs api_args;
-  api_args.extra_headers = args.extra_headers;
-  api_args.extra_query_params = args.extra_query_params;
+  static_cast<BaseArgs&>(api_args) = args;
   api_args.bucket = args.bucket;
   api_args.region = args.region;
   api_args.object = args.object;
@@ -1762,14 +1931,14 @@ minio::s3::UploadPartCopyResponse minio::s3::BaseClient::UploadPartCopy(
     return resp;
   }
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "UploadPartCopy";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   req.query_params.AddAll(args.extra_query_params);
   req.query_params.Add("partNumber", std::to_string(args.part_number));
   req.query_params.Add("uploadId", args.upload_id);
-  req.headers.AddAll(args.headers);
+  req.headers.AddAll(std::move(args.headers));
 
   Response response = Execute(req);
   if (!response) return response;
@@ -15,6 +15,11 @@
 
 #include "client.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 minio::s3::ListObjectsResult::ListObjectsResult(error::Error err) {
   this->failed_ = true;
   this->resp_.contents.push_back(Item(err));
@@ -24,7 +29,7 @@ minio::s3::ListObjectsResult::ListObjectsResult(error::Error err) {
 minio::s3::ListObjectsResult::ListObjectsResult(Client* client,
                                                 ListObjectsArgs* args) {
   this->client_ = client;
-  this->args_ = args;
+  this->args_ = std::make_shared<ListObjectsArgs>(*args);
   Populate();
 }
 
@@ -69,6 +74,202 @@ void minio::s3::ListObjectsResult::Populate() {
   itr_ = resp_.contents.begin();
 }
 
+/**
+ * Batches pulls objects of RemoveObjectsArgs, or lists them if listing args
+ * are given, in batches of up to 1000 and removes them. With concurrency of
+ * one, Next() removes a batch in the calling thread. Otherwise worker
+ * threads keep a batch each in flight, so listing by one overlaps removal
+ * by others, and queue errors for Next(); they stop pulling objects while
+ * more than kMaxBatchErrors errors per worker wait to be read.
+ */
+class minio::s3::RemoveObjectsResult::Batches {
+ private:
+  static constexpr size_t kMaxBatchErrors = 1000;
+
+  Client* client_;
+  RemoveObjectsArgs args_;
+  bool list_ = false;  // Objects are listed instead of pulled from func.
+  std::mutex func_mutex_;
+  ListObjectsArgs listing_args_;               // Guarded by func_mutex_.
+  std::unique_ptr<ListObjectsResult> listing_;  // Guarded by func_mutex_.
+  bool exhausted_ = false;                      // Guarded by func_mutex_.
+  std::atomic<size_t> pulled_ = 0;
+  std::chrono::steady_clock::time_point start_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::list<DeleteError> errors_;
+  RemoveObjectsProgress progress_;
+  unsigned int running_ = 0;
+  bool stop_ = false;
+  std::list<std::thread> workers_;
+  std::mutex progress_mutex_;  // Serializes progressfunc calls.
+  size_t reported_ = 0;        // Guarded by progress_mutex_.
+
+  // pull takes next object from listing or func. A listing error is added to
+  // errors.
+  bool pull(DeleteObject& object, std::list<DeleteError>& errors) {
+    if (listing_ == NULL) return args_.func(object);
+
+    ListObjectsResult& result = *listing_;
+    if (!result) return false;
+    Item& item = *result;
+    if (!item) {
+      errors.push_back(DeleteError(item));
+      return false;
+    }
+    object.name = std::move(item.name);
+    if (listing_args_.include_versions) {
+      object.version_id = std::move(item.version_id);
+    }
+    ++result;
+    return true;
+  }
+
+  bool next(RemoveObjectsApiArgs& args, std::list<DeleteError>& errors) {
+    static_cast<BaseArgs&>(args) = args_;
+    args.bucket = args_.bucket;
+    args.region = args_.region;
+    args.quiet = true;
+    args.bypass_governance_mode = args_.bypass_governance_mode;
+
+    std::lock_guard<std::mutex> lock(func_mutex_);
+    if (list_ && listing_ == NULL) {
+      listing_ = std::make_unique<ListObjectsResult>(client_, &listing_args_);
+    }
+    for (int i = 0; !exhausted_ && i < 1000; i++) {
+      DeleteObject object;
+      if (pull(object, errors)) {
+        args.objects.push_back(std::move(object));
+      } else {
+        exhausted_ = true;
+      }
+    }
+    pulled_ += args.objects.size();
+    return !args.objects.empty();
+  }
+
+  // remove removes objects of args, then queues errors and reports progress.
+  void remove(RemoveObjectsApiArgs& args, std::list<DeleteError>& errors) {
+    size_t failed = 0;
+    if (!args.objects.empty()) {
+      RemoveObjectsResponse resp = client_->BaseClient::RemoveObjects(args);
+      if (resp) {
+        failed = resp.errors.size();
+        errors.splice(errors.end(), resp.errors);
+      } else {
+        failed = args.objects.size();
+        errors.push_back(DeleteError(resp));
+      }
+    }
+
+    RemoveObjectsProgress progress;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      errors_.splice(errors_.end(), errors);
+      cond_.notify_all();
+      if (args.objects.empty()) return;
+
+      progress_.pulled = pulled_;
+      progress_.removed += args.objects.size() - failed;
+      progress_.failed += failed;
+      progress_.elapsed = std::chrono::steady_clock::now() - start_;
+      progress = progress_;
+    }
+
+    if (args_.progressfunc == NULL) return;
+    std::lock_guard<std::mutex> lock(progress_mutex_);
+    // Progress of another batch may have been reported meanwhile.
+    size_t done = progress.removed + progress.failed;
+    if (done <= reported_) return;
+    reported_ = done;
+    args_.progressfunc(progress);
+  }
+
+  void run() {
+    size_t max_errors = kMaxBatchErrors * args_.concurrency;
+    bool more = true;
+    while (more) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock,
+                   [&] { return stop_ || errors_.size() < max_errors; });
+        if (stop_) break;
+      }
+
+      RemoveObjectsApiArgs args;
+      std::list<DeleteError> errors;
+      more = next(args, errors);
+      remove(args, errors);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_--;
+    cond_.notify_all();
+  }
+
+  void startWorkers() {
+    start_ = std::chrono::steady_clock::now();
+    if (args_.concurrency <= 1) return;
+    running_ = args_.concurrency;
+    for (unsigned int i = 0; i < args_.concurrency; i++) {
+      workers_.emplace_back(&Batches::run, this);
+    }
+  }
+
+ public:
+  Batches(Client* client, RemoveObjectsArgs* args)
+      : client_(client), args_(*args) {
+    startWorkers();
+  }
+
+  Batches(Client* client, RemovePrefixArgs* args) : client_(client) {
+    static_cast<BaseArgs&>(args_) = *args;
+    args_.bucket = args->bucket;
+    args_.region = args->region;
+    args_.bypass_governance_mode = args->bypass_governance_mode;
+    args_.concurrency = args->concurrency;
+    args_.progressfunc = args->progressfunc;
+
+    listing_args_.extra_headers = args->extra_headers;
+    listing_args_.InheritLimits(*args);
+    listing_args_.bucket = args->bucket;
+    listing_args_.region = args->region;
+    listing_args_.prefix = args->prefix;
+    listing_args_.recursive = true;
+    listing_args_.include_versions = args->include_versions;
+    list_ = true;
+    startWorkers();
+  }
+
+  ~Batches() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cond_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+
+  // Next sets errors of next removed batches. It returns false once all
+  // objects are removed.
+  bool Next(std::list<DeleteError>& errors) {
+    bool more = true;
+    if (workers_.empty()) {
+      RemoveObjectsApiArgs args;
+      std::list<DeleteError> batch;
+      more = next(args, batch);
+      remove(args, batch);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return !errors_.empty() || running_ == 0; });
+    errors.clear();
+    errors.swap(errors_);
+    cond_.notify_all();
+    return workers_.empty() ? more || !errors.empty() : !errors.empty();
+  }
+};  // class RemoveObjectsResult::Batches
+
 minio::s3::RemoveObjectsResult::RemoveObjectsResult(error::Error err) {
   done_ = true;
   resp_.errors.push_back(DeleteError(err));
@@ -77,42 +278,32 @@ minio::s3::RemoveObjectsResult::RemoveObjectsResult(error::Error err) {
 
 minio::s3::RemoveObjectsResult::RemoveObjectsResult(Client* client,
                                                     RemoveObjectsArgs* args) {
-  client_ = client;
-  args_ = args;
+  batches_ = std::make_shared<Batches>(client, args);
   Populate();
 }
 
-void minio::s3::RemoveObjectsResult::Populate() {
-  while (!done_ && resp_.errors.size() == 0) {
-    RemoveObjectsApiArgs args;
-    args.extra_headers = args_->extra_headers;
-    args.extra_query_params = args_->extra_query_params;
-    args.bucket = args_->bucket;
-    args.region = args_->region;
-    args.quiet = true;
-    args.bypass_governance_mode = args_->bypass_governance_mode;
-
-    for (int i = 0; i < 1000; i++) {
-      DeleteObject object;
-      if (!args_->func(object)) break;
-      args.objects.push_back(object);
-    }
+minio::s3::RemoveObjectsResult::RemoveObjectsResult(Client* client,
+                                                    RemovePrefixArgs* args) {
+  batches_ = std::make_shared<Batches>(client, args);
+  Populate();
+}
 
-    if (args.objects.size() != 0) {
-      resp_ = client_->BaseClient::RemoveObjects(args);
-      if (!resp_) resp_.errors.push_back(DeleteError(resp_));
-      itr_ = resp_.errors.begin();
-    } else {
-      done_ = true;
-    }
+void minio::s3::RemoveObjectsResult::Populate() {
+  resp_.errors.clear();
+  while (!done_ && resp_.errors.empty()) {
+    done_ = !batches_->Next(resp_.errors);
   }
+  itr_ = resp_.errors.begin();
 }
 
 minio::s3::Client::Client(BaseUrl& base_url, creds::Provider* provider)
     : BaseClient(base_url, provider) {}
 
+minio::s3::Client::Client(EndpointPool& endpoints, creds::Provider* provider)
+    : BaseClient(endpoints, provider) {}
+
 minio::s3::StatObjectResponse minio::s3::Client::CalculatePartCount(
-    size_t& part_count, std::list<ComposeSource> sources) {
+    size_t& part_count, std::list<ComposeSource>& sources) {
   size_t object_size = 0;
   int i = 0;
   for (auto& source : sources) {
@@ -203,15 +394,14 @@ minio::s3::ComposeObjectResponse minio::s3::Client::ComposeObject(
   ComposeSource& source = args.sources.front();
   if (part_count == 1 && source.offset == NULL && source.length == NULL) {
     CopyObjectArgs coargs;
-    coargs.extra_headers = args.extra_headers;
-    coargs.extra_query_params = args.extra_query_params;
+    static_cast<BaseArgs&>(coargs) = args;
     coargs.bucket = args.bucket;
     coargs.region = args.region;
     coargs.object = args.object;
     coargs.sse = args.sse;
     coargs.source = source;
 
-    return CopyObject(coargs);
+    return CopyObject(std::move(coargs));
   }
 
   utils::Multimap headers = args.Headers();
@@ -219,6 +409,7 @@ minio::s3::ComposeObjectResponse minio::s3::Client::ComposeObject(
   {
     CreateMultipartUploadArgs cmu_args;
     cmu_args.extra_query_params = args.extra_query_params;
+    cmu_args.InheritLimits(args);
     cmu_args.bucket = args.bucket;
     cmu_args.region = args.region;
     cmu_args.object = args.object;
@@ -267,10 +458,11 @@ minio::s3::ComposeObjectResponse minio::s3::Client::ComposeObject(
       }
 
       UploadPartCopyArgs upc_args;
+      upc_args.InheritLimits(args);
       upc_args.bucket = args.bucket;
       upc_args.region = args.region;
       upc_args.object = args.object;
-      upc_args.headers = headers;
+      upc_args.headers = std::move(headers);
       upc_args.upload_id = upload_id;
       upc_args.part_number = part_number;
       UploadPartCopyResponse resp = UploadPartCopy(upc_args);
@@ -291,10 +483,11 @@ minio::s3::ComposeObjectResponse minio::s3::Client::ComposeObject(
                             std::to_string(end_bytes));
 
         UploadPartCopyArgs upc_args;
+        upc_args.InheritLimits(args);
         upc_args.bucket = args.bucket;
         upc_args.region = args.region;
         upc_args.object = args.object;
-        upc_args.headers = headerscopy;
+        upc_args.headers = std::move(headerscopy);
         upc_args.upload_id = upload_id;
         upc_args.part_number = part_number;
         UploadPartCopyResponse resp = UploadPartCopy(upc_args);
@@ -308,12 +501,13 @@ minio::s3::ComposeObjectResponse minio::s3::Client::ComposeObject(
   }
 
   CompleteMultipartUploadArgs cmu_args;
+  cmu_args.InheritLimits(args);
   cmu_args.bucket = args.bucket;
   cmu_args.region = args.region;
   cmu_args.object = args.object;
   cmu_args.upload_id = upload_id;
-  cmu_args.parts = parts;
-  return CompleteMultipartUpload(cmu_args);
+  cmu_args.parts = std::move(parts);
+  return CompleteMultipartUpload(std::move(cmu_args));
 }
 
 minio::s3::PutObjectResponse minio::s3::Client::PutObject(
@@ -393,18 +587,20 @@ minio::s3::PutObjectResponse minio::s3::Client::PutObject(
     if (part_count == 1) {
       PutObjectApiArgs api_args;
       api_args.extra_query_params = args.extra_query_params;
+      api_args.InheritLimits(args);
       api_args.bucket = args.bucket;
       api_args.region = args.region;
       api_args.object = args.object;
       api_args.data = data;
-      api_args.headers = headers;
+      api_args.headers = std::move(headers);
 
-      return BaseClient::PutObject(api_args);
+      return BaseClient::PutObject(std::move(api_args));
     }
 
     if (upload_id.empty()) {
       CreateMultipartUploadArgs cmu_args;
       cmu_args.extra_query_params = args.extra_query_params;
+      cmu_args.InheritLimits(args);
       cmu_args.bucket = args.bucket;
       cmu_args.region = args.region;
       cmu_args.object = args.object;
@@ -418,6 +614,7 @@ minio::s3::PutObjectResponse minio::s3::Client::PutObject(
     }
 
     UploadPartArgs up_args;
+    up_args.InheritLimits(args);
     up_args.bucket = args.bucket;
     up_args.region = args.region;
     up_args.object = args.object;
@@ -430,7 +627,7 @@ minio::s3::PutObjectResponse minio::s3::Client::PutObject(
       }
     }
 
-    if (UploadPartResponse resp = UploadPart(up_args)) {
+    if (UploadPartResponse resp = UploadPart(std::move(up_args))) {
       parts.push_back(Part{part_number, resp.etag});
     } else {
       return resp;
@@ -438,12 +635,13 @@ minio::s3::PutObjectResponse minio::s3::Client::PutObject(
   }
 
   CompleteMultipartUploadArgs cmu_args;
+  cmu_args.InheritLimits(args);
   cmu_args.bucket = args.bucket;
   cmu_args.region = args.region;
   cmu_args.object = args.object;
   cmu_args.upload_id = upload_id;
-  cmu_args.parts = parts;
-  return CompleteMultipartUpload(cmu_args);
+  cmu_args.parts = std::move(parts);
+  return CompleteMultipartUpload(std::move(cmu_args));
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -461,6 +659,7 @@ minio::s3::ComposeObjectResponse minio::s3::Client::ComposeObject(
   ComposeObjectResponse resp = ComposeObject(args, upload_id);
   if (!resp && !upload_id.empty()) {
     AbortMultipartUploadArgs amu_args;
+    amu_args.InheritLimits(args);
     amu_args.bucket = args.bucket;
     amu_args.region = args.region;
     amu_args.object = args.object;
@@ -511,8 +710,7 @@ minio::s3::CopyObjectResponse minio::s3::Client::CopyObject(
     }
 
     ComposeSource src;
-    src.extra_headers = args.source.extra_headers;
-    src.extra_query_params = args.source.extra_query_params;
+    static_cast<BaseArgs&>(src) = args.source;
     src.bucket = args.source.bucket;
     src.region = args.source.region;
     src.object = args.source.object;
@@ -525,15 +723,14 @@ minio::s3::CopyObjectResponse minio::s3::Client::CopyObject(
     src.unmodified_since = args.source.unmodified_since;
 
     ComposeObjectArgs coargs;
-    coargs.extra_headers = args.extra_headers;
-    coargs.extra_query_params = args.extra_query_params;
+    static_cast<BaseArgs&>(coargs) = args;
     coargs.bucket = args.bucket;
     coargs.region = args.region;
     coargs.object = args.object;
     coargs.sse = args.sse;
-    coargs.sources.push_back(src);
+    coargs.sources.push_back(std::move(src));
 
-    return ComposeObject(coargs);
+    return ComposeObject(std::move(coargs));
   }
 
   utils::Multimap headers;
@@ -556,11 +753,11 @@ minio::s3::CopyObjectResponse minio::s3::Client::CopyObject(
     return resp;
   }
 
-  Request req(http::Method::kPut, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kPut, region, base_url_, args);
+  req.api = "CopyObject";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
-  req.headers.AddAll(headers);
+  req.headers.AddAll(std::move(headers));
 
   Response response = Execute(req);
   if (!response) return response;
@@ -585,6 +782,7 @@ minio::s3::DownloadObjectResponse minio::s3::Client::DownloadObject(
   size_t size;
   {
     StatObjectArgs soargs;
+    soargs.InheritLimits(args);
     soargs.bucket = args.bucket;
     soargs.region = args.region;
     soargs.object = args.object;
@@ -598,10 +796,8 @@ minio::s3::DownloadObjectResponse minio::s3::Client::DownloadObject(
 
   std::string temp_filename =
       args.filename + "." + curlpp::escape(etag) + ".part.minio";
-  std::ofstream fout(temp_filename, fout.trunc | fout.out);
-  if (!fout.is_open()) {
-    return error::Error("unable to open file " + temp_filename);
-  }
+  fileio::Writer fout(args.io_engine, args.cache_mode);
+  if (error::Error err = fout.Open(temp_filename)) return err;
 
   std::string region;
   if (GetRegionResponse resp = GetRegion(args.bucket, args.region)) {
@@ -610,20 +806,23 @@ minio::s3::DownloadObjectResponse minio::s3::Client::DownloadObject(
     return resp;
   }
 
-  Request req(http::Method::kGet, region, base_url_, args.extra_headers,
-              args.extra_query_params);
+  Request req(http::Method::kGet, region, base_url_, args);
+  req.api = "DownloadObject";
   req.bucket_name = args.bucket;
   req.object_name = args.object;
   if (!args.version_id.empty()) {
     req.query_params.Add("versionId", args.version_id);
   }
   req.datafunc = [&fout = fout](http::DataFunctionArgs args) -> bool {
-    fout << args.datachunk;
-    return true;
+    return !fout.Write(args.datachunk);
   };
+  req.resumable = true;
+  req.hedgeable = true;
 
   Response response = Execute(req);
-  fout.close();
+  if (error::Error err = fout.Close()) {
+    if (response) return err;
+  }
   if (response) std::filesystem::rename(temp_filename, args.filename);
   return response;
 }
@@ -655,6 +854,7 @@ minio::s3::PutObjectResponse minio::s3::Client::PutObject(PutObjectArgs args) {
 
   if (!resp && !upload_id.empty()) {
     AbortMultipartUploadArgs amu_args;
+    amu_args.InheritLimits(args);
     amu_args.bucket = args.bucket;
     amu_args.region = args.region;
     amu_args.object = args.object;
@@ -669,18 +869,12 @@ minio::s3::UploadObjectResponse minio::s3::Client::UploadObject(
     UploadObjectArgs args) {
   if (error::Error err = args.Validate()) return err;
 
-  std::ifstream file;
-  file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-  try {
-    file.open(args.filename);
-  } catch (std::system_error& err) {
-    return error::Error("unable to open file " + args.filename + "; " +
-                        err.code().message());
-  }
+  fileio::Reader reader(args.io_engine, args.cache_mode);
+  if (error::Error err = reader.Open(args.filename)) return err;
+  std::istream file(&reader);
 
   PutObjectArgs po_args(file, args.object_size, 0);
-  po_args.extra_headers = args.extra_headers;
-  po_args.extra_query_params = args.extra_query_params;
+  static_cast<BaseArgs&>(po_args) = args;
   po_args.bucket = args.bucket;
   po_args.region = args.region;
   po_args.object = args.object;
@@ -693,7 +887,7 @@ minio::s3::UploadObjectResponse minio::s3::Client::UploadObject(
   po_args.content_type = args.content_type;
 
   PutObjectResponse resp = PutObject(po_args);
-  file.close();
+  if (error::Error err = reader.Error()) return err;
   return resp;
 }
 
@@ -702,3 +896,9 @@ minio::s3::RemoveObjectsResult minio::s3::Client::RemoveObjects(
   if (error::Error err = args.Validate()) return err;
   return RemoveObjectsResult(this, &args);
 }
+
+minio::s3::RemoveObjectsResult minio::s3::Client::RemovePrefix(
+    RemovePrefixArgs args) {
+  if (error::Error err = args.Validate()) return err;
+  return RemoveObjectsResult(this, &args);
+}
@@ -0,0 +1,236 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "endpoints.h"
+
+#include <random>
+
+namespace {
+long long SteadyNow() {
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+// unreachable returns whether a transfer failed to reach the endpoint.
+// Other curl errors, like a data callback aborting the transfer, are not
+// failures of the endpoint.
+bool unreachable(CURLcode code) {
+  switch (code) {
+    case CURLE_COULDNT_RESOLVE_HOST:
+    case CURLE_COULDNT_CONNECT:
+    case CURLE_OPERATION_TIMEDOUT:
+    case CURLE_SSL_CONNECT_ERROR:
+    case CURLE_SEND_ERROR:
+    case CURLE_RECV_ERROR:
+    case CURLE_GOT_NOTHING:
+    case CURLE_PARTIAL_FILE:
+      return true;
+    default:
+      return false;
+  }
+}
+}  // namespace
+
+minio::s3::EndpointPool::EndpointPool(std::list<std::string> hosts,
+                                      bool https) {
+  if (hosts.empty()) {
+    err_ = error::Error("at least one endpoint must be provided");
+    return;
+  }
+
+  for (auto& host : hosts) {
+    BaseUrl base_url(host, https);
+    if (!base_url) {
+      err_ = base_url.Error();
+      return;
+    }
+    if (endpoints_.empty()) base_url_ = base_url;
+    endpoints_.push_back(std::make_unique<Endpoint>(base_url));
+  }
+}
+
+minio::s3::EndpointPool::~EndpointPool() { StopHealthChecks(); }
+
+bool minio::s3::EndpointPool::healthy(Endpoint& endpoint, long long now) {
+  return endpoint.ejected_until.load() <= now;
+}
+
+void minio::s3::EndpointPool::eject(Endpoint& endpoint) {
+  unsigned int ejections = endpoint.ejections++;
+  std::chrono::steady_clock::duration period = kMinEjection;
+  for (unsigned int i = 0; i < ejections && period < kMaxEjection; i++) {
+    period *= 2;
+  }
+  if (period > kMaxEjection) period = kMaxEjection;
+  endpoint.consecutive_failures = 0;
+  endpoint.ejected_until = SteadyNow() + period.count();
+}
+
+void minio::s3::EndpointPool::restore(Endpoint& endpoint) {
+  endpoint.consecutive_failures = 0;
+  endpoint.ejections = 0;
+  endpoint.ejected_until = 0;
+}
+
+minio::s3::EndpointStats minio::s3::EndpointPool::Stats(size_t index) {
+  Endpoint& endpoint = *endpoints_[index];
+  EndpointStats stats;
+  stats.host = endpoint.base_url.host;
+  if (endpoint.base_url.port) {
+    stats.host += ":" + std::to_string(endpoint.base_url.port);
+  }
+  stats.healthy = healthy(endpoint, SteadyNow());
+  stats.outstanding = endpoint.outstanding;
+  stats.requests = endpoint.requests;
+  stats.failures = endpoint.failures;
+  stats.latency = std::chrono::microseconds(endpoint.latency_us);
+  return stats;
+}
+
+size_t minio::s3::EndpointPool::Pick() {
+  thread_local static std::mt19937 rg{std::random_device{}()};
+
+  long long now = SteadyNow();
+  std::vector<size_t> candidates;
+  candidates.reserve(endpoints_.size());
+  for (size_t i = 0; i < endpoints_.size(); i++) {
+    if (healthy(*endpoints_[i], now)) candidates.push_back(i);
+  }
+
+  size_t index = 0;
+  if (candidates.empty()) {
+    // Fail open to the endpoint due back first.
+    for (size_t i = 1; i < endpoints_.size(); i++) {
+      if (endpoints_[i]->ejected_until < endpoints_[index]->ejected_until) {
+        index = i;
+      }
+    }
+  } else if (candidates.size() == 1) {
+    index = candidates.front();
+  } else {
+    // Power of two choices.
+    std::uniform_int_distribution<size_t> pick(0, candidates.size() - 1);
+    size_t a = pick(rg);
+    size_t b = pick(rg);
+    while (b == a) b = pick(rg);
+
+    auto score = [&](size_t i) -> double {
+      Endpoint& endpoint = *endpoints_[i];
+      return (double)(endpoint.latency_us + 1) * (endpoint.outstanding + 1);
+    };
+    index = score(candidates[a]) <= score(candidates[b]) ? candidates[a]
+                                                         : candidates[b];
+  }
+
+  Endpoint& endpoint = *endpoints_[index];
+  endpoint.outstanding++;
+  endpoint.requests++;
+  return index;
+}
+
+void minio::s3::EndpointPool::Done(size_t index, http::Response& response,
+                                   std::chrono::microseconds elapsed) {
+  Endpoint& endpoint = *endpoints_[index];
+  endpoint.outstanding--;
+
+  if (unreachable(response.curl_code)) {
+    endpoint.failures++;
+    eject(endpoint);
+    return;
+  }
+  if (response.curl_code != CURLE_OK || response.status_code == 0) return;
+
+  switch (response.status_code) {
+    case 500:  // Internal Server Error
+    case 502:  // Bad Gateway
+    case 503:  // Service Unavailable
+    case 504:  // Gateway Timeout
+      endpoint.failures++;
+      if (++endpoint.consecutive_failures >= kMaxFailures) eject(endpoint);
+      return;
+  }
+
+  if (response.first_byte_time.count() > 0) {
+    elapsed = response.first_byte_time;
+  }
+  long long latency = endpoint.latency_us;
+  if (latency == 0) {
+    latency = elapsed.count();
+  } else {
+    latency += (elapsed.count() - latency) / 8;
+  }
+  endpoint.latency_us = latency;
+  endpoint.consecutive_failures = 0;
+  endpoint.ejections = 0;
+}
+
+void minio::s3::EndpointPool::IgnoreCertCheck(bool flag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ignore_cert_check_ = flag;
+}
+
+void minio::s3::EndpointPool::SetSslCertFile(std::string ssl_cert_file) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ssl_cert_file_ = ssl_cert_file;
+}
+
+void minio::s3::EndpointPool::check(std::chrono::seconds interval) {
+  while (true) {
+    bool ignore_cert_check;
+    std::string ssl_cert_file;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ignore_cert_check = ignore_cert_check_;
+      ssl_cert_file = ssl_cert_file_;
+    }
+
+    for (auto& endpoint : endpoints_) {
+      http::Url url;
+      url.https = endpoint->base_url.https;
+      url.host = endpoint->base_url.host;
+      url.port = endpoint->base_url.port;
+      url.path = "/minio/health/live";
+
+      http::Request request(http::Method::kGet, url);
+      request.timeout = kHealthCheckTimeout;
+      request.ignore_cert_check = ignore_cert_check;
+      if (!ssl_cert_file.empty()) request.ssl_cert_file = ssl_cert_file;
+      http::Response response = request.Execute();
+      if (response.status_code == 200) {
+        restore(*endpoint);
+      } else {
+        eject(*endpoint);
+      }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (cond_.wait_for(lock, interval, [&]() { return stop_; })) return;
+  }
+}
+
+void minio::s3::EndpointPool::StartHealthChecks(std::chrono::seconds interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (checker_.joinable()) return;
+  stop_ = false;
+  checker_ = std::thread(&EndpointPool::check, this, interval);
+}
+
+void minio::s3::EndpointPool::StopHealthChecks() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  if (checker_.joinable()) checker_.join();
+}
@@ -0,0 +1,622 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "fileio.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace {
+// doIO performs a full positional read or write and returns number of bytes
+// transferred or negative errno.
+ssize_t doIO(bool write, int fd, char* buf, size_t length, off_t offset) {
+  size_t done = 0;
+  while (done < length) {
+    ssize_t n = write ? pwrite(fd, buf + done, length - done, offset + done)
+                      : pread(fd, buf + done, length - done, offset + done);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return -errno;
+    }
+    if (n == 0) break;
+    done += n;
+  }
+  return done;
+}
+
+std::string errnoString(int err) { return std::string(strerror(err)); }
+
+class SyncQueue : public minio::fileio::Queue {
+ private:
+  std::vector<ssize_t> results_;
+
+ public:
+  SyncQueue(unsigned int depth) : results_(depth) {}
+
+  minio::error::Error Submit(unsigned int slot, bool write, int fd, char* buf,
+                             size_t length, off_t offset) {
+    results_[slot] = doIO(write, fd, buf, length, offset);
+    return minio::error::SUCCESS;
+  }
+
+  minio::error::Error Wait(unsigned int slot, ssize_t& result) {
+    result = results_[slot];
+    return minio::error::SUCCESS;
+  }
+
+  minio::fileio::Engine GetEngine() { return minio::fileio::Engine::kSync; }
+};  // class SyncQueue
+
+class ThreadQueue : public minio::fileio::Queue {
+ private:
+  struct Op {
+    bool write = false;
+    int fd = -1;
+    char* buf = NULL;
+    size_t length = 0;
+    off_t offset = 0;
+    ssize_t result = 0;
+    bool done = true;
+  };
+
+  std::vector<Op> ops_;
+  std::deque<unsigned int> queue_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stop_ = false;
+  std::thread worker_;
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cond_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+
+      unsigned int slot = queue_.front();
+      queue_.pop_front();
+      Op op = ops_[slot];
+
+      lock.unlock();
+      ssize_t result = doIO(op.write, op.fd, op.buf, op.length, op.offset);
+      lock.lock();
+
+      ops_[slot].result = result;
+      ops_[slot].done = true;
+      cond_.notify_all();
+    }
+  }
+
+ public:
+  ThreadQueue(unsigned int depth) : ops_(depth) {
+    worker_ = std::thread(&ThreadQueue::run, this);
+  }
+
+  ~ThreadQueue() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cond_.notify_all();
+    worker_.join();
+  }
+
+  minio::error::Error Submit(unsigned int slot, bool write, int fd, char* buf,
+                             size_t length, off_t offset) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ops_[slot] = Op{write, fd, buf, length, offset, 0, false};
+      queue_.push_back(slot);
+    }
+    cond_.notify_all();
+    return minio::error::SUCCESS;
+  }
+
+  minio::error::Error Wait(unsigned int slot, ssize_t& result) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this, slot] { return ops_[slot].done; });
+    result = ops_[slot].result;
+    return minio::error::SUCCESS;
+  }
+
+  minio::fileio::Engine GetEngine() {
+    return minio::fileio::Engine::kThreaded;
+  }
+};  // class ThreadQueue
+
+#if defined(__linux__)
+// UringQueue drives io_uring directly through system calls, so no liburing
+// dependency is needed.
+class UringQueue : public minio::fileio::Queue {
+ private:
+  int ring_fd_ = -1;
+  void* sq_ptr_ = MAP_FAILED;
+  size_t sq_size_ = 0;
+  void* cq_ptr_ = MAP_FAILED;
+  size_t cq_size_ = 0;
+  struct io_uring_sqe* sqes_ = (struct io_uring_sqe*)MAP_FAILED;
+  size_t sqes_size_ = 0;
+
+  unsigned* sq_tail_ = NULL;
+  unsigned* sq_mask_ = NULL;
+  unsigned* sq_array_ = NULL;
+  unsigned* cq_head_ = NULL;
+  unsigned* cq_tail_ = NULL;
+  unsigned* cq_mask_ = NULL;
+  struct io_uring_cqe* cqes_ = NULL;
+
+  std::vector<struct iovec> iovecs_;
+  std::vector<ssize_t> results_;
+  std::vector<bool> done_;
+
+  void reap() {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+      struct io_uring_cqe* cqe = &cqes_[head & *cq_mask_];
+      done_[cqe->user_data] = true;
+      results_[cqe->user_data] = cqe->res;
+      head++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+
+ public:
+  UringQueue(unsigned int depth)
+      : iovecs_(depth), results_(depth), done_(depth, true) {}
+
+  ~UringQueue() {
+    if (sqes_ != MAP_FAILED) munmap(sqes_, sqes_size_);
+    if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_size_);
+    if (sq_ptr_ != MAP_FAILED) munmap(sq_ptr_, sq_size_);
+    if (ring_fd_ >= 0) close(ring_fd_);
+  }
+
+  minio::error::Error Init() {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = syscall(__NR_io_uring_setup, iovecs_.size(), &params);
+    if (ring_fd_ < 0) {
+      return minio::error::Error("io_uring_setup: " + errnoString(errno));
+    }
+
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+    sq_ptr_ = mmap(NULL, sq_size_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) {
+      return minio::error::Error("io_uring mmap: " + errnoString(errno));
+    }
+
+    if (single_mmap) {
+      cq_ptr_ = sq_ptr_;
+    } else {
+      cq_ptr_ = mmap(NULL, cq_size_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+      if (cq_ptr_ == MAP_FAILED) {
+        return minio::error::Error("io_uring mmap: " + errnoString(errno));
+      }
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = (struct io_uring_sqe*)mmap(NULL, sqes_size_, PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                       IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+      return minio::error::Error("io_uring mmap: " + errnoString(errno));
+    }
+
+    char* sq = (char*)sq_ptr_;
+    sq_tail_ = (unsigned*)(sq + params.sq_off.tail);
+    sq_mask_ = (unsigned*)(sq + params.sq_off.ring_mask);
+    sq_array_ = (unsigned*)(sq + params.sq_off.array);
+
+    char* cq = (char*)cq_ptr_;
+    cq_head_ = (unsigned*)(cq + params.cq_off.head);
+    cq_tail_ = (unsigned*)(cq + params.cq_off.tail);
+    cq_mask_ = (unsigned*)(cq + params.cq_off.ring_mask);
+    cqes_ = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    return minio::error::SUCCESS;
+  }
+
+  minio::error::Error Submit(unsigned int slot, bool write, int fd, char* buf,
+                             size_t length, off_t offset) {
+    iovecs_[slot].iov_base = buf;
+    iovecs_[slot].iov_len = length;
+
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & *sq_mask_;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = write ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long)&iovecs_[slot];
+    sqe->len = 1;
+    sqe->off = offset;
+    sqe->user_data = slot;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+    done_[slot] = false;
+    while (syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, NULL, 0) < 0) {
+      if (errno != EINTR) {
+        return minio::error::Error("io_uring_enter: " + errnoString(errno));
+      }
+    }
+
+    return minio::error::SUCCESS;
+  }
+
+  minio::error::Error Wait(unsigned int slot, ssize_t& result) {
+    while (true) {
+      reap();
+      if (done_[slot]) break;
+      if (syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS,
+                  NULL, 0) < 0 &&
+          errno != EINTR) {
+        return minio::error::Error("io_uring_enter: " + errnoString(errno));
+      }
+    }
+
+    result = results_[slot];
+    return minio::error::SUCCESS;
+  }
+
+  minio::fileio::Engine GetEngine() { return minio::fileio::Engine::kIoUring; }
+};  // class UringQueue
+#endif
+
+char* allocBuffer() {
+  void* buf = NULL;
+  if (posix_memalign(&buf, minio::fileio::kAlignment,
+                     minio::fileio::kBufferSize) != 0) {
+    std::cerr << "failed to allocate aligned buffer" << std::endl;
+    std::terminate();
+  }
+  return (char*)buf;
+}
+
+// openFile opens the file for the cache mode. kDirect is downgraded to
+// kDontNeed when the file system rejects O_DIRECT.
+int openFile(std::string& filename, int flags,
+             minio::fileio::CacheMode& cache_mode) {
+  if (cache_mode == minio::fileio::CacheMode::kDirect) {
+#ifdef O_DIRECT
+    int fd = open(filename.c_str(), flags | O_DIRECT, 0666);
+    if (fd >= 0 || errno != EINVAL) return fd;
+#endif
+    cache_mode = minio::fileio::CacheMode::kDontNeed;
+  }
+
+  int fd = open(filename.c_str(), flags, 0666);
+  if (fd >= 0 && cache_mode == minio::fileio::CacheMode::kDontNeed) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+  return fd;
+}
+
+// Page cache folios may straddle part boundaries and are only evicted when
+// fully covered, so eviction also reaches back over the previous parts.
+constexpr off_t kDropSlack = 8 * 1024 * 1024;
+
+// dropCache evicts given file range from the page cache. Written ranges are
+// flushed first as dirty pages cannot be dropped.
+void dropCache(int fd, off_t offset, size_t length, bool written) {
+  if (written) {
+#if defined(__linux__)
+    sync_file_range(fd, offset, length,
+                    SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                        SYNC_FILE_RANGE_WAIT_AFTER);
+#else
+    fdatasync(fd);
+#endif
+  }
+  off_t start = offset > kDropSlack ? offset - kDropSlack : 0;
+  posix_fadvise(fd, start, offset + length - start, POSIX_FADV_DONTNEED);
+}
+}  // namespace
+
+std::unique_ptr<minio::fileio::Queue> minio::fileio::Queue::Create(
+    Engine engine, unsigned int depth) {
+  switch (engine) {
+    case Engine::kSync:
+      return std::make_unique<SyncQueue>(depth);
+    case Engine::kThreaded:
+      return std::make_unique<ThreadQueue>(depth);
+    case Engine::kIoUring: {
+#if defined(__linux__)
+      auto queue = std::make_unique<UringQueue>(depth);
+      if (!queue->Init()) return queue;
+#endif
+      return std::make_unique<ThreadQueue>(depth);
+    }
+  }
+  return std::make_unique<SyncQueue>(depth);
+}
+
+minio::fileio::Reader::Reader(Engine engine, CacheMode cache_mode) {
+  engine_ = engine;
+  cache_mode_ = cache_mode;
+}
+
+minio::fileio::Reader::~Reader() { Close(); }
+
+void minio::fileio::Reader::submit(unsigned int slot) {
+  if (next_offset_ >= size_) {
+    eof_ = true;
+    return;
+  }
+  if (error::Error err = queue_->Submit(slot, false, fd_, buffers_[slot],
+                                        kBufferSize, next_offset_)) {
+    err_ = err;
+    eof_ = true;
+    return;
+  }
+  pending_[slot] = true;
+  offsets_[slot] = next_offset_;
+  next_offset_ += kBufferSize;
+}
+
+minio::error::Error minio::fileio::Reader::Open(std::string filename) {
+  fd_ = openFile(filename, O_RDONLY | O_CLOEXEC, cache_mode_);
+  if (fd_ < 0) {
+    return error::Error("unable to open file " + filename + "; " +
+                        errnoString(errno));
+  }
+
+  struct stat st;
+  if (fstat(fd_, &st) < 0) {
+    return error::Error("unable to stat file " + filename + "; " +
+                        errnoString(errno));
+  }
+  size_ = st.st_size;
+
+  queue_ = Queue::Create(engine_, kQueueDepth);
+  for (unsigned int i = 0; i < kQueueDepth; i++) {
+    buffers_.push_back(allocBuffer());
+    offsets_.push_back(0);
+    pending_.push_back(false);
+  }
+  for (unsigned int i = 0; i < kQueueDepth && !eof_; i++) submit(i);
+
+  return err_;
+}
+
+void minio::fileio::Reader::Close() {
+  for (unsigned int i = 0; i < pending_.size(); i++) {
+    ssize_t result;
+    if (pending_[i]) queue_->Wait(i, result);
+    pending_[i] = false;
+  }
+  queue_.reset();
+  for (auto buf : buffers_) free(buf);
+  buffers_.clear();
+  offsets_.clear();
+  pending_.clear();
+  if (fd_ >= 0) close(fd_);
+  fd_ = -1;
+  setg(NULL, NULL, NULL);
+}
+
+std::streambuf::int_type minio::fileio::Reader::underflow() {
+  if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+  if (current_ >= 0) {
+    if (!eof_) submit(current_);
+    head_ = (current_ + 1) % buffers_.size();
+    current_ = -1;
+  }
+
+  if (fd_ < 0 || !pending_[head_]) return traits_type::eof();
+
+  size_t length = 0;
+  while (true) {
+    ssize_t n = 0;
+    error::Error err = queue_->Wait(head_, n);
+    pending_[head_] = false;
+    if (!err && n < 0) {
+      err = error::Error("unable to read file; " + errnoString(-n));
+    }
+    if (err) {
+      err_ = err;
+      eof_ = true;
+      return traits_type::eof();
+    }
+
+    // The file ends at zero bytes read, even if it shrank since Open().
+    if (n == 0) eof_ = true;
+    length += n;
+    off_t offset = offsets_[head_] + length;
+    if (n == 0 || length == kBufferSize || offset >= size_) break;
+
+    // Short read in the middle of the file; read the rest of the buffer.
+    err = queue_->Submit(head_, false, fd_, buffers_[head_] + length,
+                         kBufferSize - length, offset);
+    if (err) {
+      err_ = err;
+      eof_ = true;
+      return traits_type::eof();
+    }
+    pending_[head_] = true;
+  }
+
+  if (length == 0) return traits_type::eof();
+  if (cache_mode_ == CacheMode::kDontNeed) {
+    dropCache(fd_, offsets_[head_], length, false);
+  }
+
+  current_ = head_;
+  setg(buffers_[head_], buffers_[head_], buffers_[head_] + length);
+  return traits_type::to_int_type(*gptr());
+}
+
+std::streamsize minio::fileio::Reader::xsgetn(char* s, std::streamsize count) {
+  std::streamsize copied = 0;
+  while (copied < count) {
+    if (gptr() == egptr() && underflow() == traits_type::eof()) break;
+    std::streamsize n =
+        std::min(count - copied, (std::streamsize)(egptr() - gptr()));
+    memcpy(s + copied, gptr(), n);
+    gbump(n);
+    copied += n;
+  }
+  return copied;
+}
+
+minio::fileio::Writer::Writer(Engine engine, CacheMode cache_mode) {
+  engine_ = engine;
+  cache_mode_ = cache_mode;
+}
+
+minio::fileio::Writer::~Writer() { Close(); }
+
+minio::error::Error minio::fileio::Writer::Open(std::string filename) {
+  fd_ = openFile(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                 cache_mode_);
+  if (fd_ < 0) {
+    return error::Error("unable to open file " + filename + "; " +
+                        errnoString(errno));
+  }
+
+  queue_ = Queue::Create(engine_, kQueueDepth);
+  for (unsigned int i = 0; i < kQueueDepth; i++) {
+    buffers_.push_back(allocBuffer());
+    lengths_.push_back(0);
+    offsets_.push_back(0);
+    pending_.push_back(false);
+  }
+
+  return error::SUCCESS;
+}
+
+minio::error::Error minio::fileio::Writer::wait(unsigned int slot) {
+  ssize_t n = 0;
+  error::Error err = queue_->Wait(slot, n);
+  pending_[slot] = false;
+  if (err) return err;
+  if (n < 0) return error::Error("unable to write file; " + errnoString(-n));
+
+  // Complete short write on the calling thread.
+  if ((size_t)n < lengths_[slot]) {
+    ssize_t m = doIO(true, fd_, buffers_[slot] + n, lengths_[slot] - n,
+                     offsets_[slot] + n);
+    if (m < 0) return error::Error("unable to write file; " + errnoString(-m));
+  }
+
+  if (cache_mode_ == CacheMode::kDontNeed) {
+    dropCache(fd_, offsets_[slot], lengths_[slot], true);
+  }
+
+  return error::SUCCESS;
+}
+
+minio::error::Error minio::fileio::Writer::clearDirect() {
+  for (unsigned int i = 0; i < pending_.size(); i++) {
+    if (!pending_[i]) continue;
+    if (error::Error err = wait(i)) return err;
+  }
+
+#ifdef O_DIRECT
+  int flags = fcntl(fd_, F_GETFL);
+  if (flags < 0 || fcntl(fd_, F_SETFL, flags & ~O_DIRECT) < 0) {
+    return error::Error("unable to clear O_DIRECT; " + errnoString(errno));
+  }
+#endif
+  cache_mode_ = CacheMode::kDontNeed;
+
+  return error::SUCCESS;
+}
+
+minio::error::Error minio::fileio::Writer::submit() {
+  lengths_[slot_] = used_;
+  offsets_[slot_] = offset_;
+  if (error::Error err = queue_->Submit(slot_, true, fd_, buffers_[slot_],
+                                        used_, offset_)) {
+    return err;
+  }
+  pending_[slot_] = true;
+  offset_ += used_;
+  used_ = 0;
+
+  slot_ = (slot_ + 1) % buffers_.size();
+  if (pending_[slot_]) return wait(slot_);
+  return error::SUCCESS;
+}
+
+minio::error::Error minio::fileio::Writer::Write(std::string_view data) {
+  if (err_) return err_;
+  if (fd_ < 0) return error::Error("file is not open");
+
+  while (!data.empty()) {
+    size_t n = std::min(data.size(), kBufferSize - used_);
+    memcpy(buffers_[slot_] + used_, data.data(), n);
+    used_ += n;
+    data.remove_prefix(n);
+    if (used_ == kBufferSize) {
+      if (error::Error err = submit()) return err_ = err;
+    }
+  }
+
+  return error::SUCCESS;
+}
+
+minio::error::Error minio::fileio::Writer::Close() {
+  if (fd_ < 0) return err_;
+
+  if (!err_ && used_ > 0) {
+    // O_DIRECT requires aligned length, so the tail goes via the page cache.
+    if (cache_mode_ == CacheMode::kDirect && used_ % kAlignment != 0) {
+      err_ = clearDirect();
+    }
+    if (!err_) err_ = submit();
+  }
+  for (unsigned int i = 0; i < pending_.size(); i++) {
+    if (!pending_[i]) continue;
+    error::Error err = wait(i);
+    if (!err_) err_ = err;
+  }
+
+  queue_.reset();
+  for (auto buf : buffers_) free(buf);
+  buffers_.clear();
+  if (close(fd_) < 0 && !err_) {
+    err_ = error::Error("unable to close file; " + errnoString(errno));
+  }
+  fd_ = -1;
+
+  return err_;
+}
@@ -0,0 +1,105 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hedge.h"
+
+#include <algorithm>
+
+int minio::s3::Hedger::index(http::Method method) {
+  switch (method) {
+    case http::Method::kGet:
+      return 0;
+    case http::Method::kHead:
+      return 1;
+    case http::Method::kPut:
+      return 2;
+    default:
+      return -1;
+  }
+}
+
+void minio::s3::Hedger::add(Latencies& latencies,
+                            std::chrono::microseconds latency) {
+  if (latencies.samples.size() < kHedgeSamples) {
+    latencies.samples.push_back(latency.count());
+  } else {
+    latencies.samples[latencies.next] = latency.count();
+  }
+  latencies.next = (latencies.next + 1) % kHedgeSamples;
+  latencies.added++;
+
+  if (latencies.samples.size() < kHedgeMinSamples ||
+      latencies.added % kHedgeRecompute != 0) {
+    return;
+  }
+
+  std::vector<long long> samples = latencies.samples;
+  size_t n = (size_t)(policy_.percentile * (samples.size() - 1));
+  std::nth_element(samples.begin(), samples.begin() + n, samples.end());
+  latencies.delay = std::chrono::microseconds(samples[n]);
+}
+
+void minio::s3::Hedger::SetPolicy(HedgePolicy policy) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  policy_ = policy;
+}
+
+minio::s3::HedgePolicy minio::s3::Hedger::GetPolicy() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return policy_;
+}
+
+std::chrono::milliseconds minio::s3::Hedger::Delay(http::Method method) {
+  int i = index(method);
+  if (i < 0) return std::chrono::milliseconds(0);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!policy_.enabled) return std::chrono::milliseconds(0);
+
+  metrics_.requests++;
+  tokens_ = std::min(kHedgeBurst, tokens_ + policy_.max_extra_load);
+  if (latencies_[i].delay.count() == 0) return std::chrono::milliseconds(0);
+  if (tokens_ < 1) {
+    metrics_.throttled++;
+    return std::chrono::milliseconds(0);
+  }
+  tokens_ -= 1;
+
+  auto delay =
+      std::chrono::ceil<std::chrono::milliseconds>(latencies_[i].delay);
+  return std::max(delay, policy_.min_delay);
+}
+
+void minio::s3::Hedger::Done(http::Method method,
+                             std::chrono::milliseconds delay,
+                             http::Response& response) {
+  int i = index(method);
+  if (i < 0) return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (response.hedged) {
+    metrics_.hedges++;
+    if (response.hedge_won) metrics_.wins++;
+  } else if (delay.count() > 0) {
+    tokens_ = std::min(kHedgeBurst, tokens_ + 1);
+  }
+
+  if (!policy_.enabled || response.first_byte_time.count() == 0) return;
+
+  // When the duplicate won, the original took at least this long.
+  std::chrono::microseconds latency = response.first_byte_time;
+  if (response.hedge_won) latency += delay;
+  add(latencies_[i], latency);
+}
@@ -15,6 +15,47 @@
 
 #include "http.h"
 
+#include <algorithm>
+#include <charconv>
+#include <curlpp/Infos.hpp>
+#include <mutex>
+
+namespace {
+/**
+ * ConnectionShare lets requests of all threads use one libcurl connection
+ * cache, so connections stay open between requests.
+ */
+class ConnectionShare {
+ private:
+  CURLSH *share_;
+  std::mutex mutexes_[CURL_LOCK_DATA_LAST];
+
+  static void lock(CURL *, curl_lock_data data, curl_lock_access,
+                   void *userptr) {
+    ((ConnectionShare *)userptr)->mutexes_[data].lock();
+  }
+
+  static void unlock(CURL *, curl_lock_data data, void *userptr) {
+    ((ConnectionShare *)userptr)->mutexes_[data].unlock();
+  }
+
+ public:
+  ConnectionShare() {
+    share_ = curl_share_init();
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, lock);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, unlock);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  }
+
+  ~ConnectionShare() { curl_share_cleanup(share_); }
+
+  CURLSH *Get() { return share_; }
+};  // class ConnectionShare
+}  // namespace
+
 minio::error::Error minio::http::Response::ReadStatusCode() {
   size_t pos = response_.find("\r\n");
   if (pos == std::string::npos) {
@@ -22,8 +63,10 @@ minio::error::Error minio::http::Response::ReadStatusCode() {
     return error::SUCCESS;
   }
 
-  std::string line = response_.substr(0, pos);
-  response_.erase(0, pos + 2);
+  // Lines are parsed in place; consumed bytes are erased once at the end.
+  std::string_view data = response_;
+  std::string_view line = data.substr(0, pos);
+  size_t consumed = pos + 2;
 
   if (continue100_) {
     if (!line.empty()) {
@@ -33,14 +76,15 @@ minio::error::Error minio::http::Response::ReadStatusCode() {
 
     continue100_ = false;
 
-    pos = response_.find("\r\n");
+    pos = data.find("\r\n", consumed);
     if (pos == std::string::npos) {
       // Not yet received the first line after '100 Continue'.
+      response_.erase(0, consumed);
       return error::SUCCESS;
     }
 
-    line = response_.substr(0, pos);
-    response_.erase(0, pos + 2);
+    line = data.substr(consumed, pos - consumed);
+    consumed = pos + 2;
   }
 
   // Skip HTTP/1.x.
@@ -49,7 +93,7 @@ minio::error::Error minio::http::Response::ReadStatusCode() {
     // First token must be HTTP/1.x
     return error::Error("invalid HTTP response");
   }
-  line = line.substr(pos + 1);
+  line.remove_prefix(pos + 1);
 
   // Read status code.
   pos = line.find(" ");
@@ -57,12 +101,12 @@ minio::error::Error minio::http::Response::ReadStatusCode() {
     // The line must contain second token.
     return error::Error("invalid HTTP response");
   }
-  std::string code = line.substr(0, pos);
-  std::string::size_type st;
-  status_code = std::stoi(code, &st);
-  if (st == std::string::npos) {
+  std::string_view code = line.substr(0, pos);
+  auto [ptr, ec] =
+      std::from_chars(code.data(), code.data() + code.size(), status_code);
+  if (ec != std::errc() || ptr != code.data() + code.size()) {
     // Code must be a number.
-    return error::Error("invalid HTTP response code " + code);
+    return error::Error("invalid HTTP response code " + std::string(code));
   }
 
   if (status_code == 100) {
@@ -71,6 +115,7 @@ minio::error::Error minio::http::Response::ReadStatusCode() {
     status_code_read_ = true;
   }
 
+  response_.erase(0, consumed);
   return error::SUCCESS;
 }
 
@@ -83,29 +128,21 @@ minio::error::Error minio::http::Response::ReadHeaders() {
 
   headers_read_ = true;
 
-  std::string lines = response_.substr(0, pos);
-  response_.erase(0, pos + 4);
+  std::string_view lines = std::string_view(response_).substr(0, pos);
+  while (!lines.empty()) {
+    size_t end = lines.find("\r\n");
+    std::string_view line = lines.substr(0, end);
+    lines.remove_prefix(end == std::string::npos ? lines.size() : end + 2);
 
-  auto add_header = [&headers = headers](std::string line) -> error::Error {
-    size_t pos = line.find(": ");
-    if (pos != std::string::npos) {
-      headers.Add(line.substr(0, pos), line.substr(pos + 2));
-      return error::SUCCESS;
+    size_t sep = line.find(": ");
+    if (sep == std::string::npos) {
+      return error::Error("invalid HTTP header: " + std::string(line));
     }
-
-    return error::Error("invalid HTTP header: " + line);
-  };
-
-  while ((pos = lines.find("\r\n")) != std::string::npos) {
-    std::string line = lines.substr(0, pos);
-    lines.erase(0, pos + 2);
-    if (error::Error err = add_header(line)) return err;
-  }
-
-  if (!lines.empty()) {
-    if (error::Error err = add_header(lines)) return err;
+    headers.Add(std::string(line.substr(0, sep)),
+                std::string(line.substr(sep + 2)));
   }
 
+  response_.erase(0, pos + 4);
   return error::SUCCESS;
 }
 
@@ -175,17 +212,40 @@ minio::http::Request::Request(Method method, Url url) {
   }
 }
 
-minio::http::Response minio::http::Request::execute() {
-  curlpp::Cleanup cleaner;
-  curlpp::Easy request;
-  curlpp::Multi requests;
+void minio::http::Request::setup(curlpp::Easy &request,
+                                 std::istream &body_stream) {
+  static ConnectionShare share;
 
   // Request settings.
+  request.setOpt(new curlpp::options::NoSignal(true));
+  request.setOpt(new curlpp::OptionTrait<void *, CURLOPT_SHARE>(share.Get()));
   request.setOpt(
       new curlpp::options::CustomRequest{http::MethodToString(method)});
   std::string urlstring = url.String();
   request.setOpt(new curlpp::Options::Url(urlstring));
   if (debug) request.setOpt(new curlpp::Options::Verbose(true));
+  if (timeout.count() > 0) {
+    request.setOpt(new curlpp::options::TimeoutMs(timeout.count()));
+  }
+  if (resolver != NULL) {
+    unsigned int port = url.port ? url.port : (url.https ? 443 : 80);
+    std::vector<std::string> addresses = resolver->Next(url.host, port);
+    if (!addresses.empty()) {
+      // libcurl tries the addresses in order, falling back to the next one
+      // if a connection fails; the first one differs from request to
+      // request. Host header, SNI and certificate checks use url.host.
+      std::string entry = url.host + ":" + std::to_string(port) + ":";
+      for (size_t i = 0; i < addresses.size(); i++) {
+        if (i > 0) entry += ",";
+        entry += addresses[i];
+      }
+      std::list<std::string> resolve;
+      resolve.push_back(entry);
+      request.setOpt(
+          new curlpp::OptionTrait<std::list<std::string>, CURLOPT_RESOLVE>(
+              resolve));
+    }
+  }
   if (ignore_cert_check) {
     request.setOpt(new curlpp::Options::SslVerifyPeer(false));
   }
@@ -203,9 +263,6 @@ minio::http::Response minio::http::Request::execute() {
     }
   }
 
-  utils::CharBuffer charbuf((char *)body.data(), body.size());
-  std::istream body_stream(&charbuf);
-
   switch (method) {
     case Method::kDelete:
     case Method::kGet:
@@ -218,7 +275,18 @@ minio::http::Response minio::http::Request::execute() {
       if (!headers.Contains("Content-Length")) {
         headers.Add("Content-Length", std::to_string(body.size()));
       }
-      request.setOpt(new curlpp::Options::ReadStream(&body_stream));
+      if (rate_limiters.empty()) {
+        request.setOpt(new curlpp::Options::ReadStream(&body_stream));
+      } else {
+        request.setOpt(new curlpp::options::ReadFunction(
+            [this, &body_stream](char *buffer, size_t size,
+                                 size_t length) -> size_t {
+              body_stream.read(buffer, size * length);
+              size_t read = body_stream.gcount();
+              for (auto &limiter : rate_limiters) limiter->Send(read);
+              return read;
+            }));
+      }
       request.setOpt(new curlpp::Options::InfileSize(body.size()));
       request.setOpt(new curlpp::Options::Upload(true));
       break;
@@ -230,23 +298,130 @@ minio::http::Response minio::http::Request::execute() {
 
   // Response settings.
   request.setOpt(new curlpp::options::Header(true));
+}
+
+minio::http::Response minio::http::Request::execute() {
+  // Global libcurl initialization is not thread safe, so do it exactly once.
+  static curlpp::Cleanup cleaner;
+
+  // Slot 0 is the request and slot 1 is its hedged duplicate, if any. Each
+  // slot has its own body stream and response parser.
+  curlpp::Easy handles[2];
+  utils::CharBuffer charbufs[2] = {{(char *)body.data(), body.size()},
+                                   {(char *)body.data(), body.size()}};
+  std::istream body_stream0(&charbufs[0]);
+  std::istream body_stream1(&charbufs[1]);
+  std::istream *body_streams[2] = {&body_stream0, &body_stream1};
+  Response responses[2];
+  std::chrono::steady_clock::time_point starts[2];
+  bool paused[2] = {false, false};  // Receiving paused by a rate limit.
+  std::chrono::steady_clock::time_point resumes[2];
+  curlpp::Multi requests;
 
-  Response response;
-  response.datafunc = datafunc;
-  response.userdata = userdata;
+  // First slot reading a successful status line wins and the other is
+  // cancelled. A slot failing or reading an error status does not win; the
+  // other one keeps running.
+  int winner = -1;
+  auto add = [&](int slot) {
+    setup(handles[slot], *body_streams[slot]);
+    responses[slot].datafunc = datafunc;
+    responses[slot].userdata = userdata;
+    handles[slot].setOpt(new curlpp::options::WriteFunction(
+        [&, slot](char *buffer, size_t size, size_t length) -> size_t {
+          if (winner >= 0 && winner != slot) return 0;  // Abort the loser.
+          Response &response = responses[slot];
+          if (response.bytes_received == 0) {
+            response.first_byte_time =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - starts[slot]);
+          }
+          response.bytes_received += size * length;
+          // Over a receive limit, pause this transfer instead of sleeping,
+          // so that the other slot keeps running.
+          std::chrono::microseconds pause(0);
+          for (auto &limiter : rate_limiters) {
+            pause = std::max(pause, limiter->Receive(size * length));
+          }
+          if (pause.count() > 0) {
+            resumes[slot] = std::chrono::steady_clock::now() + pause;
+            paused[slot] = true;
+            curl_easy_pause(handles[slot].getHandle(), CURLPAUSE_RECV);
+          }
+          size_t written = response.ResponseCallback(
+              &requests, &handles[slot], buffer, size, length);
+          // Body data is passed on only after a successful status line, so
+          // no other slot has delivered any.
+          if (winner < 0 && response.error.empty() &&
+              response.status_code >= 200 && response.status_code <= 299) {
+            winner = slot;
+          }
+          return written;
+        }));
+    starts[slot] = std::chrono::steady_clock::now();
+    requests.add(&handles[slot]);
+  };
 
-  using namespace std::placeholders;
-  request.setOpt(new curlpp::options::WriteFunction(
-      std::bind(&Response::ResponseCallback, &response, &requests, &request, _1,
-                _2, _3)));
+  for (auto &limiter : rate_limiters) limiter->Request();
 
   int left = 0;
-  requests.add(&request);
+  bool hedged = false;
+  bool cancelled = false;
+  add(0);
 
   // Execute.
   while (!requests.perform(&left)) {
   }
   while (left) {
+    if (hedged && winner >= 0 && !cancelled) {
+      cancelled = true;
+      paused[1 - winner] = false;
+      requests.remove(&handles[1 - winner]);
+      while (!requests.perform(&left)) {
+      }
+      continue;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    bool resumed = false;
+    for (int i = 0; i < 2; i++) {
+      if (!paused[i] || now < resumes[i]) continue;
+      paused[i] = false;
+      resumed = true;
+      curl_easy_pause(handles[i].getHandle(), CURLPAUSE_CONT);
+    }
+    if (resumed) {
+      while (!requests.perform(&left)) {
+      }
+      continue;
+    }
+
+    // Wait for socket activity at most until a hedge or resume is due.
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    if (!hedged && responses[0].bytes_received == 0 &&
+        hedge_delay.count() > 0) {
+      if (now - starts[0] >= hedge_delay) {
+        hedged = true;
+        add(1);
+        while (!requests.perform(&left)) {
+        }
+        continue;
+      }
+      deadline = starts[0] + hedge_delay;
+    }
+    for (int i = 0; i < 2; i++) {
+      if (paused[i]) deadline = std::min(deadline, resumes[i]);
+    }
+
+    struct timeval timeout;
+    struct timeval *timeoutp = NULL;
+    if (deadline != std::chrono::steady_clock::time_point::max()) {
+      auto remaining =
+          std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+      timeout.tv_sec = remaining.count() / 1000000;
+      timeout.tv_usec = remaining.count() % 1000000;
+      timeoutp = &timeout;
+    }
+
     fd_set fdread;
     fd_set fdwrite;
     fd_set fdexcep;
@@ -258,7 +433,7 @@ minio::http::Response minio::http::Request::execute() {
 
     requests.fdset(&fdread, &fdwrite, &fdexcep, &maxfd);
 
-    if (select(maxfd + 1, &fdread, &fdwrite, &fdexcep, NULL) < 0) {
+    if (select(maxfd + 1, &fdread, &fdwrite, &fdexcep, timeoutp) < 0) {
       std::cerr << "select() failed; this should not happen" << std::endl;
       std::terminate();
     }
@@ -266,6 +441,51 @@ minio::http::Response minio::http::Request::execute() {
     }
   }
 
+  // Without a winner, report the request, or the duplicate if only that got
+  // a response.
+  int slot = winner;
+  if (slot < 0) {
+    slot = (hedged && responses[0].status_code == 0 &&
+            responses[1].status_code != 0)
+               ? 1
+               : 0;
+  }
+  Response &response = responses[slot];
+  response.hedged = hedged;
+  response.hedge_won = (winner == 1);
+  if (method == Method::kPut || method == Method::kPost) {
+    response.bytes_sent = body.size() * (hedged ? 2 : 1);
+  }
+  if (response.status_code != 0) {
+    response.reused_connection =
+        curlpp::infos::NumConnects::get(handles[slot]) == 0;
+  }
+  auto micros = [](double seconds) -> std::chrono::microseconds {
+    return std::chrono::microseconds((long long)(seconds * 1000000));
+  };
+  response.name_lookup_time =
+      micros(curlpp::infos::NameLookupTime::get(handles[slot]));
+  response.connect_time =
+      micros(curlpp::infos::ConnectTime::get(handles[slot]));
+  response.app_connect_time =
+      micros(curlpp::infos::AppConnectTime::get(handles[slot]));
+  response.pre_transfer_time =
+      micros(curlpp::infos::PreTransferTime::get(handles[slot]));
+  response.start_transfer_time =
+      micros(curlpp::infos::StartTransferTime::get(handles[slot]));
+  response.total_time = micros(curlpp::infos::TotalTime::get(handles[slot]));
+
+  // Transfer failures like connection reset are reported only here.
+  curlpp::Multi::Msgs msgs = requests.info();
+  for (auto &msg : msgs) {
+    if (msg.first != &handles[slot]) continue;
+    if (msg.second.msg != CURLMSG_DONE || msg.second.code == CURLE_OK) continue;
+    response.curl_code = msg.second.code;
+    if (response.error.empty()) {
+      response.error = curl_easy_strerror(msg.second.code);
+    }
+  }
+
   return response;
 }
 
@@ -276,6 +496,11 @@ minio::http::Response minio::http::Request::Execute() {
     Response response;
     response.error = std::string("curlpp::LogicError: ") + e.what();
     return response;
+  } catch (curlpp::LibcurlRuntimeError &e) {
+    Response response;
+    response.error = std::string("curlpp::RuntimeError: ") + e.what();
+    response.curl_code = e.whatCode();
+    return response;
   } catch (curlpp::RuntimeError &e) {
     Response response;
     response.error = std::string("curlpp::RuntimeError: ") + e.what();
@@ -0,0 +1,174 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "limiter.h"
+
+#include <algorithm>
+
+minio::s3::ConcurrencyLimiter::ConcurrencyLimiter(LimiterPolicy policy)
+    : policy_(policy) {
+  if (policy_.min_limit < 1) policy_.min_limit = 1;
+  if (policy_.max_limit < policy_.min_limit) {
+    policy_.max_limit = policy_.min_limit;
+  }
+  limit_ = std::clamp((double)policy_.initial_limit, (double)policy_.min_limit,
+                      (double)policy_.max_limit);
+}
+
+void minio::s3::ConcurrencyLimiter::setLimit(double limit) {
+  double old = limit_;
+  limit_ = std::clamp(limit, (double)policy_.min_limit,
+                      (double)policy_.max_limit);
+  if ((unsigned int)limit_ > (unsigned int)old) dispatch();
+}
+
+void minio::s3::ConcurrencyLimiter::dispatch() {
+  while (inflight_ < (unsigned int)limit_) {
+    std::deque<Waiter*>* queue = NULL;
+    if (!queues_[(int)Priority::kCritical].empty()) {
+      queue = &queues_[(int)Priority::kCritical];
+    } else {
+      // Weighted fair queuing: serve the smallest virtual finish time.
+      for (unsigned int i = 1; i < kPriorityCount; i++) {
+        if (queues_[i].empty()) continue;
+        if (queue == NULL ||
+            queues_[i].front()->finish < queue->front()->finish) {
+          queue = &queues_[i];
+        }
+      }
+      if (queue == NULL) return;
+      virtual_time_ = queue->front()->finish;
+    }
+
+    Waiter* waiter = queue->front();
+    queue->pop_front();
+    waiter->granted = true;
+    inflight_++;
+    waiter->cond.notify_one();
+  }
+}
+
+void minio::s3::ConcurrencyLimiter::Acquire(Priority priority) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  requests_++;
+
+  bool queued = false;
+  for (auto& queue : queues_) queued = queued || !queue.empty();
+  if (!queued && inflight_ < (unsigned int)limit_) {
+    inflight_++;
+    return;
+  }
+
+  waits_++;
+  Waiter waiter;
+  int i = (int)priority;
+  if (priority != Priority::kCritical) {
+    unsigned int weight = policy_.normal_weight;
+    if (priority == Priority::kInteractive) {
+      weight = policy_.interactive_weight;
+    } else if (priority == Priority::kBackground) {
+      weight = policy_.background_weight;
+    }
+    if (weight == 0) weight = 1;
+    waiter.finish = std::max(virtual_time_, finishes_[i]) + 1.0 / weight;
+    finishes_[i] = waiter.finish;
+  }
+  queues_[i].push_back(&waiter);
+  dispatch();
+  waiter.cond.wait(lock, [&]() { return waiter.granted; });
+}
+
+void minio::s3::ConcurrencyLimiter::Release(http::Response& response,
+                                            std::chrono::microseconds elapsed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool saturated = inflight_ >= (unsigned int)limit_;
+  for (auto& queue : queues_) saturated = saturated || !queue.empty();
+  inflight_--;
+  dispatch();
+
+  auto now = std::chrono::steady_clock::now();
+  bool throttled = response.status_code == 503 || response.status_code == 429 ||
+                   response.curl_code == CURLE_OPERATION_TIMEDOUT;
+  if (throttled) {
+    throttled_++;
+    // Decrease once per round trip; responses of requests sent before the
+    // last decrease say nothing about the new limit.
+    auto rtt = std::chrono::microseconds((long long)latency_);
+    if (now - last_decrease_ >= rtt) {
+      last_decrease_ = now;
+      setLimit(limit_ * policy_.backoff);
+    }
+    return;
+  }
+
+  // Network errors carry no latency information.
+  if (response.curl_code != CURLE_OK || response.status_code == 0) return;
+
+  // Time to first byte of a request with a body includes sending the body,
+  // so only requests without one are latency samples. The others may still
+  // grow the limit while latency is within tolerance.
+  if (response.bytes_sent == 0) {
+    if (response.first_byte_time.count() > 0) {
+      elapsed = response.first_byte_time;
+    }
+    double sample = (double)elapsed.count();
+    if (latency_ == 0) {
+      latency_ = baseline_ = sample;
+      return;
+    }
+    latency_ += (sample - latency_) / 8;
+    if (sample < baseline_) {
+      baseline_ = sample;
+    } else {
+      // Drift slowly up so a permanently slower server becomes the baseline.
+      baseline_ += (sample - baseline_) / 1024;
+    }
+
+    if (latency_ > baseline_ * policy_.tolerance) {
+      // Queueing at the server; shrink toward the limit it keeps up with.
+      auto rtt = std::chrono::microseconds((long long)latency_);
+      if (now - last_decrease_ >= rtt) {
+        last_decrease_ = now;
+        setLimit(limit_ * std::max(policy_.backoff,
+                                   baseline_ * policy_.tolerance / latency_));
+      }
+      return;
+    }
+  } else if (latency_ > baseline_ * policy_.tolerance) {
+    return;
+  }
+
+  // Grow only when the limit is what holds requests back.
+  if (saturated) setLimit(limit_ + 1 / limit_);
+}
+
+unsigned int minio::s3::ConcurrencyLimiter::Limit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return (unsigned int)limit_;
+}
+
+minio::s3::LimiterStats minio::s3::ConcurrencyLimiter::Stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LimiterStats stats;
+  stats.limit = limit_;
+  stats.inflight = inflight_;
+  stats.requests = requests_;
+  stats.throttled = throttled_;
+  stats.waits = waits_;
+  for (auto& queue : queues_) stats.queued += queue.size();
+  stats.latency = std::chrono::microseconds((long long)latency_);
+  stats.baseline = std::chrono::microseconds((long long)baseline_);
+  return stats;
+}
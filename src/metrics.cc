@@ -0,0 +1,248 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "metrics.h"
+
+#include <sstream>
+
+namespace {
+// Boundaries in seconds of exported Prometheus latency histograms.
+constexpr double kPrometheusBuckets[] = {0.001, 0.0025, 0.005, 0.01, 0.025,
+                                         0.05,  0.1,    0.25,  0.5,  1,
+                                         2.5,   5,      10,    30,   60};
+
+// seconds formats microseconds as exact decimal seconds; a double in a
+// default stream keeps only six significant digits.
+std::string seconds(unsigned long long micros) {
+  std::string fraction = std::to_string(micros % 1000000);
+  return std::to_string(micros / 1000000) + "." +
+         std::string(6 - fraction.size(), '0') + fraction;
+}
+
+std::string escape(const std::string& value) {
+  std::string escaped;
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+}  // namespace
+
+unsigned int minio::s3::Histogram::Index(unsigned long long value) {
+  if (value < kSubBuckets) return value;
+  unsigned int msb = 63 - __builtin_clzll(value);
+  if (msb >= kMaxBits) return kBuckets - 1;
+  unsigned int shift = msb - kSubBits;
+  return kSubBuckets + shift * kSubBuckets + ((value >> shift) - kSubBuckets);
+}
+
+unsigned long long minio::s3::Histogram::UpperBound(unsigned int index) {
+  if (index < kSubBuckets) return index + 1;
+  unsigned int shift = (index - kSubBuckets) / kSubBuckets;
+  unsigned long long sub = (index - kSubBuckets) % kSubBuckets;
+  return (kSubBuckets + sub + 1) << shift;
+}
+
+void minio::s3::Histogram::Record(unsigned long long value) {
+  counts_[Index(value)].fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+minio::s3::HistogramSnapshot minio::s3::Histogram::Snapshot() const {
+  HistogramSnapshot snapshot;
+  snapshot.counts.resize(kBuckets);
+  for (unsigned int i = 0; i < kBuckets; i++) {
+    snapshot.counts[i] = counts_[i].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.counts[i];
+  }
+  snapshot.sum = sum_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+unsigned long long minio::s3::HistogramSnapshot::Percentile(double q) const {
+  if (count == 0) return 0;
+  unsigned long long rank = (unsigned long long)(q * count);
+  if (rank >= count) rank = count - 1;
+  unsigned long long seen = 0;
+  for (unsigned int i = 0; i < counts.size(); i++) {
+    seen += counts[i];
+    if (seen > rank) return Histogram::UpperBound(i);
+  }
+  return Histogram::UpperBound(counts.size() - 1);
+}
+
+unsigned long long minio::s3::HistogramSnapshot::CountBelow(
+    unsigned long long bound) const {
+  unsigned long long total = 0;
+  for (unsigned int i = 0; i < counts.size(); i++) {
+    if (Histogram::UpperBound(i) > bound + 1) break;
+    total += counts[i];
+  }
+  return total;
+}
+
+minio::s3::RequestMetrics::Series& minio::s3::RequestMetrics::series(
+    std::string_view api, const std::string& bucket) {
+  std::string key;
+  key.reserve(api.size() + bucket.size() + 1);
+  key.append(api).append(1, '/').append(bucket);
+
+  std::shared_ptr<const Map> map = std::atomic_load(&map_);
+  auto i = map->find(key);
+  if (i != map->end()) return *i->second;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  map = std::atomic_load(&map_);
+  i = map->find(key);
+  if (i != map->end()) return *i->second;
+
+  std::string name(bucket);
+  if (map->size() >= kMaxSeries) {
+    // Too many buckets; fold the rest into one series per API.
+    name.clear();
+    key = std::string(api) + "/";
+    i = map->find(key);
+    if (i != map->end()) return *i->second;
+  }
+
+  Map copy = *map;
+  auto series = std::make_shared<Series>();
+  series->api = api;
+  series->bucket = name;
+  copy[key] = series;
+  std::atomic_store(&map_, std::make_shared<const Map>(std::move(copy)));
+  // Series are never removed, so the reference outlives the snapshot.
+  return *series;
+}
+
+void minio::s3::RequestMetrics::Record(std::string_view api,
+                                       const std::string& bucket,
+                                       http::Response& response,
+                                       std::chrono::microseconds elapsed) {
+  Series& s = series(api, bucket);
+  auto relaxed = std::memory_order_relaxed;
+  s.requests.fetch_add(1, relaxed);
+  if (response.status_code == 0) {
+    s.network_errors.fetch_add(1, relaxed);
+  } else {
+    int status_class = response.status_code / 100;
+    if (status_class >= 1 && status_class <= 5) {
+      s.status_classes[status_class].fetch_add(1, relaxed);
+    }
+    if (response.reused_connection) {
+      s.connections_reused.fetch_add(1, relaxed);
+    } else {
+      s.connections_opened.fetch_add(1, relaxed);
+    }
+  }
+  s.bytes_sent.fetch_add(response.bytes_sent, relaxed);
+  s.bytes_received.fetch_add(response.bytes_received, relaxed);
+  s.latency.Record(elapsed.count());
+}
+
+void minio::s3::RequestMetrics::RecordRetry(std::string_view api,
+                                            const std::string& bucket) {
+  series(api, bucket).retries.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::list<minio::s3::OperationStats> minio::s3::RequestMetrics::Snapshot() {
+  std::list<OperationStats> stats;
+  std::shared_ptr<const Map> map = std::atomic_load(&map_);
+  for (auto& [key, s] : *map) {
+    OperationStats op;
+    op.api = s->api;
+    op.bucket = s->bucket;
+    op.requests = s->requests;
+    op.retries = s->retries;
+    op.network_errors = s->network_errors;
+    for (int i = 0; i < 6; i++) op.status_classes[i] = s->status_classes[i];
+    op.bytes_sent = s->bytes_sent;
+    op.bytes_received = s->bytes_received;
+    op.connections_reused = s->connections_reused;
+    op.connections_opened = s->connections_opened;
+    op.latency = s->latency.Snapshot();
+    stats.push_back(op);
+  }
+  return stats;
+}
+
+std::string minio::s3::RequestMetrics::Prometheus() {
+  std::list<OperationStats> stats = Snapshot();
+  std::stringstream ss;
+
+  auto labels = [](const OperationStats& op) -> std::string {
+    return "api=\"" + escape(op.api) + "\",bucket=\"" + escape(op.bucket) +
+           "\"";
+  };
+  auto counter = [&](const char* name, const char* help,
+                     unsigned long long OperationStats::*field) {
+    ss << "# HELP " << name << " " << help << "\n";
+    ss << "# TYPE " << name << " counter\n";
+    for (auto& op : stats) {
+      ss << name << "{" << labels(op) << "} " << op.*field << "\n";
+    }
+  };
+
+  counter("minio_client_requests_total", "Requests sent including retries.",
+          &OperationStats::requests);
+  counter("minio_client_retries_total", "Requests retried.",
+          &OperationStats::retries);
+  counter("minio_client_network_errors_total",
+          "Requests failed without HTTP response.",
+          &OperationStats::network_errors);
+  counter("minio_client_sent_bytes_total", "Request body bytes sent.",
+          &OperationStats::bytes_sent);
+  counter("minio_client_received_bytes_total", "Response bytes received.",
+          &OperationStats::bytes_received);
+  counter("minio_client_connections_reused_total",
+          "Requests sent on a reused connection.",
+          &OperationStats::connections_reused);
+  counter("minio_client_connections_opened_total",
+          "Requests which opened a new connection.",
+          &OperationStats::connections_opened);
+
+  ss << "# HELP minio_client_responses_total Responses by HTTP status class.\n";
+  ss << "# TYPE minio_client_responses_total counter\n";
+  for (auto& op : stats) {
+    for (int i = 1; i <= 5; i++) {
+      ss << "minio_client_responses_total{" << labels(op) << ",code=\"" << i
+         << "xx\"} " << op.status_classes[i] << "\n";
+    }
+  }
+
+  const char* name = "minio_client_request_duration_seconds";
+  ss << "# HELP " << name << " Request latency.\n";
+  ss << "# TYPE " << name << " histogram\n";
+  for (auto& op : stats) {
+    for (double le : kPrometheusBuckets) {
+      ss << name << "_bucket{" << labels(op) << ",le=\"" << le << "\"} "
+         << op.latency.CountBelow((unsigned long long)(le * 1000000)) << "\n";
+    }
+    ss << name << "_bucket{" << labels(op) << ",le=\"+Inf\"} "
+       << op.latency.count << "\n";
+    ss << name << "_sum{" << labels(op) << "} " << seconds(op.latency.sum)
+       << "\n";
+    ss << name << "_count{" << labels(op) << "} " << op.latency.count << "\n";
+  }
+
+  return ss.str();
+}
@@ -0,0 +1,76 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ratelimit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+minio::http::TokenBucket::TokenBucket(double rate) {
+  rate_ = rate;
+  burst_ = std::max(1.0, rate * kRateLimitBurst.count() / 1000);
+  tokens_ = burst_;
+  last_ = std::chrono::steady_clock::now();
+}
+
+void minio::http::TokenBucket::Take(double tokens) {
+  std::chrono::microseconds wait = Debit(tokens);
+  if (wait.count() > 0) std::this_thread::sleep_for(wait);
+}
+
+std::chrono::microseconds minio::http::TokenBucket::Debit(double tokens) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto now = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed = now - last_;
+  last_ = now;
+  tokens_ = std::min(burst_, tokens_ + elapsed.count() * rate_);
+  tokens_ -= tokens;
+  if (tokens_ >= 0) return std::chrono::microseconds(0);
+  return std::chrono::microseconds(
+      (long long)std::ceil(-tokens_ / rate_ * 1000000));
+}
+
+minio::http::RateLimiter::RateLimiter(RateLimit limit) : limit_(limit) {
+  if (limit.requests_per_second > 0) {
+    requests_ = std::make_unique<TokenBucket>(limit.requests_per_second);
+  }
+  if (limit.send_bytes_per_second > 0) {
+    send_ = std::make_unique<TokenBucket>(limit.send_bytes_per_second);
+  }
+  if (limit.receive_bytes_per_second > 0) {
+    receive_ = std::make_unique<TokenBucket>(limit.receive_bytes_per_second);
+  }
+}
+
+void minio::http::RateLimiterMap::Set(std::string key, RateLimit limit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Map map = *std::atomic_load(&map_);
+  if (limit) {
+    map[key] = std::make_shared<RateLimiter>(limit);
+  } else {
+    map.erase(key);
+  }
+  std::atomic_store(&map_, std::make_shared<const Map>(std::move(map)));
+}
+
+std::shared_ptr<minio::http::RateLimiter> minio::http::RateLimiterMap::Get(
+    const std::string& key) {
+  std::shared_ptr<const Map> map = std::atomic_load(&map_);
+  if (map->empty()) return NULL;
+  auto i = map->find(key);
+  if (i == map->end()) return NULL;
+  return i->second;
+}
@@ -0,0 +1,126 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "regioncache.h"
+
+minio::s3::RegionCache::Shard& minio::s3::RegionCache::shard(
+    const std::string& bucket_name) {
+  return shards_[std::hash<std::string>{}(bucket_name) % kShards];
+}
+
+minio::s3::RegionCache::Clock::time_point minio::s3::RegionCache::expiry(
+    std::chrono::seconds ttl) {
+  if (ttl.count() == 0) return Clock::time_point::max();
+  return Clock::now() + ttl;
+}
+
+void minio::s3::RegionCache::store(Shard& shard, const std::string& bucket_name,
+                                   Entry entry) {
+  // Caller must hold shard.mutex.
+  Map map = *std::atomic_load(&shard.map);
+  map.erase(bucket_name);
+  map.emplace(bucket_name, entry);
+  std::atomic_store(&shard.map, std::make_shared<const Map>(std::move(map)));
+}
+
+bool minio::s3::RegionCache::Lookup(const std::string& bucket_name,
+                                    std::string& region) {
+  std::shared_ptr<const Map> map = std::atomic_load(&shard(bucket_name).map);
+  auto i = map->find(bucket_name);
+  if (i == map->end() || i->second.expiry <= Clock::now() ||
+      !i->second.response) {
+    return false;
+  }
+
+  region = i->second.response.region;
+  return true;
+}
+
+minio::s3::GetRegionResponse minio::s3::RegionCache::Get(
+    const std::string& bucket_name, RegionLookupFunction lookup) {
+  Shard& s = shard(bucket_name);
+
+  {
+    std::shared_ptr<const Map> map = std::atomic_load(&s.map);
+    auto i = map->find(bucket_name);
+    if (i != map->end() && i->second.expiry > Clock::now()) {
+      return i->second.response;
+    }
+  }
+
+  std::promise<GetRegionResponse> promise;
+  {
+    std::unique_lock<std::mutex> lock(s.mutex);
+
+    auto i = s.inflight.find(bucket_name);
+    if (i != s.inflight.end()) {
+      std::shared_future<GetRegionResponse> future = i->second;
+      lock.unlock();
+      return future.get();
+    }
+
+    // Another lookup may have completed between snapshot and lock.
+    std::shared_ptr<const Map> map = std::atomic_load(&s.map);
+    auto j = map->find(bucket_name);
+    if (j != map->end() && j->second.expiry > Clock::now()) {
+      return j->second.response;
+    }
+
+    s.inflight.emplace(bucket_name, promise.get_future().share());
+  }
+
+  try {
+    GetRegionResponse resp = lookup();
+
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+      if (resp) {
+        store(s, bucket_name, Entry{resp, expiry(ttl_)});
+      } else if (resp.code == "NoSuchBucket" && negative_ttl_.count() > 0) {
+        store(s, bucket_name, Entry{resp, expiry(negative_ttl_)});
+      }
+      s.inflight.erase(bucket_name);
+    }
+
+    promise.set_value(resp);
+    return resp;
+  } catch (...) {
+    // Waiters get the exception too; later calls look up again.
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+      s.inflight.erase(bucket_name);
+    }
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+}
+
+void minio::s3::RegionCache::Set(const std::string& bucket_name,
+                                 const std::string& region) {
+  Shard& s = shard(bucket_name);
+  std::lock_guard<std::mutex> lock(s.mutex);
+  store(s, bucket_name, Entry{GetRegionResponse(region), expiry(ttl_)});
+}
+
+void minio::s3::RegionCache::Remove(const std::string& bucket_name) {
+  Shard& s = shard(bucket_name);
+  std::lock_guard<std::mutex> lock(s.mutex);
+  std::shared_ptr<const Map> current = std::atomic_load(&s.map);
+  if (current->find(bucket_name) == current->end()) return;
+
+  Map map = *current;
+  map.erase(bucket_name);
+  std::atomic_store(&s.map, std::make_shared<const Map>(std::move(map)));
+}
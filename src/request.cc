@@ -60,12 +60,10 @@ minio::s3::BaseUrl::BaseUrl(std::string host, bool https) {
   }
 }
 
-minio::error::Error minio::s3::BaseUrl::BuildUrl(http::Url& url,
-                                                 http::Method method,
-                                                 std::string region,
-                                                 utils::Multimap query_params,
-                                                 std::string bucket_name,
-                                                 std::string object_name) {
+minio::error::Error minio::s3::BaseUrl::BuildUrl(
+    http::Url& url, http::Method method, const std::string& region,
+    const utils::Multimap& query_params, const std::string& bucket_name,
+    const std::string& object_name) {
   if (err_) return err_;
 
   if (bucket_name.empty() && !object_name.empty()) {
@@ -130,30 +128,48 @@ minio::error::Error minio::s3::BaseUrl::BuildUrl(http::Url& url,
 minio::s3::Request::Request(http::Method method, std::string region,
                             BaseUrl& baseurl, utils::Multimap extra_headers,
                             utils::Multimap extra_query_params)
-    : base_url(baseurl) {
-  this->method = method;
-  this->region = region;
-  this->headers = extra_headers;
-  this->query_params = extra_query_params;
+    : method(method),
+      region(std::move(region)),
+      base_url(baseurl),
+      headers(std::move(extra_headers)),
+      query_params(std::move(extra_query_params)) {}
+
+minio::s3::Request::Request(http::Method method, std::string region,
+                            BaseUrl& baseurl, BaseArgs& args)
+    : Request(method, region, baseurl, args.extra_headers,
+              args.extra_query_params) {
+  this->limit_tag = args.limit_tag;
+  this->priority = args.priority;
+}
+
+minio::s3::Request::~Request() {
+  if (span == NULL) return;
+  span->parse = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - span_end);
+  span->total += span->parse;
+  span_sink->Export(*span);
 }
 
-void minio::s3::Request::BuildHeaders(http::Url& url,
-                                      creds::Provider* provider) {
-  headers.Add("Host", url.host);
-  headers.Add("User-Agent", user_agent);
+void minio::s3::Request::BuildHeaders(utils::Multimap& http_headers,
+                                      http::Url& url,
+                                      creds::Provider* provider,
+                                      std::pmr::memory_resource* memory) {
+  http_headers.Add("Host", url.host);
+  http_headers.Add("User-Agent", user_agent);
 
-  bool md5sum_added = headers.Contains("Content-MD5");
+  bool md5sum_added = http_headers.Contains("Content-MD5");
   std::string md5sum;
 
   switch (method) {
     case http::Method::kPut:
     case http::Method::kPost:
-      headers.Add("Content-Length", std::to_string(body.size()));
-      if (!headers.Contains("Content-Type")) {
-        headers.Add("Content-Type", "application/octet-stream");
+      http_headers.Add("Content-Length", std::to_string(body.size()));
+      if (!http_headers.Contains("Content-Type")) {
+        http_headers.Add("Content-Type", "application/octet-stream");
       }
       if (provider != NULL) {
-        sha256 = utils::Sha256Hash(body);
+        // Keep hash computed by previous attempt of this request.
+        if (sha256.empty()) sha256 = utils::Sha256Hash(body);
       } else if (!md5sum_added) {
         md5sum = utils::Md5sumHash(body);
       }
@@ -162,25 +178,25 @@ void minio::s3::Request::BuildHeaders(http::Url& url,
       if (provider != NULL) sha256 = EMPTY_SHA256;
   }
 
-  if (!md5sum.empty()) headers.Add("Content-MD5", md5sum);
-  if (!sha256.empty()) headers.Add("x-amz-content-sha256", sha256);
+  if (!md5sum.empty()) http_headers.Add("Content-MD5", md5sum);
+  if (!sha256.empty()) http_headers.Add("x-amz-content-sha256", sha256);
 
   date = utils::Time::Now();
-  headers.Add("x-amz-date", date.ToAmzDate());
+  http_headers.Add("x-amz-date", date.ToAmzDate());
 
   if (provider != NULL) {
     creds::Credentials creds = provider->Fetch();
     if (!creds.session_token.empty()) {
-      headers.Add("X-Amz-Security-Token", creds.session_token);
+      http_headers.Add("X-Amz-Security-Token", creds.session_token);
     }
 
-    signer::SignV4S3(method, url.path, region, headers, query_params,
-                     creds.access_key, creds.secret_key, sha256, date);
+    signer::SignV4S3(method, url.path, region, http_headers, query_params,
+                     creds.access_key, creds.secret_key, sha256, date, memory);
   }
 }
 
 minio::http::Request minio::s3::Request::ToHttpRequest(
-    creds::Provider* provider) {
+    creds::Provider* provider, std::pmr::memory_resource* memory) {
   http::Url url;
   if (error::Error err = base_url.BuildUrl(url, method, region, query_params,
                                            bucket_name, object_name)) {
@@ -188,11 +204,18 @@ minio::http::Request minio::s3::Request::ToHttpRequest(
               << ". This should not happen" << std::endl;
     std::terminate();
   }
-  BuildHeaders(url, provider);
+  if (endpoint != NULL) {
+    url.https = endpoint->https;
+    url.host = endpoint->host;
+    url.port = endpoint->port;
+  }
 
+  // Signing headers go to the HTTP request only, so that every attempt of
+  // this request starts from its own headers.
   http::Request request(method, url);
-  request.body = body;
   request.headers = headers;
+  BuildHeaders(request.headers, url, provider, memory);
+  request.body = body;
   request.datafunc = datafunc;
   request.userdata = userdata;
   request.debug = debug;
@@ -0,0 +1,136 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "resolver.h"
+
+#if defined(_WIN32)
+#include <WS2tcpip.h>
+#include <WinSock2.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#endif
+
+#include <algorithm>
+
+void minio::http::Resolver::SetInterval(std::chrono::seconds interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  interval_ = interval;
+  entries_.clear();
+}
+
+void minio::http::Resolver::SetResolveFunction(ResolveFunction func) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  resolve_func_ = func;
+  entries_.clear();
+}
+
+std::vector<std::string> minio::http::Resolver::resolve(std::string host,
+                                                       unsigned int port) {
+  std::vector<std::string> addresses;
+
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* result = NULL;
+  std::string service = std::to_string(port);
+  if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0) {
+    return addresses;
+  }
+
+  for (struct addrinfo* ai = result; ai != NULL; ai = ai->ai_next) {
+    char buf[INET6_ADDRSTRLEN];
+    const char* address = NULL;
+    if (ai->ai_family == AF_INET) {
+      address = inet_ntop(
+          AF_INET, &((struct sockaddr_in*)ai->ai_addr)->sin_addr, buf,
+          sizeof(buf));
+    } else if (ai->ai_family == AF_INET6) {
+      address = inet_ntop(
+          AF_INET6, &((struct sockaddr_in6*)ai->ai_addr)->sin6_addr, buf,
+          sizeof(buf));
+    }
+    if (address == NULL) continue;
+
+    std::string value = (ai->ai_family == AF_INET6)
+                            ? std::string("[") + buf + "]"
+                            : std::string(buf);
+    if (std::find(addresses.begin(), addresses.end(), value) ==
+        addresses.end()) {
+      addresses.push_back(value);
+    }
+  }
+  freeaddrinfo(result);
+
+  return addresses;
+}
+
+std::shared_ptr<minio::http::Resolver::Entry> minio::http::Resolver::get(
+    std::string& host, unsigned int port) {
+  if (host.empty() || host.front() == '[') return NULL;
+  struct in_addr addr;
+  if (inet_pton(AF_INET, host.c_str(), &addr) == 1) return NULL;
+
+  std::string key = host + ":" + std::to_string(port);
+  std::shared_ptr<Entry> entry;
+  ResolveFunction func;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (interval_.count() == 0) return NULL;
+    func = resolve_func_;
+    auto i = entries_.find(key);
+    if (i != entries_.end()) {
+      entry = i->second;
+      if (entry->refreshing ||
+          std::chrono::steady_clock::now() - entry->resolved < interval_) {
+        return entry;
+      }
+      // This thread resolves again while others keep using old addresses.
+      entry->refreshing = true;
+    }
+  }
+
+  std::shared_ptr<Entry> fresh = std::make_shared<Entry>();
+  fresh->addresses = (func != NULL) ? func(host, port) : resolve(host, port);
+  fresh->resolved = std::chrono::steady_clock::now();
+  if (fresh->addresses.empty() && entry != NULL) {
+    // Keep serving last known addresses if resolving failed.
+    fresh->addresses = entry->addresses;
+  }
+  if (entry != NULL) fresh->next = entry->next.load();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[key] = fresh;
+  return fresh;
+}
+
+std::vector<std::string> minio::http::Resolver::Next(std::string host,
+                                                     unsigned int port) {
+  std::shared_ptr<Entry> entry = get(host, port);
+  if (entry == NULL || entry->addresses.empty()) return {};
+  std::vector<std::string> addresses = entry->addresses;
+  std::rotate(addresses.begin(),
+              addresses.begin() + entry->next++ % addresses.size(),
+              addresses.end());
+  return addresses;
+}
+
+std::vector<std::string> minio::http::Resolver::Addresses(std::string host,
+                                                          unsigned int port) {
+  std::shared_ptr<Entry> entry = get(host, port);
+  if (entry == NULL) return {};
+  return entry->addresses;
+}
@@ -15,775 +15,590 @@
 
 #include "response.h"
 
-minio::s3::Response minio::s3::Response::ParseXML(std::string_view data,
-                                                  int status_code,
-                                                  utils::Multimap headers) {
-  Response resp;
-  resp.status_code = status_code;
-  resp.headers = headers;
+#include "xml.h"
 
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) {
-    resp.err_ = error::Error("unable to parse XML; " + std::string(data));
-    return resp;
-  }
+namespace {
+namespace s3 = minio::s3;
+namespace xml = minio::xml;
 
-  auto root = xdoc.select_node("/Error");
-  pugi::xpath_node text;
+bool enabled(std::string_view text) { return text == "Enabled"; }
 
-  text = root.node().select_node("Code/text()");
-  resp.code = text.node().value();
-
-  text = root.node().select_node("Message/text()");
-  resp.message = text.node().value();
+template <typename T>
+void etag(T& obj, std::string_view text) {
+  obj.etag = minio::utils::Trim(text, '"');
+}
 
-  text = root.node().select_node("Resource/text()");
-  resp.resource = text.node().value();
+constexpr xml::Field<s3::Tag> kTagFields[] = {
+    {"Key", xml::Set<s3::Tag, &s3::Tag::key>},
+    {"Value", xml::Set<s3::Tag, &s3::Tag::value>},
+};
+
+// addTag decodes Tag element into tags member.
+template <typename T>
+bool addTag(T& obj, xml::Reader& reader) {
+  s3::Tag tag;
+  if (!xml::Decode(reader, tag, kTagFields)) return false;
+  obj.tags[std::move(tag.key)] = std::move(tag.value);
+  return true;
+}
 
-  text = root.node().select_node("RequestId/text()");
-  resp.request_id = text.node().value();
+// enable decodes an optional element into a member and enables it.
+template <typename T, typename C, C T::*Member, const auto&... Tables>
+bool enable(T& obj, xml::Reader& reader) {
+  (obj.*Member).Enable();
+  return xml::Decode(reader, obj.*Member, Tables...);
+}
 
-  text = root.node().select_node("HostId/text()");
-  resp.host_id = text.node().value();
+constexpr xml::Field<s3::Response> kErrorFields[] = {
+    {"Code", xml::Set<s3::Response, &s3::Response::code>},
+    {"Message", xml::Set<s3::Response, &s3::Response::message>},
+    {"Resource", xml::Set<s3::Response, &s3::Response::resource>},
+    {"RequestId", xml::Set<s3::Response, &s3::Response::request_id>},
+    {"HostId", xml::Set<s3::Response, &s3::Response::host_id>},
+    {"BucketName", xml::Set<s3::Response, &s3::Response::bucket_name>},
+    {"Key", xml::Set<s3::Response, &s3::Response::object_name>},
+};
+
+constexpr xml::Field<s3::Bucket> kBucketFields[] = {
+    {"Name", xml::Set<s3::Bucket, &s3::Bucket::name>},
+    {"CreationDate", xml::Set<s3::Bucket, &s3::Bucket::creation_date>},
+};
+
+constexpr xml::Field<s3::ListBucketsResponse> kListBucketsFields[] = {
+    {"Buckets/Bucket", NULL,
+     xml::Append<s3::ListBucketsResponse, s3::Bucket,
+                 &s3::ListBucketsResponse::buckets, kBucketFields>},
+};
+
+using CompleteMultipartUpload = s3::CompleteMultipartUploadResponse;
+constexpr xml::Field<CompleteMultipartUpload> kCompleteMultipartUploadFields[] =
+    {
+        {"Bucket", xml::Set<CompleteMultipartUpload,
+                            &CompleteMultipartUpload::bucket_name>},
+        {"Key", xml::Set<CompleteMultipartUpload,
+                         &CompleteMultipartUpload::object_name>},
+        {"Location",
+         xml::Set<CompleteMultipartUpload, &CompleteMultipartUpload::location>},
+        {"ETag", etag<CompleteMultipartUpload>},
+};
+
+constexpr xml::Field<s3::Item> kItemFields[] = {
+    {"ETag", etag<s3::Item>},
+    {"Key", xml::Set<s3::Item, &s3::Item::name>},
+    {"LastModified", xml::Set<s3::Item, &s3::Item::last_modified>},
+    {"Owner/ID", xml::Set<s3::Item, &s3::Item::owner_id>},
+    {"Owner/DisplayName", xml::Set<s3::Item, &s3::Item::owner_name>},
+    {"Size", xml::Set<s3::Item, &s3::Item::size>},
+    {"StorageClass", xml::Set<s3::Item, &s3::Item::storage_class>},
+    {"IsLatest", xml::Set<s3::Item, &s3::Item::is_latest>},
+    {"VersionId", xml::Set<s3::Item, &s3::Item::version_id>},
+    {"UserMetadata", NULL,
+     [](s3::Item& item, xml::Reader& reader) {
+       return xml::Children(reader, [&item](std::string_view name,
+                                            std::string_view value) {
+         item.user_metadata[std::string(name)] = value;
+       });
+     }},
+};
+
+constexpr xml::Field<s3::Item> kPrefixFields[] = {
+    {"Prefix", xml::Set<s3::Item, &s3::Item::name>},
+};
+
+using ListObjects = s3::ListObjectsResponse;
+constexpr xml::Field<ListObjects> kListObjectsFields[] = {
+    {"Name", xml::Set<ListObjects, &ListObjects::name>},
+    {"EncodingType", xml::Set<ListObjects, &ListObjects::encoding_type>},
+    {"Prefix", xml::Set<ListObjects, &ListObjects::prefix>},
+    {"Delimiter", xml::Set<ListObjects, &ListObjects::delimiter>},
+    {"IsTruncated", xml::Set<ListObjects, &ListObjects::is_truncated>},
+    {"MaxKeys", xml::Set<ListObjects, &ListObjects::max_keys>},
+    // ListBucketResult V1
+    {"Marker", xml::Set<ListObjects, &ListObjects::marker>},
+    {"NextMarker", xml::Set<ListObjects, &ListObjects::next_marker>},
+    // ListBucketResult V2
+    {"KeyCount", xml::Set<ListObjects, &ListObjects::key_count>},
+    {"StartAfter", xml::Set<ListObjects, &ListObjects::start_after>},
+    {"ContinuationToken",
+     xml::Set<ListObjects, &ListObjects::continuation_token>},
+    {"NextContinuationToken",
+     xml::Set<ListObjects, &ListObjects::next_continuation_token>},
+    // ListVersionsResult
+    {"KeyMarker", xml::Set<ListObjects, &ListObjects::key_marker>},
+    {"NextKeyMarker", xml::Set<ListObjects, &ListObjects::next_key_marker>},
+    {"VersionIdMarker",
+     xml::Set<ListObjects, &ListObjects::version_id_marker>},
+    {"NextVersionIdMarker",
+     xml::Set<ListObjects, &ListObjects::next_version_id_marker>},
+    {"Contents", NULL,
+     xml::Append<ListObjects, s3::Item, &ListObjects::contents, kItemFields>},
+    {"Version", NULL,
+     xml::Append<ListObjects, s3::Item, &ListObjects::contents, kItemFields>},
+};
+
+// ListObjectsResult keeps common prefixes and delete markers apart, as they
+// are listed after contents regardless of their place in the document.
+struct ListObjectsResult : public ListObjects {
+  std::list<s3::Item> prefixes;
+  std::list<s3::Item> delete_markers;
+};  // struct ListObjectsResult
+
+constexpr xml::Field<ListObjectsResult> kListObjectsResultFields[] = {
+    {"CommonPrefixes", NULL,
+     xml::Append<ListObjectsResult, s3::Item, &ListObjectsResult::prefixes,
+                 kPrefixFields>},
+    {"DeleteMarker", NULL,
+     xml::Append<ListObjectsResult, s3::Item,
+                 &ListObjectsResult::delete_markers, kItemFields>},
+};
+
+constexpr xml::Field<s3::DeletedObject> kDeletedObjectFields[] = {
+    {"Key", xml::Set<s3::DeletedObject, &s3::DeletedObject::name>},
+    {"VersionId", xml::Set<s3::DeletedObject, &s3::DeletedObject::version_id>},
+    {"DeleteMarker",
+     xml::Set<s3::DeletedObject, &s3::DeletedObject::delete_marker>},
+    {"DeleteMarkerVersionId",
+     xml::Set<s3::DeletedObject,
+              &s3::DeletedObject::delete_marker_version_id>},
+};
+
+constexpr xml::Field<s3::DeleteError> kDeleteErrorFields[] = {
+    {"Key", xml::Set<s3::DeleteError, &s3::DeleteError::object_name>},
+    {"VersionId", xml::Set<s3::DeleteError, &s3::DeleteError::version_id>},
+    {"Code", xml::Set<s3::DeleteError, &s3::DeleteError::code>},
+    {"Message", xml::Set<s3::DeleteError, &s3::DeleteError::message>},
+};
+
+using RemoveObjects = s3::RemoveObjectsResponse;
+constexpr xml::Field<RemoveObjects> kRemoveObjectsFields[] = {
+    {"Deleted", NULL,
+     xml::Append<RemoveObjects, s3::DeletedObject, &RemoveObjects::objects,
+                 kDeletedObjectFields>},
+    {"Error", NULL,
+     xml::Append<RemoveObjects, s3::DeleteError, &RemoveObjects::errors,
+                 kDeleteErrorFields>},
+};
+
+constexpr xml::Field<s3::Tag> kFilterRuleFields[] = {
+    {"Name", xml::Set<s3::Tag, &s3::Tag::key>},
+    {"Value", xml::Set<s3::Tag, &s3::Tag::value>},
+};
+
+using NotificationCommon = s3::NotificationCommonConfig;
+constexpr xml::Field<NotificationCommon> kNotificationCommonFields[] = {
+    {"Event",
+     [](NotificationCommon& config, std::string_view text) {
+       config.events.push_back(std::string(text));
+     }},
+    {"Id", xml::Set<NotificationCommon, &NotificationCommon::id>},
+    {"Filter/S3Key/FilterRule", NULL,
+     [](NotificationCommon& config, xml::Reader& reader) {
+       s3::Tag rule;  // Name and Value.
+       if (!xml::Decode(reader, rule, kFilterRuleFields)) {
+         return false;
+       }
+       if (rule.key == s3::PrefixFilterRule::name) {
+         config.prefix_filter_rule = s3::PrefixFilterRule(rule.value);
+       } else {
+         config.suffix_filter_rule = s3::SuffixFilterRule(rule.value);
+       }
+       return true;
+     }},
+};
+
+constexpr xml::Field<s3::CloudFuncConfig> kCloudFuncFields[] = {
+    {"CloudFunction",
+     xml::Set<s3::CloudFuncConfig, &s3::CloudFuncConfig::cloud_func>},
+};
+
+constexpr xml::Field<s3::QueueConfig> kQueueFields[] = {
+    {"Queue", xml::Set<s3::QueueConfig, &s3::QueueConfig::queue>},
+};
+
+constexpr xml::Field<s3::TopicConfig> kTopicFields[] = {
+    {"Topic", xml::Set<s3::TopicConfig, &s3::TopicConfig::topic>},
+};
+
+using Notification = s3::NotificationConfig;
+constexpr xml::Field<Notification> kNotificationFields[] = {
+    {"CloudFunctionConfiguration", NULL,
+     xml::Append<Notification, s3::CloudFuncConfig,
+                 &Notification::cloud_func_config_list, kCloudFuncFields,
+                 kNotificationCommonFields>},
+    {"QueueConfiguration", NULL,
+     xml::Append<Notification, s3::QueueConfig,
+                 &Notification::queue_config_list, kQueueFields,
+                 kNotificationCommonFields>},
+    {"TopicConfiguration", NULL,
+     xml::Append<Notification, s3::TopicConfig,
+                 &Notification::topic_config_list, kTopicFields,
+                 kNotificationCommonFields>},
+};
+
+constexpr xml::Field<s3::SseConfig> kSseFields[] = {
+    {"Rule/ApplyServerSideEncryptionByDefault/SSEAlgorithm",
+     xml::Set<s3::SseConfig, &s3::SseConfig::sse_algorithm>},
+    {"Rule/ApplyServerSideEncryptionByDefault/KMSMasterKeyID",
+     xml::Set<s3::SseConfig, &s3::SseConfig::kms_master_key_id>},
+};
+
+constexpr xml::Field<s3::AndOperator> kAndOperatorFields[] = {
+    {"Prefix",
+     xml::Set<s3::AndOperator, &s3::AndOperator::prefix, xml::String>},
+    {"Tag", NULL, addTag<s3::AndOperator>},
+};
+
+constexpr xml::Field<s3::Filter> kFilterFields[] = {
+    {"And", NULL,
+     xml::Into<s3::Filter, s3::AndOperator, &s3::Filter::and_operator,
+               kAndOperatorFields>},
+    {"Prefix", xml::Set<s3::Filter, &s3::Filter::prefix, xml::String>},
+    {"Tag", NULL,
+     xml::Into<s3::Filter, s3::Tag, &s3::Filter::tag, kTagFields>},
+};
+
+constexpr xml::Field<s3::AccessControlTranslation>
+    kAccessControlTranslationFields[] = {
+        {"Owner", xml::Set<s3::AccessControlTranslation,
+                           &s3::AccessControlTranslation::owner>},
+};
+
+constexpr xml::Field<s3::EncryptionConfig> kEncryptionConfigFields[] = {
+    {"ReplicaKmsKeyID", xml::Set<s3::EncryptionConfig,
+                                 &s3::EncryptionConfig::replica_kms_key_id>},
+};
+
+constexpr xml::Field<s3::Metrics> kMetricsFields[] = {
+    {"EventThreshold/Minutes",
+     xml::Set<s3::Metrics, &s3::Metrics::event_threshold_minutes>},
+    {"EventThreshold/Status",
+     xml::Set<s3::Metrics, &s3::Metrics::status, enabled>},
+    {"Status", xml::Set<s3::Metrics, &s3::Metrics::status, enabled>},
+};
+
+constexpr xml::Field<s3::ReplicationTime> kReplicationTimeFields[] = {
+    {"Time/Minutes",
+     xml::Set<s3::ReplicationTime, &s3::ReplicationTime::time_minutes>},
+    {"Status",
+     xml::Set<s3::ReplicationTime, &s3::ReplicationTime::status, enabled>},
+};
+
+using Destination = s3::Destination;
+constexpr xml::Field<Destination> kDestinationFields[] = {
+    {"Bucket", xml::Set<Destination, &Destination::bucket_arn>},
+    {"Account", xml::Set<Destination, &Destination::account>},
+    {"StorageClass", xml::Set<Destination, &Destination::storage_class>},
+    {"AccessControlTranslation", NULL,
+     enable<Destination, s3::AccessControlTranslation,
+            &Destination::access_control_translation,
+            kAccessControlTranslationFields>},
+    {"EncryptionConfiguration", NULL,
+     enable<Destination, s3::EncryptionConfig,
+            &Destination::encryption_config, kEncryptionConfigFields>},
+    {"Metrics", NULL,
+     enable<Destination, s3::Metrics, &Destination::metrics, kMetricsFields>},
+    {"ReplicationTime", NULL,
+     enable<Destination, s3::ReplicationTime, &Destination::replication_time,
+            kReplicationTimeFields>},
+};
+
+using SourceSelectionCriteria = s3::SourceSelectionCriteria;
+constexpr xml::Field<SourceSelectionCriteria>
+    kSourceSelectionCriteriaFields[] = {
+        {"SseKmsEncryptedObjects/Status",
+         xml::Set<SourceSelectionCriteria,
+                  &SourceSelectionCriteria::sse_kms_encrypted_objects_status,
+                  enabled>},
+};
+
+using ReplicationRule = s3::ReplicationRule;
+constexpr xml::Field<ReplicationRule> kReplicationRuleFields[] = {
+    {"ID", xml::Set<ReplicationRule, &ReplicationRule::id>},
+    {"Status", xml::Set<ReplicationRule, &ReplicationRule::status, enabled>},
+    {"Destination", NULL,
+     xml::Into<ReplicationRule, Destination, &ReplicationRule::destination,
+               kDestinationFields>},
+    {"DeleteMarkerReplication/Status",
+     xml::Set<ReplicationRule,
+              &ReplicationRule::delete_marker_replication_status, enabled>},
+    {"ExistingObjectReplication/Status",
+     xml::Set<ReplicationRule,
+              &ReplicationRule::existing_object_replication_status, enabled>},
+    {"Filter", NULL,
+     xml::Into<ReplicationRule, s3::Filter, &ReplicationRule::filter,
+               kFilterFields>},
+    {"Prefix",
+     xml::Set<ReplicationRule, &ReplicationRule::prefix, xml::String>},
+    {"Priority",
+     xml::Set<ReplicationRule, &ReplicationRule::priority, xml::Int>},
+    {"SourceSelectionCriteria", NULL,
+     enable<ReplicationRule, SourceSelectionCriteria,
+            &ReplicationRule::source_selection_criteria,
+            kSourceSelectionCriteriaFields>},
+    {"DeleteReplication/Status",
+     xml::Set<ReplicationRule, &ReplicationRule::delete_replication_status,
+              enabled>},
+};
+
+using Replication = s3::ReplicationConfig;
+constexpr xml::Field<Replication> kReplicationFields[] = {
+    {"Role", xml::Set<Replication, &Replication::role>},
+    {"Rule", NULL,
+     xml::Append<Replication, ReplicationRule, &Replication::rules,
+                 kReplicationRuleFields>},
+};
+
+using LifecycleRule = s3::LifecycleRule;
+constexpr xml::Field<LifecycleRule> kLifecycleRuleFields[] = {
+    {"AbortIncompleteMultipartUpload/DaysAfterInitiation",
+     xml::Set<LifecycleRule,
+              &LifecycleRule::
+                  abort_incomplete_multipart_upload_days_after_initiation,
+              xml::Int>},
+    {"Expiration/Date",
+     xml::Set<LifecycleRule, &LifecycleRule::expiration_date>},
+    {"Expiration/Days",
+     xml::Set<LifecycleRule, &LifecycleRule::expiration_days, xml::Int>},
+    {"Expiration/ExpiredObjectDeleteMarker",
+     xml::Set<LifecycleRule,
+              &LifecycleRule::expiration_expired_object_delete_marker,
+              xml::Bool>},
+    {"Filter", NULL,
+     xml::Into<LifecycleRule, s3::Filter, &LifecycleRule::filter,
+               kFilterFields>},
+    {"ID", xml::Set<LifecycleRule, &LifecycleRule::id>},
+    {"NoncurrentVersionExpiration/NoncurrentDays",
+     xml::Set<LifecycleRule,
+              &LifecycleRule::noncurrent_version_expiration_noncurrent_days,
+              xml::Int>},
+    {"NoncurrentVersionTransition/NoncurrentDays",
+     xml::Set<LifecycleRule,
+              &LifecycleRule::noncurrent_version_transition_noncurrent_days,
+              xml::Int>},
+    {"NoncurrentVersionTransition/StorageClass",
+     xml::Set<LifecycleRule,
+              &LifecycleRule::noncurrent_version_transition_storage_class>},
+    {"Status", xml::Set<LifecycleRule, &LifecycleRule::status, enabled>},
+    {"Transition/Date",
+     xml::Set<LifecycleRule, &LifecycleRule::transition_date>},
+    {"Transition/Days",
+     xml::Set<LifecycleRule, &LifecycleRule::transition_days, xml::Int>},
+    {"Transition/StorageClass",
+     xml::Set<LifecycleRule, &LifecycleRule::transition_storage_class>},
+};
+
+using Lifecycle = s3::LifecycleConfig;
+constexpr xml::Field<Lifecycle> kLifecycleFields[] = {
+    {"Rule", NULL,
+     xml::Append<Lifecycle, LifecycleRule, &Lifecycle::rules,
+                 kLifecycleRuleFields>},
+};
+
+using BucketVersioning = s3::GetBucketVersioningResponse;
+constexpr xml::Field<BucketVersioning> kBucketVersioningFields[] = {
+    {"Status", xml::Set<BucketVersioning, &BucketVersioning::status, enabled>},
+    {"MFADelete",
+     xml::Set<BucketVersioning, &BucketVersioning::mfa_delete, enabled>},
+};
+
+using ObjectLock = s3::ObjectLockConfig;
+constexpr xml::Field<ObjectLock> kObjectLockFields[] = {
+    {"Rule/DefaultRetention/Mode",
+     xml::Set<ObjectLock, &ObjectLock::retention_mode,
+              s3::StringToRetentionMode>},
+    {"Rule/DefaultRetention/Days",
+     xml::Set<ObjectLock, &ObjectLock::retention_duration_days, xml::Int>},
+    {"Rule/DefaultRetention/Years",
+     xml::Set<ObjectLock, &ObjectLock::retention_duration_years, xml::Int>},
+};
+
+using ObjectRetention = s3::GetObjectRetentionResponse;
+constexpr xml::Field<ObjectRetention> kObjectRetentionFields[] = {
+    {"Mode", xml::Set<ObjectRetention, &ObjectRetention::retention_mode,
+                      s3::StringToRetentionMode>},
+    {"RetainUntilDate",
+     xml::Set<ObjectRetention, &ObjectRetention::retain_until_date>},
+};
+
+using BucketTags = s3::GetBucketTagsResponse;
+constexpr xml::Field<BucketTags> kBucketTagsFields[] = {
+    {"TagSet/Tag", NULL, addTag<BucketTags>},
+};
+
+using ObjectTags = s3::GetObjectTagsResponse;
+constexpr xml::Field<ObjectTags> kObjectTagsFields[] = {
+    {"TagSet/Tag", NULL, addTag<ObjectTags>},
+};
+}  // namespace
 
-  text = root.node().select_node("BucketName/text()");
-  resp.bucket_name = text.node().value();
+minio::s3::Response minio::s3::Response::ParseXML(std::string_view data,
+                                                  int status_code,
+                                                  utils::Multimap headers) {
+  Response resp;
+  resp.status_code = status_code;
+  resp.headers = std::move(headers);
 
-  text = root.node().select_node("Key/text()");
-  resp.object_name = text.node().value();
+  if (xml::Decode(data, "Error", resp, kErrorFields)) {
+    resp.err_ = error::Error("unable to parse XML; " + std::string(data));
+  }
 
   return resp;
 }
 
 minio::s3::ListBucketsResponse minio::s3::ListBucketsResponse::ParseXML(
     std::string_view data) {
-  std::list<Bucket> buckets;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-  pugi::xpath_node_set xnodes =
-      xdoc.select_nodes("/ListAllMyBucketsResult/Buckets/Bucket");
-  for (auto xnode : xnodes) {
-    std::string name;
-    utils::Time creation_date;
-    if (auto node = xnode.node().select_node("Name/text()").node()) {
-      name = node.value();
-    }
-    if (auto node = xnode.node().select_node("CreationDate/text()").node()) {
-      std::string value = node.value();
-      creation_date = utils::Time::FromISO8601UTC(value.c_str());
-    }
-
-    buckets.push_back(Bucket{name, creation_date});
+  ListBucketsResponse resp(std::list<Bucket>{});
+  if (error::Error err = xml::Decode(data, "ListAllMyBucketsResult", resp,
+                                     kListBucketsFields)) {
+    return err;
   }
-
-  return buckets;
+  return resp;
 }
 
 minio::s3::CompleteMultipartUploadResponse
 minio::s3::CompleteMultipartUploadResponse::ParseXML(std::string_view data,
                                                      std::string version_id) {
   CompleteMultipartUploadResponse resp;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto root = xdoc.select_node("/CompleteMultipartUploadOutput");
-
-  pugi::xpath_node text;
-
-  text = root.node().select_node("Bucket/text()");
-  resp.bucket_name = text.node().value();
-
-  text = root.node().select_node("Key/text()");
-  resp.object_name = text.node().value();
-
-  text = root.node().select_node("Location/text()");
-  resp.location = text.node().value();
-
-  text = root.node().select_node("ETag/text()");
-  resp.etag = utils::Trim(text.node().value(), '"');
-
-  resp.version_id = version_id;
-
+  if (error::Error err = xml::Decode(data, "CompleteMultipartUploadResult",
+                                     resp, kCompleteMultipartUploadFields)) {
+    return err;
+  }
+  resp.version_id = std::move(version_id);
   return resp;
 }
 
 minio::s3::ListObjectsResponse minio::s3::ListObjectsResponse::ParseXML(
     std::string_view data, bool version) {
-  ListObjectsResponse resp;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  std::string xpath = version ? "/ListVersionsResult" : "/ListBucketResult";
-
-  auto root = xdoc.select_node(xpath.c_str());
-
-  pugi::xpath_node text;
-  std::string value;
-
-  text = root.node().select_node("Name/text()");
-  resp.name = text.node().value();
-
-  text = root.node().select_node("EncodingType/text()");
-  resp.encoding_type = text.node().value();
-
-  text = root.node().select_node("Prefix/text()");
-  value = text.node().value();
-  resp.prefix = (resp.encoding_type == "url") ? curlpp::unescape(value) : value;
-
-  text = root.node().select_node("Delimiter/text()");
-  resp.delimiter = text.node().value();
-
-  text = root.node().select_node("IsTruncated/text()");
-  value = text.node().value();
-  if (!value.empty()) resp.is_truncated = utils::StringToBool(value);
-
-  text = root.node().select_node("MaxKeys/text()");
-  value = text.node().value();
-  if (!value.empty()) resp.max_keys = std::stoi(value);
-
-  // ListBucketResult V1
-  {
-    text = root.node().select_node("Marker/text()");
-    value = text.node().value();
-    resp.marker =
-        (resp.encoding_type == "url") ? curlpp::unescape(value) : value;
-
-    text = root.node().select_node("NextMarker/text()");
-    value = text.node().value();
-    resp.next_marker =
-        (resp.encoding_type == "url") ? curlpp::unescape(value) : value;
+  ListObjectsResult result;
+  if (error::Error err = xml::Decode(
+          data, version ? "ListVersionsResult" : "ListBucketResult", result,
+          kListObjectsFields, kListObjectsResultFields)) {
+    return err;
   }
 
-  // ListBucketResult V2
-  {
-    text = root.node().select_node("KeyCount/text()");
-    value = text.node().value();
-    if (!value.empty()) resp.key_count = std::stoi(value);
-
-    text = root.node().select_node("StartAfter/text()");
-    value = text.node().value();
-    resp.start_after =
-        (resp.encoding_type == "url") ? curlpp::unescape(value) : value;
-
-    text = root.node().select_node("ContinuationToken/text()");
-    resp.continuation_token = text.node().value();
-
-    text = root.node().select_node("NextContinuationToken/text()");
-    resp.next_continuation_token = text.node().value();
-  }
-
-  // ListVersionsResult
-  {
-    text = root.node().select_node("KeyMarker/text()");
-    value = text.node().value();
-    resp.key_marker =
-        (resp.encoding_type == "url") ? curlpp::unescape(value) : value;
-
-    text = root.node().select_node("NextKeyMarker/text()");
-    value = text.node().value();
-    resp.next_key_marker =
-        (resp.encoding_type == "url") ? curlpp::unescape(value) : value;
-
-    text = root.node().select_node("VersionIdMarker/text()");
-    resp.version_id_marker = text.node().value();
-
-    text = root.node().select_node("NextVersionIdMarker/text()");
-    resp.next_version_id_marker = text.node().value();
-  }
-
-  Item last_item;
-
-  auto populate = [&resp = resp, &last_item = last_item](
-                      std::list<Item>& items, pugi::xpath_node_set& contents,
-                      bool is_delete_marker) -> void {
-    for (auto content : contents) {
-      pugi::xpath_node text;
-      std::string value;
-      Item item;
-
-      text = content.node().select_node("ETag/text()");
-      item.etag = utils::Trim(text.node().value(), '"');
-
-      text = content.node().select_node("Key/text()");
-      value = text.node().value();
-      item.name =
-          (resp.encoding_type == "url") ? curlpp::unescape(value) : value;
-
-      text = content.node().select_node("LastModified/text()");
-      value = text.node().value();
-      item.last_modified = utils::Time::FromISO8601UTC(value.c_str());
-
-      text = content.node().select_node("Owner/ID/text()");
-      item.owner_id = text.node().value();
-
-      text = content.node().select_node("Owner/DisplayName/text()");
-      item.owner_name = text.node().value();
-
-      text = content.node().select_node("Size/text()");
-      value = text.node().value();
-      if (!value.empty()) item.size = std::stoi(value);
-
-      text = content.node().select_node("StorageClass/text()");
-      item.storage_class = text.node().value();
-
-      text = content.node().select_node("IsLatest/text()");
-      value = text.node().value();
-      if (!value.empty()) item.is_latest = utils::StringToBool(value);
-
-      text = content.node().select_node("VersionId/text()");
-      item.version_id = text.node().value();
-
-      auto user_metadata = content.node().select_node("UserMetadata");
-      for (auto metadata = user_metadata.node().first_child(); metadata;
-           metadata = metadata.next_sibling()) {
-        item.user_metadata[metadata.name()] = metadata.child_value();
-      }
-
-      item.is_delete_marker = is_delete_marker;
-
-      items.push_back(item);
-      last_item = item;
+  // EncodingType may come after the values it applies to.
+  if (result.encoding_type == "url") {
+    for (std::string* value :
+         {&result.prefix, &result.marker, &result.next_marker,
+          &result.start_after, &result.key_marker, &result.next_key_marker}) {
+      *value = curlpp::unescape(*value);
+    }
+    for (auto* items :
+         {&result.contents, &result.prefixes, &result.delete_markers}) {
+      for (Item& item : *items) item.name = curlpp::unescape(item.name);
     }
-  };
-
-  auto contents = root.node().select_nodes(version ? "Version" : "Contents");
-  populate(resp.contents, contents, false);
-  // Only for ListObjectsV1.
-  if (resp.is_truncated && resp.next_marker.empty()) {
-    resp.next_marker = last_item.name;
   }
 
-  auto common_prefixes = root.node().select_nodes("CommonPrefixes");
-  for (auto common_prefix : common_prefixes) {
-    Item item;
-
-    text = common_prefix.node().select_node("Prefix/text()");
-    value = text.node().value();
-    item.name = (resp.encoding_type == "url") ? curlpp::unescape(value) : value;
-
-    item.is_prefix = true;
-
-    resp.contents.push_back(item);
+  // Only for ListObjectsV1.
+  if (result.is_truncated && result.next_marker.empty() &&
+      !result.contents.empty()) {
+    result.next_marker = result.contents.back().name;
   }
 
-  auto delete_markers = root.node().select_nodes("DeleteMarker");
-  populate(resp.contents, delete_markers, true);
+  for (Item& item : result.prefixes) item.is_prefix = true;
+  for (Item& item : result.delete_markers) item.is_delete_marker = true;
+  result.contents.splice(result.contents.end(), result.prefixes);
+  result.contents.splice(result.contents.end(), result.delete_markers);
 
-  return resp;
+  return ListObjectsResponse(std::move(result));
 }
 
 minio::s3::RemoveObjectsResponse minio::s3::RemoveObjectsResponse::ParseXML(
     std::string_view data) {
   RemoveObjectsResponse resp;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto root = xdoc.select_node("/DeleteResult");
-
-  auto deletedList = root.node().select_nodes("Deleted");
-  for (auto deleted : deletedList) {
-    pugi::xpath_node text;
-    std::string value;
-    DeletedObject object;
-
-    text = deleted.node().select_node("Key/text()");
-    object.name = text.node().value();
-
-    text = deleted.node().select_node("VersionId/text()");
-    object.version_id = text.node().value();
-
-    text = deleted.node().select_node("DeleteMarkerVersionId/text()");
-    object.delete_marker_version_id = text.node().value();
-
-    text = deleted.node().select_node("DeleteMarker/text()");
-    value = text.node().value();
-    if (!value.empty()) object.delete_marker = utils::StringToBool(value);
-
-    resp.objects.push_back(object);
-  }
-
-  auto errorList = root.node().select_nodes("Error");
-  for (auto error : errorList) {
-    pugi::xpath_node text;
-    std::string value;
-    DeleteError err;
-
-    text = error.node().select_node("Key/text()");
-    err.object_name = text.node().value();
-
-    text = error.node().select_node("VersionId/text()");
-    err.version_id = text.node().value();
-
-    text = error.node().select_node("Code/text()");
-    err.code = text.node().value();
-
-    text = error.node().select_node("Message/text()");
-    err.message = text.node().value();
-
-    resp.errors.push_back(err);
+  if (error::Error err =
+          xml::Decode(data, "DeleteResult", resp, kRemoveObjectsFields)) {
+    return err;
   }
-
   return resp;
 }
 
 minio::s3::GetBucketNotificationResponse
 minio::s3::GetBucketNotificationResponse::ParseXML(std::string_view data) {
-  minio::s3::NotificationConfig config;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto root = xdoc.select_node("/NotificationConfiguration");
-
-  auto populate = [](pugi::xpath_node& common) -> NotificationCommonConfig {
-    NotificationCommonConfig cfg;
-    pugi::xpath_node text;
-
-    auto events = common.node().select_nodes("Event");
-    for (auto event : events) cfg.events.push_back(event.node().value());
-
-    text = common.node().select_node("Id/text()");
-    cfg.id = text.node().value();
-
-    if (common.node().select_node("Filter")) {
-      auto filters = common.node().select_nodes("Filter/S3Key/FilterRule");
-      for (auto filter : filters) {
-        text = filter.node().select_node("Name/text()");
-        auto name = text.node().value();
-
-        text = filter.node().select_node("Value/text()");
-        auto value = text.node().value();
-
-        if (strcmp(name, "prefix") == 0) {
-          cfg.prefix_filter_rule = PrefixFilterRule(value);
-        } else {
-          cfg.suffix_filter_rule = SuffixFilterRule(value);
-        }
-      }
-    }
-
-    return cfg;
-  };
-
-  pugi::xpath_node text;
-  std::string value;
-
-  auto cloudfuncs = root.node().select_nodes("CloudFunctionConfiguration");
-  for (auto cloudfunc : cloudfuncs) {
-    CloudFuncConfig cfg;
-
-    text = cloudfunc.node().select_node("CloudFunction/text()");
-    cfg.cloud_func = text.node().value();
-
-    NotificationCommonConfig common = populate(cloudfunc);
-    cfg.events = common.events;
-    cfg.id = common.id;
-    cfg.prefix_filter_rule = common.prefix_filter_rule;
-    cfg.suffix_filter_rule = common.suffix_filter_rule;
-
-    config.cloud_func_config_list.push_back(cfg);
-  }
-
-  auto queues = root.node().select_nodes("QueueConfiguration");
-  for (auto queue : queues) {
-    QueueConfig cfg;
-
-    text = queue.node().select_node("Queue/text()");
-    cfg.queue = text.node().value();
-
-    NotificationCommonConfig common = populate(queue);
-    cfg.events = common.events;
-    cfg.id = common.id;
-    cfg.prefix_filter_rule = common.prefix_filter_rule;
-    cfg.suffix_filter_rule = common.suffix_filter_rule;
-
-    config.queue_config_list.push_back(cfg);
-  }
-
-  auto topics = root.node().select_nodes("TopicConfiguration");
-  for (auto topic : topics) {
-    TopicConfig cfg;
-
-    text = topic.node().select_node("Topic/text()");
-    cfg.topic = text.node().value();
-
-    NotificationCommonConfig common = populate(topic);
-    cfg.events = common.events;
-    cfg.id = common.id;
-    cfg.prefix_filter_rule = common.prefix_filter_rule;
-    cfg.suffix_filter_rule = common.suffix_filter_rule;
-
-    config.topic_config_list.push_back(cfg);
+  NotificationConfig config;
+  if (error::Error err = xml::Decode(data, "NotificationConfiguration", config,
+                                     kNotificationFields)) {
+    return err;
   }
-
   return config;
 }
 
 minio::s3::GetBucketEncryptionResponse
 minio::s3::GetBucketEncryptionResponse::ParseXML(std::string_view data) {
   SseConfig config;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto root = xdoc.select_node(
-      "/ServerSideEncryptionConfiguration/Rule"
-      "/ApplyServerSideEncryptionByDefault");
-
-  pugi::xpath_node text = root.node().select_node("SSEAlgorithm/text()");
-  config.sse_algorithm = text.node().value();
-
-  text = root.node().select_node("KMSMasterKeyID/text()");
-  config.kms_master_key_id = text.node().value();
-
+  if (error::Error err = xml::Decode(data, "ServerSideEncryptionConfiguration",
+                                     config, kSseFields)) {
+    return err;
+  }
   return config;
 }
 
+minio::s3::GetBucketVersioningResponse
+minio::s3::GetBucketVersioningResponse::ParseXML(std::string_view data) {
+  GetBucketVersioningResponse resp;
+  if (error::Error err = xml::Decode(data, "VersioningConfiguration", resp,
+                                     kBucketVersioningFields)) {
+    return err;
+  }
+  return resp;
+}
+
 minio::s3::GetBucketReplicationResponse
 minio::s3::GetBucketReplicationResponse::ParseXML(std::string_view data) {
   ReplicationConfig config;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto root = xdoc.select_node("/ReplicationConfiguration");
-
-  pugi::xpath_node text;
-  std::string value;
-
-  if (root.node().select_node("Role")) {
-    text = root.node().select_node("Role/text()");
-    config.role = text.node().value();
+  if (error::Error err = xml::Decode(data, "ReplicationConfiguration", config,
+                                     kReplicationFields)) {
+    return err;
   }
-
-  auto rules = root.node().select_nodes("Rule");
-  for (auto& rule : rules) {
-    ReplicationRule rrule;
-
-    text = rule.node().select_node("ID/text()");
-    rrule.id = text.node().value();
-
-    text = rule.node().select_node("Status/text()");
-    value = text.node().value();
-    rrule.status = (value == "Enabled");
-
-    auto destination = rule.node().select_node("Destination");
-
-    text = destination.node().select_node("Bucket/text()");
-    rrule.destination.bucket_arn = text.node().value();
-
-    text = destination.node().select_node("Account/text()");
-    rrule.destination.account = text.node().value();
-
-    text = destination.node().select_node("StorageClass/text()");
-    rrule.destination.storage_class = text.node().value();
-
-    if (destination.node().select_node("AccessControlTranslation")) {
-      rrule.destination.access_control_translation.Enable();
-      text = destination.node().select_node(
-          "AccessControlTranslation/Owner/text()");
-      rrule.destination.access_control_translation.owner = text.node().value();
-    }
-    if (destination.node().select_node("EncryptionConfiguration")) {
-      rrule.destination.encryption_config.Enable();
-      text = destination.node().select_node(
-          "EncryptionConfiguration/ReplicaKmsKeyID/text()");
-      rrule.destination.encryption_config.replica_kms_key_id =
-          text.node().value();
-    }
-    if (destination.node().select_node("Metrics")) {
-      rrule.destination.metrics.Enable();
-
-      text = destination.node().select_node(
-          "Metrics/EventThreshold/Minutes/text()");
-      value = text.node().value();
-      rrule.destination.metrics.event_threshold_minutes = std::stoi(value);
-
-      text = destination.node().select_node(
-          "Metrics/EventThreshold/Status/text()");
-      value = text.node().value();
-      rrule.destination.metrics.status = (value == "Enabled");
-    }
-    if (destination.node().select_node("ReplicationTime")) {
-      rrule.destination.replication_time.Enable();
-
-      text = destination.node().select_node("ReplicationTime/Time/text()");
-      value = text.node().value();
-      rrule.destination.replication_time.time_minutes = std::stoi(value);
-
-      text = destination.node().select_node("ReplicationTime/Status/text()");
-      value = text.node().value();
-      rrule.destination.replication_time.status = (value == "Enabled");
-    }
-
-    if (rule.node().select_node("DeleteMarkerReplication")) {
-      text = rule.node().select_node("DeleteMarkerReplication/Status/text()");
-      value = text.node().value();
-      rrule.delete_marker_replication_status = (value == "Enabled");
-    }
-
-    if (rule.node().select_node("ExistingObjectReplication")) {
-      text = rule.node().select_node("ExistingObjectReplication/Status/text()");
-      value = text.node().value();
-      rrule.existing_object_replication_status = (value == "Enabled");
-    }
-
-    if (rule.node().select_node("Filter")) {
-      auto filter = rule.node().select_node("Filter");
-
-      if (filter.node().select_node("And")) {
-        if (filter.node().select_node("And/Prefix")) {
-          text = filter.node().select_node("And/Prefix/text()");
-          rrule.filter.and_operator.prefix = Prefix(text.node().value());
-        }
-
-        if (filter.node().select_node("And/Tag")) {
-          auto tags = root.node().select_nodes("And/Tag");
-          for (auto& tag : tags) {
-            text = filter.node().select_node("Key/text()");
-            std::string key = text.node().value();
-
-            text = filter.node().select_node("Value/text()");
-            std::string value = text.node().value();
-
-            rrule.filter.and_operator.tags[key] = value;
-          }
-        }
-      }
-
-      if (filter.node().select_node("Prefix")) {
-        text = filter.node().select_node("Prefix/text()");
-        rrule.filter.prefix = Prefix(text.node().value());
-      }
-
-      if (filter.node().select_node("Tag")) {
-        text = filter.node().select_node("Tag/Key/text()");
-        rrule.filter.tag.key = text.node().value();
-
-        text = filter.node().select_node("Tag/Value/text()");
-        rrule.filter.tag.value = text.node().value();
-      }
-    }
-
-    if (rule.node().select_node("Prefix")) {
-      text = rule.node().select_node("Prefix/text()");
-      rrule.prefix = Prefix(text.node().value());
-    }
-
-    if (rule.node().select_node("Priority")) {
-      text = rule.node().select_node("Priority/text()");
-      value = text.node().value();
-      rrule.priority = Integer(std::stoi(value));
-    }
-
-    if (rule.node().select_node("SourceSelectionCriteria")) {
-      rrule.source_selection_criteria.Enable();
-      if (rule.node().select_node(
-              "SourceSelectionCriteria/SseKmsEncryptedObjects")) {
-        text = rule.node().select_node(
-            "SourceSelectionCriteria/SseKmsEncryptedObjects/Status/text()");
-        value = text.node().value();
-        rrule.source_selection_criteria.sse_kms_encrypted_objects_status =
-            (value == "Enabled");
-      }
-    }
-
-    if (rule.node().select_node("DeleteReplication")) {
-      text = rule.node().select_node("DeleteReplication/Status/text()");
-      value = text.node().value();
-      rrule.delete_replication_status = (value == "Enabled");
-    }
-
-    config.rules.push_back(rrule);
-  }
-
   return config;
 }
 
 minio::s3::GetBucketLifecycleResponse
 minio::s3::GetBucketLifecycleResponse::ParseXML(std::string_view data) {
   LifecycleConfig config;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto root = xdoc.select_node("/LifecycleConfiguration");
-
-  pugi::xpath_node text;
-  std::string value;
-
-  auto rules = root.node().select_nodes("Rule");
-  for (auto& rule : rules) {
-    LifecycleRule lrule;
-
-    if (rule.node().select_node("AbortIncompleteMultipartUpload")) {
-      text = rule.node().select_node(
-          "AbortIncompleteMultipartUpload/DaysAfterInitiation/text()");
-      value = text.node().value();
-      lrule.abort_incomplete_multipart_upload_days_after_initiation =
-          std::stoi(value);
-    }
-
-    if (rule.node().select_node("Expiration")) {
-      if (rule.node().select_node("Expiration/Date")) {
-        text = rule.node().select_node("Expiration/Date/text()");
-        lrule.expiration_date =
-            utils::Time::FromISO8601UTC(text.node().value());
-      }
-
-      if (rule.node().select_node("Expiration/Days")) {
-        text = rule.node().select_node("Expiration/Days/text()");
-        value = text.node().value();
-        lrule.expiration_days = std::stoi(value);
-      }
-
-      if (rule.node().select_node("Expiration/ExpiredObjectDeleteMarker")) {
-        text = rule.node().select_node(
-            "Expiration/ExpiredObjectDeleteMarker/text()");
-        lrule.expiration_expired_object_delete_marker =
-            utils::BoolToString(text.node().value());
-      }
-    }
-
-    auto filter = rule.node().select_node("Filter");
-    if (filter.node().select_node("And")) {
-      if (filter.node().select_node("And/Prefix")) {
-        text = filter.node().select_node("And/Prefix/text()");
-        lrule.filter.and_operator.prefix = Prefix(text.node().value());
-      }
-
-      if (filter.node().select_node("And/Tag")) {
-        auto tags = root.node().select_nodes("And/Tag");
-        for (auto& tag : tags) {
-          text = filter.node().select_node("Key/text()");
-          std::string key = text.node().value();
-
-          text = filter.node().select_node("Value/text()");
-          std::string value = text.node().value();
-
-          lrule.filter.and_operator.tags[key] = value;
-        }
-      }
-    }
-    if (filter.node().select_node("Prefix")) {
-      text = filter.node().select_node("Prefix/text()");
-      lrule.filter.prefix = Prefix(text.node().value());
-    }
-    if (filter.node().select_node("Tag")) {
-      text = filter.node().select_node("Tag/Key/text()");
-      lrule.filter.tag.key = text.node().value();
-
-      text = filter.node().select_node("Tag/Value/text()");
-      lrule.filter.tag.value = text.node().value();
-    }
-
-    text = rule.node().select_node("ID/text()");
-    lrule.id = text.node().value();
-
-    if (rule.node().select_node("NoncurrentVersionExpiration")) {
-      text = rule.node().select_node(
-          "NoncurrentVersionExpiration/NoncurrentDays/text()");
-      value = text.node().value();
-      lrule.noncurrent_version_expiration_noncurrent_days = std::stoi(value);
-    }
-
-    if (rule.node().select_node("NoncurrentVersionTransition")) {
-      text = rule.node().select_node(
-          "NoncurrentVersionTransition/NoncurrentDays/text()");
-      value = text.node().value();
-      lrule.noncurrent_version_transition_noncurrent_days = std::stoi(value);
-
-      text = rule.node().select_node(
-          "NoncurrentVersionTransition/StorageClass/text()");
-      lrule.noncurrent_version_transition_storage_class = text.node().value();
-    }
-
-    text = rule.node().select_node("Status/text()");
-    value = text.node().value();
-    lrule.status = (value == "Enabled");
-
-    if (rule.node().select_node("Transition")) {
-      if (rule.node().select_node("Transition/Date")) {
-        text = rule.node().select_node("Transition/Date/text()");
-        lrule.transition_date =
-            utils::Time::FromISO8601UTC(text.node().value());
-      }
-
-      if (rule.node().select_node("Transition/Days")) {
-        text = rule.node().select_node("Transition/Days/text()");
-        value = text.node().value();
-        lrule.transition_days = std::stoi(value);
-      }
-
-      text = rule.node().select_node("Transition/StorageClass/text()");
-      lrule.transition_storage_class = text.node().value();
-    }
-
-    config.rules.push_back(lrule);
+  if (error::Error err = xml::Decode(data, "LifecycleConfiguration", config,
+                                     kLifecycleFields)) {
+    return err;
   }
-
   return config;
 }
 
 minio::s3::GetBucketTagsResponse minio::s3::GetBucketTagsResponse::ParseXML(
     std::string_view data) {
-  std::map<std::string, std::string> map;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto tags = xdoc.select_nodes("/Tagging/TagSet/Tag");
-
-  pugi::xpath_node text;
-
-  for (auto& tag : tags) {
-    text = tag.node().select_node("Key/text()");
-    std::string key = text.node().value();
-
-    text = tag.node().select_node("Value/text()");
-    std::string value = text.node().value();
-
-    map[key] = value;
+  GetBucketTagsResponse resp(std::map<std::string, std::string>{});
+  if (error::Error err =
+          xml::Decode(data, "Tagging", resp, kBucketTagsFields)) {
+    return err;
   }
+  return resp;
+}
 
-  return map;
+minio::s3::GetObjectLockConfigResponse
+minio::s3::GetObjectLockConfigResponse::ParseXML(std::string_view data) {
+  ObjectLockConfig config;
+  if (error::Error err = xml::Decode(data, "ObjectLockConfiguration", config,
+                                     kObjectLockFields)) {
+    return err;
+  }
+  return config;
 }
 
 minio::s3::GetObjectTagsResponse minio::s3::GetObjectTagsResponse::ParseXML(
     std::string_view data) {
-  std::map<std::string, std::string> map;
-
-  pugi::xml_document xdoc;
-  pugi::xml_parse_result result = xdoc.load_string(data.data());
-  if (!result) return error::Error("unable to parse XML");
-
-  auto tags = xdoc.select_nodes("/Tagging/TagSet/Tag");
-
-  pugi::xpath_node text;
-
-  for (auto& tag : tags) {
-    text = tag.node().select_node("Key/text()");
-    std::string key = text.node().value();
-
-    text = tag.node().select_node("Value/text()");
-    std::string value = text.node().value();
-
-    map[key] = value;
+  GetObjectTagsResponse resp(std::map<std::string, std::string>{});
+  if (error::Error err =
+          xml::Decode(data, "Tagging", resp, kObjectTagsFields)) {
+    return err;
   }
+  return resp;
+}
 
-  return map;
+minio::s3::GetObjectRetentionResponse
+minio::s3::GetObjectRetentionResponse::ParseXML(std::string_view data) {
+  GetObjectRetentionResponse resp;
+  if (error::Error err =
+          xml::Decode(data, "Retention", resp, kObjectRetentionFields)) {
+    return err;
+  }
+  return resp;
 }
@@ -0,0 +1,73 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "retry.h"
+
+#include <random>
+
+bool minio::s3::RetryPolicy::IsRetryable(http::Response& http_response,
+                                         Response& response) {
+  switch (http_response.curl_code) {
+    case CURLE_OK:
+      break;
+    case CURLE_COULDNT_RESOLVE_HOST:
+    case CURLE_COULDNT_CONNECT:
+    case CURLE_OPERATION_TIMEDOUT:
+    case CURLE_SEND_ERROR:
+    case CURLE_RECV_ERROR:
+    case CURLE_GOT_NOTHING:
+    case CURLE_PARTIAL_FILE:
+    case CURLE_SSL_CONNECT_ERROR:
+    case CURLE_HTTP2:
+    case CURLE_HTTP2_STREAM:
+      return true;
+    default:
+      return false;
+  }
+
+  if (response.code == "InternalError" || response.code == "OperationAborted" ||
+      response.code == "RequestTimeout" ||
+      response.code == "ServiceUnavailable" || response.code == "SlowDown" ||
+      response.code == "SlowDownRead" || response.code == "SlowDownWrite" ||
+      response.code == "XMinioServerNotInitialized" ||
+      response.code == "XMinioReadQuorum" ||
+      response.code == "XMinioWriteQuorum") {
+    return true;
+  }
+
+  switch (http_response.status_code) {
+    case 408:  // Request Timeout
+    case 429:  // Too Many Requests
+    case 500:  // Internal Server Error
+    case 502:  // Bad Gateway
+    case 503:  // Service Unavailable
+    case 504:  // Gateway Timeout
+      return true;
+  }
+
+  return false;
+}
+
+std::chrono::milliseconds minio::s3::RetryPolicy::Backoff(unsigned int retry) {
+  thread_local static std::mt19937 rg{std::random_device{}()};
+
+  long long cap = max_delay.count();
+  long long delay = base_delay.count();
+  for (unsigned int i = 1; i < retry && delay < cap; i++) delay *= 2;
+  if (delay > cap) delay = cap;
+
+  std::uniform_int_distribution<long long> jitter(0, delay);
+  return std::chrono::milliseconds(jitter(rg));
+}
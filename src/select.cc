@@ -15,6 +15,20 @@
 
 #include "select.h"
 
+#include "xml.h"
+
+namespace {
+namespace xml = minio::xml;
+using SelectResult = minio::s3::SelectResult;
+
+constexpr xml::Field<SelectResult> kProgressFields[] = {
+    {"BytesScanned", xml::Set<SelectResult, &SelectResult::bytes_scanned>},
+    {"BytesProcessed",
+     xml::Set<SelectResult, &SelectResult::bytes_processed>},
+    {"BytesReturned", xml::Set<SelectResult, &SelectResult::bytes_returned>},
+};
+}  // namespace
+
 void minio::s3::SelectHandler::Reset() {
   prelude_ = "";
   prelude_read_ = false;
@@ -163,38 +177,16 @@ bool minio::s3::SelectHandler::process(http::DataFunctionArgs args,
   std::string payload = data_.substr(0, payload_length);
   if (headers[":event-type"] == "Progress" ||
       headers[":event-type"] == "Stats") {
-    pugi::xml_document xdoc;
-    pugi::xml_parse_result result = xdoc.load_string(payload.data());
-    if (!result) {
+    SelectResult progress(-1, -1, -1);
+    if (xml::Decode(payload, headers[":event-type"], progress,
+                    kProgressFields)) {
       done_ = true;
       result_func_(
           SelectResult(error::Error("unable to parse XML; " + payload)));
       return false;
     }
 
-    std::string xpath;
-    xpath = "/" + headers[":event-type"];
-    auto root = xdoc.select_node(xpath.c_str());
-    pugi::xpath_node text;
-    std::string value;
-    long int bytes_scanned = -1;
-    long int bytes_processed = -1;
-    long int bytes_returned = -1;
-
-    text = root.node().select_node("BytesScanned/text()");
-    value = text.node().value();
-    if (!value.empty()) bytes_scanned = std::stoi(value);
-
-    text = root.node().select_node("BytesProcessed/text()");
-    value = text.node().value();
-    if (!value.empty()) bytes_processed = std::stoi(value);
-
-    text = root.node().select_node("BytesReturned/text()");
-    value = text.node().value();
-    if (!value.empty()) bytes_returned = std::stoi(value);
-
-    cont = result_func_(
-        SelectResult(bytes_scanned, bytes_processed, bytes_returned));
+    cont = result_func_(std::move(progress));
     Reset();
     done_ = !cont;
     return cont;
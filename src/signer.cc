@@ -92,20 +92,35 @@ std::string minio::signer::GetAuthorization(std::string& access_key,
 minio::utils::Multimap& minio::signer::SignV4(
     std::string& service_name, http::Method& method, std::string& uri,
     std::string& region, utils::Multimap& headers,
-    utils::Multimap& query_params, std::string& access_key,
-    std::string& secret_key, std::string& content_sha256, utils::Time& date) {
+    const utils::Multimap& query_params, std::string& access_key,
+    std::string& secret_key, std::string& content_sha256, utils::Time& date,
+    std::pmr::memory_resource* memory) {
+  // Canonical request and its parts are built in given memory resource, or
+  // in an arena on the stack.
+  utils::Arena arena;
+  if (memory == NULL) memory = arena.Resource();
+
   std::string scope = GetScope(date, region, service_name);
 
-  std::string signed_headers;
-  std::string canonical_headers;
+  std::pmr::string signed_headers(memory);
+  std::pmr::string canonical_headers(memory);
   headers.GetCanonicalHeaders(signed_headers, canonical_headers);
 
-  std::string canonical_query_string = query_params.GetCanonicalQueryString();
-
-  std::string methodstring = http::MethodToString(method);
-  std::string canonical_request_hash = GetCanonicalRequestHash(
-      methodstring, uri, canonical_query_string, canonical_headers,
-      signed_headers, content_sha256);
+  std::pmr::string canonical_query_string =
+      query_params.GetCanonicalQueryString(memory);
+
+  // Same as GetCanonicalRequestHash().
+  std::string_view methodstring = http::MethodToString(method);
+  std::pmr::string canonical_request(memory);
+  canonical_request.reserve(methodstring.size() + uri.size() +
+                            canonical_query_string.size() +
+                            canonical_headers.size() + signed_headers.size() +
+                            content_sha256.size() + 6);
+  canonical_request.append(methodstring).append("\n").append(uri);
+  canonical_request.append("\n").append(canonical_query_string);
+  canonical_request.append("\n").append(canonical_headers).append("\n\n");
+  canonical_request.append(signed_headers).append("\n").append(content_sha256);
+  std::string canonical_request_hash = utils::Sha256Hash(canonical_request);
 
   std::string string_to_sign =
       GetStringToSign(date, scope, canonical_request_hash);
@@ -115,31 +130,38 @@ minio::utils::Multimap& minio::signer::SignV4(
 
   std::string signature = GetSignature(signing_key, string_to_sign);
 
-  std::string authorization =
-      GetAuthorization(access_key, scope, signed_headers, signature);
+  std::string authorization = "AWS4-HMAC-SHA256 Credential=";
+  authorization.reserve(authorization.size() + access_key.size() +
+                        scope.size() + signed_headers.size() +
+                        signature.size() + 30);
+  authorization.append(access_key).append("/").append(scope);
+  authorization.append(", SignedHeaders=").append(signed_headers);
+  authorization.append(", Signature=").append(signature);
 
-  headers.Add("Authorization", authorization);
+  headers.Add("Authorization", std::move(authorization));
   return headers;
 }
 
 minio::utils::Multimap& minio::signer::SignV4S3(
     http::Method method, std::string& uri, std::string& region,
-    utils::Multimap& headers, utils::Multimap query_params,
+    utils::Multimap& headers, const utils::Multimap& query_params,
     std::string& access_key, std::string& secret_key,
-    std::string& content_sha256, utils::Time& date) {
+    std::string& content_sha256, utils::Time& date,
+    std::pmr::memory_resource* memory) {
   std::string service_name = "s3";
   return SignV4(service_name, method, uri, region, headers, query_params,
-                access_key, secret_key, content_sha256, date);
+                access_key, secret_key, content_sha256, date, memory);
 }
 
 minio::utils::Multimap& minio::signer::SignV4STS(
     http::Method method, std::string& uri, std::string& region,
-    utils::Multimap& headers, utils::Multimap query_params,
+    utils::Multimap& headers, const utils::Multimap& query_params,
     std::string& access_key, std::string& secret_key,
-    std::string& content_sha256, utils::Time& date) {
+    std::string& content_sha256, utils::Time& date,
+    std::pmr::memory_resource* memory) {
   std::string service_name = "sts";
   return SignV4(service_name, method, uri, region, headers, query_params,
-                access_key, secret_key, content_sha256, date);
+                access_key, secret_key, content_sha256, date, memory);
 }
 
 minio::utils::Multimap& minio::signer::PresignV4(
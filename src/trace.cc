@@ -0,0 +1,226 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "trace.h"
+
+#include <random>
+
+namespace {
+constexpr char kTraceMagic[] = "MTRC";
+constexpr unsigned int kTraceVersion = 1;
+
+// API and bucket names are short; longer names are cut when recorded and
+// refused when read, so a corrupt length cannot drive a huge allocation.
+constexpr size_t kTraceMaxName = 1024;
+
+enum TraceTag : char { kTraceName = 0, kTraceRecord = 1 };
+
+void WriteVarint(std::ostream& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.put(char(value | 0x80));
+    value >>= 7;
+  }
+  out.put(char(value));
+}
+
+bool ReadVarint(std::istream& in, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int ch = in.get();
+    if (ch == EOF) return false;
+    value |= uint64_t(ch & 0x7f) << shift;
+    if (!(ch & 0x80)) return true;
+  }
+  return false;
+}
+
+uint64_t Microseconds(std::chrono::system_clock::duration duration) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+  return us.count() > 0 ? us.count() : 0;
+}
+}  // namespace
+
+minio::s3::RingBufferSink::RingBufferSink(
+    size_t capacity, double sample_rate,
+    std::chrono::microseconds slow_threshold) {
+  capacity_ = capacity ? capacity : 1;
+  sample_rate_ = sample_rate;
+  slow_threshold_ = slow_threshold;
+}
+
+void minio::s3::RingBufferSink::Export(const Span& span) {
+  if (span.total < slow_threshold_) {
+    thread_local static std::minstd_rand rg{std::random_device{}()};
+    std::uniform_real_distribution<double> dist(0, 1);
+    if (sample_rate_ <= 0 || dist(rg) >= sample_rate_) return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (spans_.size() < capacity_) {
+    spans_.push_back(span);
+  } else {
+    spans_[next_] = span;
+  }
+  next_ = (next_ + 1) % capacity_;
+}
+
+std::vector<minio::s3::Span> minio::s3::RingBufferSink::Spans() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (spans_.size() < capacity_) return spans_;
+
+  std::vector<Span> spans;
+  spans.reserve(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    spans.push_back(spans_[(next_ + i) % capacity_]);
+  }
+  return spans;
+}
+
+void minio::s3::RingBufferSink::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  spans_.clear();
+  next_ = 0;
+}
+
+minio::s3::TraceRecorder::~TraceRecorder() { Close(); }
+
+minio::error::Error minio::s3::TraceRecorder::Open(std::string filename) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_.is_open()) file_.close();
+  file_.open(filename, std::ios::binary | std::ios::trunc);
+  if (!file_.is_open()) {
+    return error::Error("unable to open trace file " + filename);
+  }
+  names_.clear();
+  start_ = std::chrono::system_clock::now();
+  file_.write(kTraceMagic, 4);
+  WriteVarint(file_, kTraceVersion);
+  WriteVarint(file_, Microseconds(start_.time_since_epoch()));
+  return error::SUCCESS;
+}
+
+unsigned int minio::s3::TraceRecorder::name(std::string_view value) {
+  value = value.substr(0, kTraceMaxName);
+  if (auto it = names_.find(value); it != names_.end()) return it->second;
+
+  unsigned int index = names_.size();
+  names_.emplace(value, index);
+  file_.put(kTraceName);
+  WriteVarint(file_, value.size());
+  file_.write(value.data(), value.size());
+  return index;
+}
+
+void minio::s3::TraceRecorder::Record(const TraceRecord& record) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_.is_open()) return;
+
+  unsigned int api = name(record.api);
+  unsigned int bucket = name(record.bucket);
+  file_.put(kTraceRecord);
+  WriteVarint(file_, api);
+  WriteVarint(file_, bucket);
+  for (int i = 0; i < 8; i++) file_.put(char(record.key_hash >> (8 * i)));
+  file_.put(char(record.method));
+  WriteVarint(file_, record.attempt);
+  WriteVarint(file_, record.status_code);
+  WriteVarint(file_, record.request_bytes);
+  WriteVarint(file_, record.response_bytes);
+  WriteVarint(file_, Microseconds(record.start - start_));
+  WriteVarint(file_, record.duration.count());
+}
+
+void minio::s3::TraceRecorder::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_.is_open()) file_.close();
+}
+
+uint64_t minio::s3::TraceRecorder::KeyHash(std::string_view key) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char ch : key) {
+    hash ^= ch;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+minio::error::Error minio::s3::TraceReader::Open(std::string filename) {
+  file_.open(filename, std::ios::binary);
+  if (!file_.is_open()) {
+    return error::Error("unable to open trace file " + filename);
+  }
+
+  char magic[4];
+  uint64_t version = 0;
+  uint64_t start = 0;
+  if (!file_.read(magic, 4) || std::string_view(magic, 4) != kTraceMagic ||
+      !ReadVarint(file_, version) || !ReadVarint(file_, start)) {
+    return error::Error("invalid trace file " + filename);
+  }
+  if (version != kTraceVersion) {
+    return error::Error("unsupported trace version " +
+                        std::to_string(version));
+  }
+  start_ = std::chrono::system_clock::time_point(
+      std::chrono::microseconds(start));
+  return error::SUCCESS;
+}
+
+bool minio::s3::TraceReader::Next(TraceRecord& record) {
+  while (true) {
+    int tag = file_.get();
+    if (tag == EOF) return false;
+
+    uint64_t value = 0;
+    if (tag == kTraceName) {
+      if (!ReadVarint(file_, value) || value > kTraceMaxName) return false;
+      std::string name(value, '\0');
+      if (!file_.read(name.data(), value)) return false;
+      names_.push_back(name);
+      continue;
+    }
+    if (tag != kTraceRecord) return false;
+
+    uint64_t api = 0;
+    uint64_t bucket = 0;
+    if (!ReadVarint(file_, api) || !ReadVarint(file_, bucket) ||
+        api >= names_.size() || bucket >= names_.size()) {
+      return false;
+    }
+    record.api = names_[api];
+    record.bucket = names_[bucket];
+
+    unsigned char hash[8];
+    if (!file_.read((char*)hash, 8)) return false;
+    record.key_hash = 0;
+    for (int i = 0; i < 8; i++) record.key_hash |= uint64_t(hash[i]) << (8 * i);
+
+    int method = file_.get();
+    if (method == EOF) return false;
+    record.method = http::Method(method);
+
+    uint64_t fields[6];
+    for (auto& field : fields) {
+      if (!ReadVarint(file_, field)) return false;
+    }
+    record.attempt = fields[0];
+    record.status_code = fields[1];
+    record.request_bytes = fields[2];
+    record.response_bytes = fields[3];
+    record.start = start_ + std::chrono::microseconds(fields[4]);
+    record.duration = std::chrono::microseconds(fields[5]);
+    return true;
+  }
+}
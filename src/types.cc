@@ -51,121 +51,112 @@ minio::s3::Directive minio::s3::StringToDirective(
 }
 
 std::string minio::s3::SelectRequest::ToXML() {
-  std::stringstream ss;
-  ss << "<SelectObjectContentRequest>";
+  xml::Writer writer(512, false);
+  ToXML(writer);
+  return writer.Finish().data;
+}
+
+void minio::s3::SelectRequest::ToXML(xml::Writer& writer) {
+  writer.Start("SelectObjectContentRequest");
 
-  ss << "<Expression>" << expr << "</Expression>";
-  ss << "<ExpressionType>SQL</ExpressionType>";
+  writer.Element("Expression", expr);
+  writer.Element("ExpressionType", "SQL");
 
-  ss << "<InputSerialization>";
+  writer.Start("InputSerialization");
 
   if (csv_input != NULL) {
     if (csv_input->compression_type != NULL) {
-      ss << "<CompressionType>"
-         << CompressionTypeToString(*csv_input->compression_type)
-         << "</CompressionType>";
+      writer.Element("CompressionType",
+                     CompressionTypeToString(*csv_input->compression_type));
     }
 
-    ss << "<CSV>";
+    writer.Start("CSV");
     if (csv_input->allow_quoted_record_delimiter) {
-      ss << "<AllowQuotedRecordDelimiter>true</AllowQuotedRecordDelimiter>";
+      writer.Element("AllowQuotedRecordDelimiter", "true");
     }
     if (csv_input->comments) {
-      ss << "<Comments>" << csv_input->comments << "</Comments>";
+      writer.Element("Comments", csv_input->comments);
     }
     if (csv_input->field_delimiter) {
-      ss << "<FieldDelimiter>" << csv_input->field_delimiter
-         << "</FieldDelimiter>";
+      writer.Element("FieldDelimiter", csv_input->field_delimiter);
     }
     if (csv_input->file_header_info != NULL) {
-      ss << "<FileHeaderInfo>"
-         << FileHeaderInfoToString(*csv_input->file_header_info)
-         << "</FileHeaderInfo>";
+      writer.Element("FileHeaderInfo",
+                     FileHeaderInfoToString(*csv_input->file_header_info));
     }
     if (csv_input->quote_character) {
-      ss << "<QuoteCharacter>" << csv_input->quote_character
-         << "</QuoteCharacter>";
+      writer.Element("QuoteCharacter", csv_input->quote_character);
     }
     if (csv_input->record_delimiter) {
-      ss << "<RecordDelimiter>" << csv_input->record_delimiter
-         << "</RecordDelimiter>";
+      writer.Element("RecordDelimiter", csv_input->record_delimiter);
     }
-    ss << "</CSV>";
+    writer.End("CSV");
   }
 
   if (json_input != NULL) {
     if (json_input->compression_type != NULL) {
-      ss << "<CompressionType>"
-         << CompressionTypeToString(*json_input->compression_type)
-         << "</CompressionType>";
+      writer.Element("CompressionType",
+                     CompressionTypeToString(*json_input->compression_type));
     }
 
-    ss << "<JSON>";
+    writer.Start("JSON");
     if (json_input->json_type != NULL) {
-      ss << "<Type>" << JsonTypeToString(*json_input->json_type) << "</Type>";
+      writer.Element("Type", JsonTypeToString(*json_input->json_type));
     }
-    ss << "</JSON>";
+    writer.End("JSON");
   }
 
-  if (parquet_input != NULL) ss << "<Parquet></Parquet>";
+  if (parquet_input != NULL) writer.Start("Parquet").End("Parquet");
 
-  ss << "</InputSerialization>";
+  writer.End("InputSerialization");
 
-  ss << "<OutputSerialization>";
+  writer.Start("OutputSerialization");
 
   if (csv_output != NULL) {
-    ss << "<CSV>";
+    writer.Start("CSV");
     if (csv_output->field_delimiter) {
-      ss << "<FieldDelimiter>" << csv_output->field_delimiter
-         << "</FieldDelimiter>";
+      writer.Element("FieldDelimiter", csv_output->field_delimiter);
     }
     if (csv_output->quote_character) {
-      ss << "<QuoteCharacter>" << csv_output->quote_character
-         << "</QuoteCharacter>";
+      writer.Element("QuoteCharacter", csv_output->quote_character);
     }
     if (csv_output->quote_escape_character) {
-      ss << "<QuoteEscapeCharacter>" << csv_output->quote_escape_character
-         << "</QuoteEscapeCharacter>";
+      writer.Element("QuoteEscapeCharacter",
+                     csv_output->quote_escape_character);
     }
     if (csv_output->quote_fields != NULL) {
-      ss << "<QuoteFields>" << QuoteFieldsToString(*csv_output->quote_fields)
-         << "</QuoteFields>";
+      writer.Element("QuoteFields",
+                     QuoteFieldsToString(*csv_output->quote_fields));
     }
     if (csv_output->record_delimiter) {
-      ss << "<RecordDelimiter>" << csv_output->record_delimiter
-         << "</RecordDelimiter>";
+      writer.Element("RecordDelimiter", csv_output->record_delimiter);
     }
-    ss << "</CSV>";
+    writer.End("CSV");
   }
 
   if (json_output != NULL) {
-    ss << "<JSON>";
+    writer.Start("JSON");
     if (json_output->record_delimiter) {
-      ss << "<RecordDelimiter>" << json_output->record_delimiter
-         << "</RecordDelimiter>";
+      writer.Element("RecordDelimiter", json_output->record_delimiter);
     }
-    ss << "</JSON>";
+    writer.End("JSON");
   }
 
-  ss << "</OutputSerialization>";
+  writer.End("OutputSerialization");
 
   if (request_progress) {
-    ss << "<RequestProgress><Enabled>true</Enabled></RequestProgress>";
+    writer.Start("RequestProgress")
+        .Element("Enabled", "true")
+        .End("RequestProgress");
   }
   if (scan_start_range != NULL || scan_end_range != NULL) {
-    ss << "<ScanRange>";
-    if (scan_start_range != NULL) {
-      ss << "<Start>" << *scan_start_range << "</Start>";
-    }
-    if (scan_end_range != NULL) {
-      ss << "<End>" << *scan_end_range << "</End>";
-    }
-    ss << "</ScanRange>";
+    writer.Start("ScanRange");
+    if (scan_start_range != NULL) writer.Element("Start", *scan_start_range);
+    if (scan_end_range != NULL) writer.Element("End", *scan_end_range);
+    writer.End("ScanRange");
   }
 
-  ss << "</SelectObjectContentRequest>";
-
-  return ss.str();
+  writer.End("SelectObjectContentRequest");
 }
 
 minio::s3::NotificationRecord minio::s3::NotificationRecord::ParseJSON(
@@ -235,224 +226,178 @@ minio::s3::NotificationRecord minio::s3::NotificationRecord::ParseJSON(
 }
 
 std::string minio::s3::NotificationConfig::ToXML() {
-  std::stringstream ss;
-  ss << "<NotificationConfiguration>";
+  xml::Writer writer(1024, false);
+  ToXML(writer);
+  return writer.Finish().data;
+}
 
-  for (auto& config : cloud_func_config_list) {
-    ss << "<CloudFunctionConfiguration>";
-    ss << "<CloudFunction>" << config.cloud_func << "</CloudFunction>";
-    for (auto& event : config.events) ss << "<Event>" << event << "</Event>";
-    if (!config.id.empty()) ss << "<Id>" << config.id << "</Id>";
+void minio::s3::NotificationConfig::ToXML(xml::Writer& writer) {
+  auto common_xml = [&writer](NotificationCommonConfig& config) {
+    for (auto& event : config.events) writer.Element("Event", event);
+    if (!config.id.empty()) writer.Element("Id", config.id);
     if (config.prefix_filter_rule || config.suffix_filter_rule) {
-      ss << "<Filter><S3Key>";
+      writer.Start("Filter").Start("S3Key");
       if (config.prefix_filter_rule) {
-        ss << "<FilterRule><Name>prefix</Name>";
-        ss << "<Value>" << config.prefix_filter_rule.Value()
-           << "</Value></FilterRule>";
+        writer.Start("FilterRule")
+            .Element("Name", "prefix")
+            .Element("Value", config.prefix_filter_rule.Value())
+            .End("FilterRule");
       }
       if (config.suffix_filter_rule) {
-        ss << "<FilterRule><Name>suffix</Name>";
-        ss << "<Value>" << config.suffix_filter_rule.Value()
-           << "</Value></FilterRule>";
+        writer.Start("FilterRule")
+            .Element("Name", "suffix")
+            .Element("Value", config.suffix_filter_rule.Value())
+            .End("FilterRule");
       }
-      ss << "</S3Key></Filter>";
+      writer.End("S3Key").End("Filter");
     }
-    ss << "</CloudFunctionConfiguration>";
+  };
+
+  writer.Start("NotificationConfiguration");
+
+  for (auto& config : cloud_func_config_list) {
+    writer.Start("CloudFunctionConfiguration");
+    writer.Element("CloudFunction", config.cloud_func);
+    common_xml(config);
+    writer.End("CloudFunctionConfiguration");
   }
 
   for (auto& config : queue_config_list) {
-    ss << "<QueueConfiguration>";
-    ss << "<Queue>" << config.queue << "</Queue>";
-    for (auto& event : config.events) ss << "<Event>" << event << "</Event>";
-    if (!config.id.empty()) ss << "<Id>" << config.id << "</Id>";
-    if (config.prefix_filter_rule || config.suffix_filter_rule) {
-      ss << "<Filter><S3Key>";
-      if (config.prefix_filter_rule) {
-        ss << "<FilterRule><Name>prefix</Name>";
-        ss << "<Value>" << config.prefix_filter_rule.Value()
-           << "</Value></FilterRule>";
-      }
-      if (config.suffix_filter_rule) {
-        ss << "<FilterRule><Name>suffix</Name>";
-        ss << "<Value>" << config.suffix_filter_rule.Value()
-           << "</Value></FilterRule>";
-      }
-      ss << "</S3Key></Filter>";
-    }
-    ss << "</QueueConfiguration>";
+    writer.Start("QueueConfiguration");
+    writer.Element("Queue", config.queue);
+    common_xml(config);
+    writer.End("QueueConfiguration");
   }
 
   for (auto& config : topic_config_list) {
-    ss << "<TopicConfiguration>";
-    ss << "<Topic>" << config.topic << "</Topic>";
-    for (auto& event : config.events) ss << "<Event>" << event << "</Event>";
-    if (!config.id.empty()) ss << "<Id>" << config.id << "</Id>";
-    if (config.prefix_filter_rule || config.suffix_filter_rule) {
-      ss << "<Filter><S3Key>";
-      if (config.prefix_filter_rule) {
-        ss << "<FilterRule><Name>prefix</Name>";
-        ss << "<Value>" << config.prefix_filter_rule.Value()
-           << "</Value></FilterRule>";
-      }
-      if (config.suffix_filter_rule) {
-        ss << "<FilterRule><Name>suffix</Name>";
-        ss << "<Value>" << config.suffix_filter_rule.Value()
-           << "</Value></FilterRule>";
-      }
-      ss << "</S3Key></Filter>";
-    }
-    ss << "</TopicConfiguration>";
+    writer.Start("TopicConfiguration");
+    writer.Element("Topic", config.topic);
+    common_xml(config);
+    writer.End("TopicConfiguration");
   }
 
-  ss << "</NotificationConfiguration>";
-
-  return ss.str();
+  writer.End("NotificationConfiguration");
 }
 
-std::string minio::s3::ReplicationConfig::ToXML() {
-  auto status_xml = [](bool status) -> std::string {
-    std::stringstream ss;
-    ss << "<Status>" << (status ? "Enabled" : "Disabled") << "</Status>";
-    return ss.str();
+void minio::s3::Filter::ToXML(xml::Writer& writer) {
+  auto tag_xml = [&writer](const std::string& key, const std::string& value) {
+    writer.Start("Tag").Element("Key", key).Element("Value", value).End("Tag");
   };
 
-  auto prefix_xml = [](std::string prefix) -> std::string {
-    std::stringstream ss;
-    ss << "<Prefix>" << prefix << "</Prefix>";
-    return ss.str();
-  };
+  writer.Start("Filter");
+  if (and_operator) {
+    writer.Start("And");
+    if (and_operator.prefix) {
+      writer.Element("Prefix", and_operator.prefix.Get());
+    }
+    for (auto& [key, value] : and_operator.tags) tag_xml(key, value);
+    writer.End("And");
+  }
+  if (prefix) writer.Element("Prefix", prefix.Get());
+  if (tag) tag_xml(tag.key, tag.value);
+  writer.End("Filter");
+}
 
-  auto minutes_xml = [](unsigned int minutes) -> std::string {
-    std::stringstream ss;
-    ss << "<Minutes>" << std::to_string(minutes) << "</Minutes>";
-    return ss.str();
-  };
+std::string minio::s3::ReplicationConfig::ToXML() {
+  xml::Writer writer(1024, false);
+  ToXML(writer);
+  return writer.Finish().data;
+}
 
-  auto tag_xml = [](std::string key, std::string value) -> std::string {
-    std::stringstream ss;
-    ss << "<Tag>"
-       << "<Key>" << key << "</Key>"
-       << "<Value>" << value << "</Value>"
-       << "</Tag>";
-    return ss.str();
+void minio::s3::ReplicationConfig::ToXML(xml::Writer& writer) {
+  auto status_xml = [&writer](bool status) {
+    writer.Element("Status", status ? "Enabled" : "Disabled");
   };
 
-  std::stringstream ss;
-  ss << "<ReplicationConfiguration>";
-  if (!role.empty()) ss << "<Role>" << role << "</Role>";
+  writer.Start("ReplicationConfiguration");
+  if (!role.empty()) writer.Element("Role", role);
   for (auto& rule : rules) {
-    ss << "<Rule>";
+    writer.Start("Rule");
 
-    ss << "<Destination>";
-    ss << "<Bucket>" << rule.destination.bucket_arn << "</Bucket>";
+    writer.Start("Destination");
+    writer.Element("Bucket", rule.destination.bucket_arn);
     if (rule.destination.access_control_translation) {
-      ss << "<AccessControlTranslation><Owner>"
-         << rule.destination.access_control_translation.owner
-         << "</Owner></AccessControlTranslation>";
+      writer.Start("AccessControlTranslation")
+          .Element("Owner", rule.destination.access_control_translation.owner)
+          .End("AccessControlTranslation");
     }
     if (!rule.destination.account.empty()) {
-      ss << "<Account>" << rule.destination.account << "</Account>";
+      writer.Element("Account", rule.destination.account);
     }
     if (rule.destination.encryption_config) {
-      ss << "<EncryptionConfiguration>";
+      writer.Start("EncryptionConfiguration");
       if (!rule.destination.encryption_config.replica_kms_key_id.empty()) {
-        ss << "<ReplicaKmsKeyID>"
-           << rule.destination.encryption_config.replica_kms_key_id
-           << "</ReplicaKmsKeyID>";
+        writer.Element("ReplicaKmsKeyID",
+                       rule.destination.encryption_config.replica_kms_key_id);
       }
-      ss << "</EncryptionConfiguration>";
+      writer.End("EncryptionConfiguration");
     }
     if (rule.destination.metrics) {
-      ss << "<Metrics>"
-         << "<EventThreshold>";
+      writer.Start("Metrics").Start("EventThreshold");
       if (rule.destination.metrics.event_threshold_minutes > 0) {
-        ss << minutes_xml(rule.destination.metrics.event_threshold_minutes);
+        writer.Element("Minutes",
+                       rule.destination.metrics.event_threshold_minutes);
       }
-      ss << status_xml(rule.destination.metrics.status) << "</EventThreshold>"
-         << "</Metrics>";
+      status_xml(rule.destination.metrics.status);
+      writer.End("EventThreshold").End("Metrics");
     }
     if (rule.destination.replication_time) {
-      ss << "<ReplicationTime>"
-         << "<Time>";
+      writer.Start("ReplicationTime").Start("Time");
       if (rule.destination.replication_time.time_minutes > 0) {
-        ss << minutes_xml(rule.destination.replication_time.time_minutes);
+        writer.Element("Minutes",
+                       rule.destination.replication_time.time_minutes);
       }
-      ss << "</Time>" << status_xml(rule.destination.replication_time.status)
-         << "</ReplicationTime>";
+      writer.End("Time");
+      status_xml(rule.destination.replication_time.status);
+      writer.End("ReplicationTime");
     }
     if (!rule.destination.storage_class.empty()) {
-      ss << "<StorageClass>" << rule.destination.storage_class
-         << "</StorageClass>";
+      writer.Element("StorageClass", rule.destination.storage_class);
     }
-    ss << "</Destination>";
+    writer.End("Destination");
 
     if (rule.delete_marker_replication_status) {
-      ss << "<DeleteMarkerReplication>"
-         << status_xml(rule.delete_marker_replication_status.Get())
-         << "</DeleteMarkerReplication>";
+      writer.Start("DeleteMarkerReplication");
+      status_xml(rule.delete_marker_replication_status.Get());
+      writer.End("DeleteMarkerReplication");
     }
 
     if (rule.existing_object_replication_status) {
-      ss << "<ExistingObjectReplication>"
-         << status_xml(rule.existing_object_replication_status.Get())
-         << "</ExistingObjectReplication>";
+      writer.Start("ExistingObjectReplication");
+      status_xml(rule.existing_object_replication_status.Get());
+      writer.End("ExistingObjectReplication");
     }
 
-    if (rule.filter) {
-      ss << "<Filter>";
-      if (rule.filter.and_operator) {
-        ss << "<And>";
-        if (rule.filter.and_operator.prefix) {
-          ss << prefix_xml(rule.filter.and_operator.prefix.Get());
-        }
-        if (!rule.filter.and_operator.tags.empty()) {
-          for (auto& [key, value] : rule.filter.and_operator.tags) {
-            ss << tag_xml(key, value);
-          }
-        }
-        ss << "</And>";
-      }
-      if (rule.filter.prefix) {
-        ss << prefix_xml(rule.filter.prefix.Get());
-      }
-      if (rule.filter.tag) {
-        ss << tag_xml(rule.filter.tag.key, rule.filter.tag.value);
-      }
-      ss << "</Filter>";
-    }
+    if (rule.filter) rule.filter.ToXML(writer);
 
-    if (!rule.id.empty()) ss << "<ID>" << rule.id << "</ID>";
+    if (!rule.id.empty()) writer.Element("ID", rule.id);
 
-    if (rule.prefix) ss << prefix_xml(rule.prefix.Get());
+    if (rule.prefix) writer.Element("Prefix", rule.prefix.Get());
 
-    if (rule.priority) {
-      ss << "<Priority>" << rule.priority << "</Priority>";
-    }
+    if (rule.priority) writer.Element("Priority", rule.priority.Get());
 
     if (rule.source_selection_criteria) {
-      ss << "<SourceSelectionCriteria>";
+      writer.Start("SourceSelectionCriteria");
       if (rule.source_selection_criteria.sse_kms_encrypted_objects_status) {
-        ss << "<SseKmsEncryptedObjects>"
-           << status_xml(rule.source_selection_criteria
-                             .sse_kms_encrypted_objects_status.Get())
-           << "</SseKmsEncryptedObjects>";
+        writer.Start("SseKmsEncryptedObjects");
+        status_xml(rule.source_selection_criteria
+                       .sse_kms_encrypted_objects_status.Get());
+        writer.End("SseKmsEncryptedObjects");
       }
-      ss << "</SourceSelectionCriteria>";
+      writer.End("SourceSelectionCriteria");
     }
 
     if (rule.delete_replication_status) {
-      ss << "<DeleteReplication>"
-         << status_xml(rule.delete_replication_status.Get())
-         << "</DeleteReplication>";
+      writer.Start("DeleteReplication");
+      status_xml(rule.delete_replication_status.Get());
+      writer.End("DeleteReplication");
     }
 
-    ss << status_xml(rule.status);
+    status_xml(rule.status);
 
-    ss << "</Rule>";
+    writer.End("Rule");
   }
-  ss << "</ReplicationConfiguration>";
-
-  return ss.str();
+  writer.End("ReplicationConfiguration");
 }
 
 minio::error::Error minio::s3::LifecycleRule::Validate() {
@@ -493,112 +438,91 @@ minio::error::Error minio::s3::LifecycleRule::Validate() {
 }
 
 std::string minio::s3::LifecycleConfig::ToXML() {
-  std::stringstream ss;
+  xml::Writer writer(1024, false);
+  ToXML(writer);
+  return writer.Finish().data;
+}
 
-  ss << "<LifecycleConfiguration>";
+void minio::s3::LifecycleConfig::ToXML(xml::Writer& writer) {
+  writer.Start("LifecycleConfiguration");
 
   for (auto& rule : rules) {
-    ss << "<Rule>";
+    writer.Start("Rule");
 
     if (rule.abort_incomplete_multipart_upload_days_after_initiation) {
-      ss << "<AbortIncompleteMultipartUpload><DaysAfterInitiation>"
-         << std::to_string(
-                rule.abort_incomplete_multipart_upload_days_after_initiation)
-         << "</DaysAfterInitiation></AbortIncompleteMultipartUpload>";
+      writer.Start("AbortIncompleteMultipartUpload")
+          .Element(
+              "DaysAfterInitiation",
+              rule.abort_incomplete_multipart_upload_days_after_initiation
+                  .Get())
+          .End("AbortIncompleteMultipartUpload");
     }
 
     if (rule.expiration_date || rule.expiration_days ||
         rule.expiration_expired_object_delete_marker) {
-      ss << "<Expiration>";
+      writer.Start("Expiration");
       if (rule.expiration_date) {
-        ss << "<Date>" << rule.expiration_date.ToISO8601UTC() << "</Date>";
+        writer.Element("Date", rule.expiration_date.ToISO8601UTC());
       }
       if (rule.expiration_days) {
-        ss << "<Days>" << std::to_string(rule.expiration_days) << "</Days>";
+        writer.Element("Days", rule.expiration_days.Get());
       }
       if (rule.expiration_expired_object_delete_marker) {
-        ss << "<ExpiredObjectDeleteMarker>"
-           << utils::BoolToString(rule.expiration_expired_object_delete_marker)
-           << "</ExpiredObjectDeleteMarker>";
+        writer.Element(
+            "ExpiredObjectDeleteMarker",
+            utils::BoolToString(
+                rule.expiration_expired_object_delete_marker.Get()));
       }
-      ss << "</Expiration>";
+      writer.End("Expiration");
     }
 
-    ss << "<Filter>";
-    if (rule.filter.and_operator) {
-      ss << "<And>";
-      if (rule.filter.and_operator.prefix) {
-        ss << "<Prefix>" << rule.filter.and_operator.prefix << "</Prefix>";
-      }
-      if (!rule.filter.and_operator.tags.empty()) {
-        for (auto& [key, value] : rule.filter.and_operator.tags) {
-          ss << "<Tag>"
-             << "<Key>" << key << "</Key>"
-             << "<Value>" << value << "</Value>"
-             << "</Tag>";
-        }
-      }
-      ss << "</And>";
-    }
-    if (rule.filter.prefix) {
-      ss << "<Prefix>" << rule.filter.prefix << "</Prefix>";
-    }
-    if (rule.filter.tag) {
-      ss << "<Tag>"
-         << "<Key>" << rule.filter.tag.key << "</Key>"
-         << "<Value>" << rule.filter.tag.value << "</Value>"
-         << "</Tag>";
-    }
-    ss << "</Filter>";
+    rule.filter.ToXML(writer);
 
-    if (!rule.id.empty()) ss << "<ID>" << rule.id << "</ID>";
+    if (!rule.id.empty()) writer.Element("ID", rule.id);
 
     if (rule.noncurrent_version_expiration_noncurrent_days) {
-      ss << "<NoncurrentVersionExpiration><NoncurrentDays>"
-         << rule.noncurrent_version_expiration_noncurrent_days
-         << "</NoncurrentDays></NoncurrentVersionExpiration>";
+      writer.Start("NoncurrentVersionExpiration")
+          .Element("NoncurrentDays",
+                   rule.noncurrent_version_expiration_noncurrent_days.Get())
+          .End("NoncurrentVersionExpiration");
     }
 
     if (rule.noncurrent_version_transition_noncurrent_days ||
         !rule.noncurrent_version_transition_storage_class.empty()) {
-      ss << "<NoncurrentVersionTransition>";
+      writer.Start("NoncurrentVersionTransition");
       if (rule.noncurrent_version_transition_noncurrent_days) {
-        ss << "<NoncurrentDays>"
-           << rule.noncurrent_version_expiration_noncurrent_days
-           << "</NoncurrentDays>";
+        writer.Element(
+            "NoncurrentDays",
+            rule.noncurrent_version_transition_noncurrent_days.Get());
       }
       if (!rule.noncurrent_version_transition_storage_class.empty()) {
-        ss << "<StorageClass>"
-           << rule.noncurrent_version_transition_storage_class
-           << "</StorageClass>";
+        writer.Element("StorageClass",
+                       rule.noncurrent_version_transition_storage_class);
       }
-      ss << "</NoncurrentVersionTransition>";
+      writer.End("NoncurrentVersionTransition");
     }
 
-    ss << "<Status>" << (rule.status ? "Enabled" : "Disabled") << "</Status>";
+    writer.Element("Status", rule.status ? "Enabled" : "Disabled");
 
     if (rule.transition_date || rule.transition_days ||
         !rule.transition_storage_class.empty()) {
-      ss << "<Transition>";
+      writer.Start("Transition");
       if (rule.transition_date) {
-        ss << "<Date>" << rule.transition_date.ToISO8601UTC() << "</Date>";
+        writer.Element("Date", rule.transition_date.ToISO8601UTC());
       }
       if (rule.transition_days) {
-        ss << "<Days>" << std::to_string(rule.transition_days) << "</Days>";
+        writer.Element("Days", rule.transition_days.Get());
       }
       if (!rule.transition_storage_class.empty()) {
-        ss << "<StorageClass>" << rule.transition_storage_class
-           << "</StorageClass>";
+        writer.Element("StorageClass", rule.transition_storage_class);
       }
-      ss << "</Transition>";
+      writer.End("Transition");
     }
 
-    ss << "</Rule>";
+    writer.End("Rule");
   }
 
-  ss << "</LifecycleConfiguration>";
-
-  return ss.str();
+  writer.End("LifecycleConfiguration");
 }
 
 minio::error::Error minio::s3::ObjectLockConfig::Validate() {
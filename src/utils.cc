@@ -16,13 +16,78 @@
 #include "utils.h"
 
 const char* HTTP_HEADER_FORMAT = "%a, %d %b %Y %H:%M:%S GMT";
-const std::regex MULTI_SPACE_REGEX("( +)");
 const std::regex VALID_BUCKET_NAME_REGEX(
     "^[A-Za-z0-9][A-Za-z0-9_\\.\\-\\:]{1,61}[A-Za-z0-9]$");
 const std::regex VALID_BUCKET_NAME_STRICT_REGEX(
     "^[a-z0-9][a-z0-9\\.\\-]{1,61}[a-z0-9]$");
 const std::regex VALID_IP_ADDR_REGEX("^(\\d+\\.){3}\\d+$");
 
+namespace {
+using Values = std::map<std::string, std::set<std::string>>;
+
+// appendEscaped appends URL encoded value like curl_easy_escape() does.
+template <typename String>
+void appendEscaped(String& out, std::string_view value) {
+  static constexpr char kHex[] = "0123456789ABCDEF";
+  for (unsigned char c : value) {
+    if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+        (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' ||
+        c == '~') {
+      out += c;
+    } else {
+      out += '%';
+      out += kHex[c >> 4];
+      out += kHex[c & 0x0F];
+    }
+  }
+}
+
+// canonicalHeaders writes signed and canonical headers of AWS signature V4.
+// keys maps lower case keys to keys of map, so it is in canonical order.
+template <typename String>
+void canonicalHeaders(const Values& map, const Values& keys,
+                      String& signed_headers, String& canonical_headers) {
+  for (auto& [key, names] : keys) {
+    if ("authorization" == key || "user-agent" == key) continue;
+    if (!signed_headers.empty()) {
+      signed_headers += ';';
+      canonical_headers += '\n';
+    }
+    signed_headers += key;
+    canonical_headers += key;
+    canonical_headers += ':';
+
+    bool first = true;
+    for (auto& name : names) {
+      auto i = map.find(name);
+      if (i == map.end()) continue;
+      for (auto& value : i->second) {
+        if (!first) canonical_headers += ',';
+        first = false;
+        // Sequential spaces are replaced by single space.
+        for (size_t j = 0; j < value.size(); j++) {
+          if (value[j] == ' ' && j > 0 && value[j - 1] == ' ') continue;
+          canonical_headers += value[j];
+        }
+      }
+    }
+  }
+}
+
+template <typename String>
+void canonicalQueryString(const Values& map, String& query_string) {
+  // map is ordered by key already.
+  for (auto& [key, values] : map) {
+    for (auto& value : values) {
+      if (!query_string.empty()) query_string += '&';
+      appendEscaped(query_string, key);
+      query_string += '=';
+      appendEscaped(query_string, value);
+    }
+  }
+}
+}  // namespace
+
 bool minio::utils::GetEnv(std::string& var, const char* name) {
   if (const char* value = std::getenv(name)) {
     var = value;
@@ -129,7 +194,7 @@ std::string minio::utils::Join(std::vector<std::string> values,
   return result;
 }
 
-std::string minio::utils::EncodePath(std::string& path) {
+std::string minio::utils::EncodePath(const std::string& path) {
   std::stringstream str_stream(path);
   std::string token;
   std::string out;
@@ -253,7 +318,11 @@ std::string minio::utils::FormatTime(const std::tm* time, const char* format) {
 
 std::tm* minio::utils::Time::ToUTC() {
   std::tm* t = new std::tm;
-  *t = utc_ ? *std::localtime(&tv_.tv_sec) : *std::gmtime(&tv_.tv_sec);
+  if (utc_) {
+    localtime_r(&tv_.tv_sec, t);
+  } else {
+    gmtime_r(&tv_.tv_sec, t);
+  }
   return t;
 }
 
@@ -285,8 +354,7 @@ minio::utils::Time minio::utils::Time::FromHttpHeaderValue(const char* value) {
   std::locale("C");
   strptime(value, HTTP_HEADER_FORMAT, &t);
   std::locale("");
-  std::time_t time = std::mktime(&t);
-  return Time(time, 0, true);
+  return Time(timegm(&t), 0, false);
 }
 
 std::string minio::utils::Time::ToISO8601UTC() {
@@ -304,25 +372,31 @@ minio::utils::Time minio::utils::Time::FromISO8601UTC(const char* value) {
   std::tm t{0};
   suseconds_t tv_usec = 0;
   char* rv = strptime(value, "%Y-%m-%dT%H:%M:%S", &t);
-  sscanf(rv, ".%lu", &tv_usec);
-  std::time_t time = std::mktime(&t);
-  return Time(time, tv_usec, true);
+  if (rv != NULL) sscanf(rv, ".%lu", &tv_usec);
+  return Time(timegm(&t), tv_usec, false);
 }
 
 void minio::utils::Multimap::Add(std::string key, std::string value) {
-  map_[key].insert(value);
-  keys_[ToLower(key)].insert(key);
+  map_[key].insert(std::move(value));
+  keys_[ToLower(key)].insert(std::move(key));
 }
 
 void minio::utils::Multimap::AddAll(const Multimap& headers) {
-  auto m = headers.map_;
-  for (auto& [key, values] : m) {
+  for (auto& [key, values] : headers.map_) {
     map_[key].insert(values.begin(), values.end());
     keys_[ToLower(key)].insert(key);
   }
 }
 
-std::list<std::string> minio::utils::Multimap::ToHttpHeaders() {
+void minio::utils::Multimap::AddAll(Multimap&& headers) {
+  if (map_.empty()) {
+    *this = std::move(headers);
+    return;
+  }
+  AddAll(static_cast<const Multimap&>(headers));
+}
+
+std::list<std::string> minio::utils::Multimap::ToHttpHeaders() const {
   std::list<std::string> headers;
   for (auto& [key, values] : map_) {
     for (auto& value : values) {
@@ -332,7 +406,7 @@ std::list<std::string> minio::utils::Multimap::ToHttpHeaders() {
   return headers;
 }
 
-std::string minio::utils::Multimap::ToQueryString() {
+std::string minio::utils::Multimap::ToQueryString() const {
   std::string query_string;
   for (auto& [key, values] : map_) {
     for (auto& value : values) {
@@ -344,80 +418,66 @@ std::string minio::utils::Multimap::ToQueryString() {
   return query_string;
 }
 
-bool minio::utils::Multimap::Contains(std::string_view key) {
+bool minio::utils::Multimap::Contains(std::string_view key) const {
   return keys_.find(ToLower(std::string(key))) != keys_.end();
 }
 
-std::list<std::string> minio::utils::Multimap::Get(std::string_view key) {
+std::list<std::string> minio::utils::Multimap::Get(std::string_view key) const {
   std::list<std::string> result;
-  std::set<std::string> keys = keys_[ToLower(std::string(key))];
-  for (auto& key : keys) {
-    std::set<std::string> values = map_[key];
-    result.insert(result.end(), values.begin(), values.end());
+  auto i = keys_.find(ToLower(std::string(key)));
+  if (i == keys_.end()) return result;
+  for (auto& key : i->second) {
+    auto j = map_.find(key);
+    if (j == map_.end()) continue;
+    result.insert(result.end(), j->second.begin(), j->second.end());
   }
   return result;
 }
 
-std::string minio::utils::Multimap::GetFront(std::string_view key) {
+std::string minio::utils::Multimap::GetFront(std::string_view key) const {
   std::list<std::string> values = Get(key);
   return (values.size() > 0) ? values.front() : "";
 }
 
-std::list<std::string> minio::utils::Multimap::Keys() {
+void minio::utils::Multimap::Remove(std::string_view key) {
+  auto i = keys_.find(ToLower(std::string(key)));
+  if (i == keys_.end()) return;
+  for (auto& key : i->second) map_.erase(key);
+  keys_.erase(i);
+}
+
+std::list<std::string> minio::utils::Multimap::Keys() const {
   std::list<std::string> keys;
   for (const auto& [key, _] : keys_) keys.push_back(key);
   return keys;
 }
 
 void minio::utils::Multimap::GetCanonicalHeaders(
-    std::string& signed_headers, std::string& canonical_headers) {
-  std::vector<std::string> signed_headerslist;
-  std::map<std::string, std::string> map;
-
-  for (auto& [k, values] : map_) {
-    std::string key = ToLower(k);
-    if ("authorization" == key || "user-agent" == key) continue;
-    if (std::find(signed_headerslist.begin(), signed_headerslist.end(), key) ==
-        signed_headerslist.end()) {
-      signed_headerslist.push_back(key);
-    }
-
-    std::string value;
-    for (auto& v : values) {
-      if (!value.empty()) value += ",";
-      value += std::regex_replace(v, MULTI_SPACE_REGEX, " ");
-    }
-
-    map[key] = value;
-  }
-
-  std::sort(signed_headerslist.begin(), signed_headerslist.end());
-  signed_headers = utils::Join(signed_headerslist, ";");
-
-  std::vector<std::string> canonical_headerslist;
-  for (auto& [key, value] : map) {
-    canonical_headerslist.push_back(key + ":" + value);
-  }
-
-  std::sort(canonical_headerslist.begin(), canonical_headerslist.end());
-  canonical_headers = utils::Join(canonical_headerslist, "\n");
+    std::string& signed_headers, std::string& canonical_headers) const {
+  signed_headers.clear();
+  canonical_headers.clear();
+  canonicalHeaders(map_, keys_, signed_headers, canonical_headers);
 }
 
-std::string minio::utils::Multimap::GetCanonicalQueryString() {
-  std::vector<std::string> keys;
-  for (auto& [key, _] : map_) keys.push_back(key);
-  std::sort(keys.begin(), keys.end());
+void minio::utils::Multimap::GetCanonicalHeaders(
+    std::pmr::string& signed_headers,
+    std::pmr::string& canonical_headers) const {
+  signed_headers.clear();
+  canonical_headers.clear();
+  canonicalHeaders(map_, keys_, signed_headers, canonical_headers);
+}
 
-  std::vector<std::string> values;
-  for (auto& key : keys) {
-    auto vals = map_[key];
-    for (auto& value : vals) {
-      std::string s = curlpp::escape(key) + "=" + curlpp::escape(value);
-      values.push_back(s);
-    }
-  }
+std::string minio::utils::Multimap::GetCanonicalQueryString() const {
+  std::string query_string;
+  canonicalQueryString(map_, query_string);
+  return query_string;
+}
 
-  return utils::Join(values, "&");
+std::pmr::string minio::utils::Multimap::GetCanonicalQueryString(
+    std::pmr::memory_resource* memory) const {
+  std::pmr::string query_string(memory);
+  canonicalQueryString(map_, query_string);
+  return query_string;
 }
 
 minio::error::Error minio::utils::CheckBucketName(std::string_view bucket_name,
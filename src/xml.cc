@@ -0,0 +1,399 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xml.h"
+
+namespace {
+bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// newDigest returns a digest context initialized for type.
+EVP_MD_CTX* newDigest(const EVP_MD* type) {
+  EVP_MD_CTX* ctx = EVP_MD_CTX_create();
+  if (ctx == NULL) {
+    std::cerr << "failed to create EVP_MD_CTX" << std::endl;
+    std::terminate();
+  }
+  if (1 != EVP_DigestInit_ex(ctx, type, NULL)) {
+    std::cerr << "failed to init digest" << std::endl;
+    std::terminate();
+  }
+  return ctx;
+}
+
+// finalDigest returns raw digest of ctx.
+std::string finalDigest(EVP_MD_CTX* ctx) {
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  unsigned int length = 0;
+  if (1 != EVP_DigestFinal_ex(ctx, digest, &length)) {
+    std::cerr << "failed to finalize digest" << std::endl;
+    std::terminate();
+  }
+  return std::string(reinterpret_cast<char*>(digest), length);
+}
+
+// appendUtf8 appends code point as UTF-8.
+void appendUtf8(std::string& out, unsigned long cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xE0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+}  // namespace
+
+void minio::xml::Unescape(std::string_view text, std::string& out) {
+  while (!text.empty()) {
+    size_t pos = text.find('&');
+    out.append(text.substr(0, pos));
+    if (pos == std::string_view::npos) return;
+    text.remove_prefix(pos);
+
+    size_t end = text.find(';');
+    if (end == std::string_view::npos) {
+      out.append(text);
+      return;
+    }
+
+    std::string_view entity = text.substr(1, end - 1);
+    if (entity == "lt") {
+      out += '<';
+    } else if (entity == "gt") {
+      out += '>';
+    } else if (entity == "amp") {
+      out += '&';
+    } else if (entity == "quot") {
+      out += '"';
+    } else if (entity == "apos") {
+      out += '\'';
+    } else if (entity.size() > 1 && entity[0] == '#') {
+      int base = 10;
+      entity.remove_prefix(1);
+      if (entity[0] == 'x' || entity[0] == 'X') {
+        base = 16;
+        entity.remove_prefix(1);
+      }
+      unsigned long cp = 0;
+      auto [ptr, ec] = std::from_chars(
+          entity.data(), entity.data() + entity.size(), cp, base);
+      if (ec != std::errc() || ptr != entity.data() + entity.size() ||
+          cp > 0x10FFFF) {
+        out.append(text.substr(0, end + 1));
+      } else {
+        appendUtf8(out, cp);
+      }
+    } else {
+      // Unknown entity is kept as is.
+      out.append(text.substr(0, end + 1));
+    }
+    text.remove_prefix(end + 1);
+  }
+}
+
+void minio::xml::Reader::addText(std::string_view raw, bool cdata) {
+  if (!cdata) {
+    size_t i = 0;
+    while (i < raw.size() && isSpace(raw[i])) i++;
+    if (i == raw.size()) return;
+  }
+
+  if (!buffered_ && text_.empty() && (cdata || raw.find('&') == raw.npos)) {
+    text_ = raw;
+    if (cdata) {
+      // Later text must not be appended to the document.
+      buffer_.assign(raw);
+      buffered_ = true;
+      text_ = buffer_;
+    }
+    return;
+  }
+
+  if (!buffered_) {
+    buffer_.assign(text_);
+    buffered_ = true;
+  }
+  if (cdata) {
+    buffer_.append(raw);
+  } else {
+    Unescape(raw, buffer_);
+  }
+  text_ = buffer_;
+}
+
+minio::xml::Reader::Token minio::xml::Reader::Next() {
+  if (empty_element_) {
+    empty_element_ = false;
+    pop_ = true;
+    text_ = std::string_view();
+    buffered_ = false;
+    return Token::kEnd;
+  }
+
+  if (pop_) {
+    pop_ = false;
+    size_t pos = path_.rfind('/');
+    path_.resize(pos == std::string::npos ? 0 : pos);
+  }
+
+  text_ = std::string_view();
+  buffered_ = false;
+
+  while (pos_ < data_.size()) {
+    if (data_[pos_] != '<') {
+      size_t end = data_.find('<', pos_);
+      if (end == std::string_view::npos) end = data_.size();
+      if (!path_.empty()) addText(data_.substr(pos_, end - pos_), false);
+      pos_ = end;
+      continue;
+    }
+
+    std::string_view rest = data_.substr(pos_);
+    if (rest.compare(0, 4, "<!--") == 0) {
+      size_t end = rest.find("-->", 4);
+      if (end == std::string_view::npos) return Token::kError;
+      pos_ += end + 3;
+      continue;
+    }
+    if (rest.compare(0, 9, "<![CDATA[") == 0) {
+      size_t end = rest.find("]]>", 9);
+      if (end == std::string_view::npos) return Token::kError;
+      if (!path_.empty()) addText(rest.substr(9, end - 9), true);
+      pos_ += end + 3;
+      continue;
+    }
+    if (rest.compare(0, 2, "<?") == 0) {
+      size_t end = rest.find("?>", 2);
+      if (end == std::string_view::npos) return Token::kError;
+      pos_ += end + 2;
+      continue;
+    }
+    if (rest.compare(0, 2, "<!") == 0) {
+      // Document type declaration; internal subset is not supported.
+      size_t end = rest.find('>', 2);
+      if (end == std::string_view::npos) return Token::kError;
+      pos_ += end + 1;
+      continue;
+    }
+
+    bool end_tag = rest.size() > 1 && rest[1] == '/';
+    size_t i = end_tag ? 2 : 1;
+    size_t start = i;
+    while (i < rest.size() && !isSpace(rest[i]) && rest[i] != '/' &&
+           rest[i] != '>') {
+      i++;
+    }
+    if (i == start) return Token::kError;
+    name_ = rest.substr(start, i - start);
+
+    // Skip attributes.
+    char quote = 0;
+    while (i < rest.size() && (quote != 0 || rest[i] != '>')) {
+      if (quote != 0) {
+        if (rest[i] == quote) quote = 0;
+      } else if (rest[i] == '"' || rest[i] == '\'') {
+        quote = rest[i];
+      }
+      i++;
+    }
+    if (i == rest.size()) return Token::kError;
+    bool empty = !end_tag && rest[i - 1] == '/';
+    pos_ += i + 1;
+
+    if (end_tag) {
+      size_t pos = path_.rfind('/');
+      std::string_view last = std::string_view(path_).substr(
+          pos == std::string::npos ? 0 : pos + 1);
+      if (path_.empty() || last != name_) return Token::kError;
+      pop_ = true;
+      return Token::kEnd;
+    }
+
+    if (!path_.empty()) path_ += '/';
+    path_.append(name_);
+    empty_element_ = empty;
+    return Token::kStart;
+  }
+
+  return path_.empty() ? Token::kEof : Token::kError;
+}
+
+minio::error::Error minio::xml::Value(std::string_view data,
+                                     std::string_view path,
+                                     std::string& value) {
+  Reader reader(data);
+  while (true) {
+    switch (reader.Next()) {
+      case Reader::Token::kStart:
+        break;
+      case Reader::Token::kEnd:
+        if (reader.Path() == path) {
+          value.assign(reader.Text());
+          return error::SUCCESS;
+        }
+        break;
+      case Reader::Token::kEof:
+        return error::SUCCESS;
+      default:
+        return error::Error("unable to parse XML");
+    }
+  }
+}
+
+void minio::xml::Assign(std::string& value, std::string_view text) {
+  value.assign(text);
+}
+
+void minio::xml::Assign(bool& value, std::string_view text) {
+  value = Bool(text);
+}
+
+void minio::xml::Assign(utils::Time& value, std::string_view text) {
+  value = Time(text);
+}
+
+int minio::xml::Int(std::string_view text) {
+  int value = 0;
+  Assign(value, text);
+  return value;
+}
+
+bool minio::xml::Bool(std::string_view text) {
+  return text.size() == 4 && (text[0] == 't' || text[0] == 'T') &&
+         (text[1] == 'r' || text[1] == 'R') &&
+         (text[2] == 'u' || text[2] == 'U') &&
+         (text[3] == 'e' || text[3] == 'E');
+}
+
+std::string minio::xml::String(std::string_view text) {
+  return std::string(text);
+}
+
+minio::utils::Time minio::xml::Time(std::string_view text) {
+  if (text.empty()) return utils::Time();
+  // FromISO8601UTC() needs a terminated string.
+  char buf[64];
+  size_t size = std::min(text.size(), sizeof(buf) - 1);
+  text.copy(buf, size);
+  buf[size] = '\0';
+  return utils::Time::FromISO8601UTC(buf);
+}
+
+minio::xml::Writer::Writer(size_t capacity, bool hash) {
+  data_.reserve(capacity);
+  if (hash) {
+    md5_ = newDigest(EVP_md5());
+    sha256_ = newDigest(EVP_sha256());
+  }
+}
+
+minio::xml::Writer::~Writer() {
+  if (md5_ != NULL) EVP_MD_CTX_destroy(md5_);
+  if (sha256_ != NULL) EVP_MD_CTX_destroy(sha256_);
+}
+
+void minio::xml::Writer::update(bool force) {
+  size_t size = data_.size() - hashed_;
+  if (md5_ == NULL || size == 0 || (!force && size < kHashChunk)) return;
+  if (1 != EVP_DigestUpdate(md5_, data_.data() + hashed_, size) ||
+      1 != EVP_DigestUpdate(sha256_, data_.data() + hashed_, size)) {
+    std::cerr << "failed to update digest" << std::endl;
+    std::terminate();
+  }
+  hashed_ = data_.size();
+}
+
+minio::xml::Writer& minio::xml::Writer::Start(std::string_view name) {
+  data_ += '<';
+  data_.append(name);
+  data_ += '>';
+  update();
+  return *this;
+}
+
+minio::xml::Writer& minio::xml::Writer::End(std::string_view name) {
+  data_.append("</", 2);
+  data_.append(name);
+  data_ += '>';
+  update();
+  return *this;
+}
+
+minio::xml::Writer& minio::xml::Writer::Text(std::string_view text) {
+  size_t start = 0;
+  for (size_t i = 0; i < text.size(); i++) {
+    std::string_view entity;
+    switch (text[i]) {
+      case '&':
+        entity = "&amp;";
+        break;
+      case '<':
+        entity = "&lt;";
+        break;
+      case '>':
+        entity = "&gt;";
+        break;
+      case '\r':
+        // A raw carriage return would be read as a line feed.
+        entity = "&#13;";
+        break;
+      default:
+        continue;
+    }
+    data_.append(text.substr(start, i - start));
+    data_.append(entity);
+    start = i + 1;
+  }
+  data_.append(text.substr(start));
+  update();
+  return *this;
+}
+
+minio::xml::Writer& minio::xml::Writer::Element(std::string_view name,
+                                                std::string_view text) {
+  data_ += '<';
+  data_.append(name);
+  data_ += '>';
+  Text(text);
+  return End(name);
+}
+
+minio::xml::Body minio::xml::Writer::Finish() {
+  Body body;
+  if (md5_ != NULL) {
+    update(true);
+    body.md5sum = utils::Base64Encode(finalDigest(md5_));
+
+    std::string digest = finalDigest(sha256_);
+    static constexpr char kHex[] = "0123456789abcdef";
+    body.sha256.reserve(2 * digest.size());
+    for (unsigned char c : digest) {
+      body.sha256 += kHex[c >> 4];
+      body.sha256 += kHex[c & 0x0F];
+    }
+  }
+  body.data = std::move(data_);
+  return body;
+}
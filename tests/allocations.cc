@@ -0,0 +1,274 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// allocations checks that core operations stay within heap allocation
+// budgets. Operations run against the in-process mock server. A counting
+// operator new counts allocations of the calling thread only, so work of the
+// server threads is not counted.
+//
+// Budgets count allocations beyond a bare curlpp transfer of the same
+// request, made with the options http::Request sets. So they cover this
+// library and not curlpp, whose allocations differ between versions.
+// libcurl allocates by malloc() and is not counted at all.
+//
+// Usage: allocations [--print]
+//
+// --print prints allocations per operation without checking budgets, to set
+// new budgets after an intended change.
+
+#include <cstdlib>
+#include <curlpp/Easy.hpp>
+#include <curlpp/Multi.hpp>
+#include <curlpp/Options.hpp>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+#include "client.h"
+#include "mockserver.h"
+
+namespace {
+thread_local unsigned long allocations = 0;
+thread_local unsigned long allocated_bytes = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  allocations++;
+  allocated_bytes += size;
+  if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+constexpr unsigned int kIterations = 50;
+const std::string kBucket = "allocations";
+
+/**
+ * Transfer is the HTTP request an operation makes.
+ */
+struct Transfer {
+  std::string method;
+  std::string path;  // Path and query string.
+  size_t length = 0;  // Length of request body.
+};  // struct Transfer
+
+/**
+ * Budget is the most allocations and allocated bytes one call of an
+ * operation may make beyond the bare transfer of its request. Budgets are
+ * counts printed by --print plus about 15%; set them likewise after a change
+ * which makes the request path leaner.
+ */
+struct Budget {
+  std::string name;
+  unsigned long allocations;
+  unsigned long bytes;
+  Transfer transfer;
+  std::function<void()> func;
+};  // struct Budget
+
+void Check(bool ok, std::string api, minio::error::Error err) {
+  if (!ok) throw std::runtime_error(api + ": " + err.String());
+}
+
+// transfer makes the request of transfer with curlpp alone, setting the
+// options and as many headers as http::Request sets for it. The response is
+// counted and dropped.
+void transfer(std::string& endpoint, Transfer& transfer,
+              std::list<std::string>& headers, std::string& data) {
+  std::stringstream body(data.substr(0, transfer.length));
+  size_t received = 0;
+
+  curlpp::Easy request;
+  request.setOpt(new curlpp::options::NoSignal(true));
+  request.setOpt(new curlpp::options::CustomRequest{transfer.method});
+  request.setOpt(
+      new curlpp::Options::Url("http://" + endpoint + transfer.path));
+  if (transfer.method == "HEAD") {
+    request.setOpt(new curlpp::options::NoBody(true));
+  }
+  if (transfer.method == "PUT") {
+    request.setOpt(new curlpp::Options::ReadStream(&body));
+    request.setOpt(new curlpp::Options::InfileSize(transfer.length));
+    request.setOpt(new curlpp::Options::Upload(true));
+  }
+  request.setOpt(new curlpp::Options::HttpHeader(headers));
+  request.setOpt(new curlpp::options::Header(true));
+  request.setOpt(new curlpp::options::WriteFunction(
+      [&received](char* /*buffer*/, size_t size, size_t length) -> size_t {
+        received += size * length;
+        return size * length;
+      }));
+
+  curlpp::Multi requests;
+  requests.add(&request);
+  int left = 0;
+  while (!requests.perform(&left)) {
+  }
+  while (left) {
+    fd_set fdread;
+    fd_set fdwrite;
+    fd_set fdexcep;
+    int maxfd = 0;
+    FD_ZERO(&fdread);
+    FD_ZERO(&fdwrite);
+    FD_ZERO(&fdexcep);
+    requests.fdset(&fdread, &fdwrite, &fdexcep, &maxfd);
+    select(maxfd + 1, &fdread, &fdwrite, &fdexcep, NULL);
+    while (!requests.perform(&left)) {
+    }
+  }
+  curlpp::Multi::Msgs msgs = requests.info();
+  for (auto& msg : msgs) {
+    if (msg.second.msg == CURLMSG_DONE && msg.second.code != CURLE_OK) {
+      throw std::runtime_error(std::string("transfer: ") +
+                               curl_easy_strerror(msg.second.code));
+    }
+  }
+  if (received == 0) throw std::runtime_error("transfer: no response");
+}
+
+void PutObject(minio::s3::Client& client, std::string object,
+               std::string& data) {
+  std::stringstream stream(data);
+  minio::s3::PutObjectArgs args(stream, data.size(), 0);
+  args.bucket = kBucket;
+  args.object = object;
+  minio::s3::PutObjectResponse resp = client.PutObject(args);
+  Check(resp, "PutObject()", resp.Error());
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool print = argc > 1 && std::string(argv[1]) == "--print";
+
+  minio::mock::Server server;
+  if (minio::error::Error err = server.Start()) {
+    std::cerr << "unable to start mock server; " << err.String() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  minio::s3::BaseUrl base_url(server.Endpoint(), false);
+  minio::creds::StaticProvider provider("minioadmin", "minioadmin");
+  minio::s3::Client client(base_url, &provider);
+
+  std::string data(1024, 'x');
+  {
+    minio::s3::MakeBucketArgs args;
+    args.bucket = kBucket;
+    minio::s3::MakeBucketResponse resp = client.MakeBucket(args);
+    Check(resp, "MakeBucket()", resp.Error());
+  }
+  PutObject(client, "object", data);
+  for (int i = 0; i < 100; i++) {
+    PutObject(client, "list/object-" + std::to_string(i), data);
+  }
+
+  std::list<Budget> budgets = {
+      {"StatObject", 232, 18 * 1024, {"HEAD", "/" + kBucket + "/object"},
+       [&]() {
+         minio::s3::StatObjectArgs args;
+         args.bucket = kBucket;
+         args.object = "object";
+         minio::s3::StatObjectResponse resp = client.StatObject(args);
+         Check(resp, "StatObject()", resp.Error());
+       }},
+      {"PutObject/1KiB", 209, 20 * 1024,
+       {"PUT", "/" + kBucket + "/object", 1024},
+       [&]() { PutObject(client, "object", data); }},
+      {"GetObject/1KiB", 212, 21 * 1024, {"GET", "/" + kBucket + "/object"},
+       [&]() {
+         size_t size = 0;
+         minio::s3::GetObjectArgs args;
+         args.bucket = kBucket;
+         args.object = "object";
+         args.datafunc = [&size](minio::http::DataFunctionArgs args) -> bool {
+           size += args.datachunk.size();
+           return true;
+         };
+         minio::s3::GetObjectResponse resp = client.GetObject(args);
+         Check(resp && size == data.size(), "GetObject()", resp.Error());
+       }},
+      {"ListObjectsV2/100", 436, 210 * 1024,
+       {"GET", "/" + kBucket + "/?list-type=2&max-keys=100&prefix=list%2F"},
+       [&]() {
+         minio::s3::ListObjectsV2Args args;
+         args.bucket = kBucket;
+         args.prefix = "list/";
+         args.max_keys = 100;
+         minio::s3::ListObjectsResponse resp = client.ListObjectsV2(args);
+         Check(resp && resp.contents.size() == 100, "ListObjectsV2()",
+               resp.Error());
+       }},
+  };
+
+  std::string endpoint = server.Endpoint();
+  bool failed = false;
+  for (auto& budget : budgets) {
+    // Headers as http::Request sends them, with values of typical length.
+    std::list<std::string> headers = {
+        "Host: " + endpoint,
+        "User-Agent: MinIO (Linux; x86_64) minio-cpp/0.1.0",
+        "x-amz-content-sha256: " + std::string(64, '0'),
+        "x-amz-date: 20230101T000000Z",
+        "Authorization: AWS4-HMAC-SHA256 Credential=minioadmin/20230101/"
+        "us-east-1/s3/aws4_request, SignedHeaders=host;x-amz-content-sha256;"
+        "x-amz-date, Signature=" +
+            std::string(64, '0'),
+        "Expect:"};
+    if (budget.transfer.length > 0) {
+      headers.push_back("Content-Length: " +
+                        std::to_string(budget.transfer.length));
+    }
+
+    // First call looks up bucket region and opens connections.
+    budget.func();
+    transfer(endpoint, budget.transfer, headers, data);
+
+    unsigned long start_allocations = allocations;
+    unsigned long start_bytes = allocated_bytes;
+    for (unsigned int i = 0; i < kIterations; i++) {
+      transfer(endpoint, budget.transfer, headers, data);
+    }
+    unsigned long base_count = (allocations - start_allocations) / kIterations;
+    unsigned long base_bytes = (allocated_bytes - start_bytes) / kIterations;
+
+    start_allocations = allocations;
+    start_bytes = allocated_bytes;
+    for (unsigned int i = 0; i < kIterations; i++) budget.func();
+    unsigned long count = (allocations - start_allocations) / kIterations;
+    unsigned long bytes = (allocated_bytes - start_bytes) / kIterations;
+    count = count > base_count ? count - base_count : 0;
+    bytes = bytes > base_bytes ? bytes - base_bytes : 0;
+
+    std::cout << budget.name << ": " << count << " allocations ("
+              << budget.allocations << " allowed), " << bytes << " bytes ("
+              << budget.bytes << " allowed) per operation beyond "
+              << base_count << " allocations, " << base_bytes
+              << " bytes of curlpp" << std::endl;
+    if (!print && (count > budget.allocations || bytes > budget.bytes)) {
+      std::cerr << budget.name << ": allocation budget exceeded" << std::endl;
+      failed = true;
+    }
+  }
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// hedge checks which of a hedged request and its duplicate is used, against
+// the in-process mock server with a fixed latency and injected errors.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "http.h"
+#include "mockserver.h"
+
+namespace {
+const std::string kContent(100000, 'x');
+
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+// Latency of the server is well above the hedge delay, so that every
+// request is hedged and the duplicate is answered 50ms after the request.
+minio::http::Response send(std::string endpoint, minio::http::Method method,
+                           std::string path, std::string* data = NULL) {
+  minio::http::Url url = minio::http::Url::Parse("http://" + endpoint + path);
+  minio::http::Request request(method, url);
+  request.hedge_delay = std::chrono::milliseconds(50);
+  if (method == minio::http::Method::kPut) request.body = kContent;
+  if (data != NULL) {
+    request.datafunc = [data](minio::http::DataFunctionArgs args) -> bool {
+      data->append(args.datachunk);
+      return true;
+    };
+  }
+  return request.Execute();
+}
+
+std::string describe(minio::http::Response& resp) {
+  return "status " + std::to_string(resp.status_code) +
+         (resp.hedged ? ", hedged" : "") + (resp.hedge_won ? ", won" : "") +
+         (resp.error.empty() ? "" : ", " + resp.error);
+}
+}  // namespace
+
+int main() {
+  minio::mock::ServerConfig config;
+  config.latency = std::chrono::milliseconds(200);
+  minio::mock::Server server(config);
+  if (minio::error::Error err = server.Start()) {
+    std::cerr << "unable to start mock server; " << err.String() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string endpoint = server.Endpoint();
+
+  send(endpoint, minio::http::Method::kPut, "/hedge");
+  minio::http::Response resp =
+      send(endpoint, minio::http::Method::kPut, "/hedge/object");
+  if (!resp) {
+    std::cerr << "PutObject: " << describe(resp) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  resp = send(endpoint, minio::http::Method::kGet, "/hedge/object");
+  Check(resp && resp.hedged && !resp.hedge_won && resp.body == kContent,
+        "request responding first is used; got " + describe(resp));
+
+  // The request fails first; the duplicate must not be cancelled by it.
+  server.FailNext(1);
+  resp = send(endpoint, minio::http::Method::kGet, "/hedge/object");
+  Check(resp && resp.hedged && resp.hedge_won && resp.body == kContent,
+        "duplicate is used when request fails; got " + describe(resp));
+
+  server.FailNext(1);
+  std::string data;
+  resp = send(endpoint, minio::http::Method::kGet, "/hedge/object", &data);
+  Check(resp && resp.hedge_won && data == kContent,
+        "data function gets only the body of the duplicate; got " +
+            describe(resp) + ", " + std::to_string(data.size()) + " bytes");
+
+  server.FailNext(2);
+  resp = send(endpoint, minio::http::Method::kGet, "/hedge/object");
+  Check(!resp && resp.status_code == 503 && resp.hedged && !resp.hedge_won,
+        "error of request is returned when both fail; got " + describe(resp));
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,267 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// limiter checks how ConcurrencyLimiter adapts its limit to synthetic
+// responses and latencies fed to Release(), that LimiterSlot returns its
+// slot and the order waiting requests are granted slots by priority. No
+// server is needed.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "limiter.h"
+
+namespace {
+using minio::s3::ConcurrencyLimiter;
+using minio::s3::LimiterPolicy;
+using minio::s3::Priority;
+
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+bool near(double got, double want) { return std::fabs(got - want) < 0.01; }
+
+// response returns a response of a request without a body and with given
+// time to first byte in microseconds.
+minio::http::Response response(int status_code, long long latency) {
+  minio::http::Response response;
+  response.status_code = status_code;
+  response.first_byte_time = std::chrono::microseconds(latency);
+  return response;
+}
+
+void release(ConcurrencyLimiter& limiter, int status_code,
+             long long latency) {
+  minio::http::Response resp = response(status_code, latency);
+  limiter.Release(resp, std::chrono::microseconds(latency));
+}
+
+// fill acquires slots until the limit is in use.
+void fill(ConcurrencyLimiter& limiter) {
+  while (limiter.Stats().inflight < limiter.Limit()) limiter.Acquire();
+}
+
+void Growth() {
+  ConcurrencyLimiter limiter;
+  fill(limiter);
+  release(limiter, 200, 10000);  // Latency and baseline start at 10ms.
+  limiter.Acquire();
+
+  // Each response while the limit is in use adds 1/limit.
+  double want = 16;
+  for (int i = 0; i < 16; i++) {
+    want += 1 / want;
+    release(limiter, 200, 10000);
+    fill(limiter);
+  }
+  minio::s3::LimiterStats stats = limiter.Stats();
+  Check(near(stats.limit, want) && limiter.Limit() == 16,
+        "limit grows by 1/limit per response; got " +
+            std::to_string(stats.limit));
+  for (int i = 0; i < 2; i++) {
+    release(limiter, 200, 10000);
+    fill(limiter);
+  }
+  Check(limiter.Limit() == 17 && limiter.Stats().inflight == 17,
+        "limit grows by one per limit responses; got " +
+            std::to_string(limiter.Stats().limit));
+
+  // Without requests held back by the limit it does not grow.
+  while (limiter.Stats().inflight > 1) release(limiter, 200, 10000);
+  double limit = limiter.Stats().limit;
+  for (int i = 0; i < 100; i++) {
+    release(limiter, 200, 10000);
+    limiter.Acquire();
+  }
+  Check(limiter.Stats().limit == limit, "unused limit does not grow");
+
+  // Uploads carry no latency sample.
+  minio::http::Response upload = response(200, 500000);
+  upload.bytes_sent = 1 << 20;
+  limiter.Release(upload, std::chrono::microseconds(500000));
+  Check(limiter.Stats().latency.count() == 10000,
+        "time to first byte of an upload is not a latency sample");
+}
+
+void ProportionalShrink() {
+  ConcurrencyLimiter limiter;
+  limiter.Acquire();
+  release(limiter, 200, 10000);
+
+  // Latency moves 1/8 toward each sample; the third 30ms sample takes it
+  // over 1.5 times the baseline.
+  for (int i = 0; i < 2; i++) {
+    limiter.Acquire();
+    release(limiter, 200, 30000);
+  }
+  Check(limiter.Stats().limit == 16, "limit holds within tolerance");
+  limiter.Acquire();
+  release(limiter, 200, 30000);
+  minio::s3::LimiterStats stats = limiter.Stats();
+  double want = 16 * 1.5 * stats.baseline.count() / stats.latency.count();
+  Check(std::fabs(stats.limit - want) < 0.05 && want > 14 && want < 15,
+        "limit shrinks in proportion to latency rise; got " +
+            std::to_string(stats.limit) + ", want " + std::to_string(want));
+
+  // Another congested response within the round trip changes nothing.
+  limiter.Acquire();
+  release(limiter, 200, 30000);
+  Check(limiter.Stats().limit == stats.limit,
+        "at most one decrease per round trip");
+}
+
+void Backoff() {
+  LimiterPolicy policy;
+  policy.min_limit = 4;
+  ConcurrencyLimiter limiter(policy);
+  limiter.Acquire();
+  release(limiter, 200, 50000);  // Round trip of 50ms.
+
+  limiter.Acquire();
+  release(limiter, 503, 50000);
+  Check(near(limiter.Stats().limit, 16 * 0.7),
+        "503 multiplies limit by 0.7; got " +
+            std::to_string(limiter.Stats().limit));
+  limiter.Acquire();
+  release(limiter, 429, 50000);
+  Check(near(limiter.Stats().limit, 16 * 0.7),
+        "429 within the round trip changes nothing");
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  limiter.Acquire();
+  release(limiter, 429, 50000);
+  Check(near(limiter.Stats().limit, 16 * 0.7 * 0.7),
+        "429 after a round trip multiplies limit by 0.7 again");
+
+  for (int i = 0; i < 4; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    limiter.Acquire();
+    minio::http::Response timeout;
+    timeout.curl_code = CURLE_OPERATION_TIMEDOUT;
+    limiter.Release(timeout, std::chrono::microseconds(50000));
+  }
+  minio::s3::LimiterStats stats = limiter.Stats();
+  Check(stats.limit == 4 && stats.throttled == 7,
+        "timeouts shrink limit down to min_limit; got " +
+            std::to_string(stats.limit));
+}
+
+void Slot() {
+  LimiterPolicy policy;
+  policy.initial_limit = 1;
+  policy.max_limit = 1;
+  ConcurrencyLimiter limiter(policy);
+
+  try {
+    minio::s3::LimiterSlot slot(&limiter, Priority::kNormal);
+    Check(limiter.Stats().inflight == 1, "slot is acquired");
+    throw std::runtime_error("request failed");
+  } catch (const std::runtime_error&) {
+  }
+  Check(limiter.Stats().inflight == 0, "slot is returned on exception");
+
+  {
+    minio::s3::LimiterSlot slot(&limiter, Priority::kNormal);
+    minio::http::Response resp = response(200, 10000);
+    slot.Release(resp, std::chrono::microseconds(10000));
+    Check(limiter.Stats().inflight == 0, "Release() returns slot");
+  }
+  Check(limiter.Stats().inflight == 0 &&
+            limiter.Stats().latency.count() == 10000,
+        "released slot is not returned twice");
+
+  minio::s3::LimiterSlot none(NULL, Priority::kNormal);
+}
+
+// dispatchOrder queues a request of each priority in turn behind a held
+// slot of a limit of one and returns the order they are granted in.
+std::string dispatchOrder(std::vector<Priority> priorities) {
+  LimiterPolicy policy;
+  policy.initial_limit = 1;
+  policy.max_limit = 1;
+  ConcurrencyLimiter limiter(policy);
+  limiter.Acquire();
+
+  std::mutex mutex;
+  std::string order;
+  std::vector<std::thread> threads;
+  for (auto priority : priorities) {
+    unsigned int queued = limiter.Stats().queued;
+    threads.emplace_back([&, priority]() {
+      limiter.Acquire(priority);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        order += std::string(order.empty() ? "" : ",") +
+                 minio::s3::PriorityToString(priority);
+      }
+      minio::http::Response resp;
+      limiter.Release(resp, std::chrono::microseconds(0));
+    });
+    while (limiter.Stats().queued == queued) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  minio::http::Response resp;
+  limiter.Release(resp, std::chrono::microseconds(0));
+  for (auto& thread : threads) thread.join();
+  return order;
+}
+
+void Priorities() {
+  std::string order =
+      dispatchOrder({Priority::kBackground, Priority::kNormal,
+                     Priority::kInteractive, Priority::kCritical});
+  Check(order == "critical,interactive,normal,background",
+        "classes are served by priority; got " + order);
+
+  // Weights 16, 4 and 1 give virtual finish times of n/16, n/4 and n.
+  order = dispatchOrder({Priority::kBackground, Priority::kBackground,
+                         Priority::kNormal, Priority::kNormal,
+                         Priority::kNormal, Priority::kNormal,
+                         Priority::kNormal, Priority::kInteractive});
+  Check(order ==
+            "interactive,normal,normal,normal,normal,background,normal,"
+            "background",
+        "waiting classes share slots by weight; got " + order);
+}
+}  // namespace
+
+int main() {
+  Growth();
+  ProportionalShrink();
+  Backoff();
+  Slot();
+  Priorities();
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// metrics checks bucket boundaries, relative error, percentiles and counts
+// of Histogram and the Prometheus exposition of RequestMetrics. No server
+// is needed.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "metrics.h"
+
+namespace {
+using minio::s3::Histogram;
+using minio::s3::HistogramSnapshot;
+
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+// lowerBound returns the smallest value of bucket of index.
+unsigned long long lowerBound(unsigned int index) {
+  return index == 0 ? 0 : Histogram::UpperBound(index - 1);
+}
+
+void Buckets() {
+  for (unsigned long long value = 0; value < 8; value++) {
+    Check(Histogram::Index(value) == value &&
+              Histogram::UpperBound(value) == value + 1,
+          "values below 8 have a bucket each; " + std::to_string(value));
+  }
+  Check(Histogram::Index(16) == 16 && Histogram::Index(17) == 16 &&
+            Histogram::Index(18) == 17 && Histogram::UpperBound(16) == 18,
+        "16 and 17 share a bucket");
+
+  // Every value falls in its bucket and buckets are within 12.5% wide.
+  bool contained = true;
+  bool bounded = true;
+  auto check = [&](unsigned long long value) {
+    unsigned int index = Histogram::Index(value);
+    unsigned long long lower = lowerBound(index);
+    unsigned long long upper = Histogram::UpperBound(index);
+    contained = contained && lower <= value && value < upper;
+    bounded = bounded && (upper - lower) * 8 <= (lower > 8 ? lower : 8);
+  };
+  for (unsigned long long value = 0; value < (1 << 20); value++) {
+    check(value);
+  }
+  for (unsigned int bits = 20; bits < Histogram::kMaxBits; bits++) {
+    unsigned long long power = 1ULL << bits;
+    for (unsigned long long value : {power - 1, power, power + 1,
+                                     power + power / 8 - 1, power + power / 8,
+                                     power * 2 - power / 16}) {
+      check(value);
+    }
+  }
+  Check(contained, "values fall within their bucket");
+  Check(bounded, "buckets are at most 1/8 of their lower bound wide");
+
+  unsigned int last = Histogram::kBuckets - 1;
+  Check(Histogram::Index((1ULL << Histogram::kMaxBits) - 1) == last &&
+            Histogram::Index(1ULL << Histogram::kMaxBits) == last &&
+            Histogram::Index(~0ULL) == last,
+        "values beyond 2^kMaxBits count in the last bucket");
+}
+
+void Percentiles() {
+  Histogram histogram;
+  for (unsigned long long value = 1; value <= 1000; value++) {
+    histogram.Record(value);
+  }
+  HistogramSnapshot snapshot = histogram.Snapshot();
+  Check(snapshot.count == 1000 && snapshot.sum == 500500,
+        "count and sum are exact");
+
+  for (double q : {0.5, 0.9, 0.99}) {
+    unsigned long long exact = (unsigned long long)(q * 1000) + 1;
+    unsigned long long got = snapshot.Percentile(q);
+    Check(got >= exact && got <= exact + exact / 8 + 1,
+          "percentile " + std::to_string(q) + " is within 12.5% above " +
+              std::to_string(exact) + "; got " + std::to_string(got));
+  }
+  Check(snapshot.Percentile(1) == Histogram::UpperBound(Histogram::Index(1000)),
+        "percentile 1 is the bucket of the maximum");
+  Check(HistogramSnapshot().Percentile(0.5) == 0, "empty histogram gives 0");
+}
+
+void CountBelow() {
+  Histogram histogram;
+  for (unsigned long long value = 0; value < 100; value++) {
+    histogram.Record(value);
+  }
+  HistogramSnapshot snapshot = histogram.Snapshot();
+
+  // At bucket boundaries counts are exact.
+  bool exact = true;
+  for (unsigned int i = 0; Histogram::UpperBound(i) <= 100; i++) {
+    unsigned long long bound = Histogram::UpperBound(i) - 1;
+    exact = exact && snapshot.CountBelow(bound) == bound + 1;
+  }
+  Check(exact, "counts at bucket boundaries are exact");
+
+  // Between boundaries, the bucket holding bound is left out: 64..71 share
+  // a bucket, so values up to 70 count as up to 63.
+  Check(snapshot.CountBelow(70) == 64,
+        "count rounds down to a bucket boundary; got " +
+            std::to_string(snapshot.CountBelow(70)));
+  Check(snapshot.CountBelow(1000) == 100, "all values are below 1000");
+}
+
+bool contains(const std::string& text, const std::string& line) {
+  return text.find("\n" + line + "\n") != std::string::npos;
+}
+
+void Prometheus() {
+  minio::s3::RequestMetrics metrics;
+  minio::http::Response ok;
+  ok.status_code = 200;
+  ok.bytes_received = 1000;
+  minio::http::Response failed;
+  failed.status_code = 503;
+
+  metrics.Record("GetObject", "bucket", ok, std::chrono::microseconds(1500));
+  metrics.Record("GetObject", "bucket", failed,
+                 std::chrono::microseconds(1234567891));
+  metrics.RecordRetry("GetObject", "bucket");
+  metrics.Record("StatObject", "a\"b\\c", ok, std::chrono::microseconds(7));
+
+  std::string text = "\n" + metrics.Prometheus();
+  std::string labels = "{api=\"GetObject\",bucket=\"bucket\"";
+  std::string name = "minio_client_request_duration_seconds";
+  for (std::string line : {
+           std::string("# TYPE minio_client_requests_total counter"),
+           "minio_client_requests_total" + labels + "} 2",
+           "minio_client_retries_total" + labels + "} 1",
+           "minio_client_received_bytes_total" + labels + "} 1000",
+           "minio_client_responses_total" + labels + ",code=\"2xx\"} 1",
+           "minio_client_responses_total" + labels + ",code=\"5xx\"} 1",
+           "# TYPE " + name + " histogram",
+           name + "_bucket" + labels + ",le=\"0.001\"} 0",
+           name + "_bucket" + labels + ",le=\"0.0025\"} 1",
+           name + "_bucket" + labels + ",le=\"60\"} 1",
+           name + "_bucket" + labels + ",le=\"+Inf\"} 2",
+           name + "_sum" + labels + "} 1234.569391",
+           name + "_count" + labels + "} 2",
+           name + "_sum{api=\"StatObject\",bucket=\"a\\\"b\\\\c\"} 0.000007",
+       }) {
+    Check(contains(text, line), "exposition has line " + line);
+  }
+}
+}  // namespace
+
+int main() {
+  Buckets();
+  Percentiles();
+  CountBelow();
+  Prometheus();
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// providers checks the refresh schedule, retries and Reset() of
+// RefreshingProvider over a fake provider of short-lived credentials. No
+// server is needed.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "providers.h"
+
+namespace {
+using minio::creds::Credentials;
+
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+void sleep(int milliseconds) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+/**
+ * FakeProvider returns credentials valid for lifetime seconds, with access
+ * key "key<n>" for the n-th fetch. The next fails fetches fail.
+ */
+class FakeProvider : public minio::creds::Provider {
+ public:
+  std::atomic<int> fetches = 0;
+  std::atomic<int> resets = 0;
+  std::atomic<int> fails = 0;
+  std::atomic<int> concurrent = 0;
+  std::atomic<bool> overlapped = false;  // Fetch() was called concurrently.
+  time_t lifetime;
+  int delay;  // Milliseconds each fetch takes.
+
+  FakeProvider(time_t lifetime, int delay = 0) {
+    this->lifetime = lifetime;
+    this->delay = delay;
+  }
+
+  Credentials Fetch() {
+    if (++concurrent != 1) overlapped = true;
+    int n = ++fetches;
+    sleep(delay);
+    concurrent--;
+    if (fails > 0) {
+      fails--;
+      return Credentials{minio::error::Error("fetch failed")};
+    }
+    Credentials creds{minio::error::SUCCESS, "key" + std::to_string(n),
+                      "secret"};
+    creds.expiration = minio::utils::Time::Now();
+    creds.expiration.Add(minio::creds::kExpirySkewSeconds + lifetime);
+    return creds;
+  }
+
+  void Reset() { resets++; }
+};  // class FakeProvider
+
+void Schedule() {
+  // Half of a lifetime of four seconds is two; refreshes are due about
+  // every one or two seconds as times are compared in whole seconds.
+  FakeProvider fake(4);
+  {
+    minio::creds::RefreshingProvider provider(&fake, 0.5, 1);
+    sleep(200);
+    Check(fake.fetches == 1, "credentials are fetched at start");
+
+    bool valid = true;
+    for (int i = 0; i < 35; i++) {
+      for (int j = 0; j < 10; j++) valid = valid && provider.Fetch();
+      sleep(100);
+    }
+    Check(valid, "Fetch() returns valid credentials all along");
+    Check(fake.fetches >= 2 && fake.fetches <= 4,
+          "credentials are refreshed before expiry; got " +
+              std::to_string(fake.fetches) + " fetches in 3.7s");
+    Check(fake.resets == fake.fetches, "provider is reset before each fetch");
+    Check(provider.Fetch().access_key ==
+              "key" + std::to_string(fake.fetches),
+          "Fetch() returns the latest credentials");
+  }
+  int fetches = fake.fetches;
+  sleep(1100);
+  Check(fake.fetches == fetches, "no refresh after destruction");
+}
+
+void RetryAfterFailure() {
+  FakeProvider fake(1000);
+  fake.fails = 2;
+  minio::creds::RefreshingProvider provider(&fake, 0.5, 1);
+
+  sleep(500);
+  Check(fake.fetches == 1, "first fetch fails");
+  sleep(2000);
+  Check(fake.fetches == 3, "failed fetch is retried every second; got " +
+                               std::to_string(fake.fetches) + " fetches");
+  Credentials creds = provider.Fetch();
+  Check(creds && creds.access_key == "key3" && fake.fetches == 3,
+        "credentials of the retry are served");
+  sleep(1500);
+  Check(fake.fetches == 3, "no refresh before refresh is due");
+}
+
+void FetchAfterFailure() {
+  FakeProvider fake(1000);
+  fake.fails = 1;
+  minio::creds::RefreshingProvider provider(&fake, 0.5, 10);
+
+  sleep(200);
+  Credentials creds = provider.Fetch();
+  Check(creds && creds.access_key == "key2" && fake.fetches == 2,
+        "Fetch() fetches when background refresh failed");
+}
+
+void Reset() {
+  FakeProvider fake(1000, 500);
+  minio::creds::RefreshingProvider provider(&fake, 0.5, 1);
+  Check(provider.Fetch().access_key == "key1", "first credentials");
+
+  // Concurrent resets share one fetch of the wrapped provider.
+  std::thread thread([&provider]() { provider.Reset(); });
+  sleep(100);
+  auto start = std::chrono::steady_clock::now();
+  Check(bool(provider.Fetch()), "Fetch() serves during refresh");
+  Check(std::chrono::steady_clock::now() - start <
+            std::chrono::milliseconds(100),
+        "Fetch() does not wait for refresh of valid credentials");
+  provider.Reset();
+  thread.join();
+  Check(fake.fetches == 2 && fake.resets == 2,
+        "concurrent Reset() calls share one fetch; got " +
+            std::to_string(fake.fetches) + " fetches");
+  Check(!fake.overlapped, "wrapped provider is not called concurrently");
+  Check(provider.Fetch().access_key == "key2", "Reset() fetches new keys");
+}
+}  // namespace
+
+int main() {
+  Schedule();
+  RetryAfterFailure();
+  FetchAfterFailure();
+  Reset();
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ratelimit checks the rate of TokenBucket alone and from several threads,
+// and receive limits of requests to the in-process mock server, alone and
+// shared by concurrent requests. Timings allow for a loaded machine.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "http.h"
+#include "mockserver.h"
+#include "ratelimit.h"
+
+namespace {
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+/**
+ * Timer measures milliseconds since its creation.
+ */
+struct Timer {
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  long long Elapsed() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  }
+};  // struct Timer
+
+bool within(long long got, long long low, long long high) {
+  return got >= low && got <= high;
+}
+
+void Bucket() {
+  // A bucket of 1000 tokens per second holds 100 tokens of burst.
+  minio::http::TokenBucket bucket(1000);
+  Timer timer;
+  bucket.Take(100);
+  Check(timer.Elapsed() < 20, "burst is taken without waiting");
+
+  timer = Timer();
+  for (int i = 0; i < 10; i++) bucket.Take(50);
+  long long elapsed = timer.Elapsed();
+  Check(within(elapsed, 480, 650),
+        "500 tokens at 1000/s take 500ms; got " + std::to_string(elapsed));
+
+  minio::http::TokenBucket debit(1000);
+  Check(debit.Debit(100).count() == 0, "Debit() of burst is free");
+  long long wait = debit.Debit(50).count();
+  Check(within(wait, 49000, 51000),
+        "Debit() returns time to pay debt; got " + std::to_string(wait) +
+            "us");
+}
+
+void ConcurrentBucket() {
+  // Four threads take 4000 tokens at 10000/s; 1000 are burst.
+  minio::http::TokenBucket bucket(10000);
+  Timer timer;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&bucket]() {
+      for (int j = 0; j < 10; j++) bucket.Take(100);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  long long elapsed = timer.Elapsed();
+  Check(within(elapsed, 280, 450),
+        "threads share the rate; got " + std::to_string(elapsed) + "ms");
+}
+
+minio::http::Response get(std::string endpoint, std::string path,
+                          std::shared_ptr<minio::http::RateLimiter> limiter,
+                          size_t& received) {
+  minio::http::Url url = minio::http::Url::Parse("http://" + endpoint + path);
+  minio::http::Request request(minio::http::Method::kGet, url);
+  request.rate_limiters.push_back(limiter);
+  request.datafunc = [&received](minio::http::DataFunctionArgs args) -> bool {
+    received += args.datachunk.size();
+    return true;
+  };
+  return request.Execute();
+}
+
+void Receive(minio::mock::Server& server) {
+  std::string endpoint = server.Endpoint();
+
+  // 1 MiB at 1 MiB/s with 100ms of burst.
+  minio::http::RateLimit limit;
+  limit.receive_bytes_per_second = 1 << 20;
+  auto limiter = std::make_shared<minio::http::RateLimiter>(limit);
+  size_t received = 0;
+  Timer timer;
+  minio::http::Response resp = get(endpoint, "/ratelimit/1m", limiter,
+                                   received);
+  long long elapsed = timer.Elapsed();
+  Check(resp && received == 1 << 20, "GET under receive limit; " +
+                                         resp.Error().String());
+  Check(within(elapsed, 850, 1400),
+        "1 MiB at 1 MiB/s takes 0.9s; got " + std::to_string(elapsed) + "ms");
+
+  // Four requests of 256 KiB share one limit.
+  limiter = std::make_shared<minio::http::RateLimiter>(limit);
+  timer = Timer();
+  std::vector<std::thread> threads;
+  std::vector<size_t> counts(4, 0);
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&, i]() {
+      get(endpoint, "/ratelimit/256k", limiter, counts[i]);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  elapsed = timer.Elapsed();
+  size_t total = 0;
+  for (auto count : counts) total += count;
+  Check(total == 1 << 20, "concurrent GETs under receive limit");
+  Check(within(elapsed, 850, 1400),
+        "concurrent GETs share the limit; got " + std::to_string(elapsed) +
+            "ms");
+}
+
+bool put(std::string endpoint, std::string path, std::string body) {
+  minio::http::Url url = minio::http::Url::Parse("http://" + endpoint + path);
+  minio::http::Request request(minio::http::Method::kPut, url);
+  request.body = body;
+  return bool(request.Execute());
+}
+}  // namespace
+
+int main() {
+  Bucket();
+  ConcurrentBucket();
+
+  minio::mock::Server server;
+  if (minio::error::Error err = server.Start()) {
+    std::cerr << "unable to start mock server; " << err.String() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string endpoint = server.Endpoint();
+  if (!put(endpoint, "/ratelimit", "") ||
+      !put(endpoint, "/ratelimit/1m", std::string(1 << 20, 'x')) ||
+      !put(endpoint, "/ratelimit/256k", std::string(1 << 18, 'x'))) {
+    std::cerr << "unable to create objects" << std::endl;
+    return EXIT_FAILURE;
+  }
+  Receive(server);
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
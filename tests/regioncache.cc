@@ -0,0 +1,204 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// regioncache checks sharing of concurrent lookups, expiry, negative entries,
+// Set(), Remove() and failing lookups of RegionCache with a counting lookup
+// function. No server is needed.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "regioncache.h"
+
+namespace {
+using minio::s3::GetRegionResponse;
+using minio::s3::RegionCache;
+
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+/**
+ * Lookup counts calls and returns region, or code as error when set. Each
+ * call takes delay so that concurrent callers overlap.
+ */
+struct Lookup {
+  std::atomic<int> calls = 0;
+  std::string region = "us-east-1";
+  std::string code;
+  bool fail = false;  // Throws instead of returning.
+  std::chrono::milliseconds delay{0};
+
+  minio::s3::RegionLookupFunction Func() {
+    return [this]() -> GetRegionResponse {
+      calls++;
+      std::this_thread::sleep_for(delay);
+      if (fail) throw std::runtime_error("lookup failed");
+      if (code.empty()) return GetRegionResponse(region);
+      minio::s3::Response resp;
+      resp.status_code = 404;
+      resp.code = code;
+      return GetRegionResponse(resp);
+    };
+  }
+};  // struct Lookup
+
+void ConcurrentMisses() {
+  RegionCache cache;
+  Lookup lookup;
+  lookup.delay = std::chrono::milliseconds(200);
+
+  std::atomic<int> ok = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&]() {
+      GetRegionResponse resp = cache.Get("bucket", lookup.Func());
+      if (resp && resp.region == "us-east-1") ok++;
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  Check(lookup.calls == 1, "concurrent misses share one lookup; got " +
+                               std::to_string(lookup.calls) + " lookups");
+  Check(ok == 8, "all callers get the region");
+
+  std::string region;
+  Check(cache.Lookup("bucket", region) && region == "us-east-1",
+        "Lookup() finds the cached region");
+  Check(!cache.Lookup("other", region), "Lookup() misses other bucket");
+}
+
+void SetAndRemove() {
+  RegionCache cache;
+  Lookup lookup;
+
+  cache.Set("bucket", "eu-west-1");
+  GetRegionResponse resp = cache.Get("bucket", lookup.Func());
+  Check(lookup.calls == 0 && resp.region == "eu-west-1",
+        "Set() region is served without lookup");
+
+  cache.Remove("bucket");
+  std::string region;
+  Check(!cache.Lookup("bucket", region), "Remove() drops the entry");
+  resp = cache.Get("bucket", lookup.Func());
+  Check(lookup.calls == 1 && resp.region == "us-east-1",
+        "removed bucket is looked up again");
+  cache.Remove("missing");  // Removing an absent bucket is harmless.
+}
+
+void Expiry() {
+  RegionCache cache;
+  cache.SetTtl(std::chrono::seconds(1), std::chrono::seconds(0));
+  Lookup lookup;
+
+  cache.Get("bucket", lookup.Func());
+  cache.Get("bucket", lookup.Func());
+  Check(lookup.calls == 1, "region is cached within TTL");
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  std::string region;
+  Check(!cache.Lookup("bucket", region), "Lookup() misses expired entry");
+  cache.Get("bucket", lookup.Func());
+  Check(lookup.calls == 2, "expired region is looked up again");
+}
+
+void NegativeEntries() {
+  RegionCache cache;
+  Lookup lookup;
+  lookup.code = "NoSuchBucket";
+
+  // NoSuchBucket is not cached by default; a bucket created meanwhile by
+  // someone else is found by the next call.
+  Check(!cache.Get("bucket", lookup.Func()), "NoSuchBucket is returned");
+  lookup.code = "";
+  Check(bool(cache.Get("bucket", lookup.Func())) && lookup.calls == 2,
+        "NoSuchBucket is not cached by default");
+
+  cache.SetTtl(std::chrono::seconds(0), std::chrono::seconds(1));
+  lookup.code = "NoSuchBucket";
+  cache.Get("new", lookup.Func());
+  GetRegionResponse resp = cache.Get("new", lookup.Func());
+  Check(lookup.calls == 3 && resp.code == "NoSuchBucket",
+        "NoSuchBucket is cached for negative TTL");
+  std::string region;
+  Check(!cache.Lookup("new", region), "Lookup() misses negative entry");
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  lookup.code = "";
+  Check(bool(cache.Get("new", lookup.Func())) && lookup.calls == 4,
+        "negative entry expires");
+
+  lookup.code = "AccessDenied";
+  cache.Get("denied", lookup.Func());
+  cache.Get("denied", lookup.Func());
+  Check(lookup.calls == 6, "other errors are never cached");
+}
+
+void FailingLookup() {
+  RegionCache cache;
+  Lookup lookup;
+  lookup.fail = true;
+  lookup.delay = std::chrono::milliseconds(200);
+
+  std::atomic<int> thrown = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      try {
+        cache.Get("bucket", lookup.Func());
+      } catch (const std::runtime_error& err) {
+        if (std::string(err.what()) == "lookup failed") thrown++;
+      } catch (...) {
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  Check(thrown == 4, "all callers get the lookup exception; got " +
+                         std::to_string(thrown));
+
+  lookup.fail = false;
+  lookup.delay = std::chrono::milliseconds(0);
+  int calls = lookup.calls;
+  try {
+    GetRegionResponse resp = cache.Get("bucket", lookup.Func());
+    Check(resp && resp.region == "us-east-1" && lookup.calls == calls + 1,
+          "bucket is looked up again after failed lookup");
+  } catch (const std::exception& err) {
+    Check(false, std::string("Get() after failed lookup: ") + err.what());
+  }
+}
+}  // namespace
+
+int main() {
+  ConcurrentMisses();
+  SetAndRemove();
+  Expiry();
+  NegativeEntries();
+  FailingLookup();
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
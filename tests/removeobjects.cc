@@ -0,0 +1,251 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// removeobjects removes thousands of objects in batches from the in-process
+// mock server, by names with failed batches injected and by prefix, and
+// checks that every object is removed or reported.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "client.h"
+#include "mockserver.h"
+
+namespace {
+constexpr unsigned int kObjects = 5000;  // Five full batches.
+const std::string kBucket = "removeobjects";
+
+void Check(bool ok, std::string what) {
+  if (!ok) throw std::runtime_error(what);
+}
+
+// PutObjects puts empty objects under prefix, some of whose names must be
+// escaped in XML, and returns their names.
+std::list<std::string> PutObjects(minio::s3::Client& client,
+                                  std::string prefix, unsigned int count) {
+  std::list<std::string> names;
+  for (unsigned int i = 0; i < count; i++) {
+    std::string name = prefix + (i % 7 == 0 ? "a&b<c>-" : "object-") +
+                       std::to_string(i);
+    std::stringstream stream;
+    minio::s3::PutObjectArgs args(stream, 0, 0);
+    args.bucket = kBucket;
+    args.object = name;
+    minio::s3::PutObjectResponse resp = client.PutObject(args);
+    Check(resp, "PutObject(): " + resp.Error().String());
+    names.push_back(name);
+  }
+  return names;
+}
+
+// ListObjects returns names of objects under prefix.
+std::list<std::string> ListObjects(minio::s3::Client& client,
+                                   std::string prefix) {
+  std::list<std::string> names;
+  std::string token;
+  do {
+    minio::s3::ListObjectsV2Args args;
+    args.bucket = kBucket;
+    args.prefix = prefix;
+    args.continuation_token = token;
+    minio::s3::ListObjectsResponse resp = client.ListObjectsV2(args);
+    Check(resp, "ListObjectsV2(): " + resp.Error().String());
+    for (auto& item : resp.contents) names.push_back(item.name);
+    token = resp.is_truncated ? resp.next_continuation_token : "";
+  } while (!token.empty());
+  return names;
+}
+
+/**
+ * Removal is the outcome of one RemoveObjects() call.
+ */
+struct Removal {
+  std::list<minio::s3::DeleteError> errors;
+  minio::s3::RemoveObjectsProgress progress;
+  unsigned int reports = 0;
+  bool overlapped = false;  // progressfunc was called concurrently.
+  bool regressed = false;   // progressfunc saw less done than before.
+};  // struct Removal
+
+Removal RemoveObjects(minio::s3::Client& client,
+                      std::list<std::string>& names,
+                      unsigned int concurrency) {
+  Removal removal;
+  std::atomic<int> calls = 0;
+
+  minio::s3::RemoveObjectsArgs args;
+  args.bucket = kBucket;
+  args.concurrency = concurrency;
+  auto i = names.begin();
+  args.func = [&](minio::s3::DeleteObject& object) -> bool {
+    if (i == names.end()) return false;
+    object.name = *i++;
+    return true;
+  };
+  args.progressfunc = [&](minio::s3::RemoveObjectsProgress progress) {
+    if (++calls != 1) removal.overlapped = true;
+    if (progress.removed + progress.failed <=
+        removal.progress.removed + removal.progress.failed) {
+      removal.regressed = true;
+    }
+    removal.progress = progress;
+    removal.reports++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    calls--;
+  };
+
+  minio::s3::RemoveObjectsResult result = client.RemoveObjects(args);
+  for (; result; result++) removal.errors.push_back(*result);
+  return removal;
+}
+
+void TestRemoveObjects(minio::s3::Client& client, minio::mock::Server& server,
+                       unsigned int concurrency) {
+  std::string prefix = "remove-" + std::to_string(concurrency) + "/";
+  std::string suffix = " with concurrency " + std::to_string(concurrency);
+  std::list<std::string> names = PutObjects(client, prefix, kObjects);
+
+  // Two batch requests fail as a whole and are not retried.
+  server.FailNext(2);
+  Removal removal = RemoveObjects(client, names, concurrency);
+
+  Check(removal.errors.size() == 2,
+        "RemoveObjects(): expected 2 errors; got " +
+            std::to_string(removal.errors.size()) + suffix);
+  for (auto& err : removal.errors) {
+    Check(err.code == "AccessDenied",
+          "RemoveObjects(): unexpected error " + err.Error().String() +
+              suffix);
+  }
+  Check(!removal.overlapped,
+        "RemoveObjects(): progressfunc calls overlapped" + suffix);
+  Check(!removal.regressed, "RemoveObjects(): progress went back" + suffix);
+  Check(removal.reports >= 1 && removal.progress.pulled == kObjects &&
+            removal.progress.removed == kObjects - 2000 &&
+            removal.progress.failed == 2000,
+        "RemoveObjects(): unexpected progress " +
+            std::to_string(removal.progress.removed) + " removed, " +
+            std::to_string(removal.progress.failed) + " failed" + suffix);
+
+  // Objects of failed batches are still there; remove them again.
+  std::list<std::string> remaining = ListObjects(client, prefix);
+  Check(remaining.size() == 2000,
+        "ListObjects(): expected 2000 objects; got " +
+            std::to_string(remaining.size()) + suffix);
+  removal = RemoveObjects(client, remaining, concurrency);
+  Check(removal.errors.empty(), "RemoveObjects(): unexpected errors" + suffix);
+  Check(ListObjects(client, prefix).empty(),
+        "RemoveObjects(): objects left" + suffix);
+}
+// RemovePrefix removes objects under prefix and returns progress.
+minio::s3::RemoveObjectsProgress RemovePrefix(minio::s3::Client& client,
+                                              std::string prefix,
+                                              bool all_objects) {
+  minio::s3::RemoveObjectsProgress progress;
+  minio::s3::RemovePrefixArgs args;
+  args.bucket = kBucket;
+  args.prefix = prefix;
+  args.all_objects = all_objects;
+  args.progressfunc = [&](minio::s3::RemoveObjectsProgress p) {
+    progress = p;
+  };
+  minio::s3::RemoveObjectsResult result = client.RemovePrefix(args);
+  for (; result; result++) {
+    minio::s3::DeleteError err = *result;
+    Check(false, "RemovePrefix(): " + (err ? err.object_name
+                                             : err.Error().String()));
+  }
+  return progress;
+}
+
+void TestRemovePrefix(minio::s3::Client& client) {
+  PutObjects(client, "prefix/", 2500);
+  PutObjects(client, "prefix-kept/", 3);
+  size_t total = ListObjects(client, "").size();
+
+  // An empty prefix is refused unless all objects are to be removed.
+  minio::s3::RemovePrefixArgs args;
+  args.bucket = kBucket;
+  minio::s3::RemoveObjectsResult result = client.RemovePrefix(args);
+  Check(result && !*result, "RemovePrefix(): empty prefix not refused");
+  Check(ListObjects(client, "").size() == total,
+        "RemovePrefix(): objects removed by empty prefix");
+
+  minio::s3::RemoveObjectsProgress progress =
+      RemovePrefix(client, "prefix/", false);
+  Check(progress.pulled == 2500 && progress.removed == 2500 &&
+            progress.failed == 0,
+        "RemovePrefix(): expected 2500 removed; got " +
+            std::to_string(progress.removed));
+  Check(ListObjects(client, "prefix/").empty(),
+        "RemovePrefix(): objects left");
+  Check(ListObjects(client, "prefix-kept/").size() == 3,
+        "RemovePrefix(): objects of other prefix removed");
+
+  progress = RemovePrefix(client, "", true);
+  Check(progress.removed == total - 2500,
+        "RemovePrefix(): expected " + std::to_string(total - 2500) +
+            " removed; got " + std::to_string(progress.removed));
+  Check(ListObjects(client, "").empty(), "RemovePrefix(): bucket not empty");
+}
+}  // namespace
+
+int main() {
+  minio::mock::ServerConfig config;
+  config.error_status = 403;
+  config.error_code = "AccessDenied";
+  minio::mock::Server server(config);
+  if (minio::error::Error err = server.Start()) {
+    std::cerr << "unable to start mock server; " << err.String() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  minio::s3::BaseUrl base_url(server.Endpoint(), false);
+  minio::creds::StaticProvider provider("minioadmin", "minioadmin");
+  minio::s3::Client client(base_url, &provider);
+
+  try {
+    minio::s3::MakeBucketArgs args;
+    args.bucket = kBucket;
+    minio::s3::MakeBucketResponse resp = client.MakeBucket(args);
+    Check(resp, "MakeBucket(): " + resp.Error().String());
+
+    // Objects outside of removed names must stay.
+    PutObjects(client, "keep/", 1);
+
+    for (unsigned int concurrency : {1, 4}) {
+      std::cout << "RemoveObjects() with concurrency " << concurrency
+                << std::endl;
+      TestRemoveObjects(client, server, concurrency);
+    }
+
+    Check(ListObjects(client, "keep/").size() == 1, "object not kept");
+
+    std::cout << "RemovePrefix()" << std::endl;
+    TestRemovePrefix(client);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
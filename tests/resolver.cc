@@ -0,0 +1,114 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// resolver checks rotation of addresses by Resolver and that requests
+// through it reach the in-process mock server, listening on IPv4 only, by a
+// host name resolving to both loopback addresses.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "http.h"
+#include "mockserver.h"
+
+namespace {
+using Addresses = std::vector<std::string>;
+
+const std::string kHost = "dualstack.test";
+
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+std::string join(Addresses addresses) {
+  std::string value;
+  for (auto& address : addresses) value += (value.empty() ? "" : ",") + address;
+  return value;
+}
+
+// dualStack resolves kHost to the IPv6 and IPv4 loopback addresses.
+Addresses dualStack(std::string host, unsigned int) {
+  if (host != kHost) return {};
+  return {"[::1]", "127.0.0.1"};
+}
+
+void Rotation() {
+  minio::http::Resolver disabled;
+  disabled.SetResolveFunction(dualStack);
+  Check(disabled.Next(kHost, 9000).empty(), "resolver is off by default");
+
+  minio::http::Resolver resolver(std::chrono::seconds(30));
+  resolver.SetResolveFunction(dualStack);
+  Check(join(resolver.Next(kHost, 9000)) == "[::1],127.0.0.1",
+        "first call starts at first address");
+  Check(join(resolver.Next(kHost, 9000)) == "127.0.0.1,[::1]",
+        "second call starts at second address");
+  Check(join(resolver.Next(kHost, 9000)) == "[::1],127.0.0.1",
+        "third call starts at first address again");
+  Check(resolver.Next("127.0.0.1", 9000).empty(),
+        "IP addresses are left to libcurl");
+  Check(resolver.Next("unknown.test", 9000).empty(),
+        "unresolved host is left to libcurl");
+}
+
+void Fallback() {
+  minio::mock::ServerConfig config;
+  config.address = "127.0.0.1";
+  minio::mock::Server server(config);
+  if (minio::error::Error err = server.Start()) {
+    Check(false, "unable to start mock server; " + err.String());
+    return;
+  }
+
+  minio::http::Resolver resolver(std::chrono::seconds(30));
+  resolver.SetResolveFunction(dualStack);
+  minio::http::Url url = minio::http::Url::Parse(
+      "http://" + kHost + ":" + std::to_string(server.Port()) + "/");
+
+  // Every other request lists the IPv6 address first, where nothing
+  // listens; libcurl must fall back to the IPv4 one.
+  int ok = 0;
+  for (int i = 0; i < 6; i++) {
+    minio::http::Request request(minio::http::Method::kGet, url);
+    request.resolver = &resolver;
+    minio::http::Response resp = request.Execute();
+    if (resp) {
+      ok++;
+    } else {
+      Check(false, "request " + std::to_string(i) +
+                       " failed; " + resp.Error().String());
+    }
+  }
+  Check(ok == 6, "all requests reach IPv4-only server");
+}
+}  // namespace
+
+int main() {
+  Rotation();
+  Fallback();
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
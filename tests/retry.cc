@@ -0,0 +1,311 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// retry checks classification of errors and backoff bounds of RetryPolicy,
+// and retries, exhaustion and resumed downloads of the client against the
+// in-process mock server with injected errors and cut off downloads.
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "client.h"
+#include "mockserver.h"
+
+namespace {
+const std::string kBucket = "retry";
+
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+// data returns size pseudo-random bytes.
+std::string data(size_t size) {
+  std::string data(size, '\0');
+  unsigned int x = 1;
+  for (size_t i = 0; i < size; i++) {
+    x = x * 1103515245 + 12345;
+    data[i] = (char)(x >> 16);
+  }
+  return data;
+}
+
+/**
+ * Counts is a snapshot of RetryMetrics.
+ */
+struct Counts {
+  unsigned long attempts;
+  unsigned long retries;
+  unsigned long resumes;
+  unsigned long exhausted;
+
+  Counts(minio::s3::RetryMetrics& metrics) {
+    attempts = metrics.attempts;
+    retries = metrics.retries;
+    resumes = metrics.resumes;
+    exhausted = metrics.exhausted;
+  }
+
+  // Since returns counts since start as text to compare.
+  std::string Since(Counts& start) {
+    return std::to_string(attempts - start.attempts) + " attempts, " +
+           std::to_string(retries - start.retries) + " retries, " +
+           std::to_string(resumes - start.resumes) + " resumes, " +
+           std::to_string(exhausted - start.exhausted) + " exhausted";
+  }
+};  // struct Counts
+
+void IsRetryable() {
+  minio::s3::RetryPolicy policy;
+  auto retryable = [&policy](CURLcode curl_code, int status_code,
+                             std::string code, std::string error) {
+    minio::http::Response http_response;
+    http_response.curl_code = curl_code;
+    http_response.status_code = status_code;
+    http_response.error = error;
+    minio::s3::Response response;
+    response.status_code = status_code;
+    response.code = code;
+    return policy.IsRetryable(http_response, response);
+  };
+
+  Check(retryable(CURLE_COULDNT_CONNECT, 0, "", "Couldn't connect"),
+        "connection failure is retried");
+  Check(retryable(CURLE_RECV_ERROR, 0, "",
+                  "curlpp::RuntimeError: Failure when receiving data"),
+        "receive error thrown by curlpp is retried");
+  Check(!retryable(CURLE_OK, 0, "",
+                   "curlpp::RuntimeError: curl_multi_perform failed"),
+        "curlpp error without curl code is not retried");
+  Check(!retryable(CURLE_SSL_CACERT_BADFILE, 0, "", "bad CA file"),
+        "configuration error is not retried");
+  Check(retryable(CURLE_OK, 503, "SlowDown", ""), "SlowDown is retried");
+  Check(retryable(CURLE_OK, 500, "", ""), "HTTP 500 is retried");
+  Check(retryable(CURLE_OK, 429, "", ""), "HTTP 429 is retried");
+  Check(!retryable(CURLE_OK, 404, "NoSuchKey", ""), "NoSuchKey is final");
+  Check(!retryable(CURLE_OK, 403, "AccessDenied", ""),
+        "AccessDenied is final");
+  Check(!retryable(CURLE_OK, 403, "RequestTimeTooSkewed", ""),
+        "RequestTimeTooSkewed is final");
+}
+
+void Backoff() {
+  minio::s3::RetryPolicy policy;
+  policy.base_delay = std::chrono::milliseconds(100);
+  policy.max_delay = std::chrono::milliseconds(1000);
+
+  for (unsigned int retry = 1; retry <= 8; retry++) {
+    long long cap = std::min(100LL << (retry - 1), 1000LL);
+    long long highest = 0;
+    bool within = true;
+    for (int i = 0; i < 2000; i++) {
+      long long delay = policy.Backoff(retry).count();
+      within = within && delay >= 0 && delay <= cap;
+      highest = std::max(highest, delay);
+    }
+    Check(within, "backoff of retry " + std::to_string(retry) +
+                      " is within 0.." + std::to_string(cap) + "ms");
+    Check(highest >= cap * 9 / 10, "backoff of retry " +
+                                       std::to_string(retry) +
+                                       " reaches near " + std::to_string(cap) +
+                                       "ms; got " + std::to_string(highest));
+  }
+}
+
+minio::s3::RetryPolicy fastPolicy() {
+  minio::s3::RetryPolicy policy;
+  policy.max_retries = 5;
+  policy.base_delay = std::chrono::milliseconds(1);
+  policy.max_delay = std::chrono::milliseconds(5);
+  return policy;
+}
+
+void PutObject(minio::s3::Client& client, std::string object,
+               std::string& content) {
+  std::stringstream stream(content);
+  minio::s3::PutObjectArgs args(stream, content.size(), 0);
+  args.bucket = kBucket;
+  args.object = object;
+  minio::s3::PutObjectResponse resp = client.PutObject(args);
+  Check(resp, "PutObject(): " + resp.Error().String());
+}
+
+// GetObject downloads object; offset and length are used if length is not
+// zero.
+minio::s3::GetObjectResponse GetObject(minio::s3::Client& client,
+                                       std::string object, std::string& got,
+                                       size_t offset = 0, size_t length = 0,
+                                       std::function<void()> first = NULL) {
+  got.clear();
+  minio::s3::GetObjectArgs args;
+  args.bucket = kBucket;
+  args.object = object;
+  if (length > 0) {
+    args.offset = &offset;
+    args.length = &length;
+  }
+  args.datafunc = [&](minio::http::DataFunctionArgs args) -> bool {
+    if (got.empty() && first != NULL) first();
+    got.append(args.datachunk);
+    return true;
+  };
+  return client.GetObject(args);
+}
+
+void Retries(minio::s3::Client& client, minio::mock::Server& server) {
+  minio::s3::RetryMetrics& metrics = client.GetRetryMetrics();
+  std::string content = data(1000);
+
+  Counts start(metrics);
+  server.FailNext(2);
+  PutObject(client, "retried", content);
+  Counts now(metrics);
+  Check(now.Since(start) == "3 attempts, 2 retries, 0 resumes, 0 exhausted",
+        "two failures are retried; got " + now.Since(start));
+
+  start = Counts(metrics);
+  server.FailNext(6);
+  std::stringstream stream(content);
+  minio::s3::PutObjectArgs args(stream, content.size(), 0);
+  args.bucket = kBucket;
+  args.object = "exhausted";
+  minio::s3::PutObjectResponse resp = client.PutObject(args);
+  now = Counts(metrics);
+  Check(!resp && resp.code == "SlowDown",
+        "error of last attempt is returned; got " + resp.Error().String());
+  Check(now.Since(start) == "6 attempts, 5 retries, 0 resumes, 1 exhausted",
+        "retries are exhausted after max_retries; got " + now.Since(start));
+
+  start = Counts(metrics);
+  std::string got;
+  minio::s3::GetObjectResponse get_resp = GetObject(client, "missing", got);
+  now = Counts(metrics);
+  Check(!get_resp && get_resp.code == "NoSuchKey", "NoSuchKey is returned");
+  Check(now.Since(start) == "1 attempts, 0 retries, 0 resumes, 0 exhausted",
+        "NoSuchKey is not retried; got " + now.Since(start));
+}
+
+void Resume(minio::s3::Client& client, minio::mock::Server& server) {
+  minio::s3::RetryMetrics& metrics = client.GetRetryMetrics();
+  std::string content = data(3 * 1024 * 1024 + 17);
+  PutObject(client, "resume", content);
+
+  Counts start(metrics);
+  server.DropNext(2);
+  std::string got;
+  minio::s3::GetObjectResponse resp = GetObject(client, "resume", got);
+  Counts now(metrics);
+  Check(resp, "GetObject() with cut downloads: " + resp.Error().String());
+  Check(got == content, "resumed download is byte-exact; got " +
+                            std::to_string(got.size()) + " bytes");
+  Check(now.Since(start) == "3 attempts, 2 retries, 2 resumes, 0 exhausted",
+        "cut downloads are resumed; got " + now.Since(start));
+
+  start = Counts(metrics);
+  server.DropNext(1);
+  resp = GetObject(client, "resume", got, 1000001, 1500000);
+  now = Counts(metrics);
+  Check(resp && got == content.substr(1000001, 1500000),
+        "resumed range download is byte-exact");
+  Check(now.Since(start) == "2 attempts, 1 retries, 1 resumes, 0 exhausted",
+        "cut range download is resumed; got " + now.Since(start));
+}
+
+void ResumeChanged(minio::s3::Client& client, minio::s3::Client& other,
+                   minio::mock::Server& server) {
+  std::string content = data(1024 * 1024);
+  PutObject(client, "changed", content);
+  std::string changed = data(2 * 1024 * 1024);
+
+  // The object is replaced while its download is cut off; the resumed
+  // request must not return bytes of the new version.
+  server.DropNext(1);
+  std::string got;
+  minio::s3::GetObjectResponse resp =
+      GetObject(client, "changed", got, 0, 0,
+                [&]() { PutObject(other, "changed", changed); });
+  Check(!resp && resp.code == "PreconditionFailed",
+        "resume of a replaced object fails; got " + resp.Error().String());
+  Check(got.size() < content.size() &&
+            got == content.substr(0, got.size()),
+        "only bytes of the first version are delivered");
+}
+
+void ConnectionRefused() {
+  // Port of a stopped server refuses connections.
+  minio::mock::Server stopped;
+  if (minio::error::Error err = stopped.Start()) {
+    Check(false, "unable to start mock server; " + err.String());
+    return;
+  }
+  std::string endpoint = stopped.Endpoint();
+  stopped.Stop();
+
+  minio::s3::BaseUrl base_url(endpoint, false);
+  minio::creds::StaticProvider provider("minioadmin", "minioadmin");
+  minio::s3::Client client(base_url, &provider);
+  client.SetRetryPolicy(fastPolicy());
+
+  minio::s3::ListBucketsResponse resp = client.ListBuckets();
+  minio::s3::RetryMetrics& metrics = client.GetRetryMetrics();
+  Check(!resp, "ListBuckets() of stopped server fails");
+  Check(metrics.attempts == 6 && metrics.retries == 5 &&
+            metrics.exhausted == 1,
+        "refused connections are retried; got " +
+            std::to_string(metrics.attempts) + " attempts");
+}
+}  // namespace
+
+int main() {
+  IsRetryable();
+  Backoff();
+
+  minio::mock::Server server;
+  if (minio::error::Error err = server.Start()) {
+    std::cerr << "unable to start mock server; " << err.String() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  minio::s3::BaseUrl base_url(server.Endpoint(), false);
+  minio::creds::StaticProvider provider("minioadmin", "minioadmin");
+  minio::s3::Client client(base_url, &provider);
+  client.SetRetryPolicy(fastPolicy());
+  minio::s3::Client other(base_url, &provider);
+
+  minio::s3::MakeBucketArgs args;
+  args.bucket = kBucket;
+  minio::s3::MakeBucketResponse resp = client.MakeBucket(args);
+  if (!resp) {
+    std::cerr << "MakeBucket(): " << resp.Error().String() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Retries(client, server);
+  Resume(client, server);
+  ResumeChanged(client, other, server);
+  ConnectionRefused();
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
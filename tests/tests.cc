@@ -137,9 +137,11 @@ class Tests {
     }
   }
 
-  void RemoveObjects(std::list<std::string> objects) {
+  void RemoveObjects(std::list<std::string> objects,
+                     unsigned int concurrency = 1) {
     minio::s3::RemoveObjectsArgs args;
     args.bucket = bucket_name_;
+    args.concurrency = concurrency;
 
     std::list<minio::s3::DeleteObject> delete_objects;
     for (auto& object : objects) {
@@ -311,29 +313,35 @@ class Tests {
     }
 
     try {
-      std::string filename = RandObjectName();
-      minio::s3::DownloadObjectArgs args;
-      args.bucket = bucket_name_;
-      args.object = object_name;
-      args.filename = filename;
-      minio::s3::DownloadObjectResponse resp = client_.DownloadObject(args);
-      if (!resp) {
-        throw std::runtime_error("DownloadObject(): " + resp.Error().String());
-      }
-
-      std::ifstream file(filename);
-      file.seekg(0, std::ios::end);
-      size_t length = file.tellg();
-      file.seekg(0, std::ios::beg);
-      char* buf = new char[length];
-      file.read(buf, length);
-      file.close();
+      for (auto engine :
+           {minio::fileio::Engine::kSync, minio::fileio::Engine::kThreaded,
+            minio::fileio::Engine::kIoUring}) {
+        std::string filename = RandObjectName();
+        minio::s3::DownloadObjectArgs args;
+        args.bucket = bucket_name_;
+        args.object = object_name;
+        args.filename = filename;
+        args.io_engine = engine;
+        minio::s3::DownloadObjectResponse resp = client_.DownloadObject(args);
+        if (!resp) {
+          throw std::runtime_error("DownloadObject(): " +
+                                   resp.Error().String());
+        }
 
-      if (data != std::string(buf, length)) {
-        throw std::runtime_error("DownloadObject(): expected: " + data +
-                                 "; got: " + buf);
+        std::ifstream file(filename);
+        file.seekg(0, std::ios::end);
+        size_t length = file.tellg();
+        file.seekg(0, std::ios::beg);
+        char* buf = new char[length];
+        file.read(buf, length);
+        file.close();
+
+        if (data != std::string(buf, length)) {
+          throw std::runtime_error("DownloadObject(): expected: " + data +
+                                   "; got: " + buf);
+        }
+        std::filesystem::remove(filename);
       }
-      std::filesystem::remove(filename);
       RemoveObject(bucket_name_, object_name);
     } catch (const std::runtime_error& err) {
       RemoveObject(bucket_name_, object_name);
@@ -399,25 +407,30 @@ class Tests {
         object_names.push_back(object_name);
       }
 
-      int c = 0;
-      minio::s3::ListObjectsArgs args;
-      args.bucket = bucket_name_;
-      minio::s3::ListObjectsResult result = client_.ListObjects(args);
-      for (; result; result++) {
-        minio::s3::Item item = *result;
-        if (!item) {
-          throw std::runtime_error("ListObjects(): " + item.Error().String());
-        }
-        if (std::find(object_names.begin(), object_names.end(), item.name) !=
-            object_names.end()) {
-          c++;
+      // A page of one object makes the result fetch later pages itself.
+      for (unsigned int max_keys : {1000, 1}) {
+        int c = 0;
+        minio::s3::ListObjectsArgs args;
+        args.bucket = bucket_name_;
+        args.max_keys = max_keys;
+        minio::s3::ListObjectsResult result = client_.ListObjects(args);
+        for (; result; result++) {
+          minio::s3::Item item = *result;
+          if (!item) {
+            throw std::runtime_error("ListObjects(): " +
+                                     item.Error().String());
+          }
+          if (std::find(object_names.begin(), object_names.end(),
+                        item.name) != object_names.end()) {
+            c++;
+          }
         }
-      }
 
-      if (c != object_names.size()) {
-        throw std::runtime_error(
-            "ListObjects(): expected: " + std::to_string(object_names.size()) +
-            "; got: " + std::to_string(c));
+        if (c != object_names.size()) {
+          throw std::runtime_error("ListObjects(): expected: " +
+                                   std::to_string(object_names.size()) +
+                                   "; got: " + std::to_string(c));
+        }
       }
       RemoveObjects(object_names);
     } catch (const std::runtime_error& err) {
@@ -504,41 +517,173 @@ class Tests {
     file << data;
     file.close();
 
-    std::string object_name = RandObjectName();
-    minio::s3::UploadObjectArgs args;
-    args.bucket = bucket_name_;
-    args.object = object_name;
-    args.filename = filename;
-    minio::s3::UploadObjectResponse resp = client_.UploadObject(args);
-    if (!resp) {
-      throw std::runtime_error("UploadObject(): " + resp.Error().String());
+    for (auto engine :
+         {minio::fileio::Engine::kSync, minio::fileio::Engine::kThreaded,
+          minio::fileio::Engine::kIoUring}) {
+      std::string object_name = RandObjectName();
+      minio::s3::UploadObjectArgs args;
+      args.bucket = bucket_name_;
+      args.object = object_name;
+      args.filename = filename;
+      args.io_engine = engine;
+      minio::s3::UploadObjectResponse resp = client_.UploadObject(args);
+      if (!resp) {
+        throw std::runtime_error("UploadObject(): " + resp.Error().String());
+      }
+      RemoveObject(bucket_name_, object_name);
     }
     std::filesystem::remove(filename);
-    RemoveObject(bucket_name_, object_name);
   }
 
   void RemoveObjects() {
     std::cout << "RemoveObjects()" << std::endl;
 
+    for (unsigned int concurrency : {1, 4}) {
+      std::list<std::string> object_names;
+      try {
+        for (int i = 0; i < 3; i++) {
+          std::string object_name = RandObjectName();
+          std::stringstream ss;
+          minio::s3::PutObjectArgs args(ss, 0, 0);
+          args.bucket = bucket_name_;
+          args.object = object_name;
+          minio::s3::PutObjectResponse resp = client_.PutObject(args);
+          if (!resp) {
+            throw std::runtime_error("PutObject(): " + resp.Error().String());
+          }
+          object_names.push_back(object_name);
+        }
+        RemoveObjects(object_names, concurrency);
+      } catch (const std::runtime_error& err) {
+        RemoveObjects(object_names);
+        throw err;
+      }
+    }
+  }
+
+  void RemovePrefix() {
+    std::cout << "RemovePrefix()" << std::endl;
+
+    std::string prefix = RandObjectName() + "/";
     std::list<std::string> object_names;
     try {
       for (int i = 0; i < 3; i++) {
-        std::string object_name = RandObjectName();
+        std::string object_name = prefix + RandObjectName();
         std::stringstream ss;
         minio::s3::PutObjectArgs args(ss, 0, 0);
         args.bucket = bucket_name_;
         args.object = object_name;
         minio::s3::PutObjectResponse resp = client_.PutObject(args);
-        if (!resp) std::runtime_error("PutObject(): " + resp.Error().String());
+        if (!resp) {
+          throw std::runtime_error("PutObject(): " + resp.Error().String());
+        }
         object_names.push_back(object_name);
       }
-      RemoveObjects(object_names);
+
+      minio::s3::RemoveObjectsProgress progress;
+      minio::s3::RemovePrefixArgs args;
+      args.bucket = bucket_name_;
+      args.prefix = prefix;
+      args.progressfunc = [&progress = progress](
+                              minio::s3::RemoveObjectsProgress p) {
+        progress = p;
+      };
+      minio::s3::RemoveObjectsResult result = client_.RemovePrefix(args);
+      for (; result; result++) {
+        minio::s3::DeleteError err = *result;
+        std::string msg = err ? err.object_name : err.Error().String();
+        throw std::runtime_error("RemovePrefix(): " + msg);
+      }
+
+      if (progress.removed != object_names.size()) {
+        throw std::runtime_error(
+            "RemovePrefix(): expected: " +
+            std::to_string(object_names.size()) +
+            "; got: " + std::to_string(progress.removed));
+      }
     } catch (const std::runtime_error& err) {
       RemoveObjects(object_names);
       throw err;
     }
   }
 
+  void RemovePrefixVersions() {
+    std::cout << "RemovePrefixVersions()" << std::endl;
+
+    std::string bucket_name = RandBucketName();
+    MakeBucket(bucket_name);
+
+    std::string prefix = RandObjectName() + "/";
+    std::string object_name = prefix + RandObjectName();
+    minio::s3::RemovePrefixArgs args;
+    args.bucket = bucket_name;
+    args.prefix = prefix;
+    args.include_versions = true;
+    try {
+      minio::s3::SetBucketVersioningArgs versioning_args;
+      versioning_args.bucket = bucket_name;
+      versioning_args.status = minio::s3::Boolean(true);
+      minio::s3::SetBucketVersioningResponse versioning_resp =
+          client_.SetBucketVersioning(versioning_args);
+      if (!versioning_resp) {
+        throw std::runtime_error("SetBucketVersioning(): " +
+                                 versioning_resp.Error().String());
+      }
+
+      // Three versions and a delete marker.
+      for (int i = 0; i < 3; i++) {
+        std::stringstream ss("version " + std::to_string(i));
+        minio::s3::PutObjectArgs put_args(ss, ss.str().length(), 0);
+        put_args.bucket = bucket_name;
+        put_args.object = object_name;
+        minio::s3::PutObjectResponse resp = client_.PutObject(put_args);
+        if (!resp) {
+          throw std::runtime_error("PutObject(): " + resp.Error().String());
+        }
+      }
+      RemoveObject(bucket_name, object_name);
+
+      minio::s3::RemoveObjectsProgress progress;
+      args.progressfunc = [&progress = progress](
+                              minio::s3::RemoveObjectsProgress p) {
+        progress = p;
+      };
+      minio::s3::RemoveObjectsResult result = client_.RemovePrefix(args);
+      for (; result; result++) {
+        minio::s3::DeleteError err = *result;
+        std::string msg = err ? err.object_name + "?versionId=" +
+                                    err.version_id
+                              : err.Error().String();
+        throw std::runtime_error("RemovePrefix(): " + msg);
+      }
+      if (progress.removed != 4) {
+        throw std::runtime_error(
+            "RemovePrefix(): expected: 4; got: " +
+            std::to_string(progress.removed));
+      }
+
+      minio::s3::ListObjectsArgs list_args;
+      list_args.bucket = bucket_name;
+      list_args.prefix = prefix;
+      list_args.include_versions = true;
+      minio::s3::ListObjectsResult list = client_.ListObjects(list_args);
+      if (list) {
+        minio::s3::Item item = *list;
+        std::string msg = item ? item.name + "?versionId=" + item.version_id
+                               : item.Error().String();
+        throw std::runtime_error("RemovePrefix(): left " + msg);
+      }
+    } catch (const std::runtime_error& err) {
+      args.progressfunc = NULL;
+      minio::s3::RemoveObjectsResult result = client_.RemovePrefix(args);
+      for (; result; result++) {
+      }
+      RemoveBucket(bucket_name);
+      throw err;
+    }
+    RemoveBucket(bucket_name);
+  }
+
   void SelectObjectContent() {
     std::cout << "SelectObjectContent()" << std::endl;
 
@@ -717,6 +862,8 @@ int main(int argc, char* argv[]) {
   tests.CopyObject();
   tests.UploadObject();
   tests.RemoveObjects();
+  tests.RemovePrefix();
+  tests.RemovePrefixVersions();
   tests.SelectObjectContent();
   tests.ListenBucketNotification();
 
@@ -0,0 +1,235 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// trace checks which spans RingBufferSink keeps, in which order, and how it
+// wraps around, and that TraceReader reads back every field TraceRecorder
+// wrote. Files are created in the current directory. No server is needed.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "trace.h"
+
+namespace {
+using minio::s3::RingBufferSink;
+using minio::s3::Span;
+using minio::s3::TraceRecord;
+
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+Span span(unsigned int attempt, long long total_ms) {
+  Span span;
+  span.api = "GetObject";
+  span.attempt = attempt;
+  span.total = std::chrono::milliseconds(total_ms);
+  return span;
+}
+
+// attempts returns attempts of spans as "1,2,3".
+std::string attempts(std::vector<Span> spans) {
+  std::string value;
+  for (auto& span : spans) {
+    value += (value.empty() ? "" : ",") + std::to_string(span.attempt);
+  }
+  return value;
+}
+
+void Keep() {
+  RingBufferSink none(10, 0, std::chrono::milliseconds(100));
+  none.Export(span(1, 99));
+  none.Export(span(2, 100));
+  none.Export(span(3, 5000));
+  Check(attempts(none.Spans()) == "2,3",
+        "without sampling only slow spans are kept; got " +
+            attempts(none.Spans()));
+
+  RingBufferSink all(10, 1, std::chrono::milliseconds(100));
+  for (unsigned int i = 1; i <= 5; i++) all.Export(span(i, 1));
+  Check(attempts(all.Spans()) == "1,2,3,4,5",
+        "sample rate 1 keeps every span");
+}
+
+void Sample() {
+  // 20000 spans sampled at 0.25 keep 5000 on average, with a standard
+  // deviation of about 61.
+  RingBufferSink sink(100000, 0.25, std::chrono::seconds(1));
+  for (unsigned int i = 0; i < 20000; i++) sink.Export(span(i, 1));
+  std::vector<Span> spans = sink.Spans();
+  Check(spans.size() > 4600 && spans.size() < 5400,
+        "sample rate 0.25 keeps a quarter; got " +
+            std::to_string(spans.size()));
+  bool ordered = true;
+  for (size_t i = 1; i < spans.size(); i++) {
+    ordered = ordered && spans[i - 1].attempt < spans[i].attempt;
+  }
+  Check(ordered, "sampled spans are kept in export order");
+}
+
+void Wrap() {
+  RingBufferSink sink(3, 1, std::chrono::seconds(1));
+  sink.Export(span(1, 1));
+  sink.Export(span(2, 1));
+  Check(attempts(sink.Spans()) == "1,2", "partly filled ring");
+  sink.Export(span(3, 1));
+  Check(attempts(sink.Spans()) == "1,2,3", "full ring");
+  sink.Export(span(4, 1));
+  sink.Export(span(5, 1));
+  Check(attempts(sink.Spans()) == "3,4,5",
+        "wrapped ring keeps last spans, oldest first; got " +
+            attempts(sink.Spans()));
+  for (unsigned int i = 6; i <= 9; i++) sink.Export(span(i, 1));
+  Check(attempts(sink.Spans()) == "7,8,9", "ring wraps again");
+
+  sink.Clear();
+  Check(sink.Spans().empty(), "Clear() drops spans");
+  sink.Export(span(10, 1));
+  Check(attempts(sink.Spans()) == "10", "ring refills from start");
+
+  RingBufferSink zero(0, 1, std::chrono::seconds(1));
+  zero.Export(span(1, 1));
+  zero.Export(span(2, 1));
+  Check(attempts(zero.Spans()) == "2", "capacity zero keeps one span");
+}
+
+TraceRecord record(std::string api, std::string bucket, std::string key,
+                   minio::http::Method method, long long start_us) {
+  TraceRecord record;
+  record.api = api;
+  record.bucket = bucket;
+  record.key_hash = key.empty() ? 0 : minio::s3::TraceRecorder::KeyHash(key);
+  record.method = method;
+  record.start = std::chrono::system_clock::now() +
+                 std::chrono::microseconds(start_us);
+  return record;
+}
+
+// same returns whether got is want as recorded; start is kept in whole
+// microseconds since the recorder was opened, so it may read back up to
+// 2us early.
+bool same(const TraceRecord& got, const TraceRecord& want) {
+  auto early = want.start - got.start;
+  return got.api == want.api && got.bucket == want.bucket &&
+         got.key_hash == want.key_hash && got.method == want.method &&
+         got.attempt == want.attempt && got.status_code == want.status_code &&
+         got.request_bytes == want.request_bytes &&
+         got.response_bytes == want.response_bytes &&
+         early >= std::chrono::microseconds(0) &&
+         early < std::chrono::microseconds(2) &&
+         got.duration == want.duration;
+}
+
+void RoundTrip() {
+  std::string filename = "trace.test";
+  minio::s3::TraceRecorder recorder;
+  if (minio::error::Error err = recorder.Open(filename)) {
+    Check(false, "unable to open recorder; " + err.String());
+    return;
+  }
+
+  // Records start after the recorder is opened.
+  std::vector<TraceRecord> records;
+  records.push_back(record("PutObject", "bucket", "a/b.txt",
+                           minio::http::Method::kPut, 10));
+  records.back().request_bytes = 5ULL << 30;
+  records.back().status_code = 200;
+  records.back().duration = std::chrono::microseconds(1234567);
+
+  // Names are written once; later records refer to them.
+  records.push_back(record("PutObject", "other", "a/b.txt",
+                           minio::http::Method::kPut, 20));
+  records.back().attempt = 3;
+  records.back().status_code = 503;
+  records.push_back(record("ListBuckets", "", "", minio::http::Method::kGet,
+                           3600LL * 1000000));
+  records.back().response_bytes = 300;
+  records.back().duration = std::chrono::microseconds(1);
+  records.push_back(record("HeadObject", "bucket", "~",
+                           minio::http::Method::kHead, 30));
+  records.back().key_hash = ~0ULL;
+
+  for (auto& record : records) recorder.Record(record);
+  recorder.Close();
+
+  minio::s3::TraceReader reader;
+  if (minio::error::Error err = reader.Open(filename)) {
+    Check(false, "unable to open reader; " + err.String());
+    std::remove(filename.c_str());
+    return;
+  }
+  TraceRecord got;
+  for (size_t i = 0; i < records.size(); i++) {
+    if (!reader.Next(got)) {
+      Check(false, "record " + std::to_string(i) + " is missing");
+      break;
+    }
+    Check(same(got, records[i]),
+          "record " + std::to_string(i) + " reads back as written");
+  }
+  Check(!reader.Next(got), "trace ends after last record");
+  std::remove(filename.c_str());
+}
+
+void LongName() {
+  std::string filename = "trace.test";
+  {
+    // Header of version 1 starting at zero, then a name of 2^48 bytes.
+    std::ofstream file(filename, std::ios::binary);
+    file.write("MTRC\x01\x00\x00\x80\x80\x80\x80\x80\x80\x40", 14);
+  }
+  minio::s3::TraceReader reader;
+  TraceRecord got;
+  Check(!reader.Open(filename) && !reader.Next(got),
+        "huge name length is refused");
+
+  minio::s3::TraceRecorder recorder;
+  TraceRecord long_name = record(std::string(5000, 'x'), "bucket", "",
+                                 minio::http::Method::kGet, 0);
+  if (!recorder.Open(filename)) {
+    recorder.Record(long_name);
+    recorder.Close();
+  }
+  minio::s3::TraceReader cut;
+  Check(!cut.Open(filename) && cut.Next(got) &&
+            got.api == std::string(1024, 'x') && got.bucket == "bucket",
+        "long names are cut when recorded");
+  std::remove(filename.c_str());
+}
+}  // namespace
+
+int main() {
+  Keep();
+  Sample();
+  Wrap();
+  RoundTrip();
+  LongName();
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,436 @@
+// MinIO C++ Library for Amazon S3 Compatible Cloud Storage
+// Copyright 2022 MinIO, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// xml checks decoding of fixed response bodies by xml::Reader and the
+// ParseXML functions of responses, and escaping of request bodies by
+// xml::Writer. No server is needed.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "credentials.h"
+#include "response.h"
+#include "utils.h"
+#include "xml.h"
+
+namespace {
+using Token = minio::xml::Reader::Token;
+
+unsigned int failures = 0;
+
+void Check(bool ok, std::string what) {
+  if (ok) return;
+  std::cerr << "FAILED: " << what << std::endl;
+  failures++;
+}
+
+// tokens returns tokens of data as "<path", ">path=text", "eof" or "error".
+std::vector<std::string> tokens(std::string_view data) {
+  std::vector<std::string> result;
+  minio::xml::Reader reader(data);
+  while (true) {
+    switch (reader.Next()) {
+      case Token::kStart:
+        result.push_back("<" + std::string(reader.Path()));
+        break;
+      case Token::kEnd:
+        result.push_back(">" + std::string(reader.Path()) + "=" +
+                         std::string(reader.Text()));
+        break;
+      case Token::kEof:
+        result.push_back("eof");
+        return result;
+      default:
+        result.push_back("error");
+        return result;
+    }
+  }
+}
+
+void ReaderEntities() {
+  std::vector<std::string> got = tokens(
+      "<?xml version=\"1.0\"?><a>&lt;&gt;&amp;&quot;&apos;&#65;&#x42;&#x20AC;"
+      "&unknown; &#xZZ;</a>");
+  Check(got == std::vector<std::string>{"<a",
+                                        ">a=<>&\"'AB\xE2\x82\xAC&unknown; "
+                                        "&#xZZ;",
+                                        "eof"},
+        "entity references are decoded");
+}
+
+void ReaderCdata() {
+  std::vector<std::string> got =
+      tokens("<a><![CDATA[x<y&amp;]]>&amp;z<![CDATA[]]]]><![CDATA[>]]></a>");
+  Check(got == std::vector<std::string>{"<a", ">a=x<y&amp;&z]]>", "eof"},
+        "CDATA is kept literally and joined with text");
+
+  got = tokens("<a><!-- <b> --><b><![CDATA[ ]]></b></a>");
+  Check(got == std::vector<std::string>{"<a", "<a/b", ">a/b= ", ">a=", "eof"},
+        "CDATA whitespace is kept and comments are skipped");
+}
+
+void ReaderEmptyElement() {
+  std::vector<std::string> got =
+      tokens("<a x=\"/>\"><b/><c k='v' /><d></d><e>  </e></a>");
+  Check(got == std::vector<std::string>{"<a", "<a/b", ">a/b=", "<a/c",
+                                        ">a/c=", "<a/d", ">a/d=", "<a/e",
+                                        ">a/e=", ">a=", "eof"},
+        "empty elements are read as start and end tags");
+}
+
+void ReaderMismatchedTags() {
+  Check(tokens("<a><b></a></b>") ==
+            std::vector<std::string>{"<a", "<a/b", "error"},
+        "mismatched end tag is an error");
+  Check(tokens("<a><b></b>") ==
+            std::vector<std::string>{"<a", "<a/b", ">a/b=", "error"},
+        "unterminated document is an error");
+  Check(tokens("<a></a></b>") ==
+            std::vector<std::string>{"<a", ">a=", "error"},
+        "end tag without start tag is an error");
+
+  minio::s3::ListObjectsResponse resp =
+      minio::s3::ListObjectsResponse::ParseXML(
+          "<ListBucketResult><Contents><Key>a</Contents></Key>"
+          "</ListBucketResult>",
+          false);
+  Check(!resp, "ListObjects with mismatched tags fails");
+}
+
+void ListObjectsEncodingType() {
+  minio::s3::ListObjectsResponse resp =
+      minio::s3::ListObjectsResponse::ParseXML(
+          "<ListBucketResult><Name>bucket</Name><Prefix>dir%2F</Prefix>"
+          "<KeyCount>2</KeyCount><MaxKeys>1000</MaxKeys>"
+          "<IsTruncated>false</IsTruncated>"
+          "<Contents><Key>dir%2Fa%20b%26c</Key><Size>5</Size>"
+          "<ETag>&quot;abc&quot;</ETag></Contents>"
+          "<CommonPrefixes><Prefix>dir%2Fsub%2F</Prefix></CommonPrefixes>"
+          "<EncodingType>url</EncodingType></ListBucketResult>",
+          false);
+  Check(resp, "ListObjects decodes");
+  Check(resp.encoding_type == "url", "EncodingType after Contents is read");
+  Check(resp.prefix == "dir/", "prefix is URL decoded");
+  Check(resp.key_count == 2 && resp.max_keys == 1000 && !resp.is_truncated,
+        "ListObjects counters");
+  Check(resp.contents.size() == 2, "contents and prefixes are listed");
+  if (resp.contents.size() != 2) return;
+  minio::s3::Item& item = resp.contents.front();
+  Check(item.name == "dir/a b&c", "key before EncodingType is URL decoded");
+  Check(item.etag == "abc" && item.size == 5, "ETag and size of item");
+  Check(resp.contents.back().name == "dir/sub/" &&
+            resp.contents.back().is_prefix,
+        "common prefix is URL decoded");
+}
+
+void ListObjectVersions() {
+  minio::s3::ListObjectsResponse resp =
+      minio::s3::ListObjectsResponse::ParseXML(
+          "<ListVersionsResult><IsTruncated>true</IsTruncated>"
+          "<NextKeyMarker>b</NextKeyMarker>"
+          "<NextVersionIdMarker>v3</NextVersionIdMarker>"
+          "<Version><Key>a</Key><VersionId>v1</VersionId>"
+          "<IsLatest>true</IsLatest></Version>"
+          "<DeleteMarker><Key>b</Key><VersionId>v3</VersionId>"
+          "<IsLatest>true</IsLatest></DeleteMarker>"
+          "<Version><Key>b</Key><VersionId>v2</VersionId>"
+          "<IsLatest>false</IsLatest></Version></ListVersionsResult>",
+          true);
+  Check(resp, "ListObjectVersions decodes");
+  Check(resp.is_truncated && resp.next_key_marker == "b" &&
+            resp.next_version_id_marker == "v3",
+        "version markers");
+  std::vector<std::string> got;
+  for (auto& item : resp.contents) {
+    got.push_back(item.name + "/" + item.version_id +
+                  (item.is_latest ? "/latest" : "") +
+                  (item.is_delete_marker ? "/marker" : ""));
+  }
+  Check(got == std::vector<std::string>{"a/v1/latest", "b/v2",
+                                        "b/v3/latest/marker"},
+        "versions and delete markers");
+}
+
+void NotificationEvents() {
+  minio::s3::GetBucketNotificationResponse resp =
+      minio::s3::GetBucketNotificationResponse::ParseXML(
+          "<NotificationConfiguration><QueueConfiguration><Id>1</Id>"
+          "<Queue>arn:minio:sqs::1:webhook</Queue>"
+          "<Event>s3:ObjectCreated:*</Event>"
+          "<Event>s3:ObjectRemoved:*</Event>"
+          "<Filter><S3Key><FilterRule><Name>prefix</Name>"
+          "<Value>images/</Value></FilterRule><FilterRule><Name>suffix</Name>"
+          "<Value>.jpg</Value></FilterRule></S3Key></Filter>"
+          "</QueueConfiguration></NotificationConfiguration>");
+  Check(resp, "GetBucketNotification decodes");
+  Check(resp.config.queue_config_list.size() == 1, "one queue config");
+  if (resp.config.queue_config_list.empty()) return;
+  minio::s3::QueueConfig& config = resp.config.queue_config_list.front();
+  Check(config.id == "1" && config.queue == "arn:minio:sqs::1:webhook",
+        "queue config id and ARN");
+  Check(config.events == std::list<std::string>{"s3:ObjectCreated:*",
+                                                "s3:ObjectRemoved:*"},
+        "notification events");
+  Check(config.prefix_filter_rule &&
+            config.prefix_filter_rule.Value() == "images/" &&
+            config.suffix_filter_rule &&
+            config.suffix_filter_rule.Value() == ".jpg",
+        "notification filter rules");
+}
+
+void ReplicationConfig() {
+  minio::s3::GetBucketReplicationResponse resp =
+      minio::s3::GetBucketReplicationResponse::ParseXML(
+          "<ReplicationConfiguration><Role>arn:role</Role><Rule><ID>r1</ID>"
+          "<Status>Enabled</Status><Priority>2</Priority>"
+          "<Filter><And><Prefix>docs/</Prefix>"
+          "<Tag><Key>k1</Key><Value>v1</Value></Tag>"
+          "<Tag><Key>k2</Key><Value>v2</Value></Tag></And></Filter>"
+          "<Destination><Bucket>arn:aws:s3:::dest</Bucket>"
+          "<ReplicationTime><Status>Enabled</Status>"
+          "<Time><Minutes>20</Minutes></Time></ReplicationTime>"
+          "</Destination></Rule><Rule><ID>r2</ID><Status>Disabled</Status>"
+          "<Filter><Tag><Key>k</Key><Value>v</Value></Tag></Filter>"
+          "<Destination><Bucket>arn:aws:s3:::dest</Bucket></Destination>"
+          "</Rule></ReplicationConfiguration>");
+  Check(resp, "GetBucketReplication decodes");
+  Check(resp.config.role == "arn:role" && resp.config.rules.size() == 2,
+        "replication role and rules");
+  if (resp.config.rules.size() != 2) return;
+
+  minio::s3::ReplicationRule& rule = resp.config.rules.front();
+  Check(rule.id == "r1" && rule.status && rule.priority &&
+            rule.priority.Get() == 2,
+        "replication rule ID, status and priority");
+  Check(rule.filter.and_operator.prefix &&
+            rule.filter.and_operator.prefix.Get() == "docs/",
+        "replication And/Prefix");
+  Check(rule.filter.and_operator.tags ==
+            std::map<std::string, std::string>{{"k1", "v1"}, {"k2", "v2"}},
+        "replication And/Tag");
+  minio::s3::ReplicationTime& time = rule.destination.replication_time;
+  Check(time && time.status && time.time_minutes == 20,
+        "replication time minutes and status");
+
+  minio::s3::ReplicationRule& tag_rule = resp.config.rules.back();
+  Check(!tag_rule.status && !tag_rule.filter.and_operator &&
+            tag_rule.filter.tag.key == "k" && tag_rule.filter.tag.value == "v",
+        "replication Filter/Tag");
+  Check(!tag_rule.destination.replication_time,
+        "replication time is optional");
+}
+
+void LifecycleConfig() {
+  minio::s3::GetBucketLifecycleResponse resp =
+      minio::s3::GetBucketLifecycleResponse::ParseXML(
+          "<LifecycleConfiguration><Rule><ID>l1</ID><Status>Enabled</Status>"
+          "<Filter><Tag><Key>k</Key><Value>v</Value></Tag></Filter>"
+          "<Expiration><ExpiredObjectDeleteMarker>false"
+          "</ExpiredObjectDeleteMarker></Expiration></Rule>"
+          "<Rule><ID>l2</ID><Status>Disabled</Status><Filter><And>"
+          "<Prefix>logs/</Prefix><Tag><Key>a</Key><Value>b</Value></Tag>"
+          "</And></Filter><Expiration><Days>30</Days></Expiration></Rule>"
+          "</LifecycleConfiguration>");
+  Check(resp, "GetBucketLifecycle decodes");
+  Check(resp.config.rules.size() == 2, "two lifecycle rules");
+  if (resp.config.rules.size() != 2) return;
+
+  minio::s3::LifecycleRule& rule = resp.config.rules.front();
+  Check(rule.id == "l1" && rule.status, "lifecycle rule ID and status");
+  Check(rule.filter.tag.key == "k" && rule.filter.tag.value == "v",
+        "lifecycle Filter/Tag");
+  Check(rule.expiration_expired_object_delete_marker &&
+            !rule.expiration_expired_object_delete_marker.Get(),
+        "ExpiredObjectDeleteMarker false");
+
+  minio::s3::LifecycleRule& and_rule = resp.config.rules.back();
+  Check(and_rule.id == "l2" && !and_rule.status, "second lifecycle rule");
+  Check(and_rule.filter.and_operator.prefix.Get() == "logs/" &&
+            and_rule.filter.and_operator.tags ==
+                std::map<std::string, std::string>{{"a", "b"}},
+        "lifecycle And/Prefix and And/Tag");
+  Check(and_rule.expiration_days && and_rule.expiration_days.Get() == 30 &&
+            !and_rule.expiration_expired_object_delete_marker,
+        "lifecycle expiration days");
+}
+
+void CompleteMultipartUpload() {
+  minio::s3::CompleteMultipartUploadResponse resp =
+      minio::s3::CompleteMultipartUploadResponse::ParseXML(
+          "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+          "<CompleteMultipartUploadResult "
+          "xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+          "<Location>http://localhost/bucket/a%26b</Location>"
+          "<Bucket>bucket</Bucket><Key>a&amp;b</Key>"
+          "<ETag>&quot;abc-2&quot;</ETag></CompleteMultipartUploadResult>",
+          "v1");
+  Check(resp, "CompleteMultipartUpload decodes");
+  Check(resp.bucket_name == "bucket" && resp.object_name == "a&b",
+        "CompleteMultipartUploadResult bucket and key");
+  Check(resp.location == "http://localhost/bucket/a%26b" &&
+            resp.etag == "abc-2" && resp.version_id == "v1",
+        "CompleteMultipartUploadResult location, ETag and version");
+}
+
+void RemoveObjects() {
+  minio::s3::RemoveObjectsResponse resp =
+      minio::s3::RemoveObjectsResponse::ParseXML(
+          "<DeleteResult><Deleted><Key>a</Key><VersionId>v1</VersionId>"
+          "<DeleteMarker>true</DeleteMarker>"
+          "<DeleteMarkerVersionId>v2</DeleteMarkerVersionId></Deleted>"
+          "<Deleted><Key>b</Key></Deleted>"
+          "<Error><Key>c&lt;d</Key><Code>AccessDenied</Code>"
+          "<Message>Access Denied.</Message></Error></DeleteResult>");
+  Check(resp, "RemoveObjects decodes");
+  Check(resp.objects.size() == 2 && resp.errors.size() == 1,
+        "deleted objects and errors");
+  if (resp.objects.size() != 2 || resp.errors.size() != 1) return;
+  minio::s3::DeletedObject& object = resp.objects.front();
+  Check(object.name == "a" && object.version_id == "v1" &&
+            object.delete_marker && object.delete_marker_version_id == "v2",
+        "deleted object with delete marker");
+  Check(!resp.objects.back().delete_marker, "deleted object without marker");
+  minio::s3::DeleteError& error = resp.errors.front();
+  Check(error.object_name == "c<d" && error.code == "AccessDenied" &&
+            error.message == "Access Denied.",
+        "delete error");
+}
+
+void BucketVersioning() {
+  minio::s3::GetBucketVersioningResponse resp =
+      minio::s3::GetBucketVersioningResponse::ParseXML(
+          "<VersioningConfiguration><Status>Enabled</Status>"
+          "<MFADelete>Disabled</MFADelete></VersioningConfiguration>");
+  Check(resp && resp.status && resp.status.Get() && resp.mfa_delete &&
+            !resp.mfa_delete.Get(),
+        "versioning status and MFA delete");
+
+  resp = minio::s3::GetBucketVersioningResponse::ParseXML(
+      "<VersioningConfiguration/>");
+  Check(resp && !resp.status && !resp.mfa_delete,
+        "versioning was never configured");
+}
+
+void ErrorResponse() {
+  minio::s3::Response resp = minio::s3::Response::ParseXML(
+      "<Error><Code>NoSuchKey</Code>"
+      "<Message>The specified key does not exist: &quot;a&amp;b&quot;"
+      "</Message><Key>a&amp;b</Key><BucketName>bucket</BucketName>"
+      "<RequestId>1</RequestId></Error>",
+      404, {});
+  Check(!resp && resp.code == "NoSuchKey" &&
+            resp.message == "The specified key does not exist: \"a&b\"" &&
+            resp.object_name == "a&b" && resp.bucket_name == "bucket" &&
+            resp.request_id == "1",
+        "error response");
+}
+
+void StsCredentials() {
+  minio::creds::Credentials creds = minio::creds::Credentials::ParseXML(
+      "<AssumeRoleResponse xmlns=\"https://sts.amazonaws.com/doc/2011-06-15/\">"
+      "<AssumeRoleResult><AssumedRoleUser><Arn>arn</Arn></AssumedRoleUser>"
+      "<Credentials><AccessKeyId>access</AccessKeyId>"
+      "<SecretAccessKey>secret&amp;key</SecretAccessKey>"
+      "<SessionToken>token</SessionToken>"
+      "<Expiration>2099-01-01T00:00:00Z</Expiration></Credentials>"
+      "</AssumeRoleResult><ResponseMetadata><RequestId>1</RequestId>"
+      "</ResponseMetadata></AssumeRoleResponse>",
+      "AssumeRoleResult");
+  Check(creds.access_key == "access" && creds.secret_key == "secret&key" &&
+            creds.session_token == "token",
+        "STS credentials under root element");
+  Check(bool(creds), "STS credentials are valid");
+
+  creds = minio::creds::Credentials::ParseXML(
+      "<AssumeRoleResult><Credentials><AccessKeyId>access</AccessKeyId>"
+      "</Credentials></AssumeRoleResult>",
+      "AssumeRoleResult");
+  Check(creds.access_key.empty(), "STS result must be under a root element");
+}
+void WriterEscaping() {
+  std::string key = "a&b<c>d\r\"e'";
+  minio::xml::Writer writer;
+  writer.Start("Delete").Element("Quiet", "true");
+  writer.Start("Object").Element("Key", key).End("Object");
+  writer.End("Delete");
+  minio::xml::Body body = writer.Finish();
+  Check(body.data ==
+            "<Delete><Quiet>true</Quiet><Object>"
+            "<Key>a&amp;b&lt;c&gt;d&#13;\"e'</Key></Object></Delete>",
+        "key is escaped");
+  Check(body.md5sum == minio::utils::Md5sumHash(body.data) &&
+            body.sha256 == minio::utils::Sha256Hash(body.data),
+        "hashes of escaped body");
+
+  std::string value;
+  Check(!minio::xml::Value(body.data, "Delete/Object/Key", value) &&
+            value == key,
+        "escaped key reads back");
+
+  // Hashes are updated in chunks; cover bodies spanning several of them.
+  minio::xml::Writer large(0);
+  large.Start("Delete");
+  for (int i = 0; i < 1000; i++) {
+    large.Start("Object").Element("Key", key + std::to_string(i));
+    large.End("Object");
+  }
+  large.End("Delete");
+  body = large.Finish();
+  Check(body.data.size() > 4 * minio::xml::Writer::kHashChunk &&
+            body.md5sum == minio::utils::Md5sumHash(body.data) &&
+            body.sha256 == minio::utils::Sha256Hash(body.data),
+        "hashes of large escaped body");
+
+  minio::s3::NotificationConfig config;
+  minio::s3::QueueConfig queue;
+  queue.queue = "arn:minio:sqs::1:webhook";
+  queue.events.push_back("s3:ObjectCreated:*");
+  queue.prefix_filter_rule = minio::s3::PrefixFilterRule("a&b<c");
+  config.queue_config_list.push_back(queue);
+  minio::s3::GetBucketNotificationResponse resp =
+      minio::s3::GetBucketNotificationResponse::ParseXML(config.ToXML());
+  Check(resp && resp.config.queue_config_list.size() == 1 &&
+            resp.config.queue_config_list.front().prefix_filter_rule.Value() ==
+                "a&b<c",
+        "escaped filter rule reads back");
+}
+}  // namespace
+
+int main() {
+  ReaderEntities();
+  ReaderCdata();
+  ReaderEmptyElement();
+  ReaderMismatchedTags();
+  ListObjectsEncodingType();
+  ListObjectVersions();
+  NotificationEvents();
+  ReplicationConfig();
+  LifecycleConfig();
+  CompleteMultipartUpload();
+  RemoveObjects();
+  BucketVersioning();
+  ErrorResponse();
+  StsCredentials();
+  WriterEscaping();
+
+  if (failures != 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}